@@ -0,0 +1,125 @@
+/*
+ * Copyright 2021 Adobe. All rights reserved.
+ * This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain a copy
+ * of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under
+ * the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ * OF ANY KIND, either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+ */
+#pragma once
+
+#include <lagrange/utils/la_assert.h>
+#include <lagrange/utils/safe_cast.h>
+#include <lagrange/utils/span.h>
+
+#include <vector>
+
+namespace lagrange {
+
+///
+/// Adjacency list stored in compressed sparse row (CSR) format. The neighbors of entry i are stored
+/// contiguously in a single flat array, in the range [offsets[i], offsets[i+1]).
+///
+/// @tparam     Index  Index type.
+///
+template <typename Index>
+class AdjacencyList
+{
+public:
+    using ValueArray = std::vector<Index>;
+    using OffsetArray = std::vector<Index>;
+    using NeighborList = span<const Index>;
+
+public:
+    AdjacencyList() = default;
+
+    ///
+    /// Constructs an adjacency list from its CSR arrays.
+    ///
+    /// @param[in]  data     Flat array of neighbor indices.
+    /// @param[in]  offsets  Array of #entries + 1 offsets into the data array.
+    ///
+    AdjacencyList(ValueArray data, OffsetArray offsets)
+        : m_data(std::move(data))
+        , m_offsets(std::move(offsets))
+    {
+        LA_ASSERT(!m_offsets.empty(), "Offset array must contain at least one element");
+        LA_ASSERT(safe_cast<size_t>(m_offsets.back()) == m_data.size(), "Inconsistent offsets");
+    }
+
+    ///
+    /// Number of entries (e.g. vertices or facets) in the adjacency list.
+    ///
+    /// @return     The number of entries.
+    ///
+    Index get_num_entries() const
+    {
+        return m_offsets.empty() ? Index(0) : safe_cast<Index>(m_offsets.size() - 1);
+    }
+
+    ///
+    /// Total number of stored neighbor indices.
+    ///
+    /// @return     The number of neighbor indices.
+    ///
+    size_t get_num_values() const { return m_data.size(); }
+
+    ///
+    /// Gets the neighbors of a given entry.
+    ///
+    /// @param[in]  i     Queried entry.
+    ///
+    /// @return     A read-only view over the neighbors of entry i.
+    ///
+    NeighborList get_neighbors(Index i) const
+    {
+        LA_ASSERT_DEBUG(i + 1 < safe_cast<Index>(m_offsets.size()));
+        return NeighborList(m_data.data() + m_offsets[i], m_data.data() + m_offsets[i + 1]);
+    }
+
+    ///
+    /// Gets the number of neighbors of a given entry.
+    ///
+    /// @param[in]  i     Queried entry.
+    ///
+    /// @return     The number of neighbors of entry i.
+    ///
+    Index get_num_neighbors(Index i) const { return m_offsets[i + 1] - m_offsets[i]; }
+
+    NeighborList operator[](Index i) const { return get_neighbors(i); }
+
+    size_t size() const { return safe_cast<size_t>(get_num_entries()); }
+
+    bool empty() const { return get_num_entries() == 0; }
+
+    const ValueArray& get_data() const { return m_data; }
+
+    const OffsetArray& get_offsets() const { return m_offsets; }
+
+    ///
+    /// Approximate heap memory used by the adjacency list, in bytes.
+    ///
+    /// @return     The number of bytes allocated by the underlying arrays.
+    ///
+    size_t get_memory_usage() const
+    {
+        return (m_data.capacity() + m_offsets.capacity()) * sizeof(Index);
+    }
+
+    void clear()
+    {
+        m_data.clear();
+        m_data.shrink_to_fit();
+        m_offsets.clear();
+        m_offsets.shrink_to_fit();
+    }
+
+protected:
+    ValueArray m_data;
+    OffsetArray m_offsets;
+};
+
+} // namespace lagrange
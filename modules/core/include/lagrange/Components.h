@@ -11,15 +11,29 @@
  */
 #pragma once
 
+#include <atomic>
 #include <queue>
 #include <vector>
 
 #include <lagrange/Connectivity.h>
+#include <lagrange/DisjointSets.h>
 #include <lagrange/MeshGeometry.h>
 #include <lagrange/common.h>
+#include <lagrange/corner_to_edge_mapping.h>
 #include <lagrange/utils/safe_cast.h>
 
+#include <tbb/parallel_for.h>
+
 namespace lagrange {
+
+///
+/// Defines when two facets are considered connected.
+///
+enum class ConnectivityType {
+    Vertex, ///< Facets sharing at least one vertex are connected.
+    Edge, ///< Facets sharing at least one edge are connected.
+};
+
 template <typename GeometryType>
 class Components
 {
@@ -32,8 +46,11 @@ public:
         std::unique_ptr<Connectivity<GeometryType>> temporary_conn_ptr = nullptr;
 
         if (!conn) {
-            temporary_conn_ptr = compute_connectivity<GeometryType>(geometry);
+            temporary_conn_ptr = std::make_unique<Connectivity<GeometryType>>();
+            temporary_conn_ptr->initialize_facet_facet_adjacency(geometry);
             conn = temporary_conn_ptr.get();
+        } else {
+            conn->ensure_facet_facet_adjacency(geometry);
         }
 
         m_components.clear();
@@ -72,6 +89,76 @@ public:
         }
     }
 
+    ///
+    /// Computes connected components directly from the facet array, without any adjacency list.
+    /// Facets are merged in parallel with a concurrent union-find over the facets: each vertex (or
+    /// edge) records the first facet that reaches it, and every other facet incident to it is
+    /// merged with that one.
+    ///
+    /// Components are numbered by increasing smallest facet index, as with the BFS-based
+    /// initialize(). Facets within a component are listed in increasing order.
+    ///
+    /// @note       With ConnectivityType::Edge, facets are connected if they share an edge.
+    ///             The BFS-based initialize() connects facets sharing at least two vertices, which
+    ///             is the same for valid triangle meshes, but also connects quads sharing only two
+    ///             diagonally opposite vertices.
+    ///
+    /// @param[in]  geometry           Input geometry.
+    /// @param[in]  connectivity_type  Whether facets are connected through vertices or edges.
+    ///
+    void initialize(const GeometryType& geometry, ConnectivityType connectivity_type)
+    {
+        const Index num_facets = geometry.get_num_facets();
+        const Index vertex_per_facet = geometry.get_vertex_per_facet();
+        const auto& facets = geometry.get_facets();
+
+        // Key of each facet corner: either its vertex or its edge.
+        Eigen::Matrix<Index, Eigen::Dynamic, 1> corner_to_edge;
+        Index num_keys = 0;
+        if (connectivity_type == ConnectivityType::Edge) {
+            num_keys = safe_cast<Index>(corner_to_edge_mapping(facets, corner_to_edge));
+        } else {
+            num_keys = geometry.get_num_vertices();
+        }
+        auto get_key = [&](Index f, Index lv) {
+            return connectivity_type == ConnectivityType::Edge
+                       ? corner_to_edge(f * vertex_per_facet + lv)
+                       : facets(f, lv);
+        };
+
+        ConcurrentDisjointSets<Index> facet_sets(num_facets);
+        std::vector<std::atomic<Index>> key_owner(num_keys);
+        tbb::parallel_for(Index(0), num_keys, [&](Index k) {
+            key_owner[k].store(INVALID<Index>(), std::memory_order_relaxed);
+        });
+        tbb::parallel_for(Index(0), num_facets, [&](Index f) {
+            for (Index lv = 0; lv < vertex_per_facet; ++lv) {
+                Index owner = INVALID<Index>();
+                if (!key_owner[get_key(f, lv)].compare_exchange_strong(
+                        owner,
+                        f,
+                        std::memory_order_relaxed)) {
+                    facet_sets.merge(owner, f);
+                }
+            }
+        });
+
+        const Index num_components =
+            facet_sets.extract_disjoint_set_indices(m_per_facet_component_ids);
+
+        std::vector<Index> component_sizes(num_components, 0);
+        for (Index f = 0; f < num_facets; ++f) {
+            component_sizes[m_per_facet_component_ids[f]]++;
+        }
+        m_components.assign(num_components, IndexList());
+        for (Index c = 0; c < num_components; ++c) {
+            m_components[c].reserve(component_sizes[c]);
+        }
+        for (Index f = 0; f < num_facets; ++f) {
+            m_components[m_per_facet_component_ids[f]].push_back(f);
+        }
+    }
+
     const std::vector<IndexList>& get_components() const { return m_components; }
 
     const IndexList& get_per_facet_component_ids() const { return m_per_facet_component_ids; }
@@ -93,4 +180,15 @@ std::unique_ptr<Components<GeometryType>> compute_components(
     ptr->initialize(geometry, conn);
     return ptr;
 }
+
+template <typename GeometryType>
+std::unique_ptr<Components<GeometryType>> compute_components(
+    const GeometryType& geometry,
+    ConnectivityType connectivity_type)
+{
+    auto ptr = std::make_unique<Components<GeometryType>>();
+
+    ptr->initialize(geometry, connectivity_type);
+    return ptr;
+}
 } // namespace lagrange
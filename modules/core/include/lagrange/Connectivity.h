@@ -12,105 +12,317 @@
 #pragma once
 
 #include <algorithm>
+#include <atomic>
+#include <limits>
+#include <mutex>
 #include <vector>
 
+#include <lagrange/AdjacencyList.h>
 #include <lagrange/MeshGeometry.h>
 #include <lagrange/utils/la_assert.h>
+#include <lagrange/utils/safe_cast.h>
+
+#include <tbb/enumerable_thread_specific.h>
+#include <tbb/parallel_for.h>
 
 namespace lagrange {
+
+///
+/// Vertex-vertex, vertex-facet and facet-facet adjacency of a mesh. Each relation is stored as a
+/// compressed sparse row (CSR) adjacency list, and the neighbors of an element are returned as a
+/// read-only span. Neighbor lists are sorted in increasing order and do not contain duplicates.
+///
+/// Relations can be computed all at once with initialize(), or separately with the
+/// initialize_*_adjacency() methods. The ensure_*_adjacency() methods compute a relation only if it
+/// is not available yet, and are safe to call concurrently from multiple threads.
+///
+/// @tparam     GeometryType  Mesh geometry type.
+///
 template <typename GeometryType>
 class Connectivity
 {
 public:
     using Index = typename GeometryType::Index;
     using IndexList = std::vector<Index>;
-    using AdjacencyList = std::vector<IndexList>;
+    using AdjacencyList = lagrange::AdjacencyList<Index>;
+    using NeighborList = typename AdjacencyList::NeighborList;
 
-    Connectivity()
-        : m_initialized(false)
-    {}
+    Connectivity() = default;
 
+    /// Computes all adjacency relations.
     void initialize(const GeometryType& geometry)
     {
-        m_v2v.clear();
-        m_v2f.clear();
-        m_f2f.clear();
+        std::lock_guard<std::mutex> lock(m_mutex);
+        clear_unsafe();
+        build_vertex_adjacency(geometry, true, true);
+        build_facet_facet_adjacency(geometry);
+    }
 
-        auto remove_duplicate_entries = [](IndexList& arr) {
-            std::sort(arr.begin(), arr.end());
-            const auto end_itr = std::unique(arr.begin(), arr.end());
-            arr.resize(std::distance(arr.begin(), end_itr));
-        };
+    /// Computes the vertex-vertex adjacency only.
+    void initialize_vertex_vertex_adjacency(const GeometryType& geometry)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        build_vertex_adjacency(geometry, true, false);
+    }
 
-        auto extract_duplicate_entries = [](IndexList& arr) {
-            std::sort(arr.begin(), arr.end());
-            IndexList duplicate_entries;
-            Index curr = arr.back() + 1;
-            for (const auto& item : arr) {
-                if (curr == item &&
-                    (duplicate_entries.empty() || item != duplicate_entries.back())) {
-                    duplicate_entries.push_back(item);
-                } else {
-                    curr = item;
-                }
+    /// Computes the vertex-facet adjacency only.
+    void initialize_vertex_facet_adjacency(const GeometryType& geometry)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        build_vertex_adjacency(geometry, false, true);
+    }
+
+    ///
+    /// Computes the facet-facet adjacency. The vertex-facet adjacency is computed as well if it is
+    /// not already available, since it is needed to find adjacent facets.
+    ///
+    void initialize_facet_facet_adjacency(const GeometryType& geometry)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_has_v2f.load(std::memory_order_relaxed)) {
+            build_vertex_adjacency(geometry, false, true);
+        }
+        build_facet_facet_adjacency(geometry);
+    }
+
+    /// Computes the vertex-vertex adjacency if needed. Thread-safe.
+    void ensure_vertex_vertex_adjacency(const GeometryType& geometry)
+    {
+        if (m_has_v2v.load(std::memory_order_acquire)) return;
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_has_v2v.load(std::memory_order_relaxed)) {
+            build_vertex_adjacency(geometry, true, false);
+        }
+    }
+
+    /// Computes the vertex-facet adjacency if needed. Thread-safe.
+    void ensure_vertex_facet_adjacency(const GeometryType& geometry)
+    {
+        if (m_has_v2f.load(std::memory_order_acquire)) return;
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_has_v2f.load(std::memory_order_relaxed)) {
+            build_vertex_adjacency(geometry, false, true);
+        }
+    }
+
+    /// Computes the facet-facet adjacency if needed. Thread-safe.
+    void ensure_facet_facet_adjacency(const GeometryType& geometry)
+    {
+        if (m_has_f2f.load(std::memory_order_acquire)) return;
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_has_f2f.load(std::memory_order_relaxed)) {
+            if (!m_has_v2f.load(std::memory_order_relaxed)) {
+                build_vertex_adjacency(geometry, false, true);
             }
-            arr.swap(duplicate_entries);
-        };
+            build_facet_facet_adjacency(geometry);
+        }
+    }
+
+    /// Releases all adjacency relations.
+    void clear()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        clear_unsafe();
+    }
+
+    /// Whether all three adjacency relations are available.
+    bool is_initialized() const
+    {
+        return is_vertex_vertex_adjacency_initialized() &&
+               is_vertex_facet_adjacency_initialized() && is_facet_facet_adjacency_initialized();
+    }
+    bool is_vertex_vertex_adjacency_initialized() const
+    {
+        return m_has_v2v.load(std::memory_order_acquire);
+    }
+    bool is_vertex_facet_adjacency_initialized() const
+    {
+        return m_has_v2f.load(std::memory_order_acquire);
+    }
+    bool is_facet_facet_adjacency_initialized() const
+    {
+        return m_has_f2f.load(std::memory_order_acquire);
+    }
 
+    const AdjacencyList& get_vertex_vertex_adjacency() const { return m_v2v; }
+    const AdjacencyList& get_vertex_facet_adjacency() const { return m_v2f; }
+    const AdjacencyList& get_facet_facet_adjacency() const { return m_f2f; }
+    NeighborList get_vertices_adjacent_to_vertex(Index vi) const { return m_v2v[vi]; }
+    NeighborList get_facets_adjacent_to_vertex(Index vi) const { return m_v2f[vi]; }
+    NeighborList get_facets_adjacent_to_facet(Index fi) const { return m_f2f[fi]; }
+
+protected:
+    using ValueArray = typename AdjacencyList::ValueArray;
+    using OffsetArray = typename AdjacencyList::OffsetArray;
+
+    void clear_unsafe()
+    {
+        m_has_v2v.store(false, std::memory_order_release);
+        m_has_v2f.store(false, std::memory_order_release);
+        m_has_f2f.store(false, std::memory_order_release);
+        m_v2v.clear();
+        m_v2f.clear();
+        m_f2f.clear();
+    }
+
+    ///
+    /// Computes the vertex-vertex and/or vertex-facet adjacency. Both relations share the same
+    /// counting pass over the facet corners. The caller must hold the mutex.
+    ///
+    void build_vertex_adjacency(const GeometryType& geometry, bool with_v2v, bool with_v2f)
+    {
         const Index num_vertices = geometry.get_num_vertices();
         const Index num_facets = geometry.get_num_facets();
         const Index vertex_per_facet = geometry.get_vertex_per_facet();
-        m_v2v.resize(num_vertices);
-        m_v2f.resize(num_vertices);
-        m_f2f.resize(num_facets);
-        for (auto& arr : m_v2v) arr.reserve(16);
-        for (auto& arr : m_v2f) arr.reserve(16);
-        for (auto& arr : m_f2f) arr.reserve(16);
-
         const auto& facets = geometry.get_facets();
 
-        for (Index i = 0; i < num_facets; i++) {
-            for (Index j = 0; j < vertex_per_facet; j++) {
-                Index curr = facets(i, j);
-                Index next = facets(i, (j + 1) % vertex_per_facet);
-                Index prev = facets(i, (j + vertex_per_facet - 1) % vertex_per_facet);
-                m_v2v[curr].push_back(next);
-                m_v2v[curr].push_back(prev);
-                m_v2f[curr].push_back(i);
+        // Count the number of corners incident to each vertex.
+        std::vector<std::atomic<Index>> cursor(num_vertices);
+        tbb::parallel_for(Index(0), num_facets, [&](Index f) {
+            for (Index lv = 0; lv < vertex_per_facet; ++lv) {
+                cursor[facets(f, lv)].fetch_add(1, std::memory_order_relaxed);
             }
+        });
+
+        // Prefix sum. The v2v list of a vertex gets two slots per incident corner.
+        LA_ASSERT(
+            2 * size_t(num_facets) * size_t(vertex_per_facet) <=
+                size_t(std::numeric_limits<Index>::max()),
+            "Mesh is too large for the current index type");
+        OffsetArray corner_offsets(num_vertices + 1);
+        corner_offsets[0] = 0;
+        for (Index v = 0; v < num_vertices; ++v) {
+            const Index count = cursor[v].load(std::memory_order_relaxed);
+            cursor[v].store(corner_offsets[v], std::memory_order_relaxed);
+            corner_offsets[v + 1] = corner_offsets[v] + count;
         }
-        std::for_each(m_v2v.begin(), m_v2v.end(), remove_duplicate_entries);
-        std::for_each(m_v2f.begin(), m_v2f.end(), remove_duplicate_entries);
 
-        for (Index i = 0; i < num_facets; i++) {
+        // Scatter incident facets and neighboring vertices.
+        ValueArray v2f(with_v2f ? corner_offsets.back() : 0);
+        ValueArray v2v(with_v2v ? 2 * corner_offsets.back() : 0);
+        tbb::parallel_for(Index(0), num_facets, [&](Index f) {
             for (Index j = 0; j < vertex_per_facet; j++) {
-                Index vi = facets(i, j);
-                const auto& adj_facets = m_v2f[vi];
-                m_f2f[i].insert(m_f2f[i].end(), adj_facets.begin(), adj_facets.end());
+                const Index curr = facets(f, j);
+                const Index pos = cursor[curr].fetch_add(1, std::memory_order_relaxed);
+                if (with_v2f) {
+                    v2f[pos] = f;
+                }
+                if (with_v2v) {
+                    v2v[2 * pos] = facets(f, (j + 1) % vertex_per_facet);
+                    v2v[2 * pos + 1] = facets(f, (j + vertex_per_facet - 1) % vertex_per_facet);
+                }
             }
-        }
-        std::for_each(m_f2f.begin(), m_f2f.end(), extract_duplicate_entries);
+        });
+        cursor.clear();
+        cursor.shrink_to_fit();
 
-        // Remove self from f2f adjacency.
-        for (Index i = 0; i < num_facets; i++) {
-            const auto itr = std::find(m_f2f[i].begin(), m_f2f[i].end(), i);
-            LA_ASSERT(itr != m_f2f[i].end());
-            m_f2f[i].erase(itr);
+        if (with_v2f) {
+            m_v2f = sort_and_compact(std::move(v2f), corner_offsets);
+            m_has_v2f.store(true, std::memory_order_release);
+        }
+        if (with_v2v) {
+            for (auto& offset : corner_offsets) {
+                offset *= 2;
+            }
+            m_v2v = sort_and_compact(std::move(v2v), corner_offsets);
+            m_has_v2v.store(true, std::memory_order_release);
         }
+    }
+
+    ///
+    /// Computes the facet-facet adjacency from the vertex-facet adjacency. The caller must hold the
+    /// mutex.
+    ///
+    void build_facet_facet_adjacency(const GeometryType& geometry)
+    {
+        LA_ASSERT(m_has_v2f.load(std::memory_order_relaxed), "Missing vertex-facet adjacency");
+        const Index num_facets = geometry.get_num_facets();
+        const Index vertex_per_facet = geometry.get_vertex_per_facet();
+        const auto& facets = geometry.get_facets();
+
+        // Two facets are adjacent if they share at least two vertices. Concatenating the v2f lists
+        // of the facet vertices, those are the entries that appear more than once.
+        tbb::enumerable_thread_specific<ValueArray> thread_buffers;
+        auto collect_adjacent_facets = [&](Index f, ValueArray& buffer) {
+            buffer.clear();
+            for (Index j = 0; j < vertex_per_facet; j++) {
+                const auto adj_facets = m_v2f.get_neighbors(facets(f, j));
+                buffer.insert(buffer.end(), adj_facets.begin(), adj_facets.end());
+            }
+            std::sort(buffer.begin(), buffer.end());
+            auto out = buffer.begin();
+            for (auto it = buffer.begin(); it != buffer.end();) {
+                const Index item = *it;
+                const auto next = std::find_if(it, buffer.end(), [&](Index x) { return x != item; });
+                // Remove self from f2f adjacency.
+                if (std::distance(it, next) > 1 && item != f) {
+                    *out++ = item;
+                }
+                it = next;
+            }
+            buffer.erase(out, buffer.end());
+        };
 
-        m_initialized = true;
+        // The f2f lists are computed twice: once to size the CSR arrays, and once to fill them.
+        // This is cheaper than storing a temporary copy of every list.
+        OffsetArray f2f_offsets(num_facets + 1);
+        f2f_offsets[0] = 0;
+        tbb::parallel_for(Index(0), num_facets, [&](Index f) {
+            auto& buffer = thread_buffers.local();
+            collect_adjacent_facets(f, buffer);
+            f2f_offsets[f + 1] = safe_cast<Index>(buffer.size());
+        });
+        for (Index f = 0; f < num_facets; ++f) {
+            f2f_offsets[f + 1] += f2f_offsets[f];
+        }
+        ValueArray f2f(f2f_offsets.back());
+        tbb::parallel_for(Index(0), num_facets, [&](Index f) {
+            auto& buffer = thread_buffers.local();
+            collect_adjacent_facets(f, buffer);
+            std::copy(buffer.begin(), buffer.end(), f2f.begin() + f2f_offsets[f]);
+        });
+        m_f2f = AdjacencyList(std::move(f2f), std::move(f2f_offsets));
+        m_has_f2f.store(true, std::memory_order_release);
     }
 
-    bool is_initialized() const { return m_initialized; }
-    const AdjacencyList& get_vertex_vertex_adjacency() const { return m_v2v; }
-    const AdjacencyList& get_vertex_facet_adjacency() const { return m_v2f; }
-    const AdjacencyList& get_facet_facet_adjacency() const { return m_f2f; }
-    const IndexList& get_vertices_adjacent_to_vertex(Index vi) const { return m_v2v[vi]; }
-    const IndexList& get_facets_adjacent_to_vertex(Index vi) const { return m_v2f[vi]; }
-    const IndexList& get_facets_adjacent_to_facet(Index fi) const { return m_f2f[fi]; }
+    ///
+    /// Sorts each row of a CSR array and removes duplicate entries, then packs the rows into a new
+    /// adjacency list.
+    ///
+    /// @param[in]  data     Flat array of values. Rows are sorted in place.
+    /// @param[in]  offsets  Row offsets into the data array.
+    ///
+    /// @return     The compacted adjacency list.
+    ///
+    static AdjacencyList sort_and_compact(ValueArray data, const OffsetArray& offsets)
+    {
+        const Index num_entries = safe_cast<Index>(offsets.size() - 1);
+        OffsetArray new_offsets(offsets.size());
+        new_offsets[0] = 0;
+        tbb::parallel_for(Index(0), num_entries, [&](Index i) {
+            const auto first = data.begin() + offsets[i];
+            const auto last = data.begin() + offsets[i + 1];
+            std::sort(first, last);
+            new_offsets[i + 1] = static_cast<Index>(std::distance(first, std::unique(first, last)));
+        });
+        for (Index i = 0; i < num_entries; ++i) {
+            new_offsets[i + 1] += new_offsets[i];
+        }
+        ValueArray new_data(new_offsets.back());
+        tbb::parallel_for(Index(0), num_entries, [&](Index i) {
+            std::copy_n(
+                data.begin() + offsets[i],
+                new_offsets[i + 1] - new_offsets[i],
+                new_data.begin() + new_offsets[i]);
+        });
+        return AdjacencyList(std::move(new_data), std::move(new_offsets));
+    }
 
 protected:
-    bool m_initialized;
+    std::mutex m_mutex;
+    std::atomic<bool> m_has_v2v{false};
+    std::atomic<bool> m_has_v2f{false};
+    std::atomic<bool> m_has_f2f{false};
     AdjacencyList m_v2v;
     AdjacencyList m_v2f;
     AdjacencyList m_f2f;
@@ -0,0 +1,255 @@
+/*
+ * Copyright 2021 Adobe. All rights reserved.
+ * This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain a copy
+ * of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under
+ * the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ * OF ANY KIND, either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+ */
+#pragma once
+
+#include <lagrange/Mesh.h>
+#include <lagrange/MeshTrait.h>
+#include <lagrange/common.h>
+#include <lagrange/utils/RadixHeap.h>
+#include <lagrange/utils/la_assert.h>
+
+#include <Eigen/Core>
+#include <tbb/enumerable_thread_specific.h>
+#include <tbb/parallel_for.h>
+
+#include <limits>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace lagrange {
+
+///
+/// Computes distance fields from sets of seed points on a triangle mesh. Distances are shortest
+/// path lengths along mesh edges, starting from the Euclidean distance between each seed and the
+/// vertices of its facet. The distance to a set of seeds is the distance to the closest seed.
+///
+/// Each query uses a monotone radix heap and a dense distance buffer owned by the calling thread.
+/// These buffers are reused across queries, and only the vertices reached by a query are reset
+/// once it is done, so queries with a small radius cost time proportional to the reached region.
+///
+/// @code
+/// DijkstraDistanceEngine<TriangleMesh3D> engine(mesh);
+/// engine.compute_vertex_attribute({{0, {1. / 3, 1. / 3, 1. / 3}}, {42, {1, 0, 0}}});
+/// @endcode
+///
+/// @tparam     MeshType  Mesh type.
+///
+template <typename MeshType>
+class DijkstraDistanceEngine
+{
+public:
+    static_assert(MeshTrait<MeshType>::is_mesh(), "Input type is not Mesh");
+
+    using Scalar = typename MeshType::Scalar;
+    using Index = typename MeshType::Index;
+    using AttributeArray = typename MeshType::AttributeArray;
+
+    ///
+    /// Point on the mesh surface.
+    ///
+    struct Seed
+    {
+        Index facet; ///< Facet containing the point.
+        Eigen::Matrix<Scalar, 3, 1> bc; ///< Barycentric coordinates of the point in the facet.
+    };
+
+    /// Vertex reached by a query, with its distance.
+    using Reached = std::pair<Index, Scalar>;
+
+public:
+    ///
+    /// Prepares distance queries on a mesh. Vertex-vertex adjacency is initialized if needed. The
+    /// mesh must outlive the engine, and its vertices and facets must not change in between.
+    ///
+    /// @param[in,out] mesh  Input 3D triangle mesh.
+    ///
+    explicit DijkstraDistanceEngine(MeshType& mesh)
+        : m_mesh(mesh)
+    {
+        if (mesh.get_dim() != 3) {
+            throw std::runtime_error("Input mesh must be 3D mesh.");
+        }
+        if (mesh.get_vertex_per_facet() != 3) {
+            throw std::runtime_error("Input mesh is not triangle mesh");
+        }
+        if (!mesh.is_vertex_vertex_adjacency_initialized()) {
+            mesh.initialize_vertex_vertex_adjacency();
+        }
+    }
+
+    ///
+    /// Visits the vertices within a given distance of a set of seeds, by increasing distance.
+    ///
+    /// @param[in]  seeds   Seed points.
+    /// @param[in]  radius  Vertices are only reached through paths shorter than the radius. The
+    ///                     vertices of the seed facets are always reached. Non-positive values
+    ///                     mean no limit.
+    /// @param[in]  func    Function called with each reached vertex index and its distance.
+    ///
+    template <typename Func>
+    void compute(const std::vector<Seed>& seeds, Scalar radius, Func func) const
+    {
+        auto& scratch = m_scratch.local();
+        scratch.dist.resize(m_mesh.get_num_vertices(), -1);
+        run(seeds, radius, scratch, scratch.dist.data(), func);
+        for (Index v : scratch.touched) scratch.dist[v] = -1;
+    }
+
+    ///
+    /// Computes the dense distance field of a set of seeds.
+    ///
+    /// @param[in]  seeds   Seed points.
+    /// @param[in]  radius  Maximum path length, see compute(). Non-positive values mean no limit.
+    /// @param[out] dist    #V x 1 array of distances. Vertices that are not reached have distance
+    ///                     -1.
+    /// @param[in]  func    Function called with each reached vertex index and its distance, by
+    ///                     increasing distance.
+    ///
+    template <typename Func>
+    void compute(const std::vector<Seed>& seeds, Scalar radius, AttributeArray& dist, Func func)
+        const
+    {
+        // The output array is used as the tentative distance buffer.
+        dist.setConstant(m_mesh.get_num_vertices(), 1, -1);
+        run(seeds, radius, m_scratch.local(), dist.data(), func);
+    }
+
+    ///
+    /// Computes the dense distance field of a set of seeds.
+    ///
+    /// @param[in]  seeds   Seed points.
+    /// @param[in]  radius  Maximum path length, see compute(). Non-positive values mean no limit.
+    /// @param[out] dist    #V x 1 array of distances. Vertices that are not reached have distance
+    ///                     -1.
+    ///
+    void compute(const std::vector<Seed>& seeds, Scalar radius, AttributeArray& dist) const
+    {
+        compute(seeds, radius, dist, [](Index, Scalar) {});
+    }
+
+    ///
+    /// Computes the dense distance field of a set of seeds, and stores it in a vertex attribute.
+    ///
+    /// @param[in]  seeds   Seed points.
+    /// @param[in]  radius  Maximum path length, see compute(). Non-positive values mean no limit.
+    /// @param[in]  name    Name of the output vertex attribute.
+    ///
+    void compute_vertex_attribute(
+        const std::vector<Seed>& seeds,
+        Scalar radius = 0,
+        const std::string& name = "dijkstra_distance")
+    {
+        AttributeArray dist;
+        compute(seeds, radius, dist);
+        m_mesh.add_vertex_attribute(name);
+        m_mesh.import_vertex_attribute(name, dist);
+    }
+
+    ///
+    /// Runs independent queries in parallel.
+    ///
+    /// @param[in]  queries  Seed points of each query.
+    /// @param[in]  radius   Maximum path length, see compute(). Non-positive values mean no limit.
+    /// @param[in]  func     Function called once per query, from the thread running it, with the
+    ///                      query index and the vertices reached by increasing distance. The
+    ///                      reached vertices are stored in a per-thread buffer, only valid during
+    ///                      the call.
+    ///
+    template <typename Func>
+    void compute_batch(const std::vector<std::vector<Seed>>& queries, Scalar radius, Func func)
+        const
+    {
+        tbb::parallel_for(size_t(0), queries.size(), [&](size_t q) {
+            auto& reached = m_scratch.local().reached;
+            reached.clear();
+            compute(queries[q], radius, [&](Index v, Scalar d) { reached.emplace_back(v, d); });
+            func(q, reached);
+        });
+    }
+
+protected:
+    /// Per-thread buffers reused across queries.
+    struct Scratch
+    {
+        RadixHeap<Scalar, Index> queue; ///< Pending vertices.
+        std::vector<Scalar> dist; ///< Tentative distances of sparse queries, or -1 if not reached.
+        std::vector<Index> touched; ///< Vertices reached by the last query.
+        std::vector<Reached> reached; ///< Output buffer of batched queries.
+    };
+
+    // Runs a query, using a #V buffer of tentative distances initialized to -1. Reached vertices
+    // are left with their distance, and are listed in scratch.touched.
+    template <typename Func>
+    void run(
+        const std::vector<Seed>& seeds,
+        Scalar radius,
+        Scratch& scratch,
+        Scalar* dist,
+        Func func) const
+    {
+        if (radius <= 0) {
+            radius = std::numeric_limits<Scalar>::max();
+        }
+        const Index num_facets = m_mesh.get_num_facets();
+        const auto& vertices = m_mesh.get_vertices();
+        const auto& facets = m_mesh.get_facets();
+        const auto& adjacency = m_mesh.get_vertex_vertex_adjacency();
+
+        auto& queue = scratch.queue;
+        auto& touched = scratch.touched;
+        queue.clear();
+        touched.clear();
+
+        auto relax = [&](Index v, Scalar d) {
+            if (dist[v] < 0) {
+                touched.push_back(v);
+            } else if (!(d < dist[v])) {
+                return;
+            }
+            dist[v] = d;
+            queue.push(d, v);
+        };
+
+        for (const auto& seed : seeds) {
+            LA_ASSERT(seed.facet < num_facets, "Invalid seed facet");
+        }
+        using VertexType = typename MeshType::VertexType;
+        for (const auto& seed : seeds) {
+            const auto& f = facets.row(seed.facet);
+            const VertexType seed_point = vertices.row(f[0]) * seed.bc[0] +
+                                          vertices.row(f[1]) * seed.bc[1] +
+                                          vertices.row(f[2]) * seed.bc[2];
+            for (Index lv = 0; lv < 3; ++lv) {
+                relax(f[lv], (vertices.row(f[lv]) - seed_point).norm());
+            }
+        }
+
+        while (!queue.empty()) {
+            const auto entry = queue.pop();
+            const Index vi = entry.second;
+            const Scalar di = entry.first;
+            if (di > dist[vi]) continue;
+            func(vi, di);
+            for (Index vj : adjacency.get_neighbors(vi)) {
+                const Scalar d = di + (vertices.row(vj) - vertices.row(vi)).norm();
+                if (d < radius) relax(vj, d);
+            }
+        }
+    }
+
+protected:
+    MeshType& m_mesh; ///< Input mesh.
+    mutable tbb::enumerable_thread_specific<Scratch> m_scratch; ///< Per-thread query buffers.
+};
+
+} // namespace lagrange
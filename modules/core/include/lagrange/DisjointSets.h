@@ -11,7 +11,9 @@
  */
 #pragma once
 
+#include <atomic>
 #include <numeric>
+#include <utility>
 #include <vector>
 
 #include <lagrange/common.h>
@@ -19,6 +21,8 @@
 #include <lagrange/utils/range.h>
 #include <lagrange/utils/safe_cast.h>
 
+#include <tbb/parallel_for.h>
+
 namespace lagrange {
 
 template <typename IndexType>
@@ -78,7 +82,7 @@ public:
         index_map.resize(num_entries, INVALID<IndexType>());
         IndexType counter = 0;
 
-        // Assign each roots a unique index.
+        // Assign each root a unique index.
         for (auto i : range(num_entries)) {
             const auto root = find(i);
             if (i == root) {
@@ -101,4 +105,101 @@ private:
     std::vector<IndexType> m_parent;
 };
 
+///
+/// Lock-free variant of DisjointSets, where find() and merge() can be called concurrently from
+/// multiple threads. Sets are always linked so that the root of a set is its smallest element. The
+/// resulting roots and set indices are thus independent of the order in which merges happen, and of
+/// the number of threads.
+///
+/// @tparam     IndexType  Index type.
+///
+template <typename IndexType>
+class ConcurrentDisjointSets
+{
+public:
+    ConcurrentDisjointSets() = default;
+    explicit ConcurrentDisjointSets(IndexType n) { init(n); }
+
+    void init(IndexType n)
+    {
+        m_parent = std::vector<std::atomic<IndexType>>(n);
+        tbb::parallel_for(IndexType(0), n, [&](IndexType i) {
+            m_parent[i].store(i, std::memory_order_relaxed);
+        });
+    }
+
+    IndexType size() const { return safe_cast<IndexType>(m_parent.size()); }
+
+    void clear() { m_parent.clear(); }
+
+    IndexType find(IndexType i)
+    {
+        LA_ASSERT_DEBUG(i >= 0 && i < safe_cast<IndexType>(m_parent.size()));
+        while (true) {
+            IndexType p = m_parent[i].load(std::memory_order_relaxed);
+            if (p == i) return i;
+            const IndexType gp = m_parent[p].load(std::memory_order_relaxed);
+            if (p != gp) {
+                // Path halving. Parents only ever decrease, so a failed exchange simply means
+                // another thread already moved i closer to its root.
+                m_parent[i].compare_exchange_weak(p, gp, std::memory_order_relaxed);
+            }
+            i = gp;
+        }
+    }
+
+    IndexType merge(IndexType i, IndexType j)
+    {
+        while (true) {
+            i = find(i);
+            j = find(j);
+            if (i == j) return i;
+            if (i < j) std::swap(i, j);
+            // Link the larger root under the smaller one. This fails if i stopped being a root
+            // since it was found, in which case we retry from the new roots.
+            IndexType expected = i;
+            if (m_parent[i].compare_exchange_strong(expected, j, std::memory_order_acq_rel)) {
+                return j;
+            }
+        }
+    }
+
+    /**
+     * Assign all elements their disjoint set index. Each disjoint set index ranges from 0 to k-1,
+     * where k is the number of disjoint sets. Sets are numbered by increasing smallest element.
+     * Must not be called concurrently with merge().
+     */
+    IndexType extract_disjoint_set_indices(std::vector<IndexType>& index_map)
+    {
+        const IndexType num_entries = size();
+        index_map.assign(num_entries, INVALID<IndexType>());
+
+        // Find the root of every element.
+        std::vector<IndexType> roots(num_entries);
+        tbb::parallel_for(IndexType(0), num_entries, [&](IndexType i) {
+            roots[i] = find(i);
+        });
+
+        // Assign each root a unique index.
+        IndexType counter = 0;
+        for (auto i : range(num_entries)) {
+            if (roots[i] == i) {
+                index_map[i] = counter++;
+            }
+        }
+
+        // Assign all members the same index as their root.
+        tbb::parallel_for(IndexType(0), num_entries, [&](IndexType i) {
+            if (roots[i] != i) {
+                index_map[i] = index_map[roots[i]];
+            }
+        });
+
+        return counter;
+    }
+
+private:
+    std::vector<std::atomic<IndexType>> m_parent;
+};
+
 } // namespace lagrange
@@ -18,6 +18,7 @@
 #include <unordered_map>
 #include <unordered_set>
 
+#include <lagrange/FlatEdgeMap.h>
 #include <lagrange/common.h>
 #include <lagrange/utils/la_assert.h>
 #include <lagrange/utils/safe_cast.h>
@@ -142,11 +143,13 @@ public:
     }
 };
 
+// Edge-keyed containers use open addressing, see <lagrange/FlatEdgeMap.h>. Unlike the standard
+// unordered containers, insertions invalidate iterators and references to existing elements.
 template <typename Index, typename T>
-using EdgeMap = std::unordered_map<EdgeType<Index>, T>;
+using EdgeMap = FlatEdgeMap<Index, T>;
 
 template <typename Index>
-using EdgeSet = std::unordered_set<EdgeType<Index>>;
+using EdgeSet = FlatEdgeSet<Index>;
 
 template <typename MeshType>
 using EdgeFacetMap =
@@ -193,7 +196,7 @@ EdgeFacetMap<MeshType> compute_edge_facet_map_in_active_vertices(
 
     std::unordered_set<Index> active_facets;
 
-    if (mesh.is_connectivity_initialized()) {
+    if (mesh.is_vertex_facet_adjacency_initialized()) {
         // this path is faster but requires connectivity initialized
         for (Index v : active_vertices) {
             for (Index f : mesh.get_facets_adjacent_to_vertex(v)) {
@@ -0,0 +1,510 @@
+/*
+ * Copyright 2021 Adobe. All rights reserved.
+ * This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain a copy
+ * of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under
+ * the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ * OF ANY KIND, either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+ */
+#pragma once
+
+#include <lagrange/common.h>
+#include <lagrange/utils/la_assert.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace lagrange {
+
+// Defined in <lagrange/Edge.h>, which should be included instead of this file.
+template <typename Index>
+class EdgeType;
+
+namespace internal {
+
+/// Mixes the bits of a 64-bit integer (splitmix64 finalizer).
+inline uint64_t mix_edge_hash(uint64_t x)
+{
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9ULL;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111ebULL;
+    x ^= x >> 31;
+    return x;
+}
+
+///
+/// Orientation-independent key of an edge. For indices up to 32 bits, the sorted endpoints are
+/// packed into a single 64-bit integer.
+///
+/// @tparam     Index   Index type.
+/// @tparam     Packed  Whether the key fits in 64 bits.
+///
+template <typename Index, bool Packed = (sizeof(Index) <= 4)>
+struct EdgeKey
+{
+    using Storage = uint64_t;
+
+    static Storage make(Index v1, Index v2)
+    {
+        const uint64_t a = static_cast<uint32_t>(std::min(v1, v2));
+        const uint64_t b = static_cast<uint32_t>(std::max(v1, v2));
+        return (a << 32) | b;
+    }
+    static Storage empty() { return ~uint64_t(0); }
+    static size_t hash(Storage key) { return static_cast<size_t>(mix_edge_hash(key)); }
+};
+
+template <typename Index>
+struct EdgeKey<Index, false>
+{
+    using Storage = std::array<Index, 2>;
+
+    static Storage make(Index v1, Index v2)
+    {
+        return {{std::min(v1, v2), std::max(v1, v2)}};
+    }
+    static Storage empty() { return {{INVALID<Index>(), INVALID<Index>()}}; }
+    static size_t hash(const Storage& key)
+    {
+        const uint64_t a = static_cast<uint64_t>(key[0]);
+        const uint64_t b = static_cast<uint64_t>(key[1]);
+        return static_cast<size_t>(mix_edge_hash(mix_edge_hash(a) ^ b));
+    }
+};
+
+///
+/// Open-addressing hash table with linear probing, storing edge-keyed values contiguously. Each
+/// slot holds a packed key next to its value, so a successful lookup usually touches a single cache
+/// line. Erasing uses backward-shift deletion, so no tombstones are left behind.
+///
+/// Unlike std::unordered_map, inserting or erasing an element invalidates all iterators and
+/// references.
+///
+/// @tparam     Index    Index type.
+/// @tparam     Value    Stored value type.
+/// @tparam     GetEdge  Functor extracting the edge from a stored value.
+///
+template <typename Index, typename Value, typename GetEdge>
+class FlatEdgeTable
+{
+public:
+    using Key = EdgeKey<Index>;
+    using KeyStorage = typename Key::Storage;
+    using Edge = EdgeType<Index>;
+    using value_type = Value;
+    using size_type = size_t;
+
+    template <bool IsConst>
+    class Iterator
+    {
+    public:
+        using Table = typename std::conditional<IsConst, const FlatEdgeTable, FlatEdgeTable>::type;
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = Value;
+        using difference_type = std::ptrdiff_t;
+        using reference = typename std::conditional<IsConst, const Value&, Value&>::type;
+        using pointer = typename std::conditional<IsConst, const Value*, Value*>::type;
+
+        Iterator(Table* table, size_t slot)
+            : m_table(table)
+            , m_slot(slot)
+        {
+            skip_empty();
+        }
+
+        // Allows conversion from iterator to const_iterator.
+        template <bool C, typename = std::enable_if_t<IsConst && !C>>
+        Iterator(const Iterator<C>& other)
+            : m_table(other.m_table)
+            , m_slot(other.m_slot)
+        {}
+
+        reference operator*() const { return m_table->m_slots[m_slot].value; }
+        pointer operator->() const { return &m_table->m_slots[m_slot].value; }
+        Iterator& operator++()
+        {
+            ++m_slot;
+            skip_empty();
+            return *this;
+        }
+        Iterator operator++(int)
+        {
+            Iterator tmp = *this;
+            ++*this;
+            return tmp;
+        }
+        bool operator==(const Iterator& rhs) const { return m_slot == rhs.m_slot; }
+        bool operator!=(const Iterator& rhs) const { return m_slot != rhs.m_slot; }
+
+    private:
+        void skip_empty()
+        {
+            while (m_slot < m_table->m_slots.size() &&
+                   m_table->m_slots[m_slot].key == Key::empty()) {
+                ++m_slot;
+            }
+        }
+
+    private:
+        friend class Iterator<!IsConst>;
+        Table* m_table;
+        size_t m_slot;
+    };
+
+    using iterator = Iterator<false>;
+    using const_iterator = Iterator<true>;
+
+public:
+    explicit FlatEdgeTable(Value empty_value)
+        : m_empty_value(std::move(empty_value))
+    {}
+
+    iterator begin() { return iterator(this, 0); }
+    iterator end() { return iterator(this, m_slots.size()); }
+    const_iterator begin() const { return const_iterator(this, 0); }
+    const_iterator end() const { return const_iterator(this, m_slots.size()); }
+
+    size_t size() const { return m_size; }
+    bool empty() const { return m_size == 0; }
+    size_t bucket_count() const { return m_slots.size(); }
+
+    void clear()
+    {
+        std::fill(m_slots.begin(), m_slots.end(), Slot{Key::empty(), m_empty_value});
+        m_size = 0;
+    }
+
+    ///
+    /// Makes room for at least a given number of elements without rehashing.
+    ///
+    /// @param[in]  count  Number of elements.
+    ///
+    void reserve(size_t count)
+    {
+        size_t capacity = 16;
+        while (capacity * MaxLoadNum < count * MaxLoadDen) capacity *= 2;
+        if (capacity > m_slots.size()) rehash(capacity);
+    }
+
+    iterator find(const Edge& edge) { return iterator(this, find_slot(edge)); }
+    const_iterator find(const Edge& edge) const { return const_iterator(this, find_slot(edge)); }
+    size_t count(const Edge& edge) const { return find_slot(edge) != m_slots.size() ? 1 : 0; }
+    bool contains(const Edge& edge) const { return find_slot(edge) != m_slots.size(); }
+
+    ///
+    /// Inserts a value if its edge is not already present.
+    ///
+    /// @param[in]  value  Value to insert.
+    ///
+    /// @return     Iterator to the element with the same edge, and whether the insertion happened.
+    ///
+    std::pair<iterator, bool> insert(Value value)
+    {
+        const Edge& edge = GetEdge()(value);
+        const KeyStorage key = Key::make(edge.v1(), edge.v2());
+        LA_ASSERT(key != Key::empty(), "Invalid edge");
+        if ((m_size + 1) * MaxLoadDen > m_slots.size() * MaxLoadNum) {
+            rehash(std::max<size_t>(16, 2 * m_slots.size()));
+        }
+        const size_t mask = m_slots.size() - 1;
+        size_t slot = Key::hash(key) & mask;
+        while (m_slots[slot].key != Key::empty()) {
+            if (m_slots[slot].key == key) return {iterator(this, slot), false};
+            slot = (slot + 1) & mask;
+        }
+        m_slots[slot].key = key;
+        m_slots[slot].value = std::move(value);
+        ++m_size;
+        return {iterator(this, slot), true};
+    }
+
+    ///
+    /// Removes the element with a given edge, if present.
+    ///
+    /// @param[in]  edge  Edge to remove.
+    ///
+    /// @return     Number of elements removed (0 or 1).
+    ///
+    size_t erase(const Edge& edge)
+    {
+        size_t slot = find_slot(edge);
+        if (slot == m_slots.size()) return 0;
+        const size_t mask = m_slots.size() - 1;
+        size_t next = (slot + 1) & mask;
+        while (m_slots[next].key != Key::empty()) {
+            // Shift back elements whose probe sequence passes through the hole.
+            const size_t home = Key::hash(m_slots[next].key) & mask;
+            if (((next - home) & mask) >= ((next - slot) & mask)) {
+                m_slots[slot] = std::move(m_slots[next]);
+                slot = next;
+            }
+            next = (next + 1) & mask;
+        }
+        m_slots[slot] = Slot{Key::empty(), m_empty_value};
+        --m_size;
+        return 1;
+    }
+
+protected:
+    // Maximum load factor, as a fraction.
+    static constexpr size_t MaxLoadNum = 3;
+    static constexpr size_t MaxLoadDen = 4;
+
+    size_t find_slot(const Edge& edge) const
+    {
+        if (m_size == 0) return m_slots.size();
+        const KeyStorage key = Key::make(edge.v1(), edge.v2());
+        const size_t mask = m_slots.size() - 1;
+        size_t slot = Key::hash(key) & mask;
+        while (m_slots[slot].key != Key::empty()) {
+            if (m_slots[slot].key == key) return slot;
+            slot = (slot + 1) & mask;
+        }
+        return m_slots.size();
+    }
+
+    void rehash(size_t capacity)
+    {
+        std::vector<Slot> old_slots(capacity, Slot{Key::empty(), m_empty_value});
+        std::swap(old_slots, m_slots);
+        const size_t mask = capacity - 1;
+        for (auto& old_slot : old_slots) {
+            if (old_slot.key == Key::empty()) continue;
+            size_t slot = Key::hash(old_slot.key) & mask;
+            while (m_slots[slot].key != Key::empty()) slot = (slot + 1) & mask;
+            m_slots[slot] = std::move(old_slot);
+        }
+    }
+
+protected:
+    struct Slot
+    {
+        KeyStorage key;
+        Value value;
+    };
+
+    std::vector<Slot> m_slots;
+    size_t m_size = 0;
+    Value m_empty_value;
+};
+
+template <typename Index, typename T>
+struct GetMapEdge
+{
+    const EdgeType<Index>& operator()(const std::pair<EdgeType<Index>, T>& value) const
+    {
+        return value.first;
+    }
+};
+
+template <typename Index>
+struct GetSetEdge
+{
+    const EdgeType<Index>& operator()(const EdgeType<Index>& value) const { return value; }
+};
+
+} // namespace internal
+
+///
+/// Hash map from undirected edges to values, using open addressing. Drop-in replacement for
+/// std::unordered_map<EdgeType<Index>, T>, except that insertions and erasures invalidate all
+/// iterators and references. Each edge is stored with the orientation it was first inserted with.
+///
+/// @tparam     Index  Index type.
+/// @tparam     T      Mapped type. Must be default constructible.
+///
+template <typename Index, typename T>
+class FlatEdgeMap : public internal::FlatEdgeTable<
+                        Index,
+                        std::pair<EdgeType<Index>, T>,
+                        internal::GetMapEdge<Index, T>>
+{
+public:
+    using Super = internal::FlatEdgeTable<
+        Index,
+        std::pair<EdgeType<Index>, T>,
+        internal::GetMapEdge<Index, T>>;
+    using Edge = EdgeType<Index>;
+    using key_type = Edge;
+    using mapped_type = T;
+    using typename Super::const_iterator;
+    using typename Super::iterator;
+    using typename Super::value_type;
+
+public:
+    FlatEdgeMap()
+        : Super(value_type(Edge::Invalid(), T()))
+    {}
+
+    template <typename... Args>
+    std::pair<iterator, bool> emplace(const Edge& edge, Args&&... args)
+    {
+        return this->insert(value_type(edge, T(std::forward<Args>(args)...)));
+    }
+
+    T& operator[](const Edge& edge) { return this->insert(value_type(edge, T())).first->second; }
+
+    T& at(const Edge& edge)
+    {
+        auto it = this->find(edge);
+        LA_ASSERT(it != this->end(), "Edge not found");
+        return it->second;
+    }
+
+    const T& at(const Edge& edge) const
+    {
+        auto it = this->find(edge);
+        LA_ASSERT(it != this->end(), "Edge not found");
+        return it->second;
+    }
+};
+
+///
+/// Hash set of undirected edges, using open addressing. Drop-in replacement for
+/// std::unordered_set<EdgeType<Index>>, except that insertions and erasures invalidate all
+/// iterators and references.
+///
+/// @tparam     Index  Index type.
+///
+template <typename Index>
+class FlatEdgeSet
+    : public internal::FlatEdgeTable<Index, EdgeType<Index>, internal::GetSetEdge<Index>>
+{
+public:
+    using Super = internal::FlatEdgeTable<Index, EdgeType<Index>, internal::GetSetEdge<Index>>;
+    using Edge = EdgeType<Index>;
+    using key_type = Edge;
+
+public:
+    FlatEdgeSet()
+        : Super(Edge::Invalid())
+    {}
+};
+
+///
+/// Fixed-capacity hash set of undirected edges supporting concurrent insertions, e.g. from a
+/// tbb::parallel_for. Edges are stored as packed 64-bit keys in atomic slots, so only indices of at
+/// most 32 bits are supported.
+///
+/// Each edge keeps the same slot for the lifetime of the set. Values can be associated with edges
+/// by storing them in an array of get_num_slots() elements, indexed by slot.
+///
+/// @tparam     Index  Index type.
+///
+template <typename Index>
+class ConcurrentFlatEdgeSet
+{
+public:
+    static_assert(sizeof(Index) <= 4, "Concurrent edge set requires indices of at most 32 bits");
+    using Key = internal::EdgeKey<Index>;
+    using Edge = EdgeType<Index>;
+
+public:
+    ///
+    /// Creates an empty set.
+    ///
+    /// @param[in]  max_num_edges  Maximum number of edges that will be inserted.
+    ///
+    explicit ConcurrentFlatEdgeSet(size_t max_num_edges)
+    {
+        size_t capacity = 16;
+        while (capacity < 2 * max_num_edges) capacity *= 2;
+        m_num_slots = capacity;
+        m_keys.reset(new std::atomic<uint64_t>[capacity]);
+        for (size_t i = 0; i < capacity; ++i) {
+            m_keys[i].store(Key::empty(), std::memory_order_relaxed);
+        }
+    }
+
+    size_t size() const { return m_size.load(std::memory_order_relaxed); }
+    size_t get_num_slots() const { return m_num_slots; }
+
+    ///
+    /// Inserts an edge. Safe to call concurrently with other insertions and lookups.
+    ///
+    /// @param[in]  v1    First endpoint.
+    /// @param[in]  v2    Second endpoint.
+    ///
+    /// @return     Slot of the edge, and whether it was inserted by this call.
+    ///
+    std::pair<size_t, bool> insert(Index v1, Index v2)
+    {
+        const uint64_t key = Key::make(v1, v2);
+        LA_ASSERT(key != Key::empty(), "Invalid edge");
+        const size_t mask = m_num_slots - 1;
+        size_t slot = Key::hash(key) & mask;
+        for (size_t probe = 0; probe < m_num_slots; ++probe) {
+            uint64_t current = m_keys[slot].load(std::memory_order_acquire);
+            if (current == Key::empty()) {
+                if (m_keys[slot].compare_exchange_strong(current, key, std::memory_order_acq_rel)) {
+                    m_size.fetch_add(1, std::memory_order_relaxed);
+                    return {slot, true};
+                }
+                // Another thread claimed the slot first, check what it inserted.
+            }
+            if (current == key) return {slot, false};
+            slot = (slot + 1) & mask;
+        }
+        LA_ASSERT(false, "ConcurrentFlatEdgeSet capacity exceeded");
+        return {m_num_slots, false};
+    }
+
+    std::pair<size_t, bool> insert(const Edge& edge) { return insert(edge.v1(), edge.v2()); }
+
+    ///
+    /// Finds the slot of an edge.
+    ///
+    /// @param[in]  v1    First endpoint.
+    /// @param[in]  v2    Second endpoint.
+    ///
+    /// @return     Slot of the edge, or get_num_slots() if it is not in the set.
+    ///
+    size_t find(Index v1, Index v2) const
+    {
+        const uint64_t key = Key::make(v1, v2);
+        const size_t mask = m_num_slots - 1;
+        size_t slot = Key::hash(key) & mask;
+        for (size_t probe = 0; probe < m_num_slots; ++probe) {
+            const uint64_t current = m_keys[slot].load(std::memory_order_acquire);
+            if (current == key) return slot;
+            if (current == Key::empty()) break;
+            slot = (slot + 1) & mask;
+        }
+        return m_num_slots;
+    }
+
+    bool contains(Index v1, Index v2) const { return find(v1, v2) != m_num_slots; }
+
+    /// Whether a slot holds an edge.
+    bool is_occupied(size_t slot) const
+    {
+        return m_keys[slot].load(std::memory_order_relaxed) != Key::empty();
+    }
+
+    /// Edge stored in an occupied slot, with sorted endpoints.
+    Edge get_edge(size_t slot) const
+    {
+        const uint64_t key = m_keys[slot].load(std::memory_order_relaxed);
+        return Edge(
+            static_cast<Index>(static_cast<uint32_t>(key >> 32)),
+            static_cast<Index>(static_cast<uint32_t>(key)));
+    }
+
+private:
+    std::unique_ptr<std::atomic<uint64_t>[]> m_keys;
+    size_t m_num_slots = 0;
+    std::atomic<size_t> m_size{0};
+};
+
+} // namespace lagrange
@@ -62,6 +62,7 @@ public:
 
     using AdjacencyList = typename Connectivity<Geometry>::AdjacencyList;
     using IndexList = typename Connectivity<Geometry>::IndexList;
+    using NeighborList = typename Connectivity<Geometry>::NeighborList;
 
     using Edge = EdgeType<Index>;
 
@@ -312,6 +313,14 @@ public:
         return attr->get()->template get<AttributeArray>();
     }
 
+    decltype(auto) get_edge_attribute_array(const std::string& name) const
+    {
+        LA_ASSERT(is_initialized() && is_edge_data_initialized());
+        const auto* attr = m_edge_attributes->get(name);
+        LA_ASSERT(attr != nullptr, "Attribute " + name + " is not initialized.");
+        return attr->get();
+    }
+
     decltype(auto) get_edge_attribute_array(const std::string& name)
     {
         LA_ASSERT(is_initialized() && is_edge_data_initialized());
@@ -333,7 +342,7 @@ public:
     auto get_indexed_attribute_array(const std::string& name) const
     {
         LA_ASSERT(is_initialized());
-        const auto data = m_indexed_attributes->get(name);
+        const experimental::IndexedAttribute* data = m_indexed_attributes->get(name);
         LA_ASSERT(data != nullptr);
         return std::make_tuple(data->get_values(), data->get_indices());
     }
@@ -390,6 +399,19 @@ public:
         m_edge_attributes->set(name, std::forward<Derived>(attr));
     }
 
+    template <typename ValueDerived, typename IndexDerived>
+    void set_indexed_attribute_array(
+        const std::string& name,
+        ValueDerived&& values,
+        IndexDerived&& indices)
+    {
+        LA_ASSERT(is_initialized());
+        m_indexed_attributes->set(
+            name,
+            std::forward<ValueDerived>(values),
+            std::forward<IndexDerived>(indices));
+    }
+
     void set_indexed_attribute(
         const std::string& name,
         const AttributeArray& values,
@@ -549,50 +571,120 @@ public:
     // Connecitivity functions
     //========================
 
+    ///
+    /// Computes all adjacency relations: vertex-vertex, vertex-facet and facet-facet.
+    ///
     void initialize_connectivity()
     {
         LA_ASSERT(m_connectivity);
         m_connectivity->initialize(*m_geometry);
     }
 
+    ///
+    /// Computes the vertex-vertex adjacency only.
+    ///
+    void initialize_vertex_vertex_adjacency()
+    {
+        LA_ASSERT(m_connectivity);
+        m_connectivity->initialize_vertex_vertex_adjacency(*m_geometry);
+    }
+
+    ///
+    /// Computes the vertex-facet adjacency only.
+    ///
+    void initialize_vertex_facet_adjacency()
+    {
+        LA_ASSERT(m_connectivity);
+        m_connectivity->initialize_vertex_facet_adjacency(*m_geometry);
+    }
+
+    ///
+    /// Computes the facet-facet adjacency, and the vertex-facet adjacency it depends on if needed.
+    ///
+    void initialize_facet_facet_adjacency()
+    {
+        LA_ASSERT(m_connectivity);
+        m_connectivity->initialize_facet_facet_adjacency(*m_geometry);
+    }
+
+    /// Releases all adjacency relations.
+    void clear_connectivity()
+    {
+        LA_ASSERT(m_connectivity);
+        m_connectivity->clear();
+    }
+
+    ///
+    /// Whether all adjacency relations have been computed.
+    ///
+    /// @return     True if vertex-vertex, vertex-facet and facet-facet adjacency are available.
+    ///
     bool is_connectivity_initialized() const
     {
         return (m_connectivity && m_connectivity->is_initialized());
     }
 
+    bool is_vertex_vertex_adjacency_initialized() const
+    {
+        return (m_connectivity && m_connectivity->is_vertex_vertex_adjacency_initialized());
+    }
+
+    bool is_vertex_facet_adjacency_initialized() const
+    {
+        return (m_connectivity && m_connectivity->is_vertex_facet_adjacency_initialized());
+    }
+
+    bool is_facet_facet_adjacency_initialized() const
+    {
+        return (m_connectivity && m_connectivity->is_facet_facet_adjacency_initialized());
+    }
+
+    //
+    // The adjacency accessors below compute the requested relation on first access if it has not
+    // been initialized yet. This lazy initialization is thread-safe, but the relation is not
+    // updated if the mesh geometry changes afterwards: call the corresponding initialize_*()
+    // method again in that case.
+    //
+
     const AdjacencyList& get_vertex_vertex_adjacency() const
     {
-        LA_ASSERT(is_connectivity_initialized());
+        LA_ASSERT(m_connectivity);
+        m_connectivity->ensure_vertex_vertex_adjacency(*m_geometry);
         return m_connectivity->get_vertex_vertex_adjacency();
     }
 
     const AdjacencyList& get_vertex_facet_adjacency() const
     {
-        LA_ASSERT(is_connectivity_initialized());
+        LA_ASSERT(m_connectivity);
+        m_connectivity->ensure_vertex_facet_adjacency(*m_geometry);
         return m_connectivity->get_vertex_facet_adjacency();
     }
 
     const AdjacencyList& get_facet_facet_adjacency() const
     {
-        LA_ASSERT(is_connectivity_initialized());
+        LA_ASSERT(m_connectivity);
+        m_connectivity->ensure_facet_facet_adjacency(*m_geometry);
         return m_connectivity->get_facet_facet_adjacency();
     }
 
-    const IndexList& get_vertices_adjacent_to_vertex(Index vi) const
+    NeighborList get_vertices_adjacent_to_vertex(Index vi) const
     {
-        LA_ASSERT(is_connectivity_initialized());
+        LA_ASSERT(m_connectivity);
+        m_connectivity->ensure_vertex_vertex_adjacency(*m_geometry);
         return m_connectivity->get_vertices_adjacent_to_vertex(vi);
     }
 
-    const IndexList& get_facets_adjacent_to_vertex(Index vi) const
+    NeighborList get_facets_adjacent_to_vertex(Index vi) const
     {
-        LA_ASSERT(is_connectivity_initialized());
+        LA_ASSERT(m_connectivity);
+        m_connectivity->ensure_vertex_facet_adjacency(*m_geometry);
         return m_connectivity->get_facets_adjacent_to_vertex(vi);
     }
 
-    const IndexList& get_facets_adjacent_to_facet(Index fi) const
+    NeighborList get_facets_adjacent_to_facet(Index fi) const
     {
-        LA_ASSERT(is_connectivity_initialized());
+        LA_ASSERT(m_connectivity);
+        m_connectivity->ensure_facet_facet_adjacency(*m_geometry);
         return m_connectivity->get_facets_adjacent_to_facet(fi);
     }
 
@@ -906,12 +998,24 @@ public:
     {
         LA_ASSERT(m_components);
         LA_ASSERT(m_connectivity);
-        if (!m_connectivity->is_initialized()) {
-            initialize_connectivity();
+        if (!m_connectivity->is_facet_facet_adjacency_initialized()) {
+            initialize_facet_facet_adjacency();
         }
         m_components->initialize(*m_geometry, m_connectivity.get());
     }
 
+    ///
+    /// Computes connected components with a parallel union-find over the facets. This does not
+    /// require (nor initialize) any connectivity information.
+    ///
+    /// @param[in]  connectivity_type  Whether facets are connected through vertices or edges.
+    ///
+    void initialize_components(ConnectivityType connectivity_type)
+    {
+        LA_ASSERT(m_components);
+        m_components->initialize(*m_geometry, connectivity_type);
+    }
+
     bool is_components_initialized() const
     {
         return (m_components && (get_num_facets() == 0 || m_components->get_num_components() > 0));
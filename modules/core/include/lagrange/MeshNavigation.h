@@ -16,6 +16,9 @@
 #include <lagrange/corner_to_edge_mapping.h>
 
 #include <Eigen/Core>
+#include <tbb/parallel_for.h>
+
+#include <cstdint>
 
 namespace lagrange {
 
@@ -240,7 +243,7 @@ public:
     ///
     /// @return     True if the specified vertex v is a boundary vertex, False otherwise.
     ///
-    bool is_boundary_vertex(Index v) const { return m_is_boundary_vertex[v]; }
+    bool is_boundary_vertex(Index v) const { return m_is_boundary_vertex[v] != 0; }
 
 public:
     ///
@@ -330,15 +333,22 @@ protected:
             m_v2c,
             m_next_corner_around_vertex);
 
-        // Tag boundary vertices
-        m_is_boundary_vertex.assign(mesh.get_num_vertices(), false);
-        for (Index e = 0; e < get_num_edges(); ++e) {
-            if (is_boundary_edge(e)) {
-                auto v = get_edge_vertices(mesh.get_facets(), e);
-                m_is_boundary_vertex[v[0]] = true;
-                m_is_boundary_vertex[v[1]] = true;
+        // Tag boundary vertices. A vertex is on the boundary if one of the two facet edges
+        // incident to one of its corners is a boundary edge.
+        const Index num_vertices = mesh.get_num_vertices();
+        m_is_boundary_vertex.assign(num_vertices, 0);
+        tbb::parallel_for(Index(0), num_vertices, [&](Index v) {
+            for (Index c = m_v2c[v]; c != INVALID<Index>(); c = m_next_corner_around_vertex[c]) {
+                const Index f = c / m_vertex_per_facet;
+                const Index lv = c % m_vertex_per_facet;
+                const Index prev = f * m_vertex_per_facet +
+                                   (lv + m_vertex_per_facet - 1) % m_vertex_per_facet;
+                if (is_boundary_edge(m_c2e[c]) || is_boundary_edge(m_c2e[prev])) {
+                    m_is_boundary_vertex[v] = 1;
+                    break;
+                }
             }
-        }
+        });
     }
 
 protected:
@@ -349,7 +359,7 @@ protected:
     IndexArray m_next_corner_around_edge; ///< Next corner in the chain around an edge.
     IndexArray m_v2c; ///< Vertex to first corner in the chain.
     IndexArray m_next_corner_around_vertex; ///< Next corner in the chain around a vertex.
-    std::vector<bool> m_is_boundary_vertex;
+    std::vector<uint8_t> m_is_boundary_vertex; ///< Per-vertex boundary flag.
 };
 
 } // namespace lagrange
@@ -0,0 +1,795 @@
+/*
+ * Copyright 2021 Adobe. All rights reserved.
+ * This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain a copy
+ * of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under
+ * the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ * OF ANY KIND, either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+ */
+#pragma once
+
+#include <lagrange/AdjacencyList.h>
+#include <lagrange/common.h>
+#include <lagrange/point_triangle_squared_distance.h>
+#include <lagrange/utils/la_assert.h>
+#include <lagrange/utils/safe_cast.h>
+
+#include <Eigen/Geometry>
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#include <tbb/parallel_invoke.h>
+#include <tbb/parallel_reduce.h>
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <vector>
+
+namespace lagrange {
+
+///
+/// Bounding volume hierarchy over the facets of a 3D triangle mesh.
+///
+/// The tree is built top-down with a binned surface area heuristic. Subtrees are built in parallel,
+/// and the result does not depend on the number of threads. Nodes are stored in a flat array in
+/// depth-first order: the left child of an internal node immediately follows its parent, and the
+/// node only stores the index of its right child. Triangle coordinates are copied in leaf order so
+/// that leaves can be tested without indirection through the mesh.
+///
+/// @tparam     Scalar  Scalar type used for the stored coordinates and queries.
+/// @tparam     Index   Index type used for facet and node indices.
+///
+template <typename _Scalar, typename _Index>
+class TriangleBVH
+{
+public:
+    using Scalar = _Scalar;
+    using Index = _Index;
+    using Point = Eigen::Matrix<Scalar, 1, 3>;
+    using Box = Eigen::AlignedBox<Scalar, 3>;
+    using TriangleArray = Eigen::Matrix<Scalar, Eigen::Dynamic, 9, Eigen::RowMajor>;
+
+    /// Maximum number of triangles stored in a leaf.
+    static constexpr Index MaxLeafSize = 4;
+
+    /// Number of bins per axis used to evaluate the surface area heuristic.
+    static constexpr int NumBins = 16;
+
+    /// Ranges smaller than this are built serially.
+    static constexpr Index ParallelThreshold = 4096;
+
+    /// Nodes deeper than this are split at the median centroid instead of using the surface area
+    /// heuristic, which bounds the tree depth by MaxSahDepth + log2(#F).
+    static constexpr int MaxSahDepth = 48;
+
+    struct Node
+    {
+        /// Bounding box of the triangles below this node.
+        Box box;
+
+        /// For a leaf, index of its first triangle (in leaf order). For an internal node, index of
+        /// its right child.
+        Index offset = 0;
+
+        /// Number of triangles in a leaf, 0 for internal nodes.
+        Index count = 0;
+
+        bool is_leaf() const { return count > 0; }
+    };
+
+    struct ClosestPoint
+    {
+        /// Index of the closest facet in the input mesh.
+        Index embedding_element_idx = INVALID<Index>();
+
+        /// Closest point on the mesh.
+        Point closest_point = Point::Zero();
+
+        /// Barycentric coordinates of the closest point in its facet.
+        Point barycentric_coordinates = Point::Zero();
+
+        /// Squared distance between the query point and the closest point.
+        Scalar squared_distance = std::numeric_limits<Scalar>::infinity();
+    };
+
+    struct RayHit
+    {
+        /// Index of the facet hit by the ray, or INVALID if the ray missed.
+        Index embedding_element_idx = INVALID<Index>();
+
+        /// Ray parameter of the hit point, i.e. hit = origin + ray_parameter * direction.
+        Scalar ray_parameter = std::numeric_limits<Scalar>::infinity();
+
+        /// Barycentric coordinates of the hit point in its facet.
+        Point barycentric_coordinates = Point::Zero();
+
+        bool is_hit() const { return embedding_element_idx != INVALID<Index>(); }
+    };
+
+public:
+    TriangleBVH() = default;
+
+    ///
+    /// Builds the hierarchy over the facets of a triangle mesh.
+    ///
+    /// @param[in]  vertices  #V x 3 array of vertex positions.
+    /// @param[in]  facets    #F x 3 array of triangle indices.
+    ///
+    template <typename DerivedV, typename DerivedF>
+    TriangleBVH(
+        const Eigen::MatrixBase<DerivedV>& vertices,
+        const Eigen::MatrixBase<DerivedF>& facets)
+    {
+        build(vertices, facets);
+    }
+
+    ///
+    /// Builds the hierarchy over the facets of a triangle mesh, replacing any previous content.
+    ///
+    /// @param[in]  vertices  #V x 3 array of vertex positions.
+    /// @param[in]  facets    #F x 3 array of triangle indices.
+    ///
+    template <typename DerivedV, typename DerivedF>
+    void build(
+        const Eigen::MatrixBase<DerivedV>& vertices,
+        const Eigen::MatrixBase<DerivedF>& facets)
+    {
+        LA_ASSERT(vertices.cols() == 3, "TriangleBVH only supports 3D meshes");
+        LA_ASSERT(facets.cols() == 3, "TriangleBVH only supports triangle meshes");
+
+        const Index num_facets = safe_cast<Index>(facets.rows());
+        m_nodes.clear();
+        m_facet_indices.clear();
+        m_triangles.resize(num_facets, 9);
+        if (num_facets == 0) {
+            return;
+        }
+
+        BuildData data;
+        data.boxes.resize(num_facets);
+        data.centroids.resize(num_facets);
+        tbb::parallel_for(Index(0), num_facets, [&](Index f) {
+            Box box;
+            for (Index lv = 0; lv < 3; ++lv) {
+                box.extend(vertices.row(facets(f, lv)).template cast<Scalar>().transpose());
+            }
+            data.boxes[f] = box;
+            data.centroids[f] = box.center().transpose();
+        });
+
+        // Each subtree over n triangles uses at most 2n - 1 slots. Left and right subtrees are
+        // assigned disjoint slot ranges so they can be built concurrently.
+        m_facet_indices.resize(num_facets);
+        std::iota(m_facet_indices.begin(), m_facet_indices.end(), Index(0));
+        data.nodes.resize(2 * size_t(num_facets) - 1);
+        data.used.assign(data.nodes.size(), 0);
+        build_node(data, 0, 0, num_facets, 0);
+
+        // Compact the node array. Slots are filled in depth-first order, so the left child of a
+        // node remains its immediate successor.
+        std::vector<Index> remap(data.nodes.size(), INVALID<Index>());
+        Index num_nodes = 0;
+        for (size_t i = 0; i < data.nodes.size(); ++i) {
+            if (data.used[i]) remap[i] = num_nodes++;
+        }
+        m_nodes.reserve(num_nodes);
+        for (size_t i = 0; i < data.nodes.size(); ++i) {
+            if (!data.used[i]) continue;
+            Node node = data.nodes[i];
+            if (!node.is_leaf()) node.offset = remap[node.offset];
+            m_nodes.push_back(node);
+        }
+
+        tbb::parallel_for(Index(0), num_facets, [&](Index i) {
+            const Index f = m_facet_indices[i];
+            for (Index lv = 0; lv < 3; ++lv) {
+                m_triangles.row(i).template segment<3>(3 * lv) =
+                    vertices.row(facets(f, lv)).template cast<Scalar>();
+            }
+        });
+    }
+
+    ///
+    /// Recomputes the node bounding boxes after the vertices have moved, keeping the tree topology.
+    /// The facet array must be the same as the one used to build the hierarchy.
+    ///
+    /// @param[in]  vertices  #V x 3 array of updated vertex positions.
+    /// @param[in]  facets    #F x 3 array of triangle indices.
+    ///
+    template <typename DerivedV, typename DerivedF>
+    void refit(
+        const Eigen::MatrixBase<DerivedV>& vertices,
+        const Eigen::MatrixBase<DerivedF>& facets)
+    {
+        LA_ASSERT(safe_cast<Index>(facets.rows()) == get_num_triangles(), "Facet count mismatch");
+        tbb::parallel_for(Index(0), get_num_triangles(), [&](Index i) {
+            const Index f = m_facet_indices[i];
+            for (Index lv = 0; lv < 3; ++lv) {
+                m_triangles.row(i).template segment<3>(3 * lv) =
+                    vertices.row(facets(f, lv)).template cast<Scalar>();
+            }
+        });
+
+        // Children are stored after their parent, so a reverse sweep visits them first.
+        for (size_t n = m_nodes.size(); n-- > 0;) {
+            Node& node = m_nodes[n];
+            node.box.setEmpty();
+            if (node.is_leaf()) {
+                for (Index i = node.offset; i < node.offset + node.count; ++i) {
+                    for (Index lv = 0; lv < 3; ++lv) {
+                        node.box.extend(get_vertex(i, lv).transpose());
+                    }
+                }
+            } else {
+                node.box.extend(m_nodes[n + 1].box);
+                node.box.extend(m_nodes[node.offset].box);
+            }
+        }
+    }
+
+    bool empty() const { return m_nodes.empty(); }
+
+    Index get_num_triangles() const { return safe_cast<Index>(m_facet_indices.size()); }
+
+    Index get_num_nodes() const { return safe_cast<Index>(m_nodes.size()); }
+
+    /// Flattened node array, in depth-first order. The root is node 0.
+    const std::vector<Node>& get_nodes() const { return m_nodes; }
+
+    /// Mesh facet index of each triangle, in leaf order.
+    const std::vector<Index>& get_facet_indices() const { return m_facet_indices; }
+
+    /// Triangle coordinates in leaf order, one row (x0, y0, z0, x1, ..., z2) per triangle.
+    const TriangleArray& get_triangles() const { return m_triangles; }
+
+    Box get_bounding_box() const { return m_nodes.empty() ? Box() : m_nodes.front().box; }
+
+    ///
+    /// Finds the point of the mesh closest to a query point.
+    ///
+    /// @param[in]  point             Query point.
+    /// @param[in]  max_sq_distance   Only points strictly closer than this squared distance are
+    ///                               considered.
+    ///
+    /// @return     The closest point. Its embedding_element_idx is INVALID if no facet lies within
+    ///             the search radius.
+    ///
+    ClosestPoint query_closest_point(
+        const Point& point,
+        Scalar max_sq_distance = std::numeric_limits<Scalar>::infinity()) const
+    {
+        std::vector<std::pair<Index, Scalar>> stack;
+        return query_closest_point(point, max_sq_distance, stack);
+    }
+
+    ///
+    /// Finds the closest point on the mesh for each query point, in parallel. The result can be
+    /// passed to compute_lift_operator_from_projections().
+    ///
+    /// @param[in]  points  #P x 3 array of query points.
+    ///
+    /// @return     One closest point per query point.
+    ///
+    template <typename Derived>
+    std::vector<ClosestPoint> batch_query(const Eigen::MatrixBase<Derived>& points) const
+    {
+        LA_ASSERT(points.cols() == 3, "Query points must be 3D");
+        const Index num_points = safe_cast<Index>(points.rows());
+        std::vector<ClosestPoint> result(num_points);
+        tbb::parallel_for(
+            tbb::blocked_range<Index>(0, num_points),
+            [&](const tbb::blocked_range<Index>& range) {
+                std::vector<std::pair<Index, Scalar>> stack;
+                for (Index i = range.begin(); i != range.end(); ++i) {
+                    const Point p = points.row(i).template cast<Scalar>();
+                    result[i] =
+                        query_closest_point(p, std::numeric_limits<Scalar>::infinity(), stack);
+                }
+            });
+        return result;
+    }
+
+    ///
+    /// Finds the first intersection between a ray and the mesh.
+    ///
+    /// @param[in]  origin     Ray origin.
+    /// @param[in]  direction  Ray direction (does not need to be normalized).
+    /// @param[in]  t_min      Minimum ray parameter of a valid hit.
+    /// @param[in]  t_max      Maximum ray parameter of a valid hit.
+    ///
+    /// @return     The closest hit along the ray, if any.
+    ///
+    RayHit intersect_ray(
+        const Point& origin,
+        const Point& direction,
+        Scalar t_min = 0,
+        Scalar t_max = std::numeric_limits<Scalar>::infinity()) const
+    {
+        std::vector<std::pair<Index, Scalar>> stack;
+        return intersect_ray(origin, direction, t_min, t_max, stack);
+    }
+
+    ///
+    /// Intersects a batch of rays with the mesh, in parallel.
+    ///
+    /// @param[in]  origins     #R x 3 array of ray origins.
+    /// @param[in]  directions  #R x 3 array of ray directions.
+    ///
+    /// @return     The closest hit along each ray.
+    ///
+    template <typename DerivedO, typename DerivedD>
+    std::vector<RayHit> batch_intersect_rays(
+        const Eigen::MatrixBase<DerivedO>& origins,
+        const Eigen::MatrixBase<DerivedD>& directions) const
+    {
+        LA_ASSERT(origins.cols() == 3 && directions.cols() == 3, "Rays must be 3D");
+        LA_ASSERT(origins.rows() == directions.rows(), "Ray origin and direction count mismatch");
+        const Index num_rays = safe_cast<Index>(origins.rows());
+        std::vector<RayHit> result(num_rays);
+        tbb::parallel_for(
+            tbb::blocked_range<Index>(0, num_rays),
+            [&](const tbb::blocked_range<Index>& range) {
+                std::vector<std::pair<Index, Scalar>> stack;
+                for (Index i = range.begin(); i != range.end(); ++i) {
+                    result[i] = intersect_ray(
+                        origins.row(i).template cast<Scalar>(),
+                        directions.row(i).template cast<Scalar>(),
+                        0,
+                        std::numeric_limits<Scalar>::infinity(),
+                        stack);
+                }
+            });
+        return result;
+    }
+
+    ///
+    /// Calls a function on each facet whose bounding box overlaps a query box.
+    ///
+    /// @param[in]  box   Query box.
+    /// @param[in]  func  Callback taking the mesh facet index as argument.
+    ///
+    template <typename Func>
+    void foreach_box_overlap(const Box& box, Func&& func) const
+    {
+        if (m_nodes.empty()) return;
+        std::vector<Index> stack;
+        stack.push_back(0);
+        while (!stack.empty()) {
+            const Index n = stack.back();
+            stack.pop_back();
+            const Node& node = m_nodes[n];
+            if (!node.box.intersects(box)) continue;
+            if (node.is_leaf()) {
+                for (Index i = node.offset; i < node.offset + node.count; ++i) {
+                    Box tri_box;
+                    for (Index lv = 0; lv < 3; ++lv) {
+                        tri_box.extend(get_vertex(i, lv).transpose());
+                    }
+                    if (tri_box.intersects(box)) func(m_facet_indices[i]);
+                }
+            } else {
+                stack.push_back(node.offset);
+                stack.push_back(n + 1);
+            }
+        }
+    }
+
+    ///
+    /// Finds the facets whose bounding box overlaps a query box.
+    ///
+    /// @param[in]  box   Query box.
+    ///
+    /// @return     Overlapping facet indices, sorted in increasing order.
+    ///
+    std::vector<Index> query_box(const Box& box) const
+    {
+        std::vector<Index> result;
+        foreach_box_overlap(box, [&](Index f) { result.push_back(f); });
+        std::sort(result.begin(), result.end());
+        return result;
+    }
+
+    ///
+    /// Finds the facets overlapping each box of a batch, in parallel.
+    ///
+    /// @param[in]  boxes  Query boxes.
+    ///
+    /// @return     Adjacency list whose entry i holds the sorted facets overlapping boxes[i].
+    ///
+    AdjacencyList<Index> batch_query_boxes(const std::vector<Box>& boxes) const
+    {
+        const Index num_boxes = safe_cast<Index>(boxes.size());
+        std::vector<std::vector<Index>> overlaps(num_boxes);
+        tbb::parallel_for(Index(0), num_boxes, [&](Index i) { overlaps[i] = query_box(boxes[i]); });
+
+        std::vector<Index> offsets(num_boxes + 1, 0);
+        for (Index i = 0; i < num_boxes; ++i) {
+            offsets[i + 1] = offsets[i] + safe_cast<Index>(overlaps[i].size());
+        }
+        std::vector<Index> data(offsets.back());
+        tbb::parallel_for(Index(0), num_boxes, [&](Index i) {
+            std::copy(overlaps[i].begin(), overlaps[i].end(), data.begin() + offsets[i]);
+        });
+        return AdjacencyList<Index>(std::move(data), std::move(offsets));
+    }
+
+protected:
+    using Vector = Eigen::Matrix<Scalar, 3, 1>;
+
+    struct Bin
+    {
+        Box box;
+        Index count = 0;
+    };
+
+    struct BinSet
+    {
+        Box bounds;
+        Box centroid_bounds;
+        std::array<std::array<Bin, NumBins>, 3> bins;
+    };
+
+    struct BuildData
+    {
+        std::vector<Box> boxes;
+        std::vector<Point> centroids;
+        std::vector<Node> nodes;
+        std::vector<uint8_t> used;
+    };
+
+    static Scalar half_area(const Box& box)
+    {
+        const auto d = box.sizes();
+        return d.x() * d.y() + d.y() * d.z() + d.z() * d.x();
+    }
+
+    static int bin_index(Scalar c, Scalar lo, Scalar scale)
+    {
+        return std::min(NumBins - 1, std::max(0, static_cast<int>((c - lo) * scale)));
+    }
+
+    Point get_vertex(Index i, Index lv) const
+    {
+        return m_triangles.row(i).template segment<3>(3 * lv);
+    }
+
+    template <typename Func>
+    static void reduce(Index begin, Index end, BinSet& result, Func&& func)
+    {
+        if (end - begin < ParallelThreshold) {
+            func(begin, end, result);
+            return;
+        }
+        result = tbb::parallel_reduce(
+            tbb::blocked_range<Index>(begin, end),
+            result,
+            [&](const tbb::blocked_range<Index>& range, BinSet local) {
+                func(range.begin(), range.end(), local);
+                return local;
+            },
+            [](BinSet a, const BinSet& b) {
+                a.bounds.extend(b.bounds);
+                a.centroid_bounds.extend(b.centroid_bounds);
+                for (int axis = 0; axis < 3; ++axis) {
+                    for (int k = 0; k < NumBins; ++k) {
+                        a.bins[axis][k].box.extend(b.bins[axis][k].box);
+                        a.bins[axis][k].count += b.bins[axis][k].count;
+                    }
+                }
+                return a;
+            });
+    }
+
+    void build_node(BuildData& data, size_t slot, Index begin, Index end, int depth)
+    {
+        const Index count = end - begin;
+        auto& order = m_facet_indices;
+
+        // Bounds of the triangles and of their centroids. Min/max reductions are exact, so the
+        // result does not depend on how the range is split between threads.
+        BinSet binned;
+        reduce(begin, end, binned, [&](Index b, Index e, BinSet& out) {
+            for (Index i = b; i < e; ++i) {
+                out.bounds.extend(data.boxes[order[i]]);
+                out.centroid_bounds.extend(data.centroids[order[i]].transpose());
+            }
+        });
+        const Box bounds = binned.bounds;
+        const Box centroid_bounds = binned.centroid_bounds;
+
+        Node& node = data.nodes[slot];
+        data.used[slot] = 1;
+        node.box = bounds;
+
+        auto make_leaf = [&]() {
+            node.offset = begin;
+            node.count = count;
+        };
+        if (count == 1) {
+            make_leaf();
+            return;
+        }
+
+        const auto extent = centroid_bounds.sizes();
+        if (depth >= MaxSahDepth) {
+            // Unbalanced SAH splits could otherwise make the recursion as deep as the number of
+            // triangles. Ties are broken by facet index so the split stays deterministic.
+            if (count <= MaxLeafSize) {
+                make_leaf();
+                return;
+            }
+            int axis;
+            extent.maxCoeff(&axis);
+            const Index mid = begin + count / 2;
+            std::nth_element(
+                order.begin() + begin,
+                order.begin() + mid,
+                order.begin() + end,
+                [&](Index a, Index b) {
+                    const Scalar ca = data.centroids[a][axis];
+                    const Scalar cb = data.centroids[b][axis];
+                    return ca < cb || (ca == cb && a < b);
+                });
+            build_children(data, slot, begin, mid, end, depth);
+            return;
+        }
+
+        // Bin centroids along each axis and evaluate the surface area heuristic at bin boundaries.
+        std::array<Scalar, 3> scale;
+        for (int axis = 0; axis < 3; ++axis) {
+            scale[axis] = extent[axis] > 0 ? Scalar(NumBins) / extent[axis] : Scalar(0);
+        }
+        reduce(begin, end, binned, [&](Index b, Index e, BinSet& out) {
+            for (Index i = b; i < e; ++i) {
+                const Index f = order[i];
+                for (int axis = 0; axis < 3; ++axis) {
+                    if (scale[axis] == 0) continue;
+                    const int k = bin_index(
+                        data.centroids[f][axis],
+                        centroid_bounds.min()[axis],
+                        scale[axis]);
+                    out.bins[axis][k].box.extend(data.boxes[f]);
+                    out.bins[axis][k].count++;
+                }
+            }
+        });
+
+        Scalar best_cost = std::numeric_limits<Scalar>::infinity();
+        int best_axis = -1;
+        int best_split = 0;
+        for (int axis = 0; axis < 3; ++axis) {
+            if (scale[axis] == 0) continue;
+            const auto& bins = binned.bins[axis];
+            std::array<Scalar, NumBins> right_cost;
+            Box right_box;
+            Index right_count = 0;
+            for (int k = NumBins - 1; k > 0; --k) {
+                right_box.extend(bins[k].box);
+                right_count += bins[k].count;
+                right_cost[k] = right_count > 0 ? right_count * half_area(right_box) : Scalar(0);
+            }
+            Box left_box;
+            Index left_count = 0;
+            for (int k = 0; k < NumBins - 1; ++k) {
+                left_box.extend(bins[k].box);
+                left_count += bins[k].count;
+                if (left_count == 0 || left_count == count) continue;
+                const Scalar cost = left_count * half_area(left_box) + right_cost[k + 1];
+                if (cost < best_cost) {
+                    best_cost = cost;
+                    best_axis = axis;
+                    best_split = k + 1;
+                }
+            }
+        }
+
+        // Unit traversal and intersection costs, relative to the node area.
+        const Scalar node_area = half_area(bounds);
+        if (count <= MaxLeafSize && (best_axis < 0 || count * node_area <= node_area + best_cost)) {
+            make_leaf();
+            return;
+        }
+
+        Index mid;
+        if (best_axis >= 0) {
+            const Scalar lo = centroid_bounds.min()[best_axis];
+            const Scalar s = scale[best_axis];
+            mid = safe_cast<Index>(
+                std::partition(
+                    order.begin() + begin,
+                    order.begin() + end,
+                    [&](Index f) {
+                        return bin_index(data.centroids[f][best_axis], lo, s) < best_split;
+                    }) -
+                order.begin());
+        } else {
+            // All centroids coincide: split in the middle.
+            mid = begin + count / 2;
+        }
+        build_children(data, slot, begin, mid, end, depth);
+    }
+
+    void build_children(BuildData& data, size_t slot, Index begin, Index mid, Index end, int depth)
+    {
+        const size_t left_slot = slot + 1;
+        const size_t right_slot = slot + 2 * size_t(mid - begin);
+        data.nodes[slot].offset = safe_cast<Index>(right_slot);
+        data.nodes[slot].count = 0;
+
+        if (end - begin >= ParallelThreshold) {
+            tbb::parallel_invoke(
+                [&]() { build_node(data, left_slot, begin, mid, depth + 1); },
+                [&]() { build_node(data, right_slot, mid, end, depth + 1); });
+        } else {
+            build_node(data, left_slot, begin, mid, depth + 1);
+            build_node(data, right_slot, mid, end, depth + 1);
+        }
+    }
+
+    ClosestPoint query_closest_point(
+        const Point& point,
+        Scalar max_sq_distance,
+        std::vector<std::pair<Index, Scalar>>& stack) const
+    {
+        ClosestPoint result;
+        result.squared_distance = max_sq_distance;
+        if (m_nodes.empty()) return result;
+
+        const Vector q = point.transpose();
+        stack.clear();
+        stack.emplace_back(0, m_nodes[0].box.squaredExteriorDistance(q));
+        while (!stack.empty()) {
+            const auto entry = stack.back();
+            stack.pop_back();
+            if (entry.second >= result.squared_distance) continue;
+
+            const Node& node = m_nodes[entry.first];
+            if (node.is_leaf()) {
+                for (Index i = node.offset; i < node.offset + node.count; ++i) {
+                    Vector closest;
+                    Scalar l0, l1, l2;
+                    const Vector v0 = get_vertex(i, 0).transpose();
+                    const Vector v1 = get_vertex(i, 1).transpose();
+                    const Vector v2 = get_vertex(i, 2).transpose();
+                    const Scalar d =
+                        point_triangle_squared_distance(q, v0, v1, v2, closest, l0, l1, l2);
+                    if (d < result.squared_distance) {
+                        result.embedding_element_idx = m_facet_indices[i];
+                        result.closest_point = closest.transpose();
+                        result.barycentric_coordinates = Point(l0, l1, l2);
+                        result.squared_distance = d;
+                    }
+                }
+            } else {
+                // Push the farther child first so that the nearer one is visited next.
+                const Index left = entry.first + 1;
+                const Index right = node.offset;
+                const Scalar dl = m_nodes[left].box.squaredExteriorDistance(q);
+                const Scalar dr = m_nodes[right].box.squaredExteriorDistance(q);
+                if (dl < dr) {
+                    stack.emplace_back(right, dr);
+                    stack.emplace_back(left, dl);
+                } else {
+                    stack.emplace_back(left, dl);
+                    stack.emplace_back(right, dr);
+                }
+            }
+        }
+        return result;
+    }
+
+    static bool intersect_box(
+        const Box& box,
+        const Point& origin,
+        const Point& inv_direction,
+        Scalar t_min,
+        Scalar t_max,
+        Scalar& t_entry)
+    {
+        for (int axis = 0; axis < 3; ++axis) {
+            Scalar t0 = (box.min()[axis] - origin[axis]) * inv_direction[axis];
+            Scalar t1 = (box.max()[axis] - origin[axis]) * inv_direction[axis];
+            if (t0 > t1) std::swap(t0, t1);
+            // Written so that a NaN (origin on a slab boundary of a flat direction) is ignored.
+            t_min = t0 > t_min ? t0 : t_min;
+            t_max = t1 < t_max ? t1 : t_max;
+            if (t_min > t_max) return false;
+        }
+        t_entry = t_min;
+        return true;
+    }
+
+    RayHit intersect_ray(
+        const Point& origin,
+        const Point& direction,
+        Scalar t_min,
+        Scalar t_max,
+        std::vector<std::pair<Index, Scalar>>& stack) const
+    {
+        RayHit hit;
+        hit.ray_parameter = t_max;
+        if (m_nodes.empty()) return hit;
+
+        const Point inv_direction = direction.cwiseInverse();
+        Scalar t_entry;
+        stack.clear();
+        if (intersect_box(m_nodes[0].box, origin, inv_direction, t_min, t_max, t_entry)) {
+            stack.emplace_back(0, t_entry);
+        }
+        while (!stack.empty()) {
+            const auto entry = stack.back();
+            stack.pop_back();
+            if (entry.second > hit.ray_parameter) continue;
+
+            const Node& node = m_nodes[entry.first];
+            if (node.is_leaf()) {
+                for (Index i = node.offset; i < node.offset + node.count; ++i) {
+                    // Möller-Trumbore ray/triangle intersection.
+                    const Point v0 = get_vertex(i, 0);
+                    const Point e1 = get_vertex(i, 1) - v0;
+                    const Point e2 = get_vertex(i, 2) - v0;
+                    const Point p = direction.cross(e2);
+                    const Scalar det = e1.dot(p);
+                    if (det == 0) continue;
+                    const Scalar inv_det = Scalar(1) / det;
+                    const Point s = origin - v0;
+                    const Scalar u = s.dot(p) * inv_det;
+                    if (u < 0 || u > 1) continue;
+                    const Point qv = s.cross(e1);
+                    const Scalar v = direction.dot(qv) * inv_det;
+                    if (v < 0 || u + v > 1) continue;
+                    const Scalar t = e2.dot(qv) * inv_det;
+                    if (t < t_min || t >= hit.ray_parameter) continue;
+                    hit.embedding_element_idx = m_facet_indices[i];
+                    hit.ray_parameter = t;
+                    hit.barycentric_coordinates = Point(1 - u - v, u, v);
+                }
+            } else {
+                const Index left = entry.first + 1;
+                const Index right = node.offset;
+                Scalar tl, tr;
+                const bool hl = intersect_box(
+                    m_nodes[left].box,
+                    origin,
+                    inv_direction,
+                    t_min,
+                    hit.ray_parameter,
+                    tl);
+                const bool hr = intersect_box(
+                    m_nodes[right].box,
+                    origin,
+                    inv_direction,
+                    t_min,
+                    hit.ray_parameter,
+                    tr);
+                if (hl && hr) {
+                    if (tl < tr) {
+                        stack.emplace_back(right, tr);
+                        stack.emplace_back(left, tl);
+                    } else {
+                        stack.emplace_back(left, tl);
+                        stack.emplace_back(right, tr);
+                    }
+                } else if (hl) {
+                    stack.emplace_back(left, tl);
+                } else if (hr) {
+                    stack.emplace_back(right, tr);
+                }
+            }
+        }
+        if (!hit.is_hit()) hit.ray_parameter = std::numeric_limits<Scalar>::infinity();
+        return hit;
+    }
+
+protected:
+    std::vector<Node> m_nodes;
+    std::vector<Index> m_facet_indices;
+    TriangleArray m_triangles;
+};
+
+} // namespace lagrange
@@ -96,19 +96,32 @@ void map_corner_attribute_to_vertex_attribute(MeshType& mesh, const std::string&
     const auto& valence = mesh.get_vertex_attribute("valence");
     LA_ASSERT(valence.rows() == num_vertices);
 
-    std::vector<std::vector<std::pair<Eigen::Index, double>>> weights(num_vertices);
+    // Corners around each vertex, in CSR format.
+    std::vector<Eigen::Index> offsets(num_vertices + 1, 0);
     for (Index i = 0; i < num_facets; i++) {
         for (Index j = 0; j < vertex_per_facet; j++) {
-            const double w = 1.0 / valence(facets(i, j), 0);
-            weights[facets(i, j)].emplace_back(i * vertex_per_facet + j, w);
+            offsets[facets(i, j) + 1]++;
+        }
+    }
+    for (Index v = 0; v < num_vertices; v++) {
+        offsets[v + 1] += offsets[v];
+    }
+    std::vector<Eigen::Index> corners(offsets.back());
+    std::vector<double> weights(offsets.back());
+    std::vector<Eigen::Index> fill(offsets.begin(), offsets.end() - 1);
+    for (Index i = 0; i < num_facets; i++) {
+        for (Index j = 0; j < vertex_per_facet; j++) {
+            const Index v = facets(i, j);
+            corners[fill[v]] = i * vertex_per_facet + j;
+            weights[fill[v]] = 1.0 / valence(v, 0);
+            fill[v]++;
         }
     }
 
-    auto mapping_fn = [&](Eigen::Index i, std::vector<std::pair<Eigen::Index, double>>& wts) {
-        wts.clear();
-        wts = weights[i];
-    };
-    auto vertex_attr = to_shared_ptr(corner_attr->row_slice(num_vertices, mapping_fn));
+    auto vertex_attr = to_shared_ptr(corner_attr->row_slice(experimental::RowWeights(
+        std::move(corners),
+        std::move(weights),
+        std::move(offsets))));
 
     if (!mesh.has_vertex_attribute(attr_name)) {
         mesh.add_vertex_attribute(attr_name);
@@ -12,7 +12,7 @@
 ////////////////////////////////////////////////////////////////////////////////
 #pragma once
 
-#include <lagrange/utils/range.h>
+#include <lagrange/chain_corners_by_key.h>
 
 #include <Eigen/Core>
 ////////////////////////////////////////////////////////////////////////////////
@@ -47,19 +47,13 @@ void chain_corners_around_edges(
     Index num_edges = (corner_to_edge.size() ? corner_to_edge.maxCoeff() + 1 : 0);
     Index num_corners = (Index)(facets.rows() * facets.cols());
 
-    // Chain corners around vertices and edges
-    edge_to_corner.resize(num_edges);
-    edge_to_corner.setConstant(INVALID<Index>());
-    next_corner_around_edge.resize(num_corners);
-    next_corner_around_edge.setConstant(INVALID<Index>());
-    for (auto f : range(facets.rows())) {
-        for (auto lv : range(facets.cols())) {
-            Index c = (Index)(f * facets.cols() + lv);
-            Index e = corner_to_edge(c);
-            next_corner_around_edge[c] = edge_to_corner[e];
-            edge_to_corner[e] = c;
-        }
-    }
+    // Chain corners around edges
+    internal::chain_corners_by_key(
+        num_edges,
+        num_corners,
+        [&](Index c) { return Index(corner_to_edge(c)); },
+        edge_to_corner,
+        next_corner_around_edge);
 }
 
 } // namespace lagrange
@@ -12,7 +12,7 @@
 ////////////////////////////////////////////////////////////////////////////////
 #pragma once
 
-#include <lagrange/utils/range.h>
+#include <lagrange/chain_corners_by_key.h>
 #include <lagrange/utils/safe_cast.h>
 
 #include <Eigen/Core>
@@ -48,19 +48,14 @@ void chain_corners_around_vertices(
 
     Index num_corners = safe_cast<Index>(facets.rows() * facets.cols());
 
-    // Chain corners around vertices and edges
-    vertex_to_corner.resize(num_vertices);
-    vertex_to_corner.setConstant(INVALID<Index>());
-    next_corner_around_vertex.resize(num_corners);
-    next_corner_around_vertex.setConstant(INVALID<Index>());
-    for (auto f : range(facets.rows())) {
-        for (auto lv : range(facets.cols())) {
-            Index c = (Index)(f * facets.cols() + lv);
-            Index v = facets(f, lv);
-            next_corner_around_vertex[c] = vertex_to_corner[v];
-            vertex_to_corner[v] = c;
-        }
-    }
+    // Chain corners around vertices
+    const Index vertex_per_facet = safe_cast<Index>(facets.cols());
+    internal::chain_corners_by_key(
+        num_vertices,
+        num_corners,
+        [&](Index c) { return Index(facets(c / vertex_per_facet, c % vertex_per_facet)); },
+        vertex_to_corner,
+        next_corner_around_vertex);
 }
 
 } // namespace lagrange
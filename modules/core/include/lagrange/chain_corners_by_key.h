@@ -0,0 +1,90 @@
+/*
+ * Copyright 2021 Adobe. All rights reserved.
+ * This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain a copy
+ * of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under
+ * the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ * OF ANY KIND, either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+ */
+#pragma once
+
+#include <lagrange/common.h>
+#include <lagrange/utils/safe_cast.h>
+
+#include <Eigen/Core>
+#include <tbb/parallel_for.h>
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+namespace lagrange {
+namespace internal {
+
+///
+/// Chains facet corners sharing the same key (e.g. a vertex or an edge index), in parallel. The
+/// result is identical to the serial loop that visits corners in increasing order and pushes each
+/// one at the front of its key's chain: the head of a chain is the largest corner with that key,
+/// and each corner links to the next smaller one.
+///
+/// @param[in]  num_keys       Number of distinct keys.
+/// @param[in]  num_corners    Number of facet corners.
+/// @param[in]  key_of         Callable mapping a corner index to its key in [0, num_keys[.
+/// @param[out] key_to_corner  #K x 1 array of first corner in the chain of each key.
+/// @param[out] next_corner    #C x 1 array of next corner in the chain at a given corner.
+///
+/// @tparam     Index          Index type.
+/// @tparam     KeyFunc        Type of the key callable.
+/// @tparam     DerivedK       Type of key to corner vector.
+/// @tparam     DerivedN       Type of next corner vector.
+///
+template <typename Index, typename KeyFunc, typename DerivedK, typename DerivedN>
+void chain_corners_by_key(
+    Index num_keys,
+    Index num_corners,
+    KeyFunc key_of,
+    Eigen::PlainObjectBase<DerivedK>& key_to_corner,
+    Eigen::PlainObjectBase<DerivedN>& next_corner)
+{
+    key_to_corner.resize(num_keys);
+    next_corner.resize(num_corners);
+
+    // Bucket corners by key. Buckets are filled concurrently, so each one is sorted afterwards to
+    // recover a deterministic order.
+    std::unique_ptr<std::atomic<Index>[]> counts(new std::atomic<Index>[num_keys]);
+    tbb::parallel_for(Index(0), num_keys, [&](Index k) { counts[k] = 0; });
+    tbb::parallel_for(Index(0), num_corners, [&](Index c) {
+        counts[key_of(c)].fetch_add(1, std::memory_order_relaxed);
+    });
+
+    std::vector<Index> offsets(num_keys + 1);
+    offsets[0] = 0;
+    for (Index k = 0; k < num_keys; ++k) {
+        offsets[k + 1] = offsets[k] + counts[k].load(std::memory_order_relaxed);
+        counts[k].store(offsets[k], std::memory_order_relaxed);
+    }
+
+    std::vector<Index> buckets(num_corners);
+    tbb::parallel_for(Index(0), num_corners, [&](Index c) {
+        buckets[counts[key_of(c)].fetch_add(1, std::memory_order_relaxed)] = c;
+    });
+
+    tbb::parallel_for(Index(0), num_keys, [&](Index k) {
+        const auto first = buckets.begin() + offsets[k];
+        const auto last = buckets.begin() + offsets[k + 1];
+        std::sort(first, last);
+        key_to_corner(k) = (first == last ? INVALID<Index>() : *(last - 1));
+        Index prev = INVALID<Index>();
+        for (auto it = first; it != last; ++it) {
+            next_corner(*it) = prev;
+            prev = *it;
+        }
+    });
+}
+
+} // namespace internal
+} // namespace lagrange
@@ -21,10 +21,25 @@
 #include <lagrange/create_mesh.h>
 #include <lagrange/utils/range.h>
 
+#include <tbb/parallel_for.h>
+
+#include <algorithm>
+#include <vector>
+
 namespace lagrange {
 
 namespace combine_mesh_list_internal {
 
+template <typename Index, typename MeshTypePtr, typename CountFunc>
+std::vector<Index> compute_offsets(const std::vector<MeshTypePtr>& mesh_list, CountFunc count);
+
+template <typename MeshTypePtr, typename Index, typename Derived, typename GetFunc>
+void concatenate_rows(
+    const std::vector<MeshTypePtr>& mesh_list,
+    const std::vector<Index>& offsets,
+    Eigen::PlainObjectBase<Derived>& combined,
+    GetFunc get);
+
 template <typename MeshTypePtr, typename MeshType2>
 void combine_all_vertex_attributes(
     const std::vector<MeshTypePtr>& mesh_list,
@@ -45,11 +60,6 @@ void combine_all_edge_attributes(
     const std::vector<MeshTypePtr>& mesh_list,
     MeshType2& combined_mesh);
 
-template <typename MeshTypePtr, typename MeshType2>
-void combine_all_edge_attributes(
-    const std::vector<MeshTypePtr>& mesh_list,
-    MeshType2& combined_mesh);
-
 template <typename MeshTypePtr, typename MeshType2>
 void combine_all_indexed_attributes(
     const std::vector<MeshTypePtr>& mesh_list,
@@ -64,6 +74,10 @@ void combine_all_indexed_attributes(
  * All valid vertex/facet/corner/edge attributes are combined and forwarded to
  * the output mesh.  An attribute is considered as valid iff it is set for all
  * meshes in `mesh_list`.
+ *
+ * Element offsets of each input mesh are computed upfront, and the geometry and
+ * attributes of all input meshes are then copied in parallel into arrays that
+ * are allocated once.
  */
 template <typename MeshTypePtr>
 auto combine_mesh_list(const std::vector<MeshTypePtr>& mesh_list, bool preserve_attributes = false)
@@ -91,36 +105,34 @@ auto combine_mesh_list(const std::vector<MeshTypePtr>& mesh_list, bool preserve_
         }
     }
 
+    using namespace combine_mesh_list_internal;
+
     const auto& front_mesh = mesh_list.front();
     const Index dim = front_mesh->get_dim();
     const Index vertex_per_facet = front_mesh->get_vertex_per_facet();
-    Index total_vertices(0), total_facets(0);
 
-    for (const auto& mesh : mesh_list) {
-        total_vertices += mesh->get_num_vertices();
-        total_facets += mesh->get_num_facets();
-    }
-
-    Vtype V(total_vertices, dim);
-    Ftype F(total_facets, vertex_per_facet);
-    Index curr_v_index(0), curr_f_index(0);
-
-    for (const auto& mesh : mesh_list) {
-        assert(mesh->get_dim() == dim);
-        assert(mesh->get_vertex_per_facet() == vertex_per_facet);
-
-        V.block(curr_v_index, 0, mesh->get_num_vertices(), dim) = mesh->get_vertices();
-        F.block(curr_f_index, 0, mesh->get_num_facets(), vertex_per_facet) =
-            mesh->get_facets().array() + curr_v_index;
-
-        curr_v_index += mesh->get_num_vertices();
-        curr_f_index += mesh->get_num_facets();
-    }
+    const auto vertex_offsets = compute_offsets<Index>(mesh_list, [&](const MeshType& mesh) {
+        assert(mesh.get_dim() == dim);
+        assert(mesh.get_vertex_per_facet() == vertex_per_facet);
+        return mesh.get_num_vertices();
+    });
+    const auto facet_offsets = compute_offsets<Index>(
+        mesh_list,
+        [](const MeshType& mesh) { return mesh.get_num_facets(); });
+
+    Vtype V(vertex_offsets.back(), dim);
+    Ftype F(facet_offsets.back(), vertex_per_facet);
+
+    tbb::parallel_for(size_t(0), mesh_list.size(), [&](size_t i) {
+        const auto& mesh = mesh_list[i];
+        V.block(vertex_offsets[i], 0, mesh->get_num_vertices(), dim) = mesh->get_vertices();
+        F.block(facet_offsets[i], 0, mesh->get_num_facets(), vertex_per_facet) =
+            mesh->get_facets().array() + vertex_offsets[i];
+    });
 
     auto combined_mesh = lagrange::create_mesh(std::move(V), std::move(F));
 
     if (preserve_attributes) {
-        using namespace combine_mesh_list_internal;
         combine_all_vertex_attributes(mesh_list, *combined_mesh);
         combine_all_facet_attributes(mesh_list, *combined_mesh);
         combine_all_corner_attributes(mesh_list, *combined_mesh);
@@ -133,6 +145,46 @@ auto combine_mesh_list(const std::vector<MeshTypePtr>& mesh_list, bool preserve_
 
 namespace combine_mesh_list_internal {
 
+///
+/// Computes the offset of each mesh in a combined array as a prefix sum of per-mesh counts.
+///
+/// @param[in]  mesh_list  List of meshes.
+/// @param[in]  count      Number of rows contributed by a mesh.
+///
+/// @return     #mesh_list + 1 offsets. The last entry is the total number of rows.
+///
+template <typename Index, typename MeshTypePtr, typename CountFunc>
+std::vector<Index> compute_offsets(const std::vector<MeshTypePtr>& mesh_list, CountFunc count)
+{
+    std::vector<Index> offsets(mesh_list.size() + 1, 0);
+    for (size_t i = 0; i < mesh_list.size(); ++i) {
+        offsets[i + 1] = offsets[i] + safe_cast<Index>(count(*mesh_list[i]));
+    }
+    return offsets;
+}
+
+///
+/// Copies the rows of a per-mesh array into a preallocated combined array, in parallel over the
+/// input meshes.
+///
+/// @param[in]  mesh_list  List of meshes.
+/// @param[in]  offsets    Row offset of each mesh, as returned by compute_offsets().
+/// @param[out] combined   Combined array, with offsets.back() rows.
+/// @param[in]  get        Returns the array of a mesh.
+///
+template <typename MeshTypePtr, typename Index, typename Derived, typename GetFunc>
+void concatenate_rows(
+    const std::vector<MeshTypePtr>& mesh_list,
+    const std::vector<Index>& offsets,
+    Eigen::PlainObjectBase<Derived>& combined,
+    GetFunc get)
+{
+    tbb::parallel_for(size_t(0), mesh_list.size(), [&](size_t i) {
+        const Index num_rows = offsets[i + 1] - offsets[i];
+        combined.block(offsets[i], 0, num_rows, combined.cols()) = get(*mesh_list[i]);
+    });
+}
+
 template <typename MeshTypePtr, typename MeshType2>
 void combine_all_vertex_attributes(
     const std::vector<MeshTypePtr>& mesh_list,
@@ -143,7 +195,9 @@ void combine_all_vertex_attributes(
     using AttributeArray = typename MeshType::AttributeArray;
 
     const auto& front_mesh = mesh_list.front();
-    const auto total_num_vertices = combined_mesh.get_num_vertices();
+    const auto vertex_offsets = compute_offsets<Index>(
+        mesh_list,
+        [](const MeshType& mesh) { return mesh.get_num_vertices(); });
 
     for (const auto& attr_name : front_mesh->get_vertex_attribute_names()) {
         bool can_merge = true;
@@ -157,14 +211,10 @@ void combine_all_vertex_attributes(
         if (!can_merge) continue;
 
         const auto attribute_dim = front_mesh->get_vertex_attribute(attr_name).cols();
-        AttributeArray attr(total_num_vertices, attribute_dim);
-
-        Index curr_row = 0;
-        for (const auto& mesh : mesh_list) {
-            attr.block(curr_row, 0, mesh->get_num_vertices(), attribute_dim) =
-                mesh->get_vertex_attribute(attr_name);
-            curr_row += mesh->get_num_vertices();
-        }
+        AttributeArray attr(vertex_offsets.back(), attribute_dim);
+        concatenate_rows(mesh_list, vertex_offsets, attr, [&](const MeshType& mesh) -> auto& {
+            return mesh.get_vertex_attribute(attr_name);
+        });
 
         combined_mesh.add_vertex_attribute(attr_name);
         combined_mesh.import_vertex_attribute(attr_name, attr);
@@ -181,7 +231,9 @@ void combine_all_facet_attributes(
     using AttributeArray = typename MeshType::AttributeArray;
 
     const auto& front_mesh = mesh_list.front();
-    const auto total_num_facets = combined_mesh.get_num_facets();
+    const auto facet_offsets = compute_offsets<Index>(
+        mesh_list,
+        [](const MeshType& mesh) { return mesh.get_num_facets(); });
 
     for (const auto& attr_name : front_mesh->get_facet_attribute_names()) {
         bool can_merge = true;
@@ -195,14 +247,10 @@ void combine_all_facet_attributes(
         if (!can_merge) continue;
 
         const auto attribute_dim = front_mesh->get_facet_attribute(attr_name).cols();
-        AttributeArray attr(total_num_facets, attribute_dim);
-
-        Index curr_row = 0;
-        for (const auto& mesh : mesh_list) {
-            attr.block(curr_row, 0, mesh->get_num_facets(), attribute_dim) =
-                mesh->get_facet_attribute(attr_name);
-            curr_row += mesh->get_num_facets();
-        }
+        AttributeArray attr(facet_offsets.back(), attribute_dim);
+        concatenate_rows(mesh_list, facet_offsets, attr, [&](const MeshType& mesh) -> auto& {
+            return mesh.get_facet_attribute(attr_name);
+        });
 
         combined_mesh.add_facet_attribute(attr_name);
         combined_mesh.import_facet_attribute(attr_name, attr);
@@ -219,8 +267,10 @@ void combine_all_corner_attributes(
     using AttributeArray = typename MeshType::AttributeArray;
 
     const auto& front_mesh = mesh_list.front();
-    const auto total_num_facets = combined_mesh.get_num_facets();
     const auto vertex_per_facet = combined_mesh.get_vertex_per_facet();
+    const auto corner_offsets = compute_offsets<Index>(mesh_list, [&](const MeshType& mesh) {
+        return mesh.get_num_facets() * vertex_per_facet;
+    });
 
     for (const auto& attr_name : front_mesh->get_corner_attribute_names()) {
         bool can_merge = true;
@@ -234,15 +284,10 @@ void combine_all_corner_attributes(
         if (!can_merge) continue;
 
         const auto attribute_dim = front_mesh->get_corner_attribute(attr_name).cols();
-        AttributeArray attr(total_num_facets * vertex_per_facet, attribute_dim);
-
-        Index curr_row = 0;
-        for (const auto& mesh : mesh_list) {
-            const auto num_facets = mesh->get_num_facets();
-            attr.block(curr_row, 0, num_facets * vertex_per_facet, attribute_dim) =
-                mesh->get_corner_attribute(attr_name);
-            curr_row += num_facets * vertex_per_facet;
-        }
+        AttributeArray attr(corner_offsets.back(), attribute_dim);
+        concatenate_rows(mesh_list, corner_offsets, attr, [&](const MeshType& mesh) -> auto& {
+            return mesh.get_corner_attribute(attr_name);
+        });
 
         combined_mesh.add_corner_attribute(attr_name);
         combined_mesh.import_corner_attribute(attr_name, attr);
@@ -267,9 +312,45 @@ void combine_all_edge_attributes(
 
     combined_mesh.initialize_edge_data();
 
+    const auto edge_attribute_names = front_mesh->get_edge_attribute_names();
+    if (edge_attribute_names.empty()) return;
+
+    // Map the edges of each input mesh to the combined mesh once, through the edge of one of
+    // their corners. Input edges are numbered consecutively, mesh after mesh.
+    const Index vertex_per_facet = combined_mesh.get_vertex_per_facet();
+#ifndef NDEBUG
+    const auto vertex_offsets = compute_offsets<Index>(
+        mesh_list,
+        [](const MeshType& mesh) { return mesh.get_num_vertices(); });
+#endif
+    const auto corner_offsets = compute_offsets<Index>(mesh_list, [&](const MeshType& mesh) {
+        return mesh.get_num_facets() * vertex_per_facet;
+    });
+    const auto edge_offsets = compute_offsets<Index>(
+        mesh_list,
+        [](const MeshType& mesh) { return mesh.get_num_edges(); });
+    std::vector<Index> edge_map(edge_offsets.back());
+    tbb::parallel_for(size_t(0), mesh_list.size(), [&](size_t i) {
+        const auto& mesh = mesh_list[i];
+        for (auto old_e : range(mesh->get_num_edges())) {
+            const Index c = mesh->get_one_corner_around_edge(old_e);
+            const Index new_e = combined_mesh.get_edge_from_corner(c + corner_offsets[i]);
+            edge_map[edge_offsets[i] + old_e] = new_e;
+
+#ifndef NDEBUG
+            // sanity check
+            const auto old_v = mesh->get_edge_vertices(old_e);
+            const auto new_v = combined_mesh.get_edge_vertices(new_e);
+            LA_ASSERT_DEBUG(
+                std::minmax(new_v[0], new_v[1]) ==
+                std::minmax(old_v[0] + vertex_offsets[i], old_v[1] + vertex_offsets[i]));
+#endif
+        }
+    });
+
     const auto total_num_edges = combined_mesh.get_num_edges();
 
-    for (const auto& attr_name : front_mesh->get_edge_attribute_names()) {
+    for (const auto& attr_name : edge_attribute_names) {
         bool can_merge = true;
         for (const auto& mesh : mesh_list) {
             if (!mesh->has_edge_attribute(attr_name)) {
@@ -283,31 +364,13 @@ void combine_all_edge_attributes(
         const auto attribute_dim = front_mesh->get_edge_attribute(attr_name).cols();
         AttributeArray attr(total_num_edges, attribute_dim);
 
-        Index vertex_offset = 0;
-        Index facet_offset = 0;
-        Index edge_offset = 0;
-        for (const auto& mesh : mesh_list) {
+        tbb::parallel_for(size_t(0), mesh_list.size(), [&](size_t i) {
+            const auto& mesh = mesh_list[i];
             const auto& per_mesh_attr = mesh->get_edge_attribute(attr_name);
             for (auto old_e : range(mesh->get_num_edges())) {
-                const auto& c = mesh->get_one_corner_around_edge(old_e);
-                const Index f = c / mesh->get_vertex_per_facet();
-                const Index lv = c % mesh->get_vertex_per_facet();
-                LA_ASSERT_DEBUG(mesh->get_edge(f, lv) == old_e);
-                const auto new_e = combined_mesh.get_edge(f + facet_offset, lv);
-                attr.row(new_e) = per_mesh_attr.row(old_e);
-
-                // sanity check
-                auto old_v = mesh->get_edge_vertices(old_e);
-                auto new_v = combined_mesh.get_edge_vertices(new_e);
-                std::sort(old_v.begin(), old_v.end());
-                std::sort(new_v.begin(), new_v.end());
-                LA_ASSERT_DEBUG(new_v[0] == old_v[0] + vertex_offset);
-                LA_ASSERT_DEBUG(new_v[1] == old_v[1] + vertex_offset);
+                attr.row(edge_map[edge_offsets[i] + old_e]) = per_mesh_attr.row(old_e);
             }
-            vertex_offset += mesh->get_num_vertices();
-            facet_offset += mesh->get_num_facets();
-            edge_offset += mesh->get_num_edges();
-        }
+        });
 
         combined_mesh.add_edge_attribute(attr_name);
         combined_mesh.import_edge_attribute(attr_name, attr);
@@ -356,18 +419,17 @@ void combine_all_indexed_attributes(
             continue;
         }
 
-        Index combined_num_values = 0;
-        Index combined_num_indices = 0;
-
+        std::vector<decltype(ref_attr)> attrs;
+        attrs.reserve(mesh_list.size());
         for (const auto& mesh : mesh_list) {
             if (!mesh->has_indexed_attribute(attr_name)) {
                 can_merge = false;
                 logger().warn("Cannot combine indexed attribute \"{}\"", attr_name);
                 break;
             }
-            auto attr = mesh->get_indexed_attribute_array(attr_name);
-            const auto& values = *std::get<0>(attr);
-            const auto& indices = *std::get<1>(attr);
+            attrs.push_back(mesh->get_indexed_attribute_array(attr_name));
+            const auto& values = *std::get<0>(attrs.back());
+            const auto& indices = *std::get<1>(attrs.back());
 
             if (values.get_scalar_type() != ref_values.get_scalar_type()) {
                 can_merge = false;
@@ -379,30 +441,30 @@ void combine_all_indexed_attributes(
                 logger().warn("Cannot combine indexed attribute because index type mismatch.");
                 break;
             }
-
-            combined_num_values += safe_cast<Index>(values.rows());
-            combined_num_indices += safe_cast<Index>(indices.rows());
         }
         if (!can_merge) continue;
 
-        AttributeArray combined_values(combined_num_values, ref_values.cols());
-        IndexArray combined_indices(combined_num_indices, ref_indices.cols());
+        std::vector<Index> value_offsets(attrs.size() + 1, 0);
+        std::vector<Index> index_offsets(attrs.size() + 1, 0);
+        for (size_t i = 0; i < attrs.size(); ++i) {
+            const auto& values = *std::get<0>(attrs[i]);
+            const auto& indices = *std::get<1>(attrs[i]);
+            value_offsets[i + 1] = value_offsets[i] + safe_cast<Index>(values.rows());
+            index_offsets[i + 1] = index_offsets[i] + safe_cast<Index>(indices.rows());
+        }
 
-        Index curr_value_row = 0;
-        Index curr_index_row = 0;
-        for (const auto& mesh : mesh_list) {
-            auto attr = mesh->get_indexed_attribute_array(attr_name);
-            const auto& values = *std::get<0>(attr);
-            const auto& indices = *std::get<1>(attr);
+        AttributeArray combined_values(value_offsets.back(), ref_values.cols());
+        IndexArray combined_indices(index_offsets.back(), ref_indices.cols());
 
-            combined_values.block(curr_value_row, 0, values.rows(), values.cols()) =
-                values.template view<AttributeArray>();
-            combined_indices.block(curr_index_row, 0, indices.rows(), indices.cols()) =
-                indices.template view<IndexArray>().array() + curr_value_row;
+        tbb::parallel_for(size_t(0), attrs.size(), [&](size_t i) {
+            const auto& values = *std::get<0>(attrs[i]);
+            const auto& indices = *std::get<1>(attrs[i]);
 
-            curr_value_row += safe_cast<Index>(values.rows());
-            curr_index_row += safe_cast<Index>(indices.rows());
-        }
+            combined_values.block(value_offsets[i], 0, values.rows(), values.cols()) =
+                values.template view<AttributeArray>();
+            combined_indices.block(index_offsets[i], 0, indices.rows(), indices.cols()) =
+                indices.template view<IndexArray>().array() + value_offsets[i];
+        });
 
         combined_mesh.add_indexed_attribute(attr_name);
         combined_mesh.import_indexed_attribute(
@@ -10,10 +10,11 @@
  * governing permissions and limitations under the License.
  */
 #pragma once
+#include <algorithm>
 #include <cassert>
-#include <exception>
-#include <iostream>
+#include <functional>
 #include <numeric>
+#include <vector>
 
 // clang-format off
 #include <lagrange/utils/warnoff.h>
@@ -21,6 +22,9 @@
 #include <lagrange/utils/warnon.h>
 // clang-format on
 
+#include <tbb/enumerable_thread_specific.h>
+#include <tbb/parallel_for.h>
+
 #include <lagrange/common.h>
 #include <lagrange/Mesh.h>
 #include <lagrange/compute_triangle_normal.h>
@@ -30,11 +34,25 @@
 
 namespace lagrange {
 
-template <typename MeshType>
+namespace internal {
+
+///
+/// Computes per-corner normals by grouping the corners around each vertex into smoothing groups.
+/// Corners are merged across every smooth edge incident to the vertex, using the corner chains
+/// of the mesh edge data. Vertices are processed in parallel.
+///
+/// @param[in,out] mesh            The input mesh.
+/// @param[in]     is_sharp_edge   Callable (e, vi, vj) -> bool, where e is the edge (vi, vj).
+/// @param[in]     is_cone_vertex  Callable (vi) -> bool.
+///
+/// @tparam        IsSharpEdge     Type of the edge sharpness callback.
+/// @tparam        IsConeVertex    Type of the cone vertex callback.
+///
+template <typename MeshType, typename IsSharpEdge, typename IsConeVertex>
 void compute_corner_normal(
     MeshType& mesh,
-    std::function<bool(typename MeshType::Index, typename MeshType::Index)> is_sharp,
-    std::function<bool(typename MeshType::Index)> is_cone_vertex)
+    const IsSharpEdge& is_sharp_edge,
+    const IsConeVertex& is_cone_vertex)
 {
     static_assert(MeshTrait<MeshType>::is_mesh(), "Input type is not Mesh");
 
@@ -45,9 +63,6 @@ void compute_corner_normal(
     if (!mesh.has_facet_attribute("normal")) {
         compute_triangle_normal(mesh);
     }
-    if (!mesh.is_connectivity_initialized()) {
-        mesh.initialize_connectivity();
-    }
     mesh.initialize_edge_data();
 
     const Index dim = mesh.get_dim();
@@ -64,117 +79,130 @@ void compute_corner_normal(
         assert(corner_angles.cols() == facets.cols());
     }
 
-
     AttributeArray corner_normals = AttributeArray::Zero(num_facets * vertex_per_facet, dim);
 
-    auto index_of = [](const auto& data, const auto item) -> Index {
-        auto itr = std::find(data.begin(), data.end(), item);
-        assert(itr != data.end());
-        return safe_cast<Index>(itr - data.begin());
+    // Corner of the facet containing corner c that is incident to vertex vi, assuming the edge
+    // (c, c+1) is incident to vi.
+    auto get_corner_at_vertex = [&](const Index c, const Index vi) -> Index {
+        const Index f = c / vertex_per_facet;
+        const Index lv = c % vertex_per_facet;
+        return facets(f, lv) == vi ? c : f * vertex_per_facet + (lv + 1) % vertex_per_facet;
     };
 
-    auto get_root = [](const auto& data, Index i) -> Index {
-        while (data[i] != i) {
-            assert(data[i] < i);
-            i = data[i];
-        }
-        return i;
+    struct Scratch
+    {
+        std::vector<Index> corners; // Corners around the current vertex.
+        std::vector<Index> groups; // 1-ring union-find array over local corner indices.
     };
+    tbb::enumerable_thread_specific<Scratch> scratch;
 
-    auto get_corner_index = [vertex_per_facet, &facets](const Index fid, const Index vid) -> Index {
-        for (auto i : range(vertex_per_facet)) {
-            if (facets(fid, i) == vid) {
-                return fid * vertex_per_facet + i;
-            }
+    tbb::parallel_for(Index(0), num_vertices, [&](Index vi) {
+        if (is_cone_vertex(vi)) {
+            mesh.foreach_corners_around_vertex(vi, [&](Index c) {
+                corner_normals.row(c) = facet_normals.row(c / vertex_per_facet);
+            });
+            return;
         }
-        LA_ASSERT(false, "Facet does not contain this vertex");
-        return 0; // To avoid compiler warning.
-    };
 
-    auto compute_corner_normal_around_cone_vertex =
-        [&mesh, &get_corner_index, &corner_normals, &facet_normals](Index vi) {
-            const auto& adj_facets = mesh.get_facets_adjacent_to_vertex(vi);
-            for (const auto fi : adj_facets) {
-                const auto ci = get_corner_index(fi, vi);
-                corner_normals.row(ci) = facet_normals.row(fi);
-            }
+        auto& corners = scratch.local().corners;
+        auto& groups = scratch.local().groups;
+        corners.clear();
+        mesh.foreach_corners_around_vertex(vi, [&](Index c) { corners.push_back(c); });
+        const Index num_corners = safe_cast<Index>(corners.size());
+        groups.resize(num_corners);
+        std::iota(groups.begin(), groups.end(), 0);
+
+        auto index_of = [&](const Index c) -> Index {
+            auto itr = std::find(corners.begin(), corners.end(), c);
+            assert(itr != corners.end());
+            return safe_cast<Index>(itr - corners.begin());
         };
-
-    std::vector<Index> facet_ids; // 1-ring union-find array.
-    std::vector<Index> e_fids; // per-edge facet id buffer.
-    auto compute_corner_normal_around_regular_vertex = [&](Index vi) {
-        const auto& adj_facets = mesh.get_facets_adjacent_to_vertex(vi);
-        const auto num_adj_facets = adj_facets.size();
-        const auto& adj_vertices = mesh.get_vertices_adjacent_to_vertex(vi);
-
-        // Initialize union find array.
-        facet_ids.resize(num_adj_facets);
-        std::iota(facet_ids.begin(), facet_ids.end(), 0);
-        auto get_1_ring_root = [&get_root, &facet_ids](Index idx) {
-            return get_root(facet_ids, idx);
+        auto get_root = [&](Index i) -> Index {
+            while (groups[i] != i) {
+                i = groups[i];
+            }
+            return i;
         };
 
-        for (auto vj : adj_vertices) {
-            if (!is_sharp(vi, vj)) {
-                auto ei = mesh.find_edge_from_vertices(vi, vj);
-                e_fids.clear();
-                e_fids.reserve(mesh.get_num_facets_around_edge(ei));
-                mesh.foreach_facets_around_edge(ei, [&](Index fid) {
-                    e_fids.push_back(index_of(adj_facets, fid));
-                });
-
-                std::transform(e_fids.begin(), e_fids.end(), e_fids.begin(), get_1_ring_root);
-                const auto root_id = *std::min_element(e_fids.begin(), e_fids.end());
-                std::for_each(e_fids.begin(), e_fids.end(), [&facet_ids, root_id](const Index fid) {
-                    facet_ids[fid] = root_id;
+        // Merge corners across the smooth edges incident to vi. Each edge is visited once, from
+        // the corner at vi of the first facet around it.
+        for (Index i = 0; i < num_corners; ++i) {
+            const Index c = corners[i];
+            const Index f = c / vertex_per_facet;
+            const Index lv = c % vertex_per_facet;
+            const Index lv_prev = (lv + vertex_per_facet - 1) % vertex_per_facet;
+            for (const Index le : {lv, lv_prev}) {
+                const Index vj = le == lv ? facets(f, (lv + 1) % vertex_per_facet) : facets(f, le);
+                if (vj == vi) continue;
+                const Index e = mesh.get_edge(f, le);
+                if (get_corner_at_vertex(mesh.get_one_corner_around_edge(e), vi) != c) continue;
+                if (is_sharp_edge(e, vi, vj)) continue;
+
+                mesh.foreach_corners_around_edge(e, [&](Index ce) {
+                    const Index ri = get_root(i);
+                    const Index rj = get_root(index_of(get_corner_at_vertex(ce, vi)));
+                    groups[std::max(ri, rj)] = std::min(ri, rj);
                 });
             }
         }
 
-        std::transform(facet_ids.begin(), facet_ids.end(), facet_ids.begin(), get_1_ring_root);
-
-        // Accumulate normal to root corner.
-        for (auto i : range(num_adj_facets)) {
-            const Index fid = adj_facets[i];
-            const Index corner_id = get_corner_index(fid, vi);
-            const Index root_fid = adj_facets[facet_ids[i]];
-            const Index root_corner_id = get_corner_index(root_fid, vi);
+        // Accumulate angle-weighted facet normals to the root corner of each group.
+        for (Index i = 0; i < num_corners; ++i) {
+            groups[i] = get_root(i);
+            const Index c = corners[i];
             const Scalar corner_angle =
-                corner_angles(corner_id / vertex_per_facet, corner_id % vertex_per_facet);
+                corner_angles(c / vertex_per_facet, c % vertex_per_facet);
             if (corner_angle >= 0.f &&
                 corner_angle <= 3.14f) { // filter numerical issues due to tiny or huge angels
-                corner_normals.row(root_corner_id) += facet_normals.row(fid) * corner_angle;
+                corner_normals.row(corners[groups[i]]) +=
+                    facet_normals.row(c / vertex_per_facet) * corner_angle;
             }
         }
-        // Assign corner normal to each smooth group of the 1-ring.
-        for (auto i : range(num_adj_facets)) {
-            const Index fid = adj_facets[i];
-            const Index root_fid = adj_facets[facet_ids[i]];
-            const Index curr_corner_id = get_corner_index(fid, vi);
-            const Index root_corner_id = get_corner_index(root_fid, vi);
-
-            corner_normals.row(curr_corner_id) = corner_normals.row(root_corner_id);
-
-            if (corner_normals.row(curr_corner_id).template lpNorm<Eigen::Infinity>() > 1.e-4) {
-                corner_normals.row(curr_corner_id).normalize();
+        for (Index i = 0; i < num_corners; ++i) {
+            if (groups[i] != i) continue;
+            auto n = corner_normals.row(corners[i]);
+            if (n.template lpNorm<Eigen::Infinity>() > 1.e-4) {
+                n.normalize();
             } else {
-                corner_normals.row(curr_corner_id).setZero();
+                n.setZero();
             }
         }
-    };
-
-    for (auto vi : range(num_vertices)) {
-        if (is_cone_vertex(vi)) {
-            compute_corner_normal_around_cone_vertex(vi);
-        } else {
-            compute_corner_normal_around_regular_vertex(vi);
+        // Assign corner normal to each smooth group of the 1-ring.
+        for (Index i = 0; i < num_corners; ++i) {
+            if (groups[i] != i) {
+                corner_normals.row(corners[i]) = corner_normals.row(corners[groups[i]]);
+            }
         }
-    }
+    });
 
     mesh.add_corner_attribute("normal");
     mesh.import_corner_attribute("normal", corner_normals);
 }
 
+} // namespace internal
+
+/**
+ * Compute per-corner normal, given the sharp edges and cone vertices.  Both
+ * callbacks may be called concurrently from multiple threads.
+ *
+ * @param[in,out] mesh            The input mesh.
+ * @param[in]     is_sharp        Returns true on (vi, vj) if the edge between
+ *                                vi and vj is sharp.
+ * @param[in]     is_cone_vertex  Returns true on vi if vi is a cone vertex.
+ */
+template <typename MeshType>
+void compute_corner_normal(
+    MeshType& mesh,
+    std::function<bool(typename MeshType::Index, typename MeshType::Index)> is_sharp,
+    std::function<bool(typename MeshType::Index)> is_cone_vertex)
+{
+    using Index = typename MeshType::Index;
+    internal::compute_corner_normal(
+        mesh,
+        [&](Index, Index vi, Index vj) { return is_sharp(vi, vj); },
+        is_cone_vertex);
+}
+
 /**
  * Compute per-corner normal.  Keep surface smooth everywhere with dihedral
  * angle less than feature_angle_theshold.
@@ -194,21 +222,21 @@ void compute_corner_normal(
         compute_dihedral_angles(mesh);
     }
 
-    auto is_sharp = [&mesh, feature_angle_threshold](Index vi, Index vj) {
-        assert(mesh.has_edge_attribute("dihedral_angle"));
-        const auto& dihedral_angles = mesh.get_edge_attribute("dihedral_angle");
-        Index eid = mesh.find_edge_from_vertices(vi, vj);
+    const auto& dihedral_angles = mesh.get_edge_attribute("dihedral_angle");
+    auto is_sharp = [&dihedral_angles, feature_angle_threshold](Index eid, Index, Index) {
         return std::abs(dihedral_angles(eid, 0)) > feature_angle_threshold;
     };
 
     if (cone_vertices.empty()) {
-        compute_corner_normal(mesh, is_sharp, [](Index) { return false; });
+        internal::compute_corner_normal(mesh, is_sharp, [](Index) { return false; });
     } else {
         std::vector<bool> is_cone(mesh.get_num_vertices(), false);
         std::for_each(cone_vertices.begin(), cone_vertices.end(), [&is_cone](Index vi) {
             is_cone[vi] = true;
         });
-        compute_corner_normal(mesh, is_sharp, [&is_cone](Index vi) { return is_cone[vi]; });
+        internal::compute_corner_normal(mesh, is_sharp, [&is_cone](Index vi) {
+            return is_cone[vi];
+        });
     }
 }
 
@@ -15,9 +15,8 @@
 #include <lagrange/Logger.h>
 #include <lagrange/Mesh.h>
 #include <lagrange/MeshTrait.h>
-#include <lagrange/attributes/eval_as_attribute.h>
+#include <lagrange/compute_geometry_attributes.h>
 #include <lagrange/compute_triangle_normal.h>
-#include <lagrange/utils/geometry3d.h>
 
 namespace lagrange {
 /*
@@ -39,8 +38,7 @@ void compute_dihedral_angles(MeshType& mesh)
         throw std::runtime_error("Input mesh is not 3D.");
     }
 
-    using Index = typename MeshType::Index;
-    using Scalar = typename MeshType::Scalar;
+    using AttributeArray = typename MeshType::AttributeArray;
 
     mesh.initialize_edge_data();
 
@@ -49,31 +47,11 @@ void compute_dihedral_angles(MeshType& mesh)
     }
 
     const auto& facet_normals = mesh.get_facet_attribute("normal");
-    bool non_manifold = false;
-    eval_as_edge_attribute_new(mesh, "dihedral_angle", [&](Index i) -> Scalar {
-        const auto num_adj_facets = mesh.get_num_facets_around_edge(i);
-        if (num_adj_facets > 2) {
-            non_manifold = true;
-        }
-
-        if (num_adj_facets <= 1) {
-            return 0;
-        } else if (num_adj_facets == 2) {
-            Eigen::Matrix<Scalar, 2, 3, Eigen::RowMajor> normals(num_adj_facets, 3);
-            Index index = 0;
-            mesh.foreach_facets_around_edge(i, [&](Index fid) {
-                normals.row(index) = facet_normals.row(fid);
-                index++;
-            });
-
-            const Eigen::Matrix<Scalar, 1, 3>& n1 = normals.row(0);
-            const Eigen::Matrix<Scalar, 1, 3>& n2 = normals.row(1);
-            return angle_between(n1, n2);
-        } else {
-            // Non-manifold edge encountered.  Default to 2 * M_PI.
-            return 2 * M_PI;
-        }
-    });
+    AttributeArray dihedral_angles;
+    const bool non_manifold =
+        internal::compute_edge_geometry(mesh, &facet_normals, nullptr, &dihedral_angles);
+    mesh.add_edge_attribute("dihedral_angle");
+    mesh.import_edge_attribute("dihedral_angle", dihedral_angles);
 
     if (non_manifold) {
         lagrange::logger().warn("Computing dihedral angles on a non-manifold mesh!");
@@ -16,7 +16,7 @@
 #include <lagrange/Edge.h>
 #include <lagrange/Mesh.h>
 #include <lagrange/MeshTrait.h>
-#include <lagrange/attributes/eval_as_attribute.h>
+#include <lagrange/compute_geometry_attributes.h>
 
 namespace lagrange {
 /*
@@ -29,17 +29,9 @@ void compute_edge_lengths(MeshType& mesh)
 {
     static_assert(MeshTrait<MeshType>::is_mesh(), "Input type is not Mesh");
 
-    using Index = typename MeshType::Index;
-
-    mesh.initialize_edge_data();
-
-    const auto& vertices = mesh.get_vertices();
-
-    eval_as_edge_attribute_new(mesh, "length", [&](Index e_idx) {
-        auto v = mesh.get_edge_vertices(e_idx);
-        auto p0 = vertices.row(v[0]);
-        auto p1 = vertices.row(v[1]);
-        return (p0 - p1).norm();
-    });
+    GeometryAttributeOptions options;
+    options.facet_area = false;
+    options.edge_length = true;
+    compute_geometry_attributes(mesh, options);
 }
 } // namespace lagrange
@@ -12,135 +12,15 @@
 #pragma once
 
 #include <Eigen/Dense>
-#include <exception>
+#include <tbb/parallel_for.h>
 
 #include <lagrange/Mesh.h>
 #include <lagrange/MeshTrait.h>
 #include <lagrange/common.h>
-#include <lagrange/utils/range.h>
+#include <lagrange/compute_geometry_attributes.h>
+#include <lagrange/utils/safe_cast.h>
 
 namespace lagrange {
-namespace internal {
-
-///
-/// Calculates the triangle areas.
-///
-/// @param[in]  mesh      Input triangle mesh.
-///
-/// @tparam     MeshType  Mesh type.
-///
-/// @return     #F x 1 array of triangle areas.
-///
-template <typename MeshType>
-auto compute_triangle_areas(const MeshType& mesh) -> AttributeArrayOf<MeshType>
-{
-    using Scalar = typename MeshType::Scalar;
-    using Index = typename MeshType::Index;
-    using Vector = Eigen::Matrix<Scalar, 3, 1>;
-
-    const Index dim = mesh.get_dim();
-    const Index num_facets = mesh.get_num_facets();
-    const auto& vertices = mesh.get_vertices();
-    const auto& facets = mesh.get_facets();
-    AttributeArrayOf<MeshType> areas(num_facets, 1);
-
-    if (dim == 2) {
-        for (Index i = 0; i < num_facets; i++) {
-            const Index i0 = facets(i, 0);
-            const Index i1 = facets(i, 1);
-            const Index i2 = facets(i, 2);
-            Vector v0, v1, v2;
-            v0 << vertices(i0, 0), vertices(i0, 1), 0.0;
-            v1 << vertices(i1, 0), vertices(i1, 1), 0.0;
-            v2 << vertices(i2, 0), vertices(i2, 1), 0.0;
-            Vector e1 = v1 - v0;
-            Vector e2 = v2 - v0;
-            areas(i, 0) = Scalar(0.5) * (e1.cross(e2)).norm();
-        }
-    } else if (dim == 3) {
-        for (Index i = 0; i < num_facets; i++) {
-            const Index i0 = facets(i, 0);
-            const Index i1 = facets(i, 1);
-            const Index i2 = facets(i, 2);
-            Vector v0, v1, v2;
-            v0 << vertices(i0, 0), vertices(i0, 1), vertices(i0, 2);
-            v1 << vertices(i1, 0), vertices(i1, 1), vertices(i1, 2);
-            v2 << vertices(i2, 0), vertices(i2, 1), vertices(i2, 2);
-            Vector e1 = v1 - v0;
-            Vector e2 = v2 - v0;
-            areas(i, 0) = Scalar(0.5) * (e1.cross(e2)).norm();
-        }
-    } else {
-        throw std::runtime_error("Unsupported dimention.");
-    }
-
-    return areas;
-}
-
-///
-/// Calculates the quad areas.
-///
-/// @param[in]  mesh      Input quad mesh.
-///
-/// @tparam     MeshType  Mesh type.
-///
-/// @return     #F x 1 array of quad areas.
-///
-template <typename MeshType>
-auto compute_quad_areas(const MeshType& mesh) -> AttributeArrayOf<MeshType>
-{
-    using Scalar = typename MeshType::Scalar;
-    using Index = typename MeshType::Index;
-    using Vector = Eigen::Matrix<Scalar, 3, 1>;
-
-    const Index dim = mesh.get_dim();
-    const Index num_facets = mesh.get_num_facets();
-    const auto& vertices = mesh.get_vertices();
-    const auto& facets = mesh.get_facets();
-    AttributeArrayOf<MeshType> areas(num_facets, 1);
-
-    if (dim == 2) {
-        for (Index i = 0; i < num_facets; i++) {
-            const Index i0 = facets(i, 0);
-            const Index i1 = facets(i, 1);
-            const Index i2 = facets(i, 2);
-            const Index i3 = facets(i, 3);
-            Vector v0, v1, v2, v3;
-            v0 << vertices(i0, 0), vertices(i0, 1), 0.0f;
-            v1 << vertices(i1, 0), vertices(i1, 1), 0.0f;
-            v2 << vertices(i2, 0), vertices(i2, 1), 0.0f;
-            v3 << vertices(i3, 0), vertices(i3, 1), 0.0f;
-            Vector e10 = v1 - v0;
-            Vector e30 = v3 - v0;
-            Vector e12 = v1 - v2;
-            Vector e32 = v3 - v2;
-            areas(i, 0) = 0.5f * (e10.cross(e30)).norm() + 0.5f * (e12.cross(e32)).norm();
-        }
-    } else if (dim == 3) {
-        for (Index i = 0; i < num_facets; i++) {
-            const Index i0 = facets(i, 0);
-            const Index i1 = facets(i, 1);
-            const Index i2 = facets(i, 2);
-            const Index i3 = facets(i, 3);
-            Vector v0, v1, v2, v3;
-            v0 << vertices(i0, 0), vertices(i0, 1), vertices(i0, 2);
-            v1 << vertices(i1, 0), vertices(i1, 1), vertices(i1, 2);
-            v2 << vertices(i2, 0), vertices(i2, 1), vertices(i2, 2);
-            v3 << vertices(i3, 0), vertices(i3, 1), vertices(i3, 2);
-            Vector e10 = v1 - v0;
-            Vector e30 = v3 - v0;
-            Vector e12 = v1 - v2;
-            Vector e32 = v3 - v2;
-            areas(i, 0) = 0.5f * (e10.cross(e30)).norm() + 0.5f * (e12.cross(e32)).norm();
-        }
-    } else {
-        throw std::runtime_error("Unsupported dimention.");
-    }
-
-    return areas;
-}
-} // namespace internal
-
 ///
 /// Calculates the facet areas.
 ///
@@ -154,15 +34,9 @@ template <typename MeshType>
 auto compute_facet_area_raw(const MeshType& mesh) -> AttributeArrayOf<MeshType>
 {
     static_assert(MeshTrait<MeshType>::is_mesh(), "Input type is not Mesh");
-    using Index = typename MeshType::Index;
-    const Index vertex_per_facet = mesh.get_vertex_per_facet();
-    if (vertex_per_facet == 3) {
-        return internal::compute_triangle_areas(mesh);
-    } else if (vertex_per_facet == 4) {
-        return internal::compute_quad_areas(mesh);
-    } else {
-        throw std::runtime_error("Unsupported facet type.");
-    }
+    AttributeArrayOf<MeshType> areas;
+    internal::compute_facet_geometry(mesh, &areas, nullptr);
+    return areas;
 }
 
 ///
@@ -214,9 +88,9 @@ Eigen::Matrix<typename DerivedUV::Scalar, Eigen::Dynamic, 1> compute_uv_area_raw
     };
 
     Eigen::Matrix<Scalar, Eigen::Dynamic, 1> areas(num_triangles);
-    for (auto i : range(safe_cast<Index>(num_triangles))) {
+    tbb::parallel_for(Index(0), safe_cast<Index>(num_triangles), [&](Index i) {
         areas[i] = compute_single_triangle_area(i);
-    }
+    });
     return areas;
 }
 } // namespace lagrange
@@ -0,0 +1,304 @@
+/*
+ * Copyright 2021 Adobe. All rights reserved.
+ * This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain a copy
+ * of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under
+ * the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ * OF ANY KIND, either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+ */
+#pragma once
+
+#include <lagrange/Logger.h>
+#include <lagrange/Mesh.h>
+#include <lagrange/MeshTrait.h>
+#include <lagrange/common.h>
+#include <lagrange/utils/la_assert.h>
+
+#include <Eigen/Core>
+#include <tbb/parallel_for.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+
+namespace lagrange {
+
+///
+/// Selects the quantities computed by compute_geometry_attributes().
+///
+struct GeometryAttributeOptions
+{
+    /// Compute facet areas into the facet attribute "area".
+    bool facet_area = true;
+
+    /// Compute unit facet normals into the facet attribute "normal". Requires a 3D triangle mesh.
+    bool facet_normal = false;
+
+    /// Compute edge lengths into the edge attribute "length".
+    bool edge_length = false;
+
+    /// Compute dihedral angles into the edge attribute "dihedral_angle". Boundary edges have value
+    /// 0, and non-manifold edges have value 2 * pi. Requires a 3D triangle mesh.
+    bool dihedral_angle = false;
+};
+
+namespace internal {
+
+/// Number of elements gathered in each structure-of-arrays block.
+constexpr int GeometryBlockSize = 64;
+
+template <typename Scalar>
+using GeometryBlock = Eigen::Array<Scalar, GeometryBlockSize, 1>;
+
+///
+/// Computes facet areas and unit facet normals in a single parallel pass. Facet corners are
+/// gathered into fixed-size structure-of-arrays blocks, so the arithmetic is evaluated with full
+/// SIMD packets.
+///
+/// @param[in]  mesh      Input triangle or quad mesh, in 2D or 3D.
+/// @param[out] areas     If not null, receives the #F x 1 array of facet areas.
+/// @param[out] normals   If not null, receives the #F x 3 array of unit facet normals. Requires a
+///                       3D triangle mesh.
+///
+/// @tparam     MeshType  Mesh type.
+///
+template <typename MeshType>
+void compute_facet_geometry(
+    const MeshType& mesh,
+    AttributeArrayOf<MeshType>* areas,
+    AttributeArrayOf<MeshType>* normals)
+{
+    using Scalar = ScalarOf<MeshType>;
+    using Index = IndexOf<MeshType>;
+    using Block = GeometryBlock<Scalar>;
+
+    const Index dim = mesh.get_dim();
+    const Index vertex_per_facet = mesh.get_vertex_per_facet();
+    const Index num_facets = mesh.get_num_facets();
+    LA_ASSERT(dim == 2 || dim == 3, "Unsupported dimension.");
+    LA_ASSERT(vertex_per_facet == 3 || vertex_per_facet == 4, "Unsupported facet type.");
+    LA_ASSERT(
+        normals == nullptr || (vertex_per_facet == 3 && dim == 3),
+        "Facet normals require a 3D triangle mesh.");
+
+    const auto& vertices = mesh.get_vertices();
+    const auto& facets = mesh.get_facets();
+    if (areas) areas->resize(num_facets, 1);
+    if (normals) normals->resize(num_facets, 3);
+
+    const Index num_blocks = (num_facets + GeometryBlockSize - 1) / GeometryBlockSize;
+    tbb::parallel_for(Index(0), num_blocks, [&](Index b) {
+        const Index begin = b * GeometryBlockSize;
+        const Index count = std::min(Index(GeometryBlockSize), num_facets - begin);
+
+        // Gather facet corners. Unused lanes of the last block are left at zero.
+        Block x[4], y[4], z[4];
+        for (Index k = 0; k < vertex_per_facet; ++k) {
+            x[k].setZero();
+            y[k].setZero();
+            z[k].setZero();
+            for (Index i = 0; i < count; ++i) {
+                const Index v = facets(begin + i, k);
+                x[k](i) = vertices(v, 0);
+                y[k](i) = vertices(v, 1);
+                if (dim == 3) z[k](i) = vertices(v, 2);
+            }
+        }
+
+        // Cross product of two edge vectors sharing corner c0, and its norm.
+        auto cross = [&](int c0, int c1, int c2, Block& nx, Block& ny, Block& nz) -> Block {
+            const Block e1x = x[c1] - x[c0], e1y = y[c1] - y[c0], e1z = z[c1] - z[c0];
+            const Block e2x = x[c2] - x[c0], e2y = y[c2] - y[c0], e2z = z[c2] - z[c0];
+            nx = e1y * e2z - e1z * e2y;
+            ny = e1z * e2x - e1x * e2z;
+            nz = e1x * e2y - e1y * e2x;
+            return (nx.square() + ny.square() + nz.square()).sqrt();
+        };
+
+        Block nx, ny, nz;
+        const Block len = cross(0, 1, vertex_per_facet - 1, nx, ny, nz);
+        if (areas) {
+            Block area = Scalar(0.5) * len;
+            if (vertex_per_facet == 4) {
+                Block mx, my, mz;
+                area += Scalar(0.5) * cross(2, 1, 3, mx, my, mz);
+            }
+            areas->col(0).segment(begin, count) = area.head(count).matrix();
+        }
+        if (normals) {
+            // Degenerate facets get a zero normal.
+            const Block safe_len = (len > 0).select(len, Block::Ones());
+            nx /= safe_len;
+            ny /= safe_len;
+            nz /= safe_len;
+            for (Index i = 0; i < count; ++i) {
+                normals->row(begin + i) << nx(i), ny(i), nz(i);
+            }
+        }
+    });
+}
+
+///
+/// Computes edge lengths and dihedral angles in a single parallel pass over the mesh edges. Edge
+/// endpoints and adjacent facet normals are gathered into structure-of-arrays blocks.
+///
+/// @param[in]  mesh             Input mesh of any dimension, with edge data initialized.
+/// @param[in]  facet_normals    #F x 3 array of unit facet normals. Only used if dihedral_angles
+///                              is not null.
+/// @param[out] lengths          If not null, receives the #E x 1 array of edge lengths.
+/// @param[out] dihedral_angles  If not null, receives the #E x 1 array of dihedral angles.
+///
+/// @tparam     MeshType         Mesh type.
+///
+/// @return     True if a non-manifold edge was found while computing dihedral angles.
+///
+template <typename MeshType>
+bool compute_edge_geometry(
+    const MeshType& mesh,
+    const AttributeArrayOf<MeshType>* facet_normals,
+    AttributeArrayOf<MeshType>* lengths,
+    AttributeArrayOf<MeshType>* dihedral_angles)
+{
+    using Scalar = ScalarOf<MeshType>;
+    using Index = IndexOf<MeshType>;
+    using Block = GeometryBlock<Scalar>;
+
+    LA_ASSERT(mesh.is_edge_data_initialized(), "Edge data not initialized");
+    LA_ASSERT(
+        dihedral_angles == nullptr || facet_normals != nullptr,
+        "Dihedral angles require facet normals.");
+
+    const Index dim = mesh.get_dim();
+    const Index num_edges = mesh.get_num_edges();
+    const auto& vertices = mesh.get_vertices();
+    if (lengths) lengths->resize(num_edges, 1);
+    if (dihedral_angles) dihedral_angles->resize(num_edges, 1);
+
+    std::atomic<bool> non_manifold(false);
+    const Index num_blocks = (num_edges + GeometryBlockSize - 1) / GeometryBlockSize;
+    tbb::parallel_for(Index(0), num_blocks, [&](Index b) {
+        const Index begin = b * GeometryBlockSize;
+        const Index count = std::min(Index(GeometryBlockSize), num_edges - begin);
+
+        if (lengths) {
+            // Squared lengths are accumulated one coordinate at a time, for any dimension.
+            Index v0[GeometryBlockSize], v1[GeometryBlockSize];
+            for (Index i = 0; i < count; ++i) {
+                const auto v = mesh.get_edge_vertices(begin + i);
+                v0[i] = v[0];
+                v1[i] = v[1];
+            }
+            Block len2 = Block::Zero();
+            for (Index k = 0; k < dim; ++k) {
+                Block d = Block::Zero();
+                for (Index i = 0; i < count; ++i) {
+                    d(i) = vertices(v0[i], k) - vertices(v1[i], k);
+                }
+                len2 += d.square();
+            }
+            lengths->col(0).segment(begin, count) = len2.sqrt().head(count).matrix();
+        }
+
+        if (dihedral_angles) {
+            // Lanes of edges that do not have exactly two incident facets keep zero normals, and
+            // are overwritten after the vectorized evaluation.
+            Block ax = Block::Zero(), ay = Block::Zero(), az = Block::Zero();
+            Block bx = Block::Zero(), by = Block::Zero(), bz = Block::Zero();
+            Index num_adj_facets[GeometryBlockSize];
+            for (Index i = 0; i < count; ++i) {
+                Index adj[2];
+                Index n = 0;
+                mesh.foreach_facets_around_edge(begin + i, [&](Index f) {
+                    if (n < 2) adj[n] = f;
+                    ++n;
+                });
+                num_adj_facets[i] = n;
+                if (n != 2) continue;
+                const auto& normals = *facet_normals;
+                ax(i) = normals(adj[0], 0), ay(i) = normals(adj[0], 1), az(i) = normals(adj[0], 2);
+                bx(i) = normals(adj[1], 0), by(i) = normals(adj[1], 1), bz(i) = normals(adj[1], 2);
+            }
+            const Block cx = ay * bz - az * by;
+            const Block cy = az * bx - ax * bz;
+            const Block cz = ax * by - ay * bx;
+            const Block sin_angle = (cx.square() + cy.square() + cz.square()).sqrt();
+            const Block cos_angle = ax * bx + ay * by + az * bz;
+            for (Index i = 0; i < count; ++i) {
+                Scalar angle = 0;
+                if (num_adj_facets[i] == 2) {
+                    angle = std::atan2(sin_angle(i), cos_angle(i));
+                } else if (num_adj_facets[i] > 2) {
+                    // Non-manifold edge encountered.  Default to 2 * M_PI.
+                    angle = Scalar(2 * M_PI);
+                    non_manifold = true;
+                }
+                (*dihedral_angles)(begin + i, 0) = angle;
+            }
+        }
+    });
+    return non_manifold;
+}
+
+} // namespace internal
+
+///
+/// Computes a set of facet and edge quantities in a single parallel pass over the facets and, if
+/// needed, a single pass over the edges. Results are stored in the same attributes as the
+/// individual functions: facet attributes "area" and "normal", and edge attributes "length" and
+/// "dihedral_angle". Edge data is initialized if an edge quantity is requested.
+///
+/// @param[in,out] mesh      Input mesh.
+/// @param[in]     options   Quantities to compute.
+///
+/// @tparam        MeshType  Mesh type.
+///
+template <typename MeshType>
+void compute_geometry_attributes(MeshType& mesh, const GeometryAttributeOptions& options = {})
+{
+    static_assert(MeshTrait<MeshType>::is_mesh(), "Input type is not Mesh");
+    using AttributeArray = typename MeshType::AttributeArray;
+
+    const bool need_normals = options.facet_normal || options.dihedral_angle;
+    AttributeArray areas, normals;
+    if (options.facet_area || need_normals) {
+        internal::compute_facet_geometry(
+            mesh,
+            options.facet_area ? &areas : nullptr,
+            need_normals ? &normals : nullptr);
+    }
+
+    AttributeArray lengths, dihedral_angles;
+    if (options.edge_length || options.dihedral_angle) {
+        mesh.initialize_edge_data();
+        const bool non_manifold = internal::compute_edge_geometry(
+            mesh,
+            &normals,
+            options.edge_length ? &lengths : nullptr,
+            options.dihedral_angle ? &dihedral_angles : nullptr);
+        if (non_manifold) {
+            logger().warn("Computing dihedral angles on a non-manifold mesh!");
+        }
+    }
+
+    if (options.facet_area) {
+        mesh.add_facet_attribute("area");
+        mesh.import_facet_attribute("area", areas);
+    }
+    if (options.facet_normal) {
+        mesh.add_facet_attribute("normal");
+        mesh.import_facet_attribute("normal", normals);
+    }
+    if (options.edge_length) {
+        mesh.add_edge_attribute("length");
+        mesh.import_edge_attribute("length", lengths);
+    }
+    if (options.dihedral_angle) {
+        mesh.add_edge_attribute("dihedral_angle");
+        mesh.import_edge_attribute("dihedral_angle", dihedral_angles);
+    }
+}
+
+} // namespace lagrange
@@ -82,7 +82,7 @@ auto compute_lift_operator_from_sampling(const MeshType& mesh /**< [in] Input tr
 /// It uses barycentric coordinates on each triangle to fill in coeffs of a sparse matrix which is then returned.
 /// This bilinear sparse mapping (a.k.a. the returned sparse matrix) can used extend mesh defined fields to fields defined in R^3.
 /// This is useful for interpolating positions or scalar curvatures to a sampled point cloud for example.
-/// This is suited for use with bvh structure whose data return by batch_query can be used as the second arg.
+/// This is suited for use with TriangleBVH, whose batch_query results can be used as the second arg.
 ///
 /// @return Sparse n*m matrix, where n is the number of vertex in the input mesh and m is the number of vertex in the input point cloud.
 ///
@@ -20,6 +20,8 @@
 #include <lagrange/common.h>
 #include <lagrange/utils/safe_cast.h>
 
+#include <tbb/parallel_for.h>
+
 namespace lagrange {
 
 /**
@@ -65,7 +67,7 @@ void compute_uv_distortion(MeshType& mesh)
     AttributeArray distortion(num_facets, 1);
     distortion.setConstant(INVALID);
 
-    for (Index i = 0; i < num_facets; i++) {
+    tbb::parallel_for(Index(0), num_facets, [&](Index i) {
         Eigen::Matrix<Index, 1, 3> f = facets.row(i);
         Eigen::Matrix<Scalar, 1, 3> v0, v1, v2;
         Eigen::Matrix<Scalar, 1, 2> V0, V1, V2;
@@ -76,9 +78,9 @@ void compute_uv_distortion(MeshType& mesh)
         V1 << uv.row(i * 3 + 1);
         V2 << uv.row(i * 3 + 2);
 
-        if (V0.minCoeff() < 0.0 || V0.maxCoeff() > 1.0) continue;
-        if (V1.minCoeff() < 0.0 || V1.maxCoeff() > 1.0) continue;
-        if (V2.minCoeff() < 0.0 || V2.maxCoeff() > 1.0) continue;
+        if (V0.minCoeff() < 0.0 || V0.maxCoeff() > 1.0) return;
+        if (V1.minCoeff() < 0.0 || V1.maxCoeff() > 1.0) return;
+        if (V2.minCoeff() < 0.0 || V2.maxCoeff() > 1.0) return;
 
         // AMIPS energy can be computed geometrically.
         // Area ratio == det(F)
@@ -113,7 +115,7 @@ void compute_uv_distortion(MeshType& mesh)
         // Distortion measure is bounded from below by 2.  It is achieved if
         // and only if the mapping f is isometric.
         distortion(i, 0) = dirichlet / area_ratio;
-    }
+    });
 
     mesh.add_facet_attribute("distortion");
     mesh.set_facet_attribute("distortion", distortion);
@@ -17,6 +17,7 @@
 #include <lagrange/utils/la_assert.h>
 #include <lagrange/utils/safe_cast.h>
 
+#include <tbb/parallel_for.h>
 #include <tbb/parallel_sort.h>
 #include <Eigen/Dense>
 
@@ -40,6 +41,8 @@ Eigen::Index corner_to_edge_mapping(
         Index v2;
         Index corner;
 
+        UnorientedEdge() = default;
+
         UnorientedEdge(Index x, Index y, Index c)
             : v1(std::min(x, y))
             , v2(std::max(x, y))
@@ -53,33 +56,48 @@ Eigen::Index corner_to_edge_mapping(
         bool operator!=(const UnorientedEdge& e) const { return key() != e.key(); }
     };
 
-    Index vert_per_facet = safe_cast<Index>(F.cols());
+    const Index vert_per_facet = safe_cast<Index>(F.cols());
+    const Index num_corners = safe_cast<Index>(F.rows() * F.cols());
 
     // Sort unoriented edges
-    std::vector<UnorientedEdge> edges;
-    edges.reserve(F.rows() * F.cols());
-    for (Index f = 0; f < (Index) F.rows(); ++f) {
-        for (Index lv = 0; lv < (Index) F.cols(); ++lv) {
+    std::vector<UnorientedEdge> edges(num_corners);
+    tbb::parallel_for(Index(0), safe_cast<Index>(F.rows()), [&](Index f) {
+        for (Index lv = 0; lv < vert_per_facet; ++lv) {
             auto v1 = F(f, lv);
             auto v2 = F(f, (lv + 1) % vert_per_facet);
-            edges.emplace_back(v1, v2, f * vert_per_facet + lv);
+            edges[f * vert_per_facet + lv] = UnorientedEdge(v1, v2, f * vert_per_facet + lv);
         }
-    }
+    });
     tbb::parallel_sort(edges.begin(), edges.end());
 
-    // Assign unique edge ids
-    C2E.resize(F.rows() * F.cols());
-    Index num_edges = 0;
-    for (auto it_begin = edges.begin(); it_begin != edges.end();) {
-        // First the first edge after it_begin that has a different key
-        auto it_end = std::find_if(it_begin, edges.end(), [&](auto e) { return (e != *it_begin); });
-        for (auto it = it_begin; it != it_end; ++it) {
-            C2E(it->corner) = num_edges;
+    // Assign unique edge ids in sorted order. Each fixed-size block counts the edges starting in
+    // it, and a prefix sum over blocks gives the first edge id of each block. The block size does
+    // not depend on the number of threads, so ids are the same as with a serial numbering.
+    constexpr Index block_size = 1 << 16;
+    const Index num_blocks = (num_corners + block_size - 1) / block_size;
+    auto is_first = [&](Index i) { return i == 0 || edges[i] != edges[i - 1]; };
+    std::vector<Index> block_offsets(num_blocks + 1, 0);
+    tbb::parallel_for(Index(0), num_blocks, [&](Index b) {
+        const Index end = std::min(num_corners, (b + 1) * block_size);
+        for (Index i = b * block_size; i < end; ++i) {
+            block_offsets[b + 1] += (is_first(i) ? 1 : 0);
         }
-        ++num_edges;
-        it_begin = it_end;
+    });
+    for (Index b = 0; b < num_blocks; ++b) {
+        block_offsets[b + 1] += block_offsets[b];
     }
 
+    C2E.resize(num_corners);
+    tbb::parallel_for(Index(0), num_blocks, [&](Index b) {
+        const Index end = std::min(num_corners, (b + 1) * block_size);
+        Index e = block_offsets[b] - 1;
+        for (Index i = b * block_size; i < end; ++i) {
+            if (is_first(i)) ++e;
+            C2E(edges[i].corner) = e;
+        }
+    });
+    const Index num_edges = block_offsets[num_blocks];
+
     return num_edges;
 }
 
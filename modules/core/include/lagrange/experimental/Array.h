@@ -13,18 +13,165 @@
 
 #include <algorithm>
 #include <exception>
+#include <functional>
 #include <iostream>
+#include <type_traits>
+#include <vector>
 
 #include <lagrange/Logger.h>
 #include <lagrange/common.h>
 #include <lagrange/experimental/Scalar.h>
 #include <lagrange/utils/la_assert.h>
 #include <lagrange/utils/range.h>
+#include <lagrange/utils/span.h>
 #include <lagrange/utils/strings.h>
 
 namespace lagrange {
 namespace experimental {
 
+/**
+ * Weighted row mapping stored in compressed sparse row (CSR) format.  Output
+ * row i is the weighted sum of the input rows get_rows(i), with weights
+ * get_weights(i).
+ */
+class RowWeights
+{
+public:
+    using Index = Eigen::Index;
+
+public:
+    RowWeights()
+        : m_offsets(1, 0)
+    {}
+
+    /**
+     * @param rows:    Flat array of input row indices.
+     * @param weights: Flat array of weights, one per input row index.
+     * @param offsets: Array of #output_rows + 1 offsets into the flat arrays.
+     */
+    RowWeights(std::vector<Index> rows, std::vector<double> weights, std::vector<Index> offsets)
+        : m_rows(std::move(rows))
+        , m_weights(std::move(weights))
+        , m_offsets(std::move(offsets))
+    {
+        LA_ASSERT(!m_offsets.empty(), "Offset array must contain at least one element");
+        LA_ASSERT(m_rows.size() == m_weights.size(), "Inconsistent number of weights");
+        LA_ASSERT(safe_cast<size_t>(m_offsets.back()) == m_rows.size(), "Inconsistent offsets");
+    }
+
+    Index get_num_rows() const { return safe_cast<Index>(m_offsets.size() - 1); }
+
+    span<const Index> get_rows(Index i) const
+    {
+        return span<const Index>(m_rows.data() + m_offsets[i], m_rows.data() + m_offsets[i + 1]);
+    }
+
+    span<const double> get_weights(Index i) const
+    {
+        return span<const double>(
+            m_weights.data() + m_offsets[i],
+            m_weights.data() + m_offsets[i + 1]);
+    }
+
+private:
+    std::vector<Index> m_rows;
+    std::vector<double> m_weights;
+    std::vector<Index> m_offsets;
+};
+
+namespace internal {
+
+template <typename Func, typename = void>
+struct IsIndexFunction : std::false_type
+{
+};
+
+template <typename Func>
+struct IsIndexFunction<
+    Func,
+    std::enable_if_t<std::is_convertible<
+        decltype(std::declval<Func&>()(std::declval<Eigen::Index>())),
+        Eigen::Index>::value>> : std::true_type
+{
+};
+
+template <typename Func, typename = void>
+struct IsWeightedIndexFunction : std::false_type
+{
+};
+
+template <typename Func>
+struct IsWeightedIndexFunction<
+    Func,
+    decltype(void(std::declval<Func&>()(
+        std::declval<Eigen::Index>(),
+        std::declval<std::vector<std::pair<Eigen::Index, double>>&>())))> : std::true_type
+{
+};
+
+} // namespace internal
+
+/**
+ * Output type of a row slice of an Eigen matrix.
+ */
+template <typename Derived>
+using RowSliceType = Eigen::Matrix<
+    typename Derived::Scalar,
+    Eigen::Dynamic,
+    Derived::ColsAtCompileTime,
+    Derived::IsRowMajor ? Eigen::RowMajor : Eigen::ColMajor>;
+
+/**
+ * Evaluates a row mapping function once per output row.
+ *
+ * @param mapping_fn: Either an index mapping function
+ *                    (input_row_index = mapping_fn(output_row_index)), or a
+ *                    weighted mapping function filling a vector of
+ *                    (input_row_index, weight) for an output row index.
+ *
+ * @return A vector of input row indices for an index mapping function, or
+ *         the corresponding RowWeights for a weighted mapping function.
+ */
+template <typename Func>
+std::enable_if_t<internal::IsIndexFunction<Func>::value, std::vector<Eigen::Index>>
+make_row_mapping(Eigen::Index num_rows, Func&& mapping_fn);
+
+template <typename Func>
+std::enable_if_t<internal::IsWeightedIndexFunction<Func>::value, RowWeights> make_row_mapping(
+    Eigen::Index num_rows,
+    Func&& mapping_fn);
+
+/**
+ * Gathers rows of an Eigen matrix in parallel.  The mapping function is a
+ * template parameter so it can be inlined.
+ *
+ * @param mapping_fn: An index mapping function:
+ *                    input_row_index = mapping_fn(output_row_index)).
+ */
+template <typename Derived, typename Func>
+std::enable_if_t<internal::IsIndexFunction<Func>::value, RowSliceType<Derived>> row_gather(
+    const Eigen::MatrixBase<Derived>& matrix,
+    Eigen::Index num_rows,
+    Func&& mapping_fn);
+
+/**
+ * Gathers rows of an Eigen matrix in parallel, given the input row index of
+ * each output row.
+ */
+template <typename Derived, typename T>
+RowSliceType<Derived> row_gather(
+    const Eigen::MatrixBase<Derived>& matrix,
+    const std::vector<T>& row_indices);
+
+/**
+ * Computes weighted sums of rows of an Eigen matrix in parallel.  Integral
+ * values are accumulated in double precision and rounded.
+ */
+template <typename Derived>
+RowSliceType<Derived> row_gather(
+    const Eigen::MatrixBase<Derived>& matrix,
+    const RowWeights& weights);
+
 class ArrayBase
 {
 public:
@@ -99,6 +246,35 @@ public:
         });
     }
 
+    /**
+     * Using a compile-time mapping function (e.g. a lambda), either an index
+     * mapping function or a weighted mapping function.  The function is
+     * evaluated once per output row into a flat mapping (see
+     * make_row_mapping()), which is then applied to the typed data with a
+     * single virtual call.
+     */
+    template <
+        typename Func,
+        typename = std::enable_if_t<
+            !std::is_same<std::decay_t<Func>, IndexFunction>::value &&
+            !std::is_same<std::decay_t<Func>, WeightedIndexFunction>::value>>
+    std::unique_ptr<ArrayBase> row_slice(Index num_rows, Func&& mapping_fn) const
+    {
+        return row_slice(make_row_mapping(num_rows, std::forward<Func>(mapping_fn)));
+    }
+
+    /**
+     * Using precomputed input row indices:
+     *     input_row_index = row_indices[output_row_index].
+     */
+    virtual std::unique_ptr<ArrayBase> row_slice(const std::vector<Index>& row_indices) const = 0;
+
+    /**
+     * Using precomputed weights: each output row is the weighted sum of
+     * weights.get_rows(output_row_index).
+     */
+    virtual std::unique_ptr<ArrayBase> row_slice(const RowWeights& weights) const = 0;
+
     /**
      * Using index function for row mapping.
      *
@@ -131,20 +307,20 @@ protected:
         const IndexFunction& mapping);
 
     template <typename Derived>
-    static std::
-        enable_if_t<std::is_integral<typename Derived::Scalar>::value, std::unique_ptr<ArrayBase>>
-        row_slice_impl(
-            const Eigen::MatrixBase<Derived>& matrix,
-            Index num_rows,
-            const WeightedIndexFunction& mapping);
+    static std::unique_ptr<ArrayBase> row_slice_impl(
+        const Eigen::MatrixBase<Derived>& matrix,
+        Index num_rows,
+        const WeightedIndexFunction& mapping);
+
+    template <typename Derived>
+    static std::unique_ptr<ArrayBase> row_slice_impl(
+        const Eigen::MatrixBase<Derived>& matrix,
+        const std::vector<Index>& row_indices);
 
     template <typename Derived>
-    static std::
-        enable_if_t<!std::is_integral<typename Derived::Scalar>::value, std::unique_ptr<ArrayBase>>
-        row_slice_impl(
-            const Eigen::MatrixBase<Derived>& matrix,
-            Index num_rows,
-            const WeightedIndexFunction& mapping);
+    static std::unique_ptr<ArrayBase> row_slice_impl(
+        const Eigen::MatrixBase<Derived>& matrix,
+        const RowWeights& weights);
 
 protected:
     const ScalarEnum m_scalar_type;
@@ -163,6 +339,7 @@ public:
     using EigenType = _EigenType;
     using Index = ArrayBase::Index;
     using ArrayBase::WeightedIndexFunction;
+    using ArrayBase::row_slice;
     static_assert(
         std::is_base_of<typename Eigen::EigenBase<EigenType>, EigenType>::value,
         "Template parameter `_EigenType` is not an Eigen type!");
@@ -218,6 +395,14 @@ public:
     {
         return row_slice_impl(m_data, num_rows, mapping_fn);
     }
+    std::unique_ptr<ArrayBase> row_slice(const std::vector<Index>& row_indices) const override
+    {
+        return row_slice_impl(m_data, row_indices);
+    }
+    std::unique_ptr<ArrayBase> row_slice(const RowWeights& weights) const override
+    {
+        return row_slice_impl(m_data, weights);
+    }
 
     std::string type_name() const override
     {
@@ -250,6 +435,7 @@ public:
     using DecayedEigenType = std::decay_t<_EigenType>;
     using Index = ArrayBase::Index;
     using ArrayBase::WeightedIndexFunction;
+    using ArrayBase::row_slice;
     static_assert(
         std::is_base_of<typename Eigen::EigenBase<DecayedEigenType>, DecayedEigenType>::value,
         "Template parameter `_EigenType` is not an Eigen type!");
@@ -299,6 +485,14 @@ public:
     {
         return row_slice_impl(m_data, num_rows, mapping_fn);
     }
+    std::unique_ptr<ArrayBase> row_slice(const std::vector<Index>& row_indices) const override
+    {
+        return row_slice_impl(m_data, row_indices);
+    }
+    std::unique_ptr<ArrayBase> row_slice(const RowWeights& weights) const override
+    {
+        return row_slice_impl(m_data, weights);
+    }
 
     std::string type_name() const override
     {
@@ -323,6 +517,7 @@ public:
     using DecayedEigenType = std::decay_t<_EigenType>;
     using Index = ArrayBase::Index;
     using ArrayBase::WeightedIndexFunction;
+    using ArrayBase::row_slice;
     static_assert(
         std::is_base_of<typename Eigen::EigenBase<DecayedEigenType>, DecayedEigenType>::value,
         "Template parameter `_EigenType` is not an Eigen type!");
@@ -367,6 +562,14 @@ public:
     {
         return row_slice_impl(m_data, num_rows, mapping_fn);
     }
+    std::unique_ptr<ArrayBase> row_slice(const std::vector<Index>& row_indices) const override
+    {
+        return row_slice_impl(m_data, row_indices);
+    }
+    std::unique_ptr<ArrayBase> row_slice(const RowWeights& weights) const override
+    {
+        return row_slice_impl(m_data, weights);
+    }
 
     std::string type_name() const override
     {
@@ -406,6 +609,7 @@ public:
     using EigenMap = Eigen::Map<EigenType>;
     using ConstEigenMap = Eigen::Map<const EigenType>;
     using ArrayBase::WeightedIndexFunction;
+    using ArrayBase::row_slice;
 
 public:
     RawArray(Scalar* data, Index rows, Index cols)
@@ -452,6 +656,14 @@ public:
     {
         return row_slice_impl(m_data, num_rows, mapping_fn);
     }
+    std::unique_ptr<ArrayBase> row_slice(const std::vector<Index>& row_indices) const override
+    {
+        return row_slice_impl(m_data, row_indices);
+    }
+    std::unique_ptr<ArrayBase> row_slice(const RowWeights& weights) const override
+    {
+        return row_slice_impl(m_data, weights);
+    }
 
     std::string type_name() const override
     {
@@ -472,6 +684,7 @@ public:
     using EigenType = Eigen::Matrix<Scalar, _Rows, _Cols, _Options>;
     using EigenMap = Eigen::Map<const EigenType>;
     using ArrayBase::WeightedIndexFunction;
+    using ArrayBase::row_slice;
 
 public:
     RawArray(const Scalar* data, Index rows, Index cols)
@@ -510,6 +723,14 @@ public:
     {
         return row_slice_impl(m_data, num_rows, mapping_fn);
     }
+    std::unique_ptr<ArrayBase> row_slice(const std::vector<Index>& row_indices) const override
+    {
+        return row_slice_impl(m_data, row_indices);
+    }
+    std::unique_ptr<ArrayBase> row_slice(const RowWeights& weights) const override
+    {
+        return row_slice_impl(m_data, weights);
+    }
 
     std::string type_name() const override
     {
@@ -143,104 +143,163 @@ bool ArrayBase::is_compatible(bool ignore_storage_order) const
 }
 
 
-template <typename Derived>
-std::unique_ptr<ArrayBase> ArrayBase::row_slice_impl(
+template <typename Func>
+std::enable_if_t<internal::IsIndexFunction<Func>::value, std::vector<Eigen::Index>>
+make_row_mapping(Eigen::Index num_rows, Func&& mapping_fn)
+{
+    using Index = Eigen::Index;
+    std::vector<Index> row_indices(num_rows);
+    tbb::parallel_for(
+        tbb::blocked_range<Index>(0, num_rows),
+        [&](const tbb::blocked_range<Index>& r) {
+            for (auto i = r.begin(); i != r.end(); i++) {
+                row_indices[i] = mapping_fn(i);
+            }
+        });
+    return row_indices;
+}
+
+template <typename Func>
+std::enable_if_t<internal::IsWeightedIndexFunction<Func>::value, RowWeights> make_row_mapping(
+    Eigen::Index num_rows,
+    Func&& mapping_fn)
+{
+    using Index = Eigen::Index;
+    tbb::enumerable_thread_specific<std::vector<std::pair<Index, double>>> entries;
+
+    // Entries are first gathered per fixed-size block of output rows, then concatenated.
+    constexpr Index block_size = 1 << 12;
+    const Index num_blocks = (num_rows + block_size - 1) / block_size;
+    std::vector<std::vector<std::pair<Index, double>>> block_entries(num_blocks);
+    std::vector<Index> offsets(num_rows + 1, 0);
+    tbb::parallel_for(Index(0), num_blocks, [&](Index b) {
+        auto& local_entries = entries.local();
+        const Index end = std::min(num_rows, (b + 1) * block_size);
+        for (Index i = b * block_size; i < end; ++i) {
+            mapping_fn(i, local_entries);
+            offsets[i + 1] = safe_cast<Index>(local_entries.size());
+            block_entries[b].insert(
+                block_entries[b].end(),
+                local_entries.begin(),
+                local_entries.end());
+        }
+    });
+    for (Index i = 0; i < num_rows; ++i) {
+        offsets[i + 1] += offsets[i];
+    }
+
+    std::vector<Index> rows(offsets.back());
+    std::vector<double> weights(offsets.back());
+    tbb::parallel_for(Index(0), num_blocks, [&](Index b) {
+        const Index first = offsets[b * block_size];
+        for (size_t k = 0; k < block_entries[b].size(); ++k) {
+            rows[first + k] = block_entries[b][k].first;
+            weights[first + k] = block_entries[b][k].second;
+        }
+        block_entries[b] = {};
+    });
+    return RowWeights(std::move(rows), std::move(weights), std::move(offsets));
+}
+
+template <typename Derived, typename Func>
+std::enable_if_t<internal::IsIndexFunction<Func>::value, RowSliceType<Derived>> row_gather(
     const Eigen::MatrixBase<Derived>& matrix,
-    Index num_rows,
-    const IndexFunction& mapping_fn)
+    Eigen::Index num_rows,
+    Func&& mapping_fn)
 {
-    using Scalar = typename Derived::Scalar;
-    using OutEigenType = Eigen::Matrix<
-        Scalar,
-        Eigen::Dynamic,
-        Derived::ColsAtCompileTime,
-        Derived::IsRowMajor ? Eigen::RowMajor : Eigen::ColMajor>;
-
-    const auto num_cols = matrix.cols();
-    OutEigenType out_matrix(num_rows, num_cols);
+    RowSliceType<Derived> out_matrix(num_rows, matrix.cols());
     tbb::parallel_for(
-        tbb::blocked_range<size_t>(0, num_rows),
-        [&](const tbb::blocked_range<size_t>& r) {
+        tbb::blocked_range<Eigen::Index>(0, num_rows),
+        [&](const tbb::blocked_range<Eigen::Index>& r) {
             for (auto i = r.begin(); i != r.end(); i++) {
                 out_matrix.row(i) = matrix.row(mapping_fn(i));
             }
         });
+    return out_matrix;
+}
 
-    return std::make_unique<EigenArray<OutEigenType>>(std::move(out_matrix));
+template <typename Derived, typename T>
+RowSliceType<Derived> row_gather(
+    const Eigen::MatrixBase<Derived>& matrix,
+    const std::vector<T>& row_indices)
+{
+    return row_gather(matrix, safe_cast<Eigen::Index>(row_indices.size()), [&](Eigen::Index i) {
+        return static_cast<Eigen::Index>(row_indices[i]);
+    });
 }
 
 template <typename Derived>
-std::enable_if_t<std::is_integral<typename Derived::Scalar>::value, std::unique_ptr<ArrayBase>>
-ArrayBase::row_slice_impl(
+RowSliceType<Derived> row_gather(
     const Eigen::MatrixBase<Derived>& matrix,
-    Index num_rows,
-    const WeightedIndexFunction& mapping_fn)
+    const RowWeights& weights)
 {
+    using Index = Eigen::Index;
     using Scalar = typename Derived::Scalar;
-    using OutEigenType = Eigen::Matrix<
-        Scalar,
-        Eigen::Dynamic,
-        Derived::ColsAtCompileTime,
-        Derived::IsRowMajor ? Eigen::RowMajor : Eigen::ColMajor>;
-    const auto num_cols = matrix.cols();
-    tbb::enumerable_thread_specific<std::vector<std::pair<Index, double>>> weights;
-
-    using DoubleEigenType = Eigen::Matrix<
-        double,
-        Eigen::Dynamic,
-        Derived::ColsAtCompileTime,
-        Derived::IsRowMajor ? Eigen::RowMajor : Eigen::ColMajor>;
-    DoubleEigenType out_matrix(num_rows, num_cols);
-    out_matrix.setZero();
+    using OutEigenType = RowSliceType<Derived>;
+
+    // Integral values are accumulated in double precision and rounded.
+    constexpr bool is_integral = std::is_integral<Scalar>::value;
+    using AccumScalar = std::conditional_t<is_integral, double, Scalar>;
+    using AccumRow = Eigen::Matrix<AccumScalar, 1, Derived::ColsAtCompileTime>;
 
+    const Index num_rows = weights.get_num_rows();
+    OutEigenType out_matrix(num_rows, matrix.cols());
     tbb::parallel_for(
         tbb::blocked_range<Index>(0, num_rows),
         [&](const tbb::blocked_range<Index>& r) {
+            AccumRow accum;
+            accum.resize(matrix.cols());
             for (auto i = r.begin(); i != r.end(); i++) {
-                auto& entries = weights.local();
-                mapping_fn(i, entries);
-                for (const auto& entry : entries) {
-                    out_matrix.row(i) +=
-                        matrix.row(entry.first).template cast<double>() * entry.second;
+                const auto rows = weights.get_rows(i);
+                const auto row_weights = weights.get_weights(i);
+                accum.setZero();
+                for (size_t k = 0; k < rows.size(); ++k) {
+                    accum += matrix.row(rows[k]).template cast<AccumScalar>() *
+                             safe_cast<AccumScalar>(row_weights[k]);
+                }
+                if (is_integral) {
+                    out_matrix.row(i) = accum.array().round().template cast<Scalar>().matrix();
+                } else {
+                    out_matrix.row(i) = accum.template cast<Scalar>();
                 }
             }
         });
-    return std::make_unique<EigenArray<OutEigenType>>(
-        std::move(out_matrix.array().round().template cast<Scalar>().matrix().eval()));
+    return out_matrix;
+}
+
+template <typename Derived>
+std::unique_ptr<ArrayBase> ArrayBase::row_slice_impl(
+    const Eigen::MatrixBase<Derived>& matrix,
+    Index num_rows,
+    const IndexFunction& mapping_fn)
+{
+    return std::make_unique<EigenArray<RowSliceType<Derived>>>(
+        row_gather(matrix, num_rows, mapping_fn));
 }
 
 template <typename Derived>
-std::enable_if_t<!std::is_integral<typename Derived::Scalar>::value, std::unique_ptr<ArrayBase>>
-ArrayBase::row_slice_impl(
+std::unique_ptr<ArrayBase> ArrayBase::row_slice_impl(
     const Eigen::MatrixBase<Derived>& matrix,
     Index num_rows,
     const WeightedIndexFunction& mapping_fn)
 {
-    using Scalar = typename Derived::Scalar;
-    using OutEigenType = Eigen::Matrix<
-        Scalar,
-        Eigen::Dynamic,
-        Derived::ColsAtCompileTime,
-        Derived::IsRowMajor ? Eigen::RowMajor : Eigen::ColMajor>;
-    const auto num_cols = matrix.cols();
-    tbb::enumerable_thread_specific<std::vector<std::pair<Index, double>>> weights;
+    return row_slice_impl(matrix, make_row_mapping(num_rows, mapping_fn));
+}
 
-    OutEigenType out_matrix(num_rows, num_cols);
-    out_matrix.setZero();
+template <typename Derived>
+std::unique_ptr<ArrayBase> ArrayBase::row_slice_impl(
+    const Eigen::MatrixBase<Derived>& matrix,
+    const std::vector<Index>& row_indices)
+{
+    return std::make_unique<EigenArray<RowSliceType<Derived>>>(row_gather(matrix, row_indices));
+}
 
-    tbb::parallel_for(
-        tbb::blocked_range<Index>(0, num_rows),
-        [&](const tbb::blocked_range<Index>& r) {
-            for (auto i = r.begin(); i != r.end(); i++) {
-                auto& entries = weights.local();
-                mapping_fn(i, entries);
-                for (const auto& entry : entries) {
-                    out_matrix.row(i) += matrix.row(entry.first).template cast<Scalar>() *
-                                         safe_cast<Scalar>(entry.second);
-                }
-            }
-        });
-    return std::make_unique<EigenArray<OutEigenType>>(std::move(out_matrix));
+template <typename Derived>
+std::unique_ptr<ArrayBase> ArrayBase::row_slice_impl(
+    const Eigen::MatrixBase<Derived>& matrix,
+    const RowWeights& weights)
+{
+    return std::make_unique<EigenArray<RowSliceType<Derived>>>(row_gather(matrix, weights));
 }
 
 } // namespace experimental
@@ -0,0 +1,309 @@
+/*
+ * Copyright 2021 Adobe. All rights reserved.
+ * This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain a copy
+ * of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under
+ * the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ * OF ANY KIND, either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+ */
+#pragma once
+
+#include <lagrange/DisjointSets.h>
+#include <lagrange/Logger.h>
+#include <lagrange/Mesh.h>
+#include <lagrange/MeshTrait.h>
+#include <lagrange/attributes/map_attributes.h>
+#include <lagrange/common.h>
+#include <lagrange/create_mesh.h>
+#include <lagrange/utils/la_assert.h>
+#include <lagrange/utils/safe_cast.h>
+
+#include <tbb/parallel_for.h>
+#include <tbb/parallel_sort.h>
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <tuple>
+#include <vector>
+
+namespace lagrange {
+
+///
+/// Chains mesh cleanup operations on a single working copy of the facet array. Removed facets are
+/// tombstoned and merged vertices are remapped in place. Geometry and attributes are compacted
+/// once, when finalize() is called.
+///
+/// Each operation gives the same result as the corresponding free function (e.g.
+/// remove_topologically_degenerate_triangles()), except remove_duplicate_facets(), which keeps the
+/// first occurrence of each facet in place instead of reordering facets.
+///
+/// @code
+/// auto cleaned = MeshCleanupPipeline<TriangleMesh3D>(mesh)
+///                    .remove_topologically_degenerate_triangles()
+///                    .remove_short_edges(1e-6)
+///                    .remove_null_area_triangles()
+///                    .remove_duplicate_facets()
+///                    .remove_isolated_vertices()
+///                    .finalize();
+/// @endcode
+///
+/// @tparam     MeshType  Mesh type.
+///
+template <typename MeshType>
+class MeshCleanupPipeline
+{
+public:
+    static_assert(MeshTrait<MeshType>::is_mesh(), "Input type is not Mesh");
+
+    using Scalar = typename MeshType::Scalar;
+    using Index = typename MeshType::Index;
+    using VertexArray = typename MeshType::VertexArray;
+    using FacetArray = typename MeshType::FacetArray;
+
+public:
+    ///
+    /// Starts a cleanup pipeline. The input mesh must outlive the pipeline.
+    ///
+    /// @param[in]  mesh  Input mesh.
+    ///
+    explicit MeshCleanupPipeline(const MeshType& mesh)
+        : m_mesh(mesh)
+        , m_facets(mesh.get_facets())
+        , m_facet_alive(mesh.get_num_facets(), 1)
+    {}
+
+    /// Number of facets that have not been removed so far.
+    Index get_num_facets() const
+    {
+        return safe_cast<Index>(std::count(m_facet_alive.begin(), m_facet_alive.end(), 1));
+    }
+
+    ///
+    /// Removes triangles with repeated vertex indices.
+    ///
+    /// @return     This pipeline.
+    ///
+    MeshCleanupPipeline& remove_topologically_degenerate_triangles()
+    {
+        LA_ASSERT(m_mesh.get_vertex_per_facet() == 3);
+        logger().trace("[MeshCleanupPipeline::remove_topologically_degenerate_triangles]");
+        remove_facets_if([&](Index f) {
+            return m_facets(f, 0) == m_facets(f, 1) || m_facets(f, 1) == m_facets(f, 2) ||
+                   m_facets(f, 2) == m_facets(f, 0);
+        });
+        return *this;
+    }
+
+    ///
+    /// Removes triangles with exactly zero area.
+    ///
+    /// @return     This pipeline.
+    ///
+    MeshCleanupPipeline& remove_null_area_triangles()
+    {
+        LA_ASSERT(m_mesh.get_vertex_per_facet() == 3);
+        LA_ASSERT(m_mesh.get_dim() == 3);
+        logger().trace("[MeshCleanupPipeline::remove_null_area_triangles]");
+        using RowVector3s = Eigen::Matrix<Scalar, 1, 3>;
+        const auto& vertices = m_mesh.get_vertices();
+        remove_facets_if([&](Index f) {
+            const RowVector3s aa = vertices.row(m_facets(f, 0));
+            const RowVector3s bb = vertices.row(m_facets(f, 1));
+            const RowVector3s cc = vertices.row(m_facets(f, 2));
+            return !((bb - aa).cross(cc - aa).norm() > 0);
+        });
+        return *this;
+    }
+
+    ///
+    /// Removes triangles spanning the same set of vertices as an earlier triangle, regardless of
+    /// orientation. The first occurrence is kept.
+    ///
+    /// @return     This pipeline.
+    ///
+    MeshCleanupPipeline& remove_duplicate_facets()
+    {
+        LA_ASSERT(m_mesh.get_vertex_per_facet() == 3);
+        logger().trace("[MeshCleanupPipeline::remove_duplicate_facets]");
+        using Key = std::pair<std::array<Index, 3>, Index>;
+        std::vector<Key> keys;
+        keys.reserve(m_facet_alive.size());
+        for (Index f = 0; f < safe_cast<Index>(m_facet_alive.size()); ++f) {
+            if (!m_facet_alive[f]) continue;
+            std::array<Index, 3> key = {{m_facets(f, 0), m_facets(f, 1), m_facets(f, 2)}};
+            std::sort(key.begin(), key.end());
+            keys.emplace_back(key, f);
+        }
+        tbb::parallel_sort(keys.begin(), keys.end());
+        tbb::parallel_for(size_t(1), keys.size(), [&](size_t i) {
+            if (keys[i].first == keys[i - 1].first) {
+                m_facet_alive[keys[i].second] = 0;
+            }
+        });
+        return *this;
+    }
+
+    ///
+    /// Collapses edges whose length is at most a given tolerance, then removes the triangles and
+    /// vertices made degenerate or unused by the collapse.
+    ///
+    /// @param[in]  tol   Edges with length <= tol are collapsed.
+    ///
+    /// @return     This pipeline.
+    ///
+    MeshCleanupPipeline& remove_short_edges(Scalar tol = 0)
+    {
+        logger().trace("[MeshCleanupPipeline::remove_short_edges]");
+
+        // Topological degeneracy can affect the index mapping algorithm used here.
+        remove_topologically_degenerate_triangles();
+
+        // Merge the endpoints of short edges. Edges are visited in lexicographic order of their
+        // endpoints, and each edge is oriented as in the last facet containing it, which is the
+        // order used by the mesh edge data.
+        struct ShortEdge
+        {
+            Index v_min, v_max, corner, v0, v1;
+            bool operator<(const ShortEdge& e) const
+            {
+                return std::tie(v_min, v_max, e.corner) < std::tie(e.v_min, e.v_max, corner);
+            }
+        };
+        const auto& vertices = m_mesh.get_vertices();
+        const Index vertex_per_facet = m_mesh.get_vertex_per_facet();
+        std::vector<ShortEdge> short_edges;
+        for (Index f = 0; f < safe_cast<Index>(m_facet_alive.size()); ++f) {
+            if (!m_facet_alive[f]) continue;
+            for (Index lv = 0; lv < vertex_per_facet; ++lv) {
+                const Index v0 = m_facets(f, lv);
+                const Index v1 = m_facets(f, (lv + 1) % vertex_per_facet);
+                if ((vertices.row(v0) - vertices.row(v1)).norm() <= tol) {
+                    short_edges.push_back(
+                        {std::min(v0, v1), std::max(v0, v1), f * vertex_per_facet + lv, v0, v1});
+                }
+            }
+        }
+        tbb::parallel_sort(short_edges.begin(), short_edges.end());
+
+        const Index num_vertices = m_mesh.get_num_vertices();
+        DisjointSets<Index> clusters(num_vertices);
+        for (size_t i = 0; i < short_edges.size(); ++i) {
+            const auto& e = short_edges[i];
+            if (i > 0 && e.v_min == short_edges[i - 1].v_min &&
+                e.v_max == short_edges[i - 1].v_max) {
+                continue;
+            }
+            clusters.merge(e.v0, e.v1);
+        }
+
+        if (!short_edges.empty()) {
+            std::vector<Index> roots(num_vertices);
+            for (Index v = 0; v < num_vertices; ++v) {
+                roots[v] = clusters.find(v);
+            }
+            tbb::parallel_for(Index(0), safe_cast<Index>(m_facets.rows()), [&](Index f) {
+                for (Index lv = 0; lv < vertex_per_facet; ++lv) {
+                    m_facets(f, lv) = roots[m_facets(f, lv)];
+                }
+            });
+        }
+
+        remove_topologically_degenerate_triangles();
+        remove_isolated_vertices();
+        return *this;
+    }
+
+    ///
+    /// Removes vertices that are not referenced by any remaining facet. The removal is applied
+    /// when the pipeline is finalized, and remaining vertices are ordered by first occurrence in
+    /// the facet array.
+    ///
+    /// @return     This pipeline.
+    ///
+    MeshCleanupPipeline& remove_isolated_vertices()
+    {
+        m_remove_isolated_vertices = true;
+        return *this;
+    }
+
+    ///
+    /// Compacts the geometry and maps all vertex, facet, corner and indexed attributes of the input
+    /// mesh onto the cleaned mesh.
+    ///
+    /// @return     The cleaned mesh.
+    ///
+    std::unique_ptr<MeshType> finalize() const
+    {
+        const Index num_facets = safe_cast<Index>(m_facet_alive.size());
+        const Index num_vertices = m_mesh.get_num_vertices();
+        const Index vertex_per_facet = m_mesh.get_vertex_per_facet();
+
+        // Backward facet mapping, left empty if no facet was removed.
+        const Index new_num_facets = get_num_facets();
+        std::vector<Index> facet_map;
+        if (new_num_facets != num_facets) {
+            facet_map.reserve(new_num_facets);
+            for (Index f = 0; f < num_facets; ++f) {
+                if (m_facet_alive[f]) facet_map.push_back(f);
+            }
+        }
+        auto old_facet = [&](Index f) { return facet_map.empty() ? f : facet_map[f]; };
+
+        // Forward and backward vertex mappings, left empty if vertices are kept as is.
+        std::vector<Index> forward_vertex_map;
+        std::vector<Index> vertex_map;
+        if (m_remove_isolated_vertices) {
+            forward_vertex_map.assign(num_vertices, INVALID<Index>());
+            for (Index f = 0; f < new_num_facets; ++f) {
+                for (Index lv = 0; lv < vertex_per_facet; ++lv) {
+                    const Index v = m_facets(old_facet(f), lv);
+                    if (forward_vertex_map[v] == INVALID<Index>()) {
+                        forward_vertex_map[v] = safe_cast<Index>(vertex_map.size());
+                        vertex_map.push_back(v);
+                    }
+                }
+            }
+        }
+        const Index new_num_vertices =
+            m_remove_isolated_vertices ? safe_cast<Index>(vertex_map.size()) : num_vertices;
+
+        const auto& vertices = m_mesh.get_vertices();
+        VertexArray new_vertices(new_num_vertices, m_mesh.get_dim());
+        tbb::parallel_for(Index(0), new_num_vertices, [&](Index v) {
+            new_vertices.row(v) = vertices.row(m_remove_isolated_vertices ? vertex_map[v] : v);
+        });
+        FacetArray new_facets(new_num_facets, vertex_per_facet);
+        tbb::parallel_for(Index(0), new_num_facets, [&](Index f) {
+            for (Index lv = 0; lv < vertex_per_facet; ++lv) {
+                const Index v = m_facets(old_facet(f), lv);
+                new_facets(f, lv) = m_remove_isolated_vertices ? forward_vertex_map[v] : v;
+            }
+        });
+
+        auto out_mesh = create_mesh(std::move(new_vertices), std::move(new_facets));
+        map_attributes(m_mesh, *out_mesh, vertex_map, facet_map);
+        return out_mesh;
+    }
+
+protected:
+    template <typename Func>
+    void remove_facets_if(Func func)
+    {
+        tbb::parallel_for(Index(0), safe_cast<Index>(m_facet_alive.size()), [&](Index f) {
+            if (m_facet_alive[f] && func(f)) m_facet_alive[f] = 0;
+        });
+    }
+
+protected:
+    const MeshType& m_mesh; ///< Input mesh.
+    FacetArray m_facets; ///< Facets of the input mesh, with merged vertices remapped.
+    std::vector<uint8_t> m_facet_alive; ///< Facet tombstones.
+    bool m_remove_isolated_vertices = false; ///< Whether to drop unreferenced vertices.
+};
+
+} // namespace lagrange
@@ -11,7 +11,14 @@
  */
 #pragma once
 
+#include <algorithm>
+#include <array>
+#include <atomic>
 #include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <utility>
 #include <vector>
 
 // clang-format off
@@ -20,6 +27,7 @@
 #include <lagrange/utils/warnon.h>
 // clang-format on
 
+#include <lagrange/DisjointSets.h>
 #include <lagrange/common.h>
 #include <lagrange/create_mesh.h>
 #include <lagrange/Mesh.h>
@@ -29,6 +37,9 @@
 #include <lagrange/attributes/map_attributes.h>
 #include <lagrange/utils/range.h>
 
+#include <tbb/parallel_for.h>
+#include <tbb/parallel_sort.h>
+
 namespace lagrange {
 
 namespace internal {
@@ -60,6 +71,210 @@ void unique_rows(
     }
     ++num_unique_vertices; // num_of_xx = last index + 1
 }
+
+inline uint64_t hash_combine_64(uint64_t seed, uint64_t value)
+{
+    // splitmix64 finalizer applied to the combined value.
+    uint64_t x = seed ^ (value + 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2));
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+}
+
+template <typename Scalar>
+uint64_t scalar_bits(Scalar x)
+{
+    static_assert(sizeof(Scalar) <= sizeof(uint64_t), "Unsupported scalar type");
+    if (x == Scalar(0)) x = Scalar(0); // -0 and +0 must hash the same.
+    uint64_t bits = 0;
+    std::memcpy(&bits, &x, sizeof(Scalar));
+    return bits;
+}
+
+///
+/// Computes the vertex forward mapping used by the tolerant version of remove_duplicate_vertices.
+///
+/// Each vertex is hashed by the grid cell containing it (or by its exact coordinates if the
+/// tolerance is 0). Hashes are sorted in parallel, then each vertex probes the 3^dim cells around
+/// it and merges with every smaller-index vertex within tolerance and with identical keys, using a
+/// concurrent union-find. Hash collisions only add candidates, which are rejected by the distance
+/// test.
+///
+/// @param[in]  mesh                     Input mesh.
+/// @param[in]  tolerance                Merge distance.
+/// @param[in]  vertex_attribute_names   Vertex attributes that serve as keys.
+/// @param[in]  indexed_attribute_names  Indexed attributes that serve as keys.
+/// @param[out] num_unique_vertices      Number of vertices after merging.
+/// @param[out] forward_mapping          Old to new vertex index mapping.
+///
+template <typename MeshType, typename Index>
+void weld_vertices_hash_grid(
+    const MeshType& mesh,
+    typename MeshType::Scalar tolerance,
+    const std::vector<std::string>& vertex_attribute_names,
+    const std::vector<std::string>& indexed_attribute_names,
+    Index& num_unique_vertices,
+    std::vector<Index>& forward_mapping)
+{
+    using Scalar = typename MeshType::Scalar;
+    using AttributeArray = typename MeshType::AttributeArray;
+    constexpr int max_dim = 3;
+
+    LA_ASSERT(tolerance >= 0, "Tolerance must be non-negative");
+    const auto& vertices = mesh.get_vertices();
+    const auto& facets = mesh.get_facets();
+    const Index num_vertices = mesh.get_num_vertices();
+    const Index num_facets = mesh.get_num_facets();
+    const int dim = safe_cast<int>(mesh.get_dim());
+    LA_ASSERT(dim <= max_dim, "Unsupported dimension: " + std::to_string(dim));
+
+    // Keys are compared in place, without building a #V x #keys matrix. For indexed attributes,
+    // each vertex uses the value of its last corner in facet order, as in the exact version.
+    std::vector<const AttributeArray*> vertex_keys;
+    for (const auto& attr_name : vertex_attribute_names) {
+        LA_ASSERT(mesh.has_vertex_attribute(attr_name));
+        vertex_keys.push_back(&mesh.get_vertex_attribute(attr_name));
+    }
+    std::vector<const AttributeArray*> indexed_keys;
+    std::vector<std::vector<Index>> indexed_key_ids;
+    if (!indexed_attribute_names.empty()) {
+        std::vector<std::atomic<Index>> last_corner(num_vertices);
+        for (const auto& attr_name : indexed_attribute_names) {
+            LA_ASSERT(mesh.has_indexed_attribute(attr_name));
+            const auto attr = mesh.get_indexed_attribute(attr_name);
+            const auto& attr_values = std::get<0>(attr);
+            const auto& attr_indices = std::get<1>(attr);
+            if (indexed_key_ids.empty()) {
+                // Store corner + 1 so that 0 means "no corner" and atomic max is enough.
+                tbb::parallel_for(Index(0), num_vertices, [&](Index v) {
+                    last_corner[v].store(0, std::memory_order_relaxed);
+                });
+                tbb::parallel_for(Index(0), num_facets, [&](Index f) {
+                    for (Index lv = 0; lv < 3; ++lv) {
+                        const Index c = f * 3 + lv + 1;
+                        auto& slot = last_corner[facets(f, lv)];
+                        Index prev = slot.load(std::memory_order_relaxed);
+                        while (prev < c &&
+                               !slot.compare_exchange_weak(prev, c, std::memory_order_relaxed)) {
+                        }
+                    }
+                });
+            }
+            std::vector<Index> key_ids(num_vertices);
+            tbb::parallel_for(Index(0), num_vertices, [&](Index v) {
+                const Index c = last_corner[v].load(std::memory_order_relaxed);
+                key_ids[v] = (c == 0 ? INVALID<Index>() : attr_indices((c - 1) / 3, (c - 1) % 3));
+            });
+            indexed_keys.push_back(&attr_values);
+            indexed_key_ids.push_back(std::move(key_ids));
+        }
+    }
+
+    auto same_keys = [&](Index i, Index j) {
+        for (const auto* attr : vertex_keys) {
+            if (attr->row(i) != attr->row(j)) return false;
+        }
+        for (size_t k = 0; k < indexed_keys.size(); ++k) {
+            const Index ki = indexed_key_ids[k][i];
+            const Index kj = indexed_key_ids[k][j];
+            if (ki == kj) continue;
+            if (ki == INVALID<Index>() || kj == INVALID<Index>()) return false;
+            if (indexed_keys[k]->row(ki) != indexed_keys[k]->row(kj)) return false;
+        }
+        return true;
+    };
+
+    const bool exact = (tolerance == 0);
+    const Scalar inv_cell_size = exact ? Scalar(0) : Scalar(1) / tolerance;
+    const Scalar sq_tolerance = tolerance * tolerance;
+    using Cell = std::array<int64_t, max_dim>;
+    auto get_cell = [&](Index v) {
+        Cell cell = {0, 0, 0};
+        for (int d = 0; d < dim; ++d) {
+            cell[d] = static_cast<int64_t>(std::floor(vertices(v, d) * inv_cell_size));
+        }
+        return cell;
+    };
+    auto hash_cell = [&](const Cell& cell) {
+        uint64_t h = 0;
+        for (int d = 0; d < dim; ++d) {
+            h = hash_combine_64(h, static_cast<uint64_t>(cell[d]));
+        }
+        return h;
+    };
+    auto hash_vertex = [&](Index v) {
+        if (!exact) return hash_cell(get_cell(v));
+        uint64_t h = 0;
+        for (int d = 0; d < dim; ++d) {
+            h = hash_combine_64(h, scalar_bits(vertices(v, d)));
+        }
+        return h;
+    };
+
+    // Hash grid: (cell hash, vertex) pairs sorted by hash, then by vertex index.
+    std::vector<std::pair<uint64_t, Index>> grid(num_vertices);
+    tbb::parallel_for(Index(0), num_vertices, [&](Index v) {
+        grid[v] = std::make_pair(hash_vertex(v), v);
+    });
+    tbb::parallel_sort(grid.begin(), grid.end());
+
+    int num_neighbor_cells = 1;
+    if (!exact) {
+        for (int d = 0; d < dim; ++d) num_neighbor_cells *= 3;
+    }
+
+    ConcurrentDisjointSets<Index> vertex_sets(num_vertices);
+    tbb::parallel_for(Index(0), num_vertices, [&](Index i) {
+        const auto pi = vertices.row(i);
+        const Cell cell = exact ? Cell() : get_cell(i);
+        for (int n = 0; n < num_neighbor_cells; ++n) {
+            uint64_t h;
+            if (exact) {
+                h = hash_vertex(i);
+            } else {
+                Cell neighbor = cell;
+                for (int d = 0, code = n; d < dim; ++d, code /= 3) {
+                    neighbor[d] += (code % 3) - 1;
+                }
+                h = hash_cell(neighbor);
+            }
+            auto it = std::lower_bound(grid.begin(), grid.end(), std::make_pair(h, Index(0)));
+            // Only compare against smaller indices: the pair (j, i) is handled when visiting j.
+            for (; it != grid.end() && it->first == h && it->second < i; ++it) {
+                const Index j = it->second;
+                if (exact) {
+                    if (vertices.row(j) != pi || !same_keys(i, j)) continue;
+                    // Exact equality is transitive, merging with the first match is enough.
+                    vertex_sets.merge(i, j);
+                    break;
+                } else if (
+                    (vertices.row(j) - pi).squaredNorm() <= sq_tolerance && same_keys(i, j)) {
+                    vertex_sets.merge(i, j);
+                }
+            }
+        }
+    });
+
+    num_unique_vertices = vertex_sets.extract_disjoint_set_indices(forward_mapping);
+}
+
+template <typename MeshType>
+std::unique_ptr<MeshType> merge_vertices(
+    const MeshType& mesh,
+    typename MeshType::Index num_unique_vertices,
+    const std::vector<typename MeshType::Index>& forward_mapping)
+{
+    if (num_unique_vertices < mesh.get_num_vertices()) {
+        auto mesh2 = reorder_mesh_vertices(mesh, forward_mapping);
+        mesh2 = remove_topologically_degenerate_triangles(*mesh2);
+        return mesh2;
+    } else {
+        LA_ASSERT(num_unique_vertices == mesh.get_num_vertices());
+        auto mesh2 = create_mesh(mesh.get_vertices(), mesh.get_facets());
+        map_attributes(mesh, *mesh2);
+        return mesh2;
+    }
+}
 } // namespace internal
 
 
@@ -139,16 +354,56 @@ std::unique_ptr<MeshType> remove_duplicate_vertices(
 
     LA_ASSERT(safe_cast<Eigen::Index>(forward_mapping.size()) == vertices.rows());
 
-    if (num_unique_vertices < mesh.get_num_vertices()) {
-        auto mesh2 = reorder_mesh_vertices(mesh, forward_mapping);
-        mesh2 = remove_topologically_degenerate_triangles(*mesh2);
-        return mesh2;
-    } else {
-        LA_ASSERT(num_unique_vertices == mesh.get_num_vertices());
-        auto mesh2 = create_mesh(mesh.get_vertices(), mesh.get_facets());
-        map_attributes(mesh, *mesh2);
-        return mesh2;
-    }
+    return internal::merge_vertices(mesh, num_unique_vertices, forward_mapping);
+}
+
+/**
+ * Merge vertices closer than a given tolerance. Two vertices are merged iff they
+ * are within `tolerance` of each other (Euclidean distance) and have exactly the
+ * same attribute values for the specified vertex and indexed attributes. Merging
+ * is transitive: chains of close vertices end up in the same output vertex.
+ *
+ * Unlike the exact version above, this does not sort the vertices. Vertices are
+ * bucketed in a spatial hash grid with cells of size `tolerance`, and each vertex
+ * is compared against the vertices of its neighboring cells in parallel. With a
+ * tolerance of 0, only vertices with bit-exact coordinates (up to the sign of 0)
+ * are merged.
+ *
+ * Output vertices are ordered by the smallest input vertex index they merge.
+ *
+ * @param[in] mesh                    Input triangle mesh.
+ * @param[in] tolerance               Maximum distance between merged vertices.
+ * @param[in] vertex_attribute_names  A vector of vertex attributes that serve as keys.
+ * @param[in] indexed_attribute_names A vector of indexed attributes that serve as keys.
+ *
+ * @return  A new mesh without duplicate vertices.  All attributes are
+ *          transferred to the output mesh.
+ */
+template <typename MeshType>
+std::unique_ptr<MeshType> remove_duplicate_vertices(
+    const MeshType& mesh,
+    typename MeshType::Scalar tolerance,
+    const std::vector<std::string>& vertex_attribute_names = {},
+    const std::vector<std::string>& indexed_attribute_names = {})
+{
+    static_assert(MeshTrait<MeshType>::is_mesh(), "Input type is not Mesh");
+    LA_ASSERT(
+        mesh.get_vertex_per_facet() == 3,
+        std::string("vertex per facet is ") + std::to_string(mesh.get_vertex_per_facet()));
+
+    using Index = typename MeshType::Index;
+
+    std::vector<Index> forward_mapping;
+    Index num_unique_vertices;
+    internal::weld_vertices_hash_grid(
+        mesh,
+        tolerance,
+        vertex_attribute_names,
+        indexed_attribute_names,
+        num_unique_vertices,
+        forward_mapping);
+
+    return internal::merge_vertices(mesh, num_unique_vertices, forward_mapping);
 }
 
 /**
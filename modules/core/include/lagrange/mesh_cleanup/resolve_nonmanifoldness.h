@@ -11,12 +11,15 @@
  */
 #pragma once
 
+#include <algorithm>
+#include <array>
+#include <cstdint>
 #include <memory>
 #include <numeric>
-#include <set>
-#include <unordered_map>
+#include <utility>
 #include <vector>
 
+#include <lagrange/DisjointSets.h>
 #include <lagrange/Mesh.h>
 #include <lagrange/attributes/map_attributes.h>
 #include <lagrange/common.h>
@@ -25,25 +28,59 @@
 #include <lagrange/mesh_cleanup/remove_isolated_vertices.h>
 #include <lagrange/mesh_cleanup/remove_topologically_degenerate_triangles.h>
 #include <lagrange/mesh_cleanup/resolve_vertex_nonmanifoldness.h>
+#include <lagrange/utils/safe_cast.h>
+
+#include <tbb/enumerable_thread_specific.h>
+#include <tbb/parallel_for.h>
 
 
 namespace lagrange {
 
+///
+/// Statistics reported by resolve_nonmanifoldness().
+///
+struct ResolveNonManifoldnessStats
+{
+    /// Number of edges with more than 2 incident facets, or with 2 inconsistently oriented
+    /// incident facets.
+    size_t num_nonmanifold_edges = 0;
+
+    /// Number of facets given their own copy of a non-manifold edge, because they are connected to
+    /// other facets of the same edge through manifold edges.
+    size_t num_detached_facets = 0;
+
+    /// Number of input vertices split between several locally manifold facet components.
+    size_t num_split_vertices = 0;
+
+    /// Number of vertices added, including the ones splitting the rim loops of non-manifold
+    /// vertices, before unused vertices are removed.
+    size_t num_added_vertices = 0;
+};
+
 /**
  * Resolve **all** non-manifold edges and vertices in the mesh.
  *
  * Arguments:
  *   mesh: The input mesh.
+ *   stats: If not null, receives statistics about the resolved elements.
  *
  * Returns:
  *   A mesh same as the input mesh except non-manifold vertices and edges
  *   are pulled apart topologically.
+ *
+ * Note:
+ *   Facets detached from a non-manifold edge are processed by increasing color
+ *   instead of hash map order, so the output is deterministic.  Compared to
+ *   earlier versions, the output topology is the same up to a renumbering of
+ *   the vertices and a reordering of the facets.
  */
 template <typename MeshType>
-std::unique_ptr<MeshType> resolve_nonmanifoldness(MeshType& mesh)
+std::unique_ptr<MeshType> resolve_nonmanifoldness(
+    MeshType& mesh,
+    ResolveNonManifoldnessStats* stats = nullptr)
 {
-    if (!mesh.is_connectivity_initialized()) {
-        mesh.initialize_connectivity();
+    if (!mesh.is_vertex_facet_adjacency_initialized()) {
+        mesh.initialize_vertex_facet_adjacency();
     }
 
     mesh.initialize_edge_data();
@@ -54,6 +91,7 @@ std::unique_ptr<MeshType> resolve_nonmanifoldness(MeshType& mesh)
 
     const Index num_vertices = mesh.get_num_vertices();
     const Index num_facets = mesh.get_num_facets();
+    const Index num_edges = mesh.get_num_edges();
     const Index vertex_per_facet = mesh.get_vertex_per_facet();
     const auto& vertices = mesh.get_vertices();
     const auto& facets = mesh.get_facets();
@@ -78,29 +116,8 @@ std::unique_ptr<MeshType> resolve_nonmanifoldness(MeshType& mesh)
     };
 
     /**
-     * Return true iff facets around an edge are **inconsistently** oriented.
-     * E.g. f0: * [0, 1, 2] and f1: [1, 2, 3], with e=[1, 2]
-     *
-     * @note: This method does not depend on the orientaiton of the edge e.
-     *        This method also assumes the edge `ei` has exactly 2 adjacent
-     *        facets.
-     */
-    auto is_inconsistently_oriented = [&mesh, &get_orientation](const Index ei) -> bool {
-        const auto e = mesh.get_edge_vertices(ei);
-        std::array<bool, 2> orientations;
-        size_t count = 0;
-        mesh.foreach_facets_around_edge(ei, [&](Index fid) {
-            orientations[count] = get_orientation(e[0], e[1], fid);
-            count++;
-        });
-        return orientations[0] == orientations[1];
-    };
-
-    /**
-     * Return true iff f0 and f1 are consistantly oriented with respect to edge
-     * ei.  This is **almost** the same as `is_inconsistently_oriented`.
-     * With `f0` and `f1` specified, this version can work with non-manifold
-     * edges.
+     * Return true iff f0 and f1 are inconsistently oriented with respect to
+     * edge ei.
      */
     auto is_inconsistently_oriented_wrt_facets =
         [&mesh, &get_orientation](const Index ei, const Index f0, const Index f1) {
@@ -112,195 +129,249 @@ std::unique_ptr<MeshType> resolve_nonmanifoldness(MeshType& mesh)
      * Return true iff edge e has more than 2 incident facets or it has
      * exactly 2 incident facet but they are inconsistently oriented.
      */
-    auto is_nonmanifold_edge = [&mesh, &is_inconsistently_oriented](const Index ei) {
+    auto is_nonmanifold_edge = [&](const Index ei) -> bool {
         auto edge_valence = mesh.get_num_facets_around_edge(ei);
         if (edge_valence > 2) return true;
         if (edge_valence <= 1) return false;
-        return is_inconsistently_oriented(ei);
+        std::array<Index, 2> adj_facets;
+        size_t count = 0;
+        mesh.foreach_facets_around_edge(ei, [&](Index fid) { adj_facets[count++] = fid; });
+        return is_inconsistently_oriented_wrt_facets(ei, adj_facets[0], adj_facets[1]);
     };
 
-    // Flood fill color across manifold edges.  The color field split the
-    // facets into locally manifold components.  Edges and vertices adjacent
-    // to multiple colors will be split.
-    constexpr Index BLANK = 0;
-    std::vector<Index> colors(num_facets, BLANK);
-    Index curr_color = 1;
-    for (Index i = 0; i < num_facets; i++) {
-        if (colors[i] != BLANK) continue;
-        std::queue<Index> Q;
-        Q.push(i);
-        colors[i] = curr_color;
-        while (!Q.empty()) {
-            Index curr_fid = Q.front();
-            Q.pop();
-            for (Index j = 0; j < vertex_per_facet; j++) {
-                Index ei = mesh.get_edge(curr_fid, j);
-                if (is_nonmanifold_edge(ei)) continue;
-
-                mesh.foreach_facets_around_edge(ei, [&](Index adj_fid) {
-                    if (colors[adj_fid] == BLANK) {
-                        colors[adj_fid] = curr_color;
-                        Q.push(adj_fid);
-                    }
-                });
-            }
+    // Merge facets across manifold edges.  The color field split the facets
+    // into locally manifold components, numbered from 1 by increasing smallest
+    // facet index.  Edges and vertices adjacent to multiple colors will be
+    // split.
+    std::vector<uint8_t> nonmanifold_edge_flags(num_edges, 0);
+    ConcurrentDisjointSets<Index> components(num_facets);
+    tbb::parallel_for(Index(0), num_edges, [&](Index ei) {
+        if (is_nonmanifold_edge(ei)) {
+            nonmanifold_edge_flags[ei] = 1;
+            return;
         }
-        curr_color++;
-    }
+        Index first_fid = INVALID<Index>();
+        mesh.foreach_facets_around_edge(ei, [&](Index fid) {
+            if (first_fid == INVALID<Index>()) {
+                first_fid = fid;
+            } else {
+                components.merge(first_fid, fid);
+            }
+        });
+    });
+    std::vector<Index> colors;
+    Index curr_color = components.extract_disjoint_set_indices(colors) + 1;
+    tbb::parallel_for(Index(0), num_facets, [&](Index i) { colors[i] += 1; });
 
-    Index vertex_count = num_vertices;
     // Note:
-    // The goal of vertex_map is to split the 1-ring neighborhood of a
+    // The goal of the vertex copies is to split the 1-ring neighborhood of a
     // non-manifold vertex based on the colors of its adjacent facets.  All
-    // adjacent facets sharing the sanme color will share the same copy of
-    // this vertex.
+    // adjacent facets sharing the same color will share the same copy of
+    // this vertex.  The first color seen at a vertex keeps the vertex itself.
     //
-    // To achieve this, I store a color map for each non-manifold vertex,
-    // where vertex_map maps a non-manifold vertex to its color map.
-    // A color map maps specific color to the vertex index after the split.
-    std::unordered_map<Index, std::unordered_map<Index, Index>> vertex_map;
-    // Split non-manifold edges.
-    for (Index i = 0; i < mesh.get_num_edges(); ++i) {
-        const auto e = mesh.get_edge_vertices(i);
-
-        if (!is_nonmanifold_edge(i)) continue;
-        auto itr0 = vertex_map.find(e[0]);
-        auto itr1 = vertex_map.find(e[1]);
+    // Copies created while splitting non-manifold edges are stored in a
+    // linked list per vertex.  Copies created while splitting non-manifold
+    // vertices are stored in a flat array, sorted by vertex and color.
+    struct VertexCopy
+    {
+        Index vertex;
+        Index color;
+        Index index;
+        Index next;
+    };
+    std::vector<VertexCopy> edge_copies;
+    std::vector<Index> first_edge_copy(num_vertices, INVALID<Index>());
+    auto find_edge_copy = [&](Index v, Index c) {
+        Index k = first_edge_copy[v];
+        while (k != INVALID<Index>() && edge_copies[k].color != c) k = edge_copies[k].next;
+        return k;
+    };
+    auto insert_edge_copy = [&](Index v, Index c, Index index) {
+        if (find_edge_copy(v, c) != INVALID<Index>()) return;
+        edge_copies.push_back({v, c, index, first_edge_copy[v]});
+        first_edge_copy[v] = safe_cast<Index>(edge_copies.size() - 1);
+    };
 
-        if (itr0 == vertex_map.end()) {
-            itr0 = vertex_map.insert({e[0], std::unordered_map<Index, Index>()}).first;
-        }
-        if (itr1 == vertex_map.end()) {
-            itr1 = vertex_map.insert({e[1], std::unordered_map<Index, Index>()}).first;
-        }
+    // Split non-manifold edges.  Edges are processed sequentially, since facets
+    // detached from an edge are recolored before the next edge is visited.
+    std::vector<Index> nonmanifold_edges;
+    for (Index i = 0; i < num_edges; ++i) {
+        if (nonmanifold_edge_flags[i]) nonmanifold_edges.push_back(i);
+    }
 
-        auto& color_map_0 = itr0->second;
-        auto& color_map_1 = itr1->second;
+    Index vertex_count = num_vertices;
+    size_t num_detached_facets = 0;
+    std::vector<std::pair<Index, Index>> color_facets;
+    std::vector<std::pair<Index, Index>> detached_groups;
+    for (Index i : nonmanifold_edges) {
+        const auto e = mesh.get_edge_vertices(i);
 
-        std::unordered_map<Index, std::list<Index>> color_count;
+        color_facets.clear();
         mesh.foreach_facets_around_edge(i, [&](Index fid) {
-            const auto c = colors[fid];
-
-            auto c_itr = color_count.find(c);
-            if (c_itr == color_count.end()) {
-                color_count.insert({c, {fid}});
-            } else {
-                c_itr->second.push_back(fid);
-            }
-
-            auto c_itr0 = color_map_0.find(c);
-            if (c_itr0 == color_map_0.end()) {
-                if (color_map_0.size() == 0) {
-                    color_map_0.insert({c, e[0]});
-                } else {
-                    color_map_0.insert({c, vertex_count});
-                    vertex_count++;
-                }
-            }
-
-            auto c_itr1 = color_map_1.find(c);
-            if (c_itr1 == color_map_1.end()) {
-                if (color_map_1.size() == 0) {
-                    color_map_1.insert({c, e[1]});
-                } else {
-                    color_map_1.insert({c, vertex_count});
-                    vertex_count++;
+            const Index c = colors[fid];
+            color_facets.emplace_back(c, fid);
+            for (Index v : e) {
+                if (find_edge_copy(v, c) == INVALID<Index>()) {
+                    const bool first = first_edge_copy[v] == INVALID<Index>();
+                    insert_edge_copy(v, c, first ? v : vertex_count++);
                 }
             }
         });
 
-        for (const auto& entry : color_count) {
+        // Group facets around this edge by color, keeping the traversal order
+        // within each group.
+        std::stable_sort(
+            color_facets.begin(),
+            color_facets.end(),
+            [](const std::pair<Index, Index>& a, const std::pair<Index, Index>& b) {
+                return a.first < b.first;
+            });
+        detached_groups.clear();
+        for (size_t begin = 0, end = 0; begin < color_facets.size(); begin = end) {
+            const Index c = color_facets[begin].first;
+            while (end < color_facets.size() && color_facets[end].first == c) ++end;
+            const size_t group_size = end - begin;
+
             // Corner case 1:
             // Exact two facets share the same color around this edge, but
             // they are inconsistently oriented.  Thus, they needs to be
             // detacted.
-            const bool inconsistent_edge =
-                (entry.second.size() == 2) &&
-                is_inconsistently_oriented_wrt_facets(i, entry.second.front(), entry.second.back());
+            const bool inconsistent_edge = (group_size == 2) &&
+                                           is_inconsistently_oriented_wrt_facets(
+                                               i,
+                                               color_facets[begin].second,
+                                               color_facets[begin + 1].second);
 
             // Corner case 2:
             // Some facets around this non-manifold edge are connected via
             // a chain of manifold edges.  Thus, they have the same color.
             // To resolve this, I am detacching all facets of this color
             // adjacent to this edge.
-            const bool single_comp_nonmanifoldness = entry.second.size() > 2;
+            const bool single_comp_nonmanifoldness = group_size > 2;
 
             if (single_comp_nonmanifoldness || inconsistent_edge) {
-                // Each facet will be reconnect to a newly created edge.
-                // This solution is not ideal, but works.
-                for (const auto fid : entry.second) {
-                    colors[fid] = curr_color;
-                    color_map_0.insert({curr_color, vertex_count});
-                    vertex_count++;
-                    color_map_1.insert({curr_color, vertex_count});
-                    vertex_count++;
-                    curr_color++;
-                }
+                detached_groups.emplace_back(safe_cast<Index>(begin), safe_cast<Index>(end));
             }
         }
-    }
 
-    // Split non-manifold vertices
-    for (Index i = 0; i < num_vertices; i++) {
-        const auto& adj_facets = mesh.get_facets_adjacent_to_vertex(i);
-        std::set<Index> adj_colors;
-        for (auto adj_f : adj_facets) {
-            adj_colors.insert(colors[adj_f]);
+        // Groups are detached by increasing color, so new vertex indices do
+        // not depend on any hashing order.
+        for (const auto& group : detached_groups) {
+            // Each facet will be reconnect to a newly created edge.
+            // This solution is not ideal, but works.
+            for (Index k = group.first; k < group.second; ++k) {
+                colors[color_facets[k].second] = curr_color;
+                insert_edge_copy(e[0], curr_color, vertex_count++);
+                insert_edge_copy(e[1], curr_color, vertex_count++);
+                curr_color++;
+            }
+            num_detached_facets += group.second - group.first;
         }
-        if (adj_colors.size() <= 1) continue;
+    }
 
-        auto itr = vertex_map.find(i);
-        if (itr == vertex_map.end()) {
-            vertex_map.insert({i, {}});
+    // Split non-manifold vertices.  Every color adjacent to a vertex that has
+    // no copy yet is given one, in increasing color order.
+    tbb::enumerable_thread_specific<std::vector<Index>> thread_adj_colors;
+    auto get_adjacent_colors = [&](Index i) -> std::vector<Index>& {
+        auto& adj_colors = thread_adj_colors.local();
+        adj_colors.clear();
+        for (auto adj_f : mesh.get_facets_adjacent_to_vertex(i)) {
+            adj_colors.push_back(colors[adj_f]);
         }
+        std::sort(adj_colors.begin(), adj_colors.end());
+        adj_colors.erase(std::unique(adj_colors.begin(), adj_colors.end()), adj_colors.end());
+        if (adj_colors.size() <= 1) adj_colors.clear();
+        return adj_colors;
+    };
 
-        auto& vi_map = vertex_map[i];
-        for (auto c : adj_colors) {
-            auto c_itr = vi_map.find(c);
-            if (c_itr == vi_map.end()) {
-                if (vi_map.size() == 0) {
-                    vi_map.insert({c, i});
-                } else {
-                    vi_map.insert({c, vertex_count});
-                    vertex_count++;
-                }
-            }
+    std::vector<Index> copy_offsets(num_vertices + 1, 0);
+    std::vector<Index> index_offsets(num_vertices + 1, 0);
+    tbb::parallel_for(Index(0), num_vertices, [&](Index i) {
+        Index num_missing = 0;
+        for (Index c : get_adjacent_colors(i)) {
+            if (find_edge_copy(i, c) == INVALID<Index>()) ++num_missing;
         }
-    }
-
-    VertexArray manifold_vertices(vertex_count, vertices.cols());
-    manifold_vertices.topRows(num_vertices) = vertices;
+        copy_offsets[i + 1] = num_missing;
+        const bool has_copy = first_edge_copy[i] != INVALID<Index>();
+        index_offsets[i + 1] = num_missing > 0 && !has_copy ? num_missing - 1 : num_missing;
+    });
+    std::partial_sum(copy_offsets.begin(), copy_offsets.end(), copy_offsets.begin());
+    std::partial_sum(index_offsets.begin(), index_offsets.end(), index_offsets.begin());
+
+    std::vector<std::pair<Index, Index>> vertex_copies(copy_offsets.back());
+    tbb::parallel_for(Index(0), num_vertices, [&](Index i) {
+        if (copy_offsets[i + 1] == copy_offsets[i]) return;
+        Index k = copy_offsets[i];
+        Index index = vertex_count + index_offsets[i];
+        for (Index c : get_adjacent_colors(i)) {
+            if (find_edge_copy(i, c) != INVALID<Index>()) continue;
+            const bool first = k == copy_offsets[i] && first_edge_copy[i] == INVALID<Index>();
+            vertex_copies[k++] = {c, first ? i : index++};
+        }
+    });
+    vertex_count += index_offsets.back();
 
     std::vector<Index> backward_vertex_map(vertex_count, 0);
     std::iota(backward_vertex_map.begin(), backward_vertex_map.begin() + num_vertices, 0);
-
-    for (const auto& itr : vertex_map) {
-        Index vid = itr.first;
-        for (const auto& itr2 : itr.second) {
-            manifold_vertices.row(itr2.second) = vertices.row(vid);
-            backward_vertex_map[itr2.second] = vid;
-        }
+    for (const auto& copy : edge_copies) {
+        backward_vertex_map[copy.index] = copy.vertex;
     }
+    tbb::parallel_for(Index(0), num_vertices, [&](Index i) {
+        for (Index k = copy_offsets[i]; k < copy_offsets[i + 1]; ++k) {
+            backward_vertex_map[vertex_copies[k].second] = i;
+        }
+    });
+
+    VertexArray manifold_vertices(vertex_count, vertices.cols());
+    manifold_vertices.topRows(num_vertices) = vertices;
+    tbb::parallel_for(num_vertices, vertex_count, [&](Index i) {
+        manifold_vertices.row(i) = vertices.row(backward_vertex_map[i]);
+    });
 
+    // A split vertex is mapped to 0 in facets whose color has no copy of it,
+    // which only happens for degenerate inputs.
     FacetArray manifold_facets = facets;
-    for (Index i = 0; i < num_facets; i++) {
+    tbb::parallel_for(Index(0), num_facets, [&](Index i) {
         const Index c = colors[i];
         for (Index j = 0; j < vertex_per_facet; j++) {
-            const auto& itr = vertex_map.find(manifold_facets(i, j));
-            if (itr != vertex_map.end()) {
-                manifold_facets(i, j) = itr->second[c];
+            const Index v = facets(i, j);
+            const auto copies_begin = vertex_copies.begin() + copy_offsets[v];
+            const auto copies_end = vertex_copies.begin() + copy_offsets[v + 1];
+            if (first_edge_copy[v] == INVALID<Index>() && copies_begin == copies_end) continue;
+            const Index k = find_edge_copy(v, c);
+            if (k != INVALID<Index>()) {
+                manifold_facets(i, j) = edge_copies[k].index;
+                continue;
             }
+            const auto itr = std::lower_bound(
+                copies_begin,
+                copies_end,
+                std::make_pair(c, Index(0)),
+                [](const std::pair<Index, Index>& a, const std::pair<Index, Index>& b) {
+                    return a.first < b.first;
+                });
+            manifold_facets(i, j) = (itr != copies_end && itr->first == c) ? itr->second : 0;
         }
-    }
+    });
 
     auto out_mesh = create_mesh(std::move(manifold_vertices), std::move(manifold_facets));
 
     map_attributes(mesh, *out_mesh, backward_vertex_map);
 
-    out_mesh->initialize_connectivity();
-    out_mesh->initialize_edge_data();
-
     out_mesh = resolve_vertex_nonmanifoldness(*out_mesh);
+    if (stats) {
+        stats->num_nonmanifold_edges = nonmanifold_edges.size();
+        stats->num_detached_facets = num_detached_facets;
+        stats->num_split_vertices = 0;
+        for (Index i = 0; i < num_vertices; ++i) {
+            Index num_copies = copy_offsets[i + 1] - copy_offsets[i];
+            for (Index k = first_edge_copy[i]; k != INVALID<Index>(); k = edge_copies[k].next) {
+                ++num_copies;
+            }
+            if (num_copies > 1) ++stats->num_split_vertices;
+        }
+        stats->num_added_vertices = out_mesh->get_num_vertices() - num_vertices;
+    }
     out_mesh = remove_topologically_degenerate_triangles(*out_mesh);
     out_mesh = remove_duplicate_facets(*out_mesh);
     out_mesh = remove_isolated_vertices(*out_mesh);
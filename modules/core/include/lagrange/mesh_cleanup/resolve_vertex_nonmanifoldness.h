@@ -11,26 +11,111 @@
  */
 #pragma once
 
+#include <algorithm>
+#include <array>
+#include <cassert>
 #include <exception>
-#include <list>
 #include <numeric>
-#include <unordered_map>
+#include <vector>
 
-#include <lagrange/Edge.h>
 #include <lagrange/Logger.h>
 #include <lagrange/Mesh.h>
 #include <lagrange/attributes/map_attributes.h>
-#include <lagrange/chain_edges.h>
 #include <lagrange/common.h>
 #include <lagrange/create_mesh.h>
 #include <lagrange/get_opposite_edge.h>
+#include <lagrange/utils/safe_cast.h>
+
+#include <tbb/enumerable_thread_specific.h>
+#include <tbb/parallel_for.h>
 
 namespace lagrange {
 
+namespace internal {
+
+///
+/// Reusable buffers for chaining the rim edges of a vertex one-ring.
+///
+template <typename Index>
+struct RimChains
+{
+    std::vector<std::array<Index, 2>> edges; ///< Rim edges, in adjacent facet order.
+    std::vector<Index> vertices; ///< Sorted rim vertices.
+    std::vector<Index> next; ///< Successor of each rim vertex, or invalid.
+    std::vector<Index> prev; ///< Predecessor of each rim vertex, or invalid.
+    std::vector<Index> chain; ///< Chain index of each rim vertex, or invalid if never reached.
+
+    /// Local index of a rim vertex.
+    Index local(Index v) const
+    {
+        return safe_cast<Index>(
+            std::lower_bound(vertices.begin(), vertices.end(), v) - vertices.begin());
+    }
+
+    /// Chain index of a rim vertex. Vertices that were never reached belong to the first chain.
+    Index get_chain(Index v) const
+    {
+        const Index c = chain[local(v)];
+        return c == INVALID<Index>() ? 0 : c;
+    }
+
+    ///
+    /// Chains the rim edges of a vertex into simple chains and loops, and returns the number of
+    /// chains. Chains are numbered exactly as the output of chain_edges() on the same edges.
+    ///
+    /// @param[in]  facets      Triangle facets.
+    /// @param[in]  adj_facets  Facets adjacent to the vertex.
+    /// @param[in]  vi          Vertex index.
+    ///
+    template <typename FacetArray, typename NeighborList>
+    Index compute(const FacetArray& facets, const NeighborList& adj_facets, Index vi)
+    {
+        edges.clear();
+        vertices.clear();
+        for (Index fid : adj_facets) {
+            const auto e = get_opposite_edge(facets, fid, vi);
+            edges.push_back({{e[0], e[1]}});
+            vertices.push_back(e[0]);
+            vertices.push_back(e[1]);
+        }
+        std::sort(vertices.begin(), vertices.end());
+        vertices.erase(std::unique(vertices.begin(), vertices.end()), vertices.end());
+        next.assign(vertices.size(), INVALID<Index>());
+        prev.assign(vertices.size(), INVALID<Index>());
+        chain.assign(vertices.size(), INVALID<Index>());
+        for (auto& e : edges) {
+            e = {{local(e[0]), local(e[1])}};
+            next[e[0]] = e[1];
+            prev[e[1]] = e[0];
+        }
+
+        Index num_chains = 0;
+        for (const auto& e : edges) {
+            if (chain[e[0]] != INVALID<Index>()) continue;
+            chain[e[0]] = num_chains;
+            for (Index v = next[e[0]]; v != INVALID<Index>() && chain[v] == INVALID<Index>();
+                 v = next[v]) {
+                chain[v] = num_chains;
+            }
+            for (Index v = prev[e[0]]; v != INVALID<Index>() && chain[v] == INVALID<Index>();
+                 v = prev[v]) {
+                chain[v] = num_chains;
+            }
+            ++num_chains;
+        }
+        return num_chains;
+    }
+};
+
+} // namespace internal
+
 /**
  * Remove nonmanifold vertices topologically by pulling disconnected 1-ring
  * neighborhood apart.
  *
+ * Vertices are processed in parallel. Each additional rim loop of vertex i is
+ * given a new vertex, numbered after the copies of vertices 0 to i-1.
+ *
  * Warning: This function assumes the input mesh contains **no** nonmanifold
  * edges or inconsistently oriented triangles.  If that is not the case,
  * consider using `lagrange::resolve_nonmanifoldness()` instead.
@@ -38,8 +123,8 @@ namespace lagrange {
 template <typename MeshType>
 std::unique_ptr<MeshType> resolve_vertex_nonmanifoldness(MeshType& mesh)
 {
-    if (!mesh.is_connectivity_initialized()) {
-        mesh.initialize_connectivity();
+    if (!mesh.is_vertex_facet_adjacency_initialized()) {
+        mesh.initialize_vertex_facet_adjacency();
     }
     if (mesh.get_vertex_per_facet() != 3) {
         throw std::runtime_error(
@@ -47,7 +132,6 @@ std::unique_ptr<MeshType> resolve_vertex_nonmanifoldness(MeshType& mesh)
     }
 
     using Index = typename MeshType::Index;
-    using Edge = typename MeshType::Edge;
     using VertexArray = typename MeshType::VertexArray;
     using FacetArray = typename MeshType::FacetArray;
 
@@ -55,78 +139,59 @@ std::unique_ptr<MeshType> resolve_vertex_nonmanifoldness(MeshType& mesh)
     const Index num_vertices = mesh.get_num_vertices();
     const auto& vertices = mesh.get_vertices();
     const auto& facets = mesh.get_facets();
+    tbb::enumerable_thread_specific<internal::RimChains<Index>> thread_chains;
 
-    FacetArray out_facets(facets);
-    Index vertex_count = mesh.get_num_vertices();
+    // Count the rim loops of every vertex, and number the vertices added for additional loops.
+    std::vector<Index> offsets(num_vertices + 1, 0);
+    tbb::parallel_for(Index(0), num_vertices, [&](Index i) {
+        const Index num_chains =
+            thread_chains.local().compute(facets, mesh.get_facets_adjacent_to_vertex(i), i);
+        offsets[i + 1] = num_chains > 1 ? num_chains - 1 : 0;
+    });
+    std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+    const Index vertex_count = num_vertices + offsets.back();
 
-    // this is a backward vertex map, we initialize with iota as {0, 1, 2, 3, ...}
-    // later we add elements gradually, since we don't know the final size in advance
-    // This sounds really bad, but in practice there are not many non-manifold vertices,
-    // and because of std::vector's memory allocation strategy, copying will typically
-    // never happen, or at most once.
     std::vector<Index> backward_vertex_map(vertex_count);
-    std::iota(backward_vertex_map.begin(), backward_vertex_map.end(), 0);
+    std::iota(backward_vertex_map.begin(), backward_vertex_map.begin() + num_vertices, 0);
 
-    for (Index i = 0; i < num_vertices; i++) {
+    // Assign a new vertex for each additional rim loop.
+    FacetArray out_facets(facets);
+    tbb::parallel_for(Index(0), num_vertices, [&](Index i) {
+        if (offsets[i + 1] == offsets[i]) return;
         const auto& adj_facets = mesh.get_facets_adjacent_to_vertex(i);
-        std::list<Edge> rim_edges;
+        auto& chains = thread_chains.local();
+        chains.compute(facets, adj_facets, i);
         for (Index fid : adj_facets) {
-            rim_edges.push_back(get_opposite_edge(facets, fid, i));
-        }
-        auto chains = chain_edges<Index>(rim_edges);
-        if (chains.size() > 1) {
-            std::unordered_map<Index, Index> comp_map;
-            Index comp_count = 0;
-            for (const auto& chain : chains) {
-                for (const auto vid : chain) {
-                    comp_map[vid] = comp_count;
-                }
-                comp_count++;
-            }
-
-            // Assign a new vertex for each additional rim loops.
-            for (Index fid : adj_facets) {
-                auto& f = facets.row(fid);
-                for (Index j = 0; j < 3; j++) {
-                    if (f[j] == i) {
-                        const Index next = (j + 1) % 3;
-                        const Index prev = (j + 2) % 3;
-                        assert(comp_map.find(f[next]) != comp_map.end());
-                        assert(comp_map.find(f[prev]) != comp_map.end());
-                        if (comp_map[f[next]] != comp_map[f[prev]]) {
-                            logger().trace("vertex: {}", i);
-                            for (auto fi : adj_facets) {
-                                logger().trace("{}", facets.row(fi));
-                            }
-                            throw std::runtime_error(
-                                "Complex edge loop detected.  Vertex " + std::to_string(i) +
-                                "'s one ring neighborhood must contain nonmanifold_edges!");
-                        }
-                        assert(comp_map[f[next]] == comp_map[f[prev]]);
-                        const Index comp_id = comp_map[f[next]];
-                        if (comp_id > 0) {
-                            const Index new_vertex_index = vertex_count + comp_id - 1;
-                            out_facets(fid, j) = new_vertex_index;
-                            if (safe_cast<Index>(backward_vertex_map.size()) <= new_vertex_index) {
-                                backward_vertex_map.resize(new_vertex_index + 1, INVALID<Index>());
-                            }
-                            backward_vertex_map[new_vertex_index] = i;
-                        }
-                        break;
+            const auto& f = facets.row(fid);
+            for (Index j = 0; j < 3; j++) {
+                if (f[j] != i) continue;
+                const Index comp_id = chains.get_chain(f[(j + 1) % 3]);
+                if (comp_id != chains.get_chain(f[(j + 2) % 3])) {
+                    logger().trace("vertex: {}", i);
+                    for (auto fi : adj_facets) {
+                        logger().trace("{}", facets.row(fi));
                     }
+                    throw std::runtime_error(
+                        "Complex edge loop detected.  Vertex " + std::to_string(i) +
+                        "'s one ring neighborhood must contain nonmanifold_edges!");
                 }
+                if (comp_id > 0) {
+                    const Index new_vertex_index = num_vertices + offsets[i] + comp_id - 1;
+                    out_facets(fid, j) = new_vertex_index;
+                    backward_vertex_map[new_vertex_index] = i;
+                }
+                break;
             }
-            vertex_count += safe_cast<Index>(chains.size()) - 1;
         }
-    }
+    });
     assert(out_facets.rows() == 0 || out_facets.maxCoeff() == vertex_count - 1);
 
     // all vertices between 0 and num_vertices are the same, so we can block-copy
     VertexArray out_vertices(vertex_count, dim);
     out_vertices.block(0, 0, num_vertices, dim) = vertices;
-    for (Index i = num_vertices; i < vertex_count; i++) {
+    tbb::parallel_for(num_vertices, vertex_count, [&](Index i) {
         out_vertices.row(i) = vertices.row(backward_vertex_map[i]);
-    }
+    });
 
     auto out_mesh = create_mesh(std::move(out_vertices), std::move(out_facets));
 
@@ -11,9 +11,11 @@
  */
 #pragma once
 
+#include <cmath>
+#include <numeric>
+#include <tuple>
 #include <vector>
 
-#include <lagrange/Edge.h>
 #include <lagrange/Mesh.h>
 #include <lagrange/attributes/attribute_utils.h>
 #include <lagrange/attributes/map_corner_attributes.h>
@@ -23,6 +25,8 @@
 #include <lagrange/mesh_cleanup/split_triangle.h>
 #include <lagrange/utils/safe_cast.h>
 
+#include <tbb/parallel_for.h>
+
 namespace lagrange {
 
 // TODO: Should accept const ref, needs refactor (non-moving export facet attribute)
@@ -32,19 +36,15 @@ split_long_edges(MeshType& mesh, typename MeshType::Scalar sq_tol, bool recursiv
 {
     using Index = typename MeshType::Index;
     using Scalar = typename MeshType::Scalar;
-    using Edge = typename MeshType::Edge;
     if (mesh.get_vertex_per_facet() != 3) {
         throw "Only triangle is supported";
     }
     const Index dim = mesh.get_dim();
     const Index num_vertices = mesh.get_num_vertices();
     const Index num_facets = mesh.get_num_facets();
+    const Index num_corners = num_facets * 3;
     const auto& vertices = mesh.get_vertices();
     const auto& facets = mesh.get_facets();
-    std::vector<typename MeshType::VertexType> additional_vertices;
-    EdgeMap<Index, std::vector<Index>> splitting_pts;
-    EdgeSet<Index> visited;
-    std::vector<std::tuple<Index, Index, Scalar>> vertex_mapping;
 
     typename MeshType::AttributeArray active_facets;
     const bool has_active_region = mesh.has_facet_attribute("__is_active");
@@ -54,115 +54,111 @@ split_long_edges(MeshType& mesh, typename MeshType::Scalar sq_tol, bool recursiv
         active_facets.resize(num_facets, 1);
         active_facets.setZero();
     }
-    auto is_active = [&active_facets](Index fid) { return active_facets(fid, 0) != 0; };
-
-    auto split_edge = [&vertices,
-                       &additional_vertices,
-                       &splitting_pts,
-                       &visited,
-                       sq_tol,
-                       num_vertices,
-                       &vertex_mapping](const Edge& edge) {
-        if (visited.find(edge) != visited.end()) return;
-        visited.insert(edge);
-        if (splitting_pts.find(edge) != splitting_pts.end()) return;
-        Scalar sq_length = (vertices.row(edge[0]) - vertices.row(edge[1])).squaredNorm();
-        if (sq_length <= sq_tol) return;
+    auto is_active = [&](Index fid) { return !has_active_region || active_facets(fid, 0) != 0; };
 
-        const Scalar num_segments = std::ceil(sqrt(sq_length / sq_tol));
-        const auto v0 = vertices.row(edge[0]).eval();
-        const auto v1 = vertices.row(edge[1]).eval();
-        std::vector<Index> split_pts_indices;
-        split_pts_indices.push_back(edge[0]);
-        const Index base = safe_cast<Index>(additional_vertices.size()) + num_vertices;
-        for (Index i = 1; i < num_segments; i++) {
-            Scalar ratio = i / num_segments;
-            additional_vertices.push_back(v0 * (1.0f - ratio) + v1 * ratio);
-            vertex_mapping.emplace_back(edge[0], edge[1], 1.0f - ratio);
-            split_pts_indices.push_back(base + i - 1);
-        }
-        split_pts_indices.push_back(edge[1]);
-        splitting_pts.insert({edge, split_pts_indices});
-    };
+    // Each edge is split from the first corner of an active facet containing it, so that new
+    // vertices are numbered in the order edges are first encountered while visiting facets.
+    mesh.initialize_edge_data();
+    const Index num_edges = mesh.get_num_edges();
+    std::vector<Index> first_corner(num_edges, INVALID<Index>());
+    tbb::parallel_for(Index(0), num_edges, [&](Index e) {
+        mesh.foreach_corners_around_edge(e, [&](Index c) {
+            if (is_active(c / 3) && (first_corner[e] == INVALID<Index>() || c < first_corner[e])) {
+                first_corner[e] = c;
+            }
+        });
+    });
 
-    for (Index i = 0; i < num_facets; i++) {
-        if (has_active_region && !is_active(i)) continue;
-        split_edge({{facets(i, 0), facets(i, 1)}});
-        split_edge({{facets(i, 1), facets(i, 2)}});
-        split_edge({{facets(i, 2), facets(i, 0)}});
-    }
+    // Number of new vertices inserted on the edge starting at each corner, turned into offsets.
+    std::vector<Index> offsets(num_corners + 1, 0);
+    tbb::parallel_for(Index(0), num_corners, [&](Index c) {
+        if (first_corner[mesh.get_edge_from_corner(c)] != c) return;
+        const Index v0 = facets(c / 3, c % 3);
+        const Index v1 = facets(c / 3, (c + 1) % 3);
+        const Scalar sq_length = (vertices.row(v0) - vertices.row(v1)).squaredNorm();
+        if (sq_length <= sq_tol) return;
+        offsets[c + 1] = safe_cast<Index>(std::ceil(sqrt(sq_length / sq_tol))) - 1;
+    });
+    std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
 
     // Concatenate original vertices and additional vertices.
-    const Index total_num_vertices = num_vertices + safe_cast<Index>(additional_vertices.size());
-    LA_ASSERT(vertex_mapping.size() == additional_vertices.size());
+    const Index num_additional_vertices = offsets.back();
+    const Index total_num_vertices = num_vertices + num_additional_vertices;
     typename MeshType::VertexArray all_vertices(total_num_vertices, dim);
-    all_vertices.block(0, 0, num_vertices, dim) = vertices;
-    for (Index i = num_vertices; i < total_num_vertices; i++) {
-        all_vertices.row(i) = additional_vertices[i - num_vertices];
-    }
+    all_vertices.topRows(num_vertices) = vertices;
+    std::vector<std::tuple<Index, Index, Scalar>> vertex_mapping(num_additional_vertices);
+    tbb::parallel_for(Index(0), num_corners, [&](Index c) {
+        const Index num_new = offsets[c + 1] - offsets[c];
+        if (num_new == 0) return;
+        const Index v0 = facets(c / 3, c % 3);
+        const Index v1 = facets(c / 3, (c + 1) % 3);
+        const Scalar num_segments = Scalar(num_new + 1);
+        const auto p0 = vertices.row(v0).eval();
+        const auto p1 = vertices.row(v1).eval();
+        for (Index i = 1; i < num_segments; i++) {
+            const Scalar ratio = i / num_segments;
+            const Index k = offsets[c] + i - 1;
+            all_vertices.row(num_vertices + k) = p0 * (1.0f - ratio) + p1 * ratio;
+            vertex_mapping[k] = std::make_tuple(v0, v1, 1.0f - ratio);
+        }
+    });
 
     // Re-triangulate facets.
-    std::vector<Eigen::Matrix<Index, 3, 1>> out_facets;
-    std::vector<Index> facet_map;
-    for (Index i = 0; i < num_facets; i++) {
-        Index corners[3];
-        std::vector<Index> chain;
-
+    std::vector<std::vector<Eigen::Matrix<Index, 3, 1>>> split_facets(num_facets);
+    std::vector<Index> facet_offsets(num_facets + 1, 0);
+    tbb::parallel_for(Index(0), num_facets, [&](Index i) {
         // Copy over inactive facets.
-        if (has_active_region && !is_active(i)) {
-            LA_ASSERT(facets.row(i).maxCoeff() < total_num_vertices);
-            LA_ASSERT(facets.row(i).minCoeff() >= 0);
-            out_facets.push_back(facets.row(i));
-            facet_map.push_back(i);
-            continue;
+        if (!is_active(i)) {
+            facet_offsets[i + 1] = 1;
+            return;
         }
 
+        Index corners[3];
+        std::vector<Index> chain;
         for (Index j = 0; j < 3; j++) {
-            Edge e{{facets(i, j), facets(i, (j + 1) % 3)}};
+            const Index v0 = facets(i, j);
             corners[j] = safe_cast<Index>(chain.size());
-            chain.push_back(e[0]);
-            auto itr = splitting_pts.find(e);
-            if (itr != splitting_pts.end()) {
-                const auto& pts = itr->second;
-                LA_ASSERT(pts.size() >= 3);
-                if (pts[0] == e[0]) {
-                    auto start = std::next(pts.cbegin());
-                    auto end = std::prev(pts.cend());
-                    chain.insert(chain.end(), start, end);
-                } else {
-                    LA_ASSERT(pts[0] == e[1]);
-                    auto start = std::next(pts.crbegin());
-                    auto end = std::prev(pts.crend());
-                    chain.insert(chain.end(), start, end);
-                }
+            chain.push_back(v0);
+            const Index c = first_corner[mesh.get_edge(i, j)];
+            const Index first = num_vertices + offsets[c];
+            const Index last = num_vertices + offsets[c + 1];
+            if (facets(c / 3, c % 3) == v0) {
+                for (Index v = first; v < last; ++v) chain.push_back(v);
+            } else {
+                LA_ASSERT(facets(c / 3, (c + 1) % 3) == v0);
+                for (Index v = last; v > first; --v) chain.push_back(v - 1);
             }
         }
         if (chain.size() == 3) {
             // No split.
-            LA_ASSERT(facets.row(i).maxCoeff() < total_num_vertices);
-            LA_ASSERT(facets.row(i).minCoeff() >= 0);
-            out_facets.push_back(facets.row(i));
-            facet_map.push_back(i);
+            facet_offsets[i + 1] = 1;
             active_facets(i, 0) = 0;
         } else {
-            auto additional_facets =
+            split_facets[i] =
                 split_triangle(all_vertices, chain, corners[0], corners[1], corners[2]);
-            std::copy(
-                additional_facets.begin(),
-                additional_facets.end(),
-                std::back_inserter(out_facets));
-            facet_map.insert(facet_map.end(), additional_facets.size(), i);
+            facet_offsets[i + 1] = safe_cast<Index>(split_facets[i].size());
             active_facets(i, 0) = 1;
         }
-    }
+    });
+    std::partial_sum(facet_offsets.begin(), facet_offsets.end(), facet_offsets.begin());
 
-    const Index num_out_facets = safe_cast<Index>(out_facets.size());
+    const Index num_out_facets = facet_offsets.back();
     typename MeshType::FacetArray all_facets(num_out_facets, 3);
-    for (Index i = 0; i < num_out_facets; i++) {
-        LA_ASSERT(out_facets[i].minCoeff() >= 0);
-        LA_ASSERT(out_facets[i].maxCoeff() < total_num_vertices);
-        all_facets.row(i) = out_facets[i];
-    }
+    std::vector<Index> facet_map(num_out_facets);
+    tbb::parallel_for(Index(0), num_facets, [&](Index i) {
+        Index fid = facet_offsets[i];
+        if (split_facets[i].empty()) {
+            all_facets.row(fid) = facets.row(i);
+            facet_map[fid] = i;
+        } else {
+            for (const auto& f : split_facets[i]) {
+                all_facets.row(fid) = f.transpose();
+                facet_map[fid++] = i;
+            }
+        }
+    });
+    LA_ASSERT(num_out_facets == 0 || all_facets.minCoeff() >= 0);
+    LA_ASSERT(num_out_facets == 0 || all_facets.maxCoeff() < total_num_vertices);
 
     // Mark active facets (i.e. facets that are split).
     if (has_active_region) {
@@ -228,7 +224,7 @@ split_long_edges(MeshType& mesh, typename MeshType::Scalar sq_tol, bool recursiv
         };
 
         typename MeshType::AttributeArray out_uv(num_out_facets * 3, 2);
-        for (auto i : range(num_out_facets)) {
+        tbb::parallel_for(Index(0), num_out_facets, [&](Index i) {
             const auto old_fid = facet_map[i];
             assert(old_fid < facets.rows());
 
@@ -250,7 +246,7 @@ split_long_edges(MeshType& mesh, typename MeshType::Scalar sq_tol, bool recursiv
                                             uv.row(uv_indices(old_fid, old_j1)) * (1.0f - ratio);
                 }
             }
-        }
+        });
 
         out_mesh->add_corner_attribute("tmp_uv");
         out_mesh->import_corner_attribute("tmp_uv", out_uv);
@@ -11,21 +11,103 @@
  */
 #pragma once
 
-#include <unordered_map>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <vector>
+
+#include <tbb/enumerable_thread_specific.h>
+#include <tbb/parallel_for.h>
 
 #include <lagrange/common.h>
 #include <lagrange/compute_facet_area.h>
 #include <lagrange/utils/la_assert.h>
 #include <lagrange/utils/range.h>
+#include <lagrange/utils/safe_cast.h>
 
 namespace lagrange {
 
+namespace internal {
+
+// Sparse grid of cells, where each occupied cell records the smallest
+// candidate that falls in it. Cells are stored in a fixed-size open
+// addressing hash table, which can be updated concurrently.
+class GridCellClaims
+{
+public:
+    // Creates a table able to hold a given number of distinct cells.
+    explicit GridCellClaims(uint64_t max_num_cells)
+    {
+        size_t num_slots = 16;
+        while (num_slots < 2 * max_num_cells) num_slots *= 2;
+        m_mask = num_slots - 1;
+        m_cells = std::vector<std::atomic<uint64_t>>(num_slots);
+        m_owners = std::vector<std::atomic<uint64_t>>(num_slots);
+        tbb::parallel_for(size_t(0), num_slots, [&](size_t i) {
+            m_cells[i].store(EMPTY, std::memory_order_relaxed);
+            m_owners[i].store(EMPTY, std::memory_order_relaxed);
+        });
+    }
+
+    // Records a candidate in a cell, keeping the smallest candidate.
+    void claim(uint64_t cell, uint64_t candidate)
+    {
+        auto& owner = m_owners[find_or_insert(cell)];
+        uint64_t current = owner.load(std::memory_order_relaxed);
+        while (candidate < current &&
+               !owner.compare_exchange_weak(current, candidate, std::memory_order_relaxed)) {
+        }
+    }
+
+    // Smallest candidate recorded in a cell. Must not be called concurrently with claim().
+    uint64_t get_owner(uint64_t cell) const
+    {
+        for (size_t i = slot(cell);; i = (i + 1) & m_mask) {
+            const uint64_t key = m_cells[i].load(std::memory_order_relaxed);
+            if (key == cell) return m_owners[i].load(std::memory_order_relaxed);
+            if (key == EMPTY) return EMPTY;
+        }
+    }
+
+protected:
+    static constexpr uint64_t EMPTY = std::numeric_limits<uint64_t>::max();
+
+    size_t slot(uint64_t cell) const
+    {
+        return size_t((cell * 0x9E3779B97F4A7C15ull) >> 32) & m_mask;
+    }
+
+    size_t find_or_insert(uint64_t cell)
+    {
+        for (size_t i = slot(cell);; i = (i + 1) & m_mask) {
+            uint64_t key = m_cells[i].load(std::memory_order_relaxed);
+            if (key == EMPTY &&
+                m_cells[i].compare_exchange_strong(key, cell, std::memory_order_relaxed)) {
+                return i;
+            }
+            if (key == cell) return i;
+        }
+    }
+
+protected:
+    std::vector<std::atomic<uint64_t>> m_cells;
+    std::vector<std::atomic<uint64_t>> m_owners;
+    size_t m_mask = 0;
+};
+
+} // namespace internal
+
 // sample_points_on_surface()
 //
 // Samples points on a mesh as uniformly as possible by splitting edges
 // until they are smaller than a certain value and also not sampling more
 // than one point inside a grid.
 //
+// Facets are processed in parallel. The samples do not depend on the number
+// of threads, and are the same as with a sequential traversal of the facets.
+//
 // This is a Lagrangified version of segmentation/PointSample::SampleViaGrid()
 
 // Output values
@@ -72,12 +154,10 @@ SamplePointsOnSurfaceOutput<MeshType> sample_points_on_surface(
     // Helper types
     using Index = typename MeshType::Index;
     using Scalar = typename MeshType::Scalar;
-    using VertexType = typename MeshType::VertexType;
     //
     using Output = SamplePointsOnSurfaceOutput<MeshType>;
     //
     using RowVectorS = Eigen::Matrix<Scalar, 1, Eigen::Dynamic>;
-    using RowVector3S = Eigen::Matrix<Scalar, 1, 3>;
     using RowVectorI = Eigen::Matrix<Index, 1, Eigen::Dynamic>;
     using BoundingBox = Eigen::AlignedBox<Scalar, Eigen::Dynamic>;
 
@@ -133,126 +213,72 @@ SamplePointsOnSurfaceOutput<MeshType> sample_points_on_surface(
     const RowVectorI grid_dims =
         (grid_lens / sampling_length).array().ceil().template cast<Index>();
 
-    // Number of cells in the grid
-    const Index num_grid_cells = grid_dims.prod();
-
-    // Given a 2(3)-D index gives the flattened index of a cell in the grid
-    auto get_flattend_index = [grid_dims, n_dims](const RowVectorI& index_nd) -> Index {
-        // Some debug time assertions
-        assert(index_nd.minCoeff() >= 0);
-        assert((index_nd.array() < grid_dims.array()).all());
-        //
-        Index answer = INVALID<Index>();
-        //
+    // Given a 2(3)-D index gives the flattened index of a cell in the grid.
+    // 64 bit arithmetic is used, so large grids do not overflow.
+    auto get_flattend_index = [&grid_dims, n_dims](const int64_t* index_nd) -> uint64_t {
         if (n_dims == 2) {
-            answer = index_nd(1) * grid_dims(0) + index_nd(0);
+            return uint64_t(index_nd[1] * grid_dims(0) + index_nd[0]);
         } else if (n_dims == 3) {
-            answer = index_nd(2) * grid_dims(1) * grid_dims(0) + index_nd(1) * grid_dims(0) +
-                     index_nd(0);
+            return uint64_t(
+                index_nd[2] * int64_t(grid_dims(1)) * grid_dims(0) + index_nd[1] * grid_dims(0) +
+                index_nd[0]);
         } else {
             LA_ASSERT(0, "This dimension is not supported");
+            return 0;
         }
-        //
-        assert(answer >= 0 && answer < grid_dims.prod());
-        //
-        return answer;
-    };
-
-    // A data structure to indicate if we have already sampled from a cell of the grid
-    // A vector, this can be too memory consuming
-    // std::vector<bool> is_grid_cell_marked_backend(num_grid_cells, false);
-    // Hash map
-    std::unordered_set<Index> is_grid_cell_marked_backend(num_grid_cells);
-    //
-    // A labmda to see if a grid cell is already marked.
-    auto is_grid_cell_marked = [&is_grid_cell_marked_backend](const Index cell_index) {
-        // for a vector
-        // return is_grid_cell_marked_backend[cell_index];
-        // for the hashmap
-        return is_grid_cell_marked_backend.count(cell_index) != 0;
-    };
-    //
-    // A lambda to mark a grid cell
-    auto mark_grid_cell = [&is_grid_cell_marked_backend](const Index cell_index) {
-        // for a vector
-        // is_grid_cell_marked_backend[cell_index] = true;
-        // for hashmap
-        is_grid_cell_marked_backend.insert(cell_index);
     };
 
-
-    // Hold the info about the sample points in a list
-    // once the process is finished move them to the output struct
-    std::list<VertexType> sample_positions;
-    std::list<Index> sample_facet_ids;
-    std::list<RowVector3S> sample_barycentrics;
-    Index num_samples = 0;
-
     //
-    // A queue holding the triangles generated by splitting.
-    // Each triangle is represented by a 3x6 vector.
-    // Each row represents a vertex.
-    // The first three(two) columns represent the positions in the xy(z) space.
-    // The second three columns are the barycentric coordinates of the vertices w.r.t to the
-    // mother triangle (the non splitted one).
+    // Each facet is split into sub-triangles, until they are smaller than
+    // the sampling length. The centroids of the sub-triangles are the sample
+    // candidates. A candidate is kept if it is the first one to fall in its
+    // grid cell, in the order of the active facets and of the splitting
+    // queue within each facet.
     //
-    const Index num_triangle_cols = 3 + n_dims;
-    using Triangle = Eigen::Matrix<Scalar, 3, Eigen::Dynamic>;
-    auto get_triangle_pos = [&n_dims](const Triangle& tri, const Index vert_offset) -> RowVectorS {
-        return tri.row(vert_offset).head(n_dims);
-    };
-    auto get_triangle_bary = [](const Triangle& tri, const Index vert_offset) -> RowVectorS {
-        return tri.row(vert_offset).tail(3);
-    };
-    auto set_triangle_pos =
-        [&n_dims](Triangle& tri, const Index vert_offset, const RowVectorS& v) -> void {
-        tri.row(vert_offset).head(n_dims) = v;
-    };
-    auto set_triangle_bary = [](Triangle& tri,
-                                const Index vert_offset,
-                                const RowVectorS& v) -> void { tri.row(vert_offset).tail(3) = v; };
-    std::queue<Triangle> sub_triangles;
-
+    // Facets are processed in parallel in several passes, which give the
+    // same result as visiting candidates one by one, for any number of
+    // threads:
+    //   1. Count the candidates of each facet, and number candidates in
+    //      sequential order.
+    //   2. For each grid cell, find the smallest candidate number that falls
+    //      in it.
+    //   3. Count the candidates of each facet that won their cell.
+    //   4. Write the winners directly into the output arrays.
     //
-    // Loop over facets
-    // subdivide each facet to the point that you get a triangle smaller
-    // than sampling length. Then get the midpoint of that triangle if
-    // its corresponding grid cell is not marked already.
+    // Each sub-triangle is a 3x6 matrix. Each row represents a vertex. The
+    // first three columns are the position (the last one is zero in 2D), the
+    // last three columns are the barycentric coordinates of the vertex w.r.t.
+    // the mother triangle (the non splitted one).
     //
-    for (auto facet_id : range_facets(mesh, active_facets)) {
-        //
-        // Splitting code follows.
-        // This is done rather inefficiently using a queue. There is no need for that.
-        // If a samaritan with free time was passing by, they can  make it better :).
-        //
+    using Triangle = Eigen::Matrix<Scalar, 3, 6, Eigen::RowMajor | Eigen::DontAlign>;
+    tbb::enumerable_thread_specific<std::vector<Triangle>> thread_sub_triangles;
 
-        // Empty out the queue
-        sub_triangles = std::queue<Triangle>();
+    // Calls func(centroid) for each candidate of a facet, in order. The
+    // centroid has the same layout as the rows of a sub-triangle.
+    using Centroid = Eigen::Matrix<Scalar, 1, 6>;
+    auto foreach_candidate = [&](const Index facet_id, auto func) {
+        auto& sub_triangles = thread_sub_triangles.local();
+        sub_triangles.clear();
 
         // Create the mother triangle
-        Triangle mother_facet = Triangle::Zero(3, num_triangle_cols);
-        set_triangle_pos(mother_facet, 0, vertices.row(facets(facet_id, 0)));
-        set_triangle_pos(mother_facet, 1, vertices.row(facets(facet_id, 1)));
-        set_triangle_pos(mother_facet, 2, vertices.row(facets(facet_id, 2)));
-        set_triangle_bary(mother_facet, 0, RowVector3S(1, 0, 0));
-        set_triangle_bary(mother_facet, 1, RowVector3S(0, 1, 0));
-        set_triangle_bary(mother_facet, 2, RowVector3S(0, 0, 1));
-
-        // Push it to the queue
-        sub_triangles.push(mother_facet);
-
-        // Now process the triagles in the queue
-        while (!sub_triangles.empty()) {
-            const Triangle current_facet = sub_triangles.front();
-            sub_triangles.pop();
+        Triangle mother_facet = Triangle::Zero();
+        for (Index lv : range(3)) {
+            mother_facet.row(lv).head(n_dims) = vertices.row(facets(facet_id, lv));
+            mother_facet(lv, 3 + lv) = 1;
+        }
+        sub_triangles.push_back(mother_facet);
+
+        // Now process the triangles in first-in first-out order
+        for (size_t front = 0; front < sub_triangles.size(); ++front) {
+            const Triangle current_facet = sub_triangles[front];
 
             // Find the longest edge in the triangle
             Scalar longest_edge_length = -std::numeric_limits<Scalar>::max();
             Index longest_edge_offset = INVALID<Index>();
-            for (auto edge_offset : range(3)) {
-                const auto edge_offset_p1 = (edge_offset + 1) % 3;
-                const Scalar edge_length = (get_triangle_pos(current_facet, edge_offset) //
-                                            - get_triangle_pos(current_facet, edge_offset_p1))
+            for (Index edge_offset : range(3)) {
+                const Index edge_offset_p1 = (edge_offset + 1) % 3;
+                const Scalar edge_length = (current_facet.row(edge_offset).head(n_dims) -
+                                            current_facet.row(edge_offset_p1).head(n_dims))
                                                .norm();
                 if (edge_length > longest_edge_length) {
                     longest_edge_length = edge_length;
@@ -262,9 +288,7 @@ SamplePointsOnSurfaceOutput<MeshType> sample_points_on_surface(
 
             // If too big, subdivide
             if (longest_edge_length > 2 * sampling_length) {
-                Triangle f1 = Triangle::Zero(3, num_triangle_cols);
-                Triangle f2 = Triangle::Zero(3, num_triangle_cols);
-                //
+                Triangle f1, f2;
                 f1.row(0) = (current_facet.row(longest_edge_offset) +
                              current_facet.row((longest_edge_offset + 1) % 3)) /
                             2;
@@ -275,66 +299,86 @@ SamplePointsOnSurfaceOutput<MeshType> sample_points_on_surface(
                 f2.row(1) = current_facet.row((longest_edge_offset + 1) % 3);
                 f2.row(2) = current_facet.row((longest_edge_offset + 2) % 3);
                 //
-                sub_triangles.push(f1);
-                sub_triangles.push(f2);
+                sub_triangles.push_back(f1);
+                sub_triangles.push_back(f2);
             } else { // Otherwise, sample the centroid
-                const RowVector3S point_barycentric =
-                    (get_triangle_bary(current_facet, 0) + get_triangle_bary(current_facet, 1) +
-                     get_triangle_bary(current_facet, 2)) /
-                    3.;
-                const VertexType point_position =
-                    (get_triangle_pos(current_facet, 0) + get_triangle_pos(current_facet, 1) +
-                     get_triangle_pos(current_facet, 2)) /
-                    3.;
-
-
-                // Get the corresponding cell in the grid
-                // min() returns column vector, hence the tranpose(), arg...
-                const RowVectorI grid_cell =
-                    ((point_position - bounding_box.min().transpose()) / sampling_length)
-                        .array()
-                        .floor()
-                        .template cast<Index>();
-                const Index grid_cell_id = get_flattend_index(grid_cell);
-
-                if (!is_grid_cell_marked(grid_cell_id)) {
-                    mark_grid_cell(grid_cell_id);
-                    // record sample facet
-                    sample_facet_ids.push_back(facet_id);
-                    // record barycetric (in mother facet)
-                    sample_barycentrics.push_back(point_barycentric);
-                    // record the position
-                    sample_positions.push_back(point_position);
-                    //
-                    ++num_samples;
-                } // end of grid check
-            } // end of size check
-        } //  end of loop over queue
-    } // end of loop over faces
-
-
-    // Now copy the result into the output struct
-    Output output;
-    {
-        output.num_samples = num_samples;
-        //
-        output.barycentrics.resize(num_samples, 3);
-        output.facet_ids.resize(num_samples);
-        output.positions.resize(num_samples, n_dims);
-        //
-        auto it_barycentric = sample_barycentrics.begin();
-        auto it_facet_id = sample_facet_ids.begin();
-        auto it_position = sample_positions.begin();
-        //
-        for (Index i : range(num_samples)) {
-            output.barycentrics.row(i) = *it_barycentric;
-            output.facet_ids[i] = *it_facet_id;
-            output.positions.row(i) = *it_position;
-            ++it_barycentric;
-            ++it_facet_id;
-            ++it_position;
+                const Centroid centroid =
+                    (current_facet.row(0) + current_facet.row(1) + current_facet.row(2)) / 3.;
+                func(centroid);
+            }
         }
-    }
+    };
+
+    // Get the corresponding cell in the grid
+    auto get_grid_cell = [&](const Centroid& point_position) -> uint64_t {
+        int64_t grid_cell[3] = {0, 0, 0};
+        for (Index d : range(n_dims)) {
+            grid_cell[d] = static_cast<Index>(
+                std::floor((point_position(d) - bounding_box.min()(d)) / sampling_length));
+        }
+        return get_flattend_index(grid_cell);
+    };
+
+    const Index num_active_facets =
+        active_facets.empty() ? mesh.get_num_facets() : safe_cast<Index>(active_facets.size());
+    auto get_facet_id = [&](const Index i) { return active_facets.empty() ? i : active_facets[i]; };
+
+    // 1. Count candidates
+    std::vector<uint64_t> candidate_offsets(num_active_facets + 1, 0);
+    tbb::parallel_for(Index(0), num_active_facets, [&](Index i) {
+        uint64_t count = 0;
+        foreach_candidate(get_facet_id(i), [&](const Centroid&) { ++count; });
+        candidate_offsets[i + 1] = count;
+    });
+    std::partial_sum(candidate_offsets.begin(), candidate_offsets.end(), candidate_offsets.begin());
+
+    // 2. Mark the smallest candidate of each occupied grid cell
+    internal::GridCellClaims grid_cell_claims(candidate_offsets.back());
+    std::vector<uint64_t> candidate_cells(candidate_offsets.back());
+    tbb::parallel_for(Index(0), num_active_facets, [&](Index i) {
+        uint64_t candidate = candidate_offsets[i];
+        foreach_candidate(get_facet_id(i), [&](const Centroid& centroid) {
+            candidate_cells[candidate] = get_grid_cell(centroid);
+            grid_cell_claims.claim(candidate_cells[candidate], candidate);
+            ++candidate;
+        });
+    });
+
+    // 3. Count samples
+    auto is_sample = [&](const uint64_t candidate) {
+        return grid_cell_claims.get_owner(candidate_cells[candidate]) == candidate;
+    };
+    std::vector<Index> sample_offsets(num_active_facets + 1, 0);
+    tbb::parallel_for(Index(0), num_active_facets, [&](Index i) {
+        Index count = 0;
+        for (uint64_t c = candidate_offsets[i]; c < candidate_offsets[i + 1]; ++c) {
+            if (is_sample(c)) ++count;
+        }
+        sample_offsets[i + 1] = count;
+    });
+    std::partial_sum(sample_offsets.begin(), sample_offsets.end(), sample_offsets.begin());
+    const Index num_samples = sample_offsets.back();
+
+    // 4. Copy the result into the output struct
+    Output output;
+    output.num_samples = num_samples;
+    output.barycentrics.resize(num_samples, 3);
+    output.facet_ids.resize(num_samples);
+    output.positions.resize(num_samples, n_dims);
+    tbb::parallel_for(Index(0), num_active_facets, [&](Index i) {
+        if (sample_offsets[i + 1] == sample_offsets[i]) return;
+        const Index facet_id = get_facet_id(i);
+        uint64_t candidate = candidate_offsets[i];
+        Index sample = sample_offsets[i];
+        foreach_candidate(facet_id, [&](const Centroid& centroid) {
+            if (is_sample(candidate++)) {
+                output.barycentrics.row(sample) = centroid.template tail<3>();
+                output.facet_ids[sample] = facet_id;
+                output.positions.row(sample) = centroid.head(n_dims);
+                ++sample;
+            }
+        });
+    });
 
     return output;
 }
@@ -91,7 +91,6 @@ std::vector<bool> select_facets_by_normal_similarity(
     using VertexType = typename MeshType::VertexType;
     using Index = typename MeshType::Index;
     using Scalar = typename MeshType::Scalar;
-    using IndexList = typename MeshType::IndexList;
     using AttributeArray = typename MeshType::AttributeArray;
     using Parameters = SelectFacetsByNormalSimilarityParameters<MeshType>;
 
@@ -121,8 +120,8 @@ std::vector<bool> select_facets_by_normal_similarity(
     }
 
     // We need this things
-    if (!mesh.is_connectivity_initialized()) {
-        mesh.initialize_connectivity();
+    if (!mesh.is_facet_facet_adjacency_initialized()) {
+        mesh.initialize_facet_facet_adjacency();
     }
     if (!mesh.has_facet_attribute("normal")) {
         compute_triangle_normal(mesh);
@@ -145,7 +144,7 @@ std::vector<bool> select_facets_by_normal_similarity(
     is_facet_processed[seed_facet_id] = true;
     is_facet_selected[seed_facet_id] = true;
     {
-        const IndexList& facets_adjacent_to_seed = mesh.get_facets_adjacent_to_facet(seed_facet_id);
+        const auto facets_adjacent_to_seed = mesh.get_facets_adjacent_to_facet(seed_facet_id);
         for (Index j = 0; j < static_cast<Index>(facets_adjacent_to_seed.size()); j++) {
             const Index ne_fid = facets_adjacent_to_seed[j];
             const VertexType ne_n = facet_normals.row(ne_fid);
@@ -177,7 +176,7 @@ std::vector<bool> select_facets_by_normal_similarity(
         const VertexType center_n = facet_normals.row(fid);
 
 
-        const IndexList& facets_adjacent_to_candidate = mesh.get_facets_adjacent_to_facet(fid);
+        const auto facets_adjacent_to_candidate = mesh.get_facets_adjacent_to_facet(fid);
         for (Index j = 0; j < static_cast<Index>(facets_adjacent_to_candidate.size()); j++) {
             const Index ne_fid = facets_adjacent_to_candidate[j];
             const VertexType ne_n = facet_normals.row(ne_fid);
@@ -211,7 +210,7 @@ std::vector<bool> select_facets_by_normal_similarity(
             for (Index i = 0; i < mesh.get_num_facets(); i++) {
                 // std::cout << facet_one_ring_faces[i].size() << std::endl;
 
-                const IndexList& facets_adjacent_to_candidate =
+                const auto facets_adjacent_to_candidate =
                     mesh.get_facets_adjacent_to_facet(i);
 
                 if (is_facet_selectable(i) && (facets_adjacent_to_candidate.size() > 2)) {
@@ -0,0 +1,138 @@
+/*
+ * Copyright 2021 Adobe. All rights reserved.
+ * This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain a copy
+ * of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under
+ * the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ * OF ANY KIND, either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+ */
+#pragma once
+
+#include <lagrange/utils/la_assert.h>
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace lagrange {
+
+///
+/// Monotone min-priority queue keyed by non-negative floating point values. Keys are bucketed by
+/// the highest bit in which they differ from the last popped key, so each element is moved at most
+/// once per bit of the key. Keys pushed must be greater or equal to the last popped key, which is
+/// the case for Dijkstra-like traversals with non-negative edge weights.
+///
+/// Calling clear() keeps the memory allocated by the buckets, so a heap can be reused across many
+/// traversals without reallocating.
+///
+/// @tparam     Scalar  Key type (float or double).
+/// @tparam     Value   Value type.
+///
+template <typename Scalar, typename Value>
+class RadixHeap
+{
+public:
+    static_assert(std::is_floating_point<Scalar>::value, "Keys must be floating point values");
+    static_assert(std::numeric_limits<Scalar>::is_iec559, "Keys must be IEEE 754 values");
+
+    using Bits = typename std::conditional<sizeof(Scalar) == 4, uint32_t, uint64_t>::type;
+    static_assert(sizeof(Bits) == sizeof(Scalar), "Unsupported key type");
+
+public:
+    bool empty() const { return m_size == 0; }
+
+    size_t size() const { return m_size; }
+
+    ///
+    /// Inserts an element.
+    ///
+    /// @param[in]  key    Non-negative key, greater or equal to the last popped key.
+    /// @param[in]  value  Value.
+    ///
+    void push(Scalar key, const Value& value)
+    {
+        const Bits bits = to_bits(key);
+        LA_ASSERT_DEBUG(key >= 0 && bits >= m_last);
+        m_buckets[bucket_index(bits)].emplace_back(bits, value);
+        ++m_size;
+    }
+
+    ///
+    /// Removes an element with the smallest key.
+    ///
+    /// @return     The removed key and value.
+    ///
+    std::pair<Scalar, Value> pop()
+    {
+        LA_ASSERT_DEBUG(m_size > 0);
+        if (m_buckets[0].empty()) {
+            // Elements of the first non-empty bucket all end up in lower buckets once the
+            // smallest of them becomes the reference key.
+            size_t i = 1;
+            while (m_buckets[i].empty()) ++i;
+            auto& bucket = m_buckets[i];
+            m_last = std::min_element(bucket.begin(), bucket.end())->first;
+            for (const auto& entry : bucket) {
+                m_buckets[bucket_index(entry.first)].push_back(entry);
+            }
+            bucket.clear();
+        }
+        const auto entry = m_buckets[0].back();
+        m_buckets[0].pop_back();
+        --m_size;
+        return {from_bits(entry.first), entry.second};
+    }
+
+    /// Removes all elements, keeping allocated memory.
+    void clear()
+    {
+        for (auto& bucket : m_buckets) bucket.clear();
+        m_last = 0;
+        m_size = 0;
+    }
+
+protected:
+    // Non-negative IEEE 754 values have the same order as their bit patterns.
+    static Bits to_bits(Scalar x)
+    {
+        Bits bits;
+        std::memcpy(&bits, &x, sizeof(Bits));
+        return bits;
+    }
+
+    static Scalar from_bits(Bits bits)
+    {
+        Scalar x;
+        std::memcpy(&x, &bits, sizeof(Bits));
+        return x;
+    }
+
+    // Number of significant bits in which a key differs from the last popped key.
+    size_t bucket_index(Bits bits) const
+    {
+        Bits x = bits ^ m_last;
+        size_t n = 0;
+        for (size_t shift = sizeof(Bits) * 4; shift > 0; shift /= 2) {
+            if (x >> shift) {
+                x >>= shift;
+                n += shift;
+            }
+        }
+        return n + size_t(x);
+    }
+
+protected:
+    std::array<std::vector<std::pair<Bits, Value>>, sizeof(Bits) * 8 + 1> m_buckets;
+    Bits m_last = 0;
+    size_t m_size = 0;
+};
+
+} // namespace lagrange
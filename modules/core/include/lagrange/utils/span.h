@@ -0,0 +1,118 @@
+/*
+ * Copyright 2021 Adobe. All rights reserved.
+ * This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain a copy
+ * of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under
+ * the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ * OF ANY KIND, either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+ */
+#pragma once
+
+#include <lagrange/utils/la_assert.h>
+
+#include <cstddef>
+#include <type_traits>
+#include <vector>
+
+namespace lagrange {
+
+///
+/// Non-owning view over a contiguous sequence of elements. This is a minimal subset of C++20
+/// std::span, restricted to a dynamic extent.
+///
+/// @tparam     T     Element type. Use a const-qualified type for read-only views.
+///
+template <typename T>
+class span
+{
+public:
+    using element_type = T;
+    using value_type = std::remove_cv_t<T>;
+    using size_type = std::size_t;
+    using pointer = T*;
+    using reference = T&;
+    using iterator = T*;
+    using const_iterator = const T*;
+
+public:
+    span() = default;
+
+    span(pointer data, size_type size)
+        : m_data(data)
+        , m_size(size)
+    {}
+
+    span(pointer first, pointer last)
+        : m_data(first)
+        , m_size(static_cast<size_type>(last - first))
+    {}
+
+    template <
+        typename U,
+        typename = std::enable_if_t<std::is_const<T>::value && std::is_same<U, value_type>::value>>
+    span(const std::vector<U>& vec)
+        : m_data(vec.data())
+        , m_size(vec.size())
+    {}
+
+    template <typename U, typename = std::enable_if_t<std::is_same<U, value_type>::value>>
+    span(std::vector<U>& vec)
+        : m_data(vec.data())
+        , m_size(vec.size())
+    {}
+
+    template <
+        typename U,
+        typename = std::enable_if_t<std::is_convertible<U (*)[], T (*)[]>::value>>
+    span(const span<U>& other)
+        : m_data(other.data())
+        , m_size(other.size())
+    {}
+
+    pointer data() const { return m_data; }
+    size_type size() const { return m_size; }
+    bool empty() const { return m_size == 0; }
+
+    iterator begin() const { return m_data; }
+    iterator end() const { return m_data + m_size; }
+
+    reference front() const
+    {
+        LA_ASSERT_DEBUG(m_size > 0);
+        return m_data[0];
+    }
+
+    reference back() const
+    {
+        LA_ASSERT_DEBUG(m_size > 0);
+        return m_data[m_size - 1];
+    }
+
+    reference operator[](size_type i) const
+    {
+        LA_ASSERT_DEBUG(i < m_size);
+        return m_data[i];
+    }
+
+    span subspan(size_type offset, size_type count) const
+    {
+        LA_ASSERT(offset + count <= m_size);
+        return span(m_data + offset, count);
+    }
+
+    ///
+    /// Copies the viewed elements into a new vector.
+    ///
+    /// @return     A vector holding a copy of the elements.
+    ///
+    std::vector<value_type> to_vector() const { return std::vector<value_type>(begin(), end()); }
+
+private:
+    pointer m_data = nullptr;
+    size_type m_size = 0;
+};
+
+} // namespace lagrange
@@ -11,8 +11,10 @@
  */
 #include <iostream>
 
+#include <lagrange/Components.h>
 #include <lagrange/Logger.h>
 #include <lagrange/common.h>
+#include <lagrange/create_mesh.h>
 #include <lagrange/io/load_mesh.h>
 #include <lagrange/utils/timing.h>
 #include <lagrange/Mesh.h>
@@ -25,19 +27,40 @@ int main(int argc, char** argv)
     }
 
     auto mesh = lagrange::io::load_mesh<lagrange::TriangleMesh3D>(argv[1]);
+    lagrange::logger().info(
+        "Mesh: {} vertices, {} facets",
+        mesh->get_num_vertices(),
+        mesh->get_num_facets());
 
+    // BFS over the facet-facet adjacency.
     lagrange::timestamp_type start, mid, finish;
     lagrange::get_timestamp(&start);
-    mesh->initialize_connectivity();
+    mesh->initialize_facet_facet_adjacency();
     lagrange::get_timestamp(&mid);
     mesh->initialize_components();
     lagrange::get_timestamp(&finish);
     double conn_duration = lagrange::timestamp_diff_in_seconds(start, mid);
     double comp_duration = lagrange::timestamp_diff_in_seconds(mid, finish);
+    const auto num_bfs_components = mesh->get_num_components();
 
-    lagrange::logger().info("#Components: {}", mesh->get_num_components());
+    lagrange::logger().info("#Components: {}", num_bfs_components);
     lagrange::logger().info("Connectivity computation: {}s", conn_duration);
-    lagrange::logger().info("Components computation: {}s", comp_duration);
+    lagrange::logger().info("Components computation (BFS): {}s", comp_duration);
+    lagrange::logger().info("Total (BFS): {}s", conn_duration + comp_duration);
+
+    // Parallel union-find directly on the facet array.
+    auto uf_mesh = lagrange::create_mesh(mesh->get_vertices(), mesh->get_facets());
+    for (auto type : {lagrange::ConnectivityType::Vertex, lagrange::ConnectivityType::Edge}) {
+        const char* name = (type == lagrange::ConnectivityType::Vertex ? "vertex" : "edge");
+        lagrange::get_timestamp(&start);
+        uf_mesh->initialize_components(type);
+        lagrange::get_timestamp(&finish);
+        lagrange::logger().info(
+            "Components computation (union-find, {}): {}s, #Components: {}",
+            name,
+            lagrange::timestamp_diff_in_seconds(start, finish),
+            uf_mesh->get_num_components());
+    }
 
     return 0;
 }
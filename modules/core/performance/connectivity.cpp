@@ -9,29 +9,158 @@
  * OF ANY KIND, either express or implied. See the License for the specific language
  * governing permissions and limitations under the License.
  */
+#include <algorithm>
 #include <iostream>
+#include <string>
+#include <vector>
 
 #include <lagrange/common.h>
+#include <lagrange/create_mesh.h>
 #include <lagrange/io/load_mesh.h>
 #include <lagrange/utils/timing.h>
 #include <lagrange/Mesh.h>
 
+#ifdef _WIN32
+// clang-format off
+#include <windows.h>
+#include <psapi.h>
+// clang-format on
+#else
+#include <sys/resource.h>
+#endif
+
+namespace {
+
+// Peak resident set size of the process, in MB.
+double get_peak_rss_in_mb()
+{
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS info;
+    GetProcessMemoryInfo(GetCurrentProcess(), &info, sizeof(info));
+    return double(info.PeakWorkingSetSize) / (1024.0 * 1024.0);
+#else
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+#ifdef __APPLE__
+    return double(usage.ru_maxrss) / (1024.0 * 1024.0);
+#else
+    return double(usage.ru_maxrss) / 1024.0;
+#endif
+#endif
+}
+
+// Reference vector-of-vectors implementation, as used before the CSR layout.
+template <typename MeshType>
+struct LegacyConnectivity
+{
+    using Index = typename MeshType::Index;
+    using IndexList = std::vector<Index>;
+    using AdjacencyList = std::vector<IndexList>;
+
+    AdjacencyList v2v;
+    AdjacencyList v2f;
+    AdjacencyList f2f;
+
+    void initialize(const MeshType& mesh)
+    {
+        auto remove_duplicate_entries = [](IndexList& arr) {
+            std::sort(arr.begin(), arr.end());
+            const auto end_itr = std::unique(arr.begin(), arr.end());
+            arr.resize(std::distance(arr.begin(), end_itr));
+        };
+
+        auto extract_duplicate_entries = [](IndexList& arr) {
+            std::sort(arr.begin(), arr.end());
+            IndexList duplicate_entries;
+            Index curr = arr.back() + 1;
+            for (const auto& item : arr) {
+                if (curr == item &&
+                    (duplicate_entries.empty() || item != duplicate_entries.back())) {
+                    duplicate_entries.push_back(item);
+                } else {
+                    curr = item;
+                }
+            }
+            arr.swap(duplicate_entries);
+        };
+
+        const Index num_vertices = mesh.get_num_vertices();
+        const Index num_facets = mesh.get_num_facets();
+        const Index vertex_per_facet = mesh.get_vertex_per_facet();
+        v2v.resize(num_vertices);
+        v2f.resize(num_vertices);
+        f2f.resize(num_facets);
+        for (auto& arr : v2v) arr.reserve(16);
+        for (auto& arr : v2f) arr.reserve(16);
+        for (auto& arr : f2f) arr.reserve(16);
+
+        const auto& facets = mesh.get_facets();
+        for (Index i = 0; i < num_facets; i++) {
+            for (Index j = 0; j < vertex_per_facet; j++) {
+                Index curr = facets(i, j);
+                Index next = facets(i, (j + 1) % vertex_per_facet);
+                Index prev = facets(i, (j + vertex_per_facet - 1) % vertex_per_facet);
+                v2v[curr].push_back(next);
+                v2v[curr].push_back(prev);
+                v2f[curr].push_back(i);
+            }
+        }
+        std::for_each(v2v.begin(), v2v.end(), remove_duplicate_entries);
+        std::for_each(v2f.begin(), v2f.end(), remove_duplicate_entries);
+
+        for (Index i = 0; i < num_facets; i++) {
+            for (Index j = 0; j < vertex_per_facet; j++) {
+                const auto& adj_facets = v2f[facets(i, j)];
+                f2f[i].insert(f2f[i].end(), adj_facets.begin(), adj_facets.end());
+            }
+        }
+        std::for_each(f2f.begin(), f2f.end(), extract_duplicate_entries);
+        for (Index i = 0; i < num_facets; i++) {
+            f2f[i].erase(std::find(f2f[i].begin(), f2f[i].end(), i));
+        }
+    }
+};
+
+} // namespace
+
 int main(int argc, char** argv)
 {
-    if (argc != 2) {
-        std::cerr << "Usage: " << argv[0] << " input_mesh" << std::endl;
+    if (argc != 2 && argc != 3) {
+        std::cerr << "Usage: " << argv[0] << " input_mesh [csr|legacy|both]" << std::endl;
         return 1;
     }
+    const std::string mode = (argc == 3 ? argv[2] : "both");
 
     auto mesh = lagrange::io::load_mesh<lagrange::TriangleMesh3D>(argv[1]);
+    lagrange::logger().info(
+        "Mesh: {} vertices, {} facets",
+        mesh->get_num_vertices(),
+        mesh->get_num_facets());
+    lagrange::logger().info("Peak RSS after loading: {:.1f} MB", get_peak_rss_in_mb());
 
+    // Peak RSS is monotonic over the lifetime of the process. When running both builds, the CSR
+    // build runs first so the legacy peak reported afterwards includes its own overhead. Run each
+    // mode in a separate process for an exact comparison.
     lagrange::timestamp_type start, finish;
-    lagrange::get_timestamp(&start);
-    mesh->initialize_connectivity();
-    lagrange::get_timestamp(&finish);
-    double duration = lagrange::timestamp_diff_in_seconds(start, finish);
+    if (mode == "csr" || mode == "both") {
+        lagrange::get_timestamp(&start);
+        mesh->initialize_connectivity();
+        lagrange::get_timestamp(&finish);
+        double duration = lagrange::timestamp_diff_in_seconds(start, finish);
+        lagrange::logger().info("Connectivity computation (CSR): {}s", duration);
+        lagrange::logger().info("Peak RSS (CSR): {:.1f} MB", get_peak_rss_in_mb());
+        mesh = lagrange::create_mesh(mesh->get_vertices(), mesh->get_facets());
+    }
 
-    lagrange::logger().info("Connectivity computation: {}s", duration);
+    if (mode == "legacy" || mode == "both") {
+        LegacyConnectivity<lagrange::TriangleMesh3D> legacy;
+        lagrange::get_timestamp(&start);
+        legacy.initialize(*mesh);
+        lagrange::get_timestamp(&finish);
+        double duration = lagrange::timestamp_diff_in_seconds(start, finish);
+        lagrange::logger().info("Connectivity computation (legacy): {}s", duration);
+        lagrange::logger().info("Peak RSS (legacy): {:.1f} MB", get_peak_rss_in_mb());
+    }
 
     return 0;
 }
@@ -9,27 +9,53 @@
  * OF ANY KIND, either express or implied. See the License for the specific language
  * governing permissions and limitations under the License.
  */
+#include <lagrange/DijkstraDistanceEngine.h>
 #include <lagrange/compute_dijkstra_distance.h>
 #include <lagrange/io/load_mesh.h>
 #include <lagrange/utils/timing.h>
 #include <Eigen/Core>
 
+#include <string>
+#include <vector>
+
 int main(int argc, char** argv)
 {
-    if (argc != 3) {
-        std::cerr << "Usage: " << argv[0] << " mesh radius" << std::endl;
+    if (argc != 3 && argc != 4) {
+        std::cerr << "Usage: " << argv[0] << " mesh radius [single|batch]" << std::endl;
         return -1;
     }
 
-    auto mesh = lagrange::io::load_mesh<lagrange::TriangleMesh3D>(argv[1]);
+    using MeshType = lagrange::TriangleMesh3D;
+    using Engine = lagrange::DijkstraDistanceEngine<MeshType>;
+    auto mesh = lagrange::io::load_mesh<MeshType>(argv[1]);
     const double radius = atof(argv[2]);
+    const std::string mode = argc == 4 ? argv[3] : "single";
     // const size_t num_facets = mesh->get_num_facets();
     const int num_runs = 100;
 
     lagrange::timestamp_type t0, t1;
     lagrange::get_timestamp(&t0);
-    for (int i = 0; i < num_runs; i++) {
-        lagrange::compute_dijkstra_distance(*mesh, i, {0.3, 0.3, 0.4}, radius);
+    if (mode == "single") {
+        for (int i = 0; i < num_runs; i++) {
+            lagrange::compute_dijkstra_distance(*mesh, i, {0.3, 0.3, 0.4}, radius);
+        }
+    } else if (mode == "batch") {
+        // Independent single-seed queries, run in parallel with sparse outputs.
+        std::vector<std::vector<Engine::Seed>> queries(num_runs);
+        for (int i = 0; i < num_runs; i++) {
+            queries[i] = {{i, {0.3, 0.3, 0.4}}};
+        }
+        Engine engine(*mesh);
+        std::vector<size_t> num_reached(num_runs);
+        engine.compute_batch(
+            queries,
+            radius,
+            [&](size_t q, const std::vector<Engine::Reached>& reached) {
+                num_reached[q] = reached.size();
+            });
+    } else {
+        std::cerr << "Unknown mode: " << mode << std::endl;
+        return -1;
     }
     lagrange::get_timestamp(&t1);
 
@@ -0,0 +1,147 @@
+/*
+ * Copyright 2021 Adobe. All rights reserved.
+ * This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain a copy
+ * of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under
+ * the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ * OF ANY KIND, either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+ */
+#include <iostream>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+
+#include <lagrange/Edge.h>
+#include <lagrange/Mesh.h>
+#include <lagrange/common.h>
+#include <lagrange/create_mesh.h>
+#include <lagrange/io/load_mesh.h>
+#include <lagrange/mesh_cleanup/remove_degenerate_triangles.h>
+#include <lagrange/utils/timing.h>
+
+#include <tbb/parallel_for.h>
+
+// Times EdgeMap and EdgeSet against the std::unordered_map/set they replaced, on the edges of the
+// same input, then the code paths that go through them.
+
+namespace {
+
+// Runs a function and logs its running time.
+template <typename Func>
+void timed(const std::string& name, Func func)
+{
+    lagrange::timestamp_type start, finish;
+    lagrange::get_timestamp(&start);
+    func();
+    lagrange::get_timestamp(&finish);
+    lagrange::logger().info("{}: {}s", name, lagrange::timestamp_diff_in_seconds(start, finish));
+}
+
+// Inserts every facet edge in a map, numbering edges by first occurrence, then looks them up.
+template <typename MapType>
+size_t count_edges(const lagrange::TriangleMesh3D& mesh, MapType& map)
+{
+    using Index = lagrange::TriangleMesh3D::Index;
+    const auto& facets = mesh.get_facets();
+    for (Index f = 0; f < mesh.get_num_facets(); ++f) {
+        for (Index lv = 0; lv < 3; ++lv) {
+            const lagrange::EdgeType<Index> e(facets(f, lv), facets(f, (lv + 1) % 3));
+            map.insert({e, Index(map.size())});
+        }
+    }
+    size_t checksum = 0;
+    for (Index f = 0; f < mesh.get_num_facets(); ++f) {
+        for (Index lv = 0; lv < 3; ++lv) {
+            const lagrange::EdgeType<Index> e(facets(f, (lv + 1) % 3), facets(f, lv));
+            checksum += map.find(e)->second;
+        }
+    }
+    return checksum;
+}
+
+// Inserts every facet edge in a set.
+template <typename SetType>
+size_t count_unique_edges(const lagrange::TriangleMesh3D& mesh, SetType& set)
+{
+    using Index = lagrange::TriangleMesh3D::Index;
+    const auto& facets = mesh.get_facets();
+    for (Index f = 0; f < mesh.get_num_facets(); ++f) {
+        for (Index lv = 0; lv < 3; ++lv) {
+            set.insert(lagrange::EdgeType<Index>(facets(f, lv), facets(f, (lv + 1) % 3)));
+        }
+    }
+    return set.size();
+}
+
+// Makes one facet out of `stride` degenerate by moving its last vertex onto its first one, so that
+// remove_degenerate_triangles() has edges to split. A midpoint would not be exactly collinear.
+void add_degenerate_facets(lagrange::TriangleMesh3D& mesh, int stride)
+{
+    using Index = lagrange::TriangleMesh3D::Index;
+    auto vertices = mesh.get_vertices();
+    const auto& facets = mesh.get_facets();
+    for (Index f = 0; f < mesh.get_num_facets(); f += stride) {
+        vertices.row(facets(f, 2)) = vertices.row(facets(f, 0));
+    }
+    mesh.import_vertices(vertices);
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    using namespace lagrange;
+    using MeshType = TriangleMesh3D;
+    using Index = MeshType::Index;
+
+    if (argc < 2) {
+        std::cerr << "Usage: " << argv[0] << " input_mesh" << std::endl;
+        return 1;
+    }
+    auto mesh = io::load_mesh<MeshType>(argv[1]);
+    logger().info(
+        "Mesh: {} vertices, {} facets",
+        mesh->get_num_vertices(),
+        mesh->get_num_facets());
+
+    timed("EdgeMap insert + find", [&]() {
+        EdgeMap<Index, Index> map;
+        const size_t checksum = count_edges(*mesh, map);
+        logger().info("{} edges, checksum {}", map.size(), checksum);
+    });
+    timed("std::unordered_map insert + find", [&]() {
+        std::unordered_map<EdgeType<Index>, Index> map;
+        const size_t checksum = count_edges(*mesh, map);
+        logger().info("{} edges, checksum {}", map.size(), checksum);
+    });
+
+    timed("EdgeSet insert", [&]() {
+        EdgeSet<Index> set;
+        logger().info("{} edges", count_unique_edges(*mesh, set));
+    });
+    timed("std::unordered_set insert", [&]() {
+        std::unordered_set<EdgeType<Index>> set;
+        logger().info("{} edges", count_unique_edges(*mesh, set));
+    });
+
+    auto degenerate = create_mesh(mesh->get_vertices(), mesh->get_facets());
+    add_degenerate_facets(*degenerate, 100);
+    timed("remove_degenerate_triangles", [&]() {
+        auto out = remove_degenerate_triangles(*degenerate);
+        logger().info("{} facets after removing degeneracies", out->get_num_facets());
+    });
+
+    timed("ConcurrentFlatEdgeSet parallel insert", [&]() {
+        const auto& facets = mesh->get_facets();
+        ConcurrentFlatEdgeSet<Index> set(3 * facets.rows());
+        tbb::parallel_for(Index(0), mesh->get_num_facets(), [&](Index f) {
+            for (Index lv = 0; lv < 3; ++lv) set.insert(facets(f, lv), facets(f, (lv + 1) % 3));
+        });
+        logger().info("{} edges", set.size());
+    });
+
+    return 0;
+}
@@ -14,7 +14,11 @@
 #include <lagrange/io/load_mesh.h>
 #include <lagrange/utils/range.h>
 #include <lagrange/utils/timing.h>
+#include <algorithm>
 #include <iostream>
+#include <numeric>
+#include <random>
+#include <vector>
 
 #ifndef EIGEN_VECTORIZE
 #warning "Vectorization is disabled"
@@ -44,6 +48,71 @@ auto compute_centroids(
     return lagrange::timestamp_diff_in_seconds(start, end) / N;
 }
 
+template <typename Func>
+double time_average(Func func)
+{
+    constexpr int N = 10;
+    auto start = lagrange::get_timestamp();
+    for (int j = 0; j < N; j++) {
+        func();
+    }
+    auto end = lagrange::get_timestamp();
+    return lagrange::timestamp_diff_in_seconds(start, end) / N;
+}
+
+// Compares row slicing through std::function callbacks, compile-time functors, precomputed
+// mappings and a raw Eigen gather.
+template <typename DerivedV>
+void compare_row_slices(const Eigen::MatrixBase<DerivedV>& vertices)
+{
+    using namespace lagrange::experimental;
+    using Index = Eigen::Index;
+    using WeightList = std::vector<std::pair<Index, double>>;
+    using EigenType = RowSliceType<DerivedV>;
+
+    const Index num_rows = vertices.rows();
+    std::vector<Index> permutation(num_rows);
+    std::iota(permutation.begin(), permutation.end(), 0);
+    std::shuffle(permutation.begin(), permutation.end(), std::mt19937(0));
+
+    auto array = create_array(vertices);
+    auto index_fn = [&](Index i) { return permutation[i]; };
+    auto weighted_fn = [&](Index i, WeightList& weights) {
+        weights.clear();
+        weights.emplace_back(permutation[i], 0.5);
+        weights.emplace_back(permutation[(i + 1) % num_rows], 0.5);
+    };
+
+    // Every variant allocates its output.
+    std::unique_ptr<ArrayBase> sliced;
+    EigenType gathered;
+    auto t1 = time_average(
+        [&]() { sliced = array->row_slice(num_rows, ArrayBase::IndexFunction(index_fn)); });
+    std::cout << "Index row_slice (std::function): " << t1 << "s" << std::endl;
+    auto t2 = time_average([&]() { sliced = array->row_slice(num_rows, index_fn); });
+    std::cout << "Index row_slice (functor): " << t2 << "s" << std::endl;
+    auto t3 = time_average([&]() { gathered = row_gather(vertices, num_rows, index_fn); });
+    std::cout << "Index row_gather (functor): " << t3 << "s" << std::endl;
+    auto t4 = time_average([&]() {
+        EigenType out(num_rows, vertices.cols());
+        for (Index i = 0; i < num_rows; ++i) {
+            out.row(i) = vertices.row(permutation[i]);
+        }
+        gathered = std::move(out);
+    });
+    std::cout << "Index gather (raw Eigen loop): " << t4 << "s" << std::endl;
+
+    auto t5 = time_average([&]() {
+        sliced = array->row_slice(num_rows, ArrayBase::WeightedIndexFunction(weighted_fn));
+    });
+    std::cout << "Weighted row_slice (std::function): " << t5 << "s" << std::endl;
+    auto t6 = time_average([&]() { sliced = array->row_slice(num_rows, weighted_fn); });
+    std::cout << "Weighted row_slice (functor): " << t6 << "s" << std::endl;
+    const auto weights = make_row_mapping(num_rows, weighted_fn);
+    auto t7 = time_average([&]() { gathered = row_gather(vertices, weights); });
+    std::cout << "Weighted row_gather (precomputed RowWeights): " << t7 << "s" << std::endl;
+}
+
 int main(int argc, char** argv)
 {
     if (argc != 2) {
@@ -82,6 +151,8 @@ int main(int argc, char** argv)
     std::cout << vertices_view.data() << "\t" << facets_view.data() << std::endl;
     std::cout << "Average duration (Array, unaligned): " << t2 << "s" << std::endl;
 
+    compare_row_slices(vertices);
+
     free(mem);
     return 0;
 }
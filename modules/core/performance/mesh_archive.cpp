@@ -0,0 +1,66 @@
+/*
+ * Copyright 2021 Adobe. All rights reserved.
+ * This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain a copy
+ * of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under
+ * the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ * OF ANY KIND, either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+ */
+#include <iostream>
+#include <string>
+
+#include <lagrange/Mesh.h>
+#include <lagrange/common.h>
+#include <lagrange/io/load_mesh.h>
+#include <lagrange/io/mesh_archive.h>
+#include <lagrange/utils/timing.h>
+
+int main(int argc, char** argv)
+{
+    if (argc != 3) {
+        std::cerr << "Usage: " << argv[0] << " input_mesh output_archive" << std::endl;
+        return 1;
+    }
+
+    lagrange::timestamp_type start, finish;
+    lagrange::get_timestamp(&start);
+    auto mesh = lagrange::io::load_mesh<lagrange::TriangleMesh3D>(argv[1]);
+    lagrange::get_timestamp(&finish);
+    lagrange::logger().info(
+        "Mesh: {} vertices, {} facets",
+        mesh->get_num_vertices(),
+        mesh->get_num_facets());
+    lagrange::logger().info(
+        "Loading input mesh: {}s",
+        lagrange::timestamp_diff_in_seconds(start, finish));
+
+    lagrange::get_timestamp(&start);
+    lagrange::io::save_mesh_archive(argv[2], *mesh);
+    lagrange::get_timestamp(&finish);
+    lagrange::logger().info(
+        "Saving archive: {}s",
+        lagrange::timestamp_diff_in_seconds(start, finish));
+
+    lagrange::get_timestamp(&start);
+    auto loaded = lagrange::io::load_mesh_archive<lagrange::TriangleMesh3D>(argv[2]);
+    lagrange::get_timestamp(&finish);
+    lagrange::logger().info(
+        "Loading archive (copy): {}s",
+        lagrange::timestamp_diff_in_seconds(start, finish));
+
+    lagrange::get_timestamp(&start);
+    auto mapped =
+        lagrange::io::map_mesh_archive<lagrange::Vertices3D, lagrange::Triangles>(argv[2]);
+    lagrange::get_timestamp(&finish);
+    lagrange::logger().info(
+        "Loading archive (mapped): {}s",
+        lagrange::timestamp_diff_in_seconds(start, finish));
+
+    LA_ASSERT(loaded->get_vertices() == mesh->get_vertices());
+    LA_ASSERT(mapped->get_mesh().get_facets() == mesh->get_facets());
+
+    return 0;
+}
@@ -9,15 +9,18 @@
  * OF ANY KIND, either express or implied. See the License for the specific language
  * governing permissions and limitations under the License.
  */
+#include <lagrange/Logger.h>
 #include <lagrange/io/load_mesh.h>
 #include <lagrange/io/save_mesh.h>
 #include <lagrange/mesh_cleanup/remove_duplicate_vertices.h>
+#include <lagrange/utils/timing.h>
 #include <iostream>
+#include <string>
 
 int main(int argc, char** argv)
 {
-    if (argc != 3) {
-        std::cerr << "Usage: " << argv[0] << " input_mesh output_mesh" << std::endl;
+    if (argc != 3 && argc != 4) {
+        std::cerr << "Usage: " << argv[0] << " input_mesh output_mesh [tolerance]" << std::endl;
         return 1;
     }
 
@@ -27,7 +30,9 @@ int main(int argc, char** argv)
     const auto num_vertices = mesh->get_num_vertices();
     const auto num_facets = mesh->get_num_facets();
     const auto& facets = mesh->get_facets();
+    const double tolerance = (argc == 4 ? std::stod(argv[3]) : 0.0);
 
+    std::vector<std::string> keys;
     if (mesh->is_uv_initialized()) {
         const auto& uv = mesh->get_uv();
         const auto& uv_indices = mesh->get_uv_indices();
@@ -39,11 +44,43 @@ int main(int argc, char** argv)
         }
         mesh->add_vertex_attribute("uv");
         mesh->set_vertex_attribute("uv", per_vertex_uv);
-        mesh = lagrange::remove_duplicate_vertices(*mesh, "uv");
-    } else {
-        mesh = lagrange::remove_duplicate_vertices(*mesh);
+        keys.push_back("uv");
     }
 
-    lagrange::io::save_mesh(argv[2], *mesh);
+    lagrange::timestamp_type start, finish;
+    lagrange::get_timestamp(&start);
+    auto sorted_mesh = lagrange::remove_duplicate_vertices(*mesh, keys, {});
+    lagrange::get_timestamp(&finish);
+    const double sort_duration = lagrange::timestamp_diff_in_seconds(start, finish);
+    lagrange::logger().info(
+        "Sort-based (exact): {}s, {} -> {} vertices",
+        sort_duration,
+        num_vertices,
+        sorted_mesh->get_num_vertices());
+
+    lagrange::get_timestamp(&start);
+    auto hashed_mesh = lagrange::remove_duplicate_vertices(*mesh, 0.0, keys, {});
+    lagrange::get_timestamp(&finish);
+    const double hash_duration = lagrange::timestamp_diff_in_seconds(start, finish);
+    lagrange::logger().info(
+        "Hash grid (exact): {}s, {} -> {} vertices, speedup: {:.2f}x",
+        hash_duration,
+        num_vertices,
+        hashed_mesh->get_num_vertices(),
+        sort_duration / hash_duration);
+
+    if (tolerance > 0) {
+        lagrange::get_timestamp(&start);
+        hashed_mesh = lagrange::remove_duplicate_vertices(*mesh, tolerance, keys, {});
+        lagrange::get_timestamp(&finish);
+        lagrange::logger().info(
+            "Hash grid (tolerance {}): {}s, {} -> {} vertices",
+            tolerance,
+            lagrange::timestamp_diff_in_seconds(start, finish),
+            num_vertices,
+            hashed_mesh->get_num_vertices());
+    }
+
+    lagrange::io::save_mesh(argv[2], *hashed_mesh);
     return 0;
 }
@@ -0,0 +1,74 @@
+/*
+ * Copyright 2021 Adobe. All rights reserved.
+ * This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain a copy
+ * of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under
+ * the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ * OF ANY KIND, either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+ */
+#include <algorithm>
+#include <iostream>
+#include <string>
+
+#include <lagrange/Mesh.h>
+#include <lagrange/TriangleBVH.h>
+#include <lagrange/common.h>
+#include <lagrange/io/load_mesh.h>
+#include <lagrange/utils/timing.h>
+
+int main(int argc, char** argv)
+{
+    if (argc < 2) {
+        std::cerr << "Usage: " << argv[0] << " input_mesh [num_queries]" << std::endl;
+        return 1;
+    }
+    const int num_queries = argc > 2 ? std::stoi(argv[2]) : 1000000;
+
+    auto mesh = lagrange::io::load_mesh<lagrange::TriangleMesh3D>(argv[1]);
+    lagrange::logger().info(
+        "Mesh: {} vertices, {} facets",
+        mesh->get_num_vertices(),
+        mesh->get_num_facets());
+
+    using BVH = lagrange::TriangleBVH<double, int>;
+    lagrange::timestamp_type start, finish;
+    lagrange::get_timestamp(&start);
+    BVH bvh(mesh->get_vertices(), mesh->get_facets());
+    lagrange::get_timestamp(&finish);
+    lagrange::logger().info(
+        "Build: {}s, {} nodes",
+        lagrange::timestamp_diff_in_seconds(start, finish),
+        bvh.get_num_nodes());
+
+    // Queries are spread over a box slightly larger than the mesh.
+    const auto box = bvh.get_bounding_box();
+    Eigen::Matrix<double, Eigen::Dynamic, 3, Eigen::RowMajor> points(num_queries, 3);
+    points.setRandom();
+    points = ((points.array() + 1) * 0.6).matrix() * box.sizes().asDiagonal();
+    points.rowwise() += (box.center() - 0.6 * box.sizes()).transpose();
+
+    lagrange::get_timestamp(&start);
+    auto projections = bvh.batch_query(points);
+    lagrange::get_timestamp(&finish);
+    lagrange::logger().info(
+        "Closest point queries: {}s",
+        lagrange::timestamp_diff_in_seconds(start, finish));
+
+    Eigen::Matrix<double, Eigen::Dynamic, 3, Eigen::RowMajor> directions(num_queries, 3);
+    directions.rowwise() = box.center().transpose();
+    directions -= points;
+    lagrange::get_timestamp(&start);
+    auto hits = bvh.batch_intersect_rays(points, directions);
+    lagrange::get_timestamp(&finish);
+    const auto num_hits =
+        std::count_if(hits.begin(), hits.end(), [](const BVH::RayHit& h) { return h.is_hit(); });
+    lagrange::logger().info(
+        "Ray queries: {}s, {} hits",
+        lagrange::timestamp_diff_in_seconds(start, finish),
+        num_hits);
+
+    return 0;
+}
@@ -0,0 +1,88 @@
+/*
+ * Copyright 2020 Adobe. All rights reserved.
+ * This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain a copy
+ * of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under
+ * the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ * OF ANY KIND, either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+ */
+#include <lagrange/Logger.h>
+#include <lagrange/compute_vertex_normal.h>
+#include <lagrange/create_mesh.h>
+#include <lagrange/ui/utils/mesh.h>
+#include <lagrange/ui/utils/mesh.impl.h>
+#include <lagrange/utils/timing.h>
+#include <CLI/CLI.hpp>
+
+namespace ui = lagrange::ui;
+
+// Measures the per-call overhead of the MeshData functions of <lagrange/ui/utils/mesh.h>. The
+// previous dispatch (entt reflection lookup and meta_any boxing on each call) is reproduced with
+// the meta functions that register_mesh_type() still registers.
+int main(int argc, char* argv[])
+{
+    struct
+    {
+        int num_calls = 1000000;
+    } args;
+
+    CLI::App app{argv[0]};
+    app.option_defaults()->always_capture_default();
+    app.add_option("-n,--num-calls", args.num_calls, "Number of calls per measurement.");
+    CLI11_PARSE(app, argc, argv)
+
+    ui::register_mesh_type<lagrange::TriangleMesh3D>();
+
+    auto cube = lagrange::create_cube();
+    lagrange::compute_vertex_normal(*cube);
+
+    ui::Registry registry;
+    const auto e = ui::register_mesh(registry, std::move(cube));
+    const auto& cached = registry.get<ui::MeshData>(e);
+
+    // Same mesh without cached operations, resolved from its type on each call
+    ui::MeshData uncached = cached;
+    uncached.ops = nullptr;
+
+    auto measure = [&](const std::string& name, auto&& fn) {
+        size_t checksum = 0;
+        const auto start = lagrange::get_timestamp();
+        for (int i = 0; i < args.num_calls; i++) {
+            checksum += size_t(fn());
+        }
+        const double elapsed = lagrange::timestamp_diff_in_seconds(start);
+        lagrange::logger().info(
+            "{:<40} {:8.2f} ns/call (checksum {})",
+            name,
+            1e9 * elapsed / args.num_calls,
+            checksum);
+    };
+
+    measure("get_num_vertices: entt meta", [&]() {
+        return entt::resolve(cached.type)
+            .func(entt::hashed_string{"get_num_vertices"})
+            .invoke({}, (const lagrange::MeshBase*)(cached.mesh.get()))
+            .cast<size_t>();
+    });
+    measure("get_num_vertices: type lookup", [&]() { return ui::get_num_vertices(uncached); });
+    measure("get_num_vertices: cached ops", [&]() { return ui::get_num_vertices(cached); });
+
+    const std::string attribute_name = "normal";
+    measure("has_mesh_vertex_attribute: entt meta", [&]() {
+        return entt::resolve(cached.type)
+            .func(entt::hashed_string{"has_mesh_vertex_attribute"})
+            .invoke({}, (const lagrange::MeshBase*)(cached.mesh.get()), attribute_name)
+            .cast<bool>();
+    });
+    measure("has_mesh_vertex_attribute: type lookup", [&]() {
+        return ui::has_mesh_vertex_attribute(uncached, attribute_name);
+    });
+    measure("has_mesh_vertex_attribute: cached ops", [&]() {
+        return ui::has_mesh_vertex_attribute(cached, attribute_name);
+    });
+
+    return 0;
+}
@@ -428,6 +428,58 @@ TEST_CASE("experimental/Array.h", "[array]")
         }
     }
 
+    SECTION("Row slice with compile-time mapping")
+    {
+        Eigen::Matrix<int, Eigen::Dynamic, 2, Eigen::RowMajor> A(5, 2);
+        A << 0, 1, 10, 11, 20, 21, 30, 31, 40, 41;
+        Eigen::Matrix<float, Eigen::Dynamic, 3, Eigen::RowMajor> B(5, 3);
+        B.setRandom();
+
+        auto index_fn = [](Eigen::Index i) { return 4 - i; };
+        auto weighted_fn = [](Eigen::Index i,
+                              std::vector<std::pair<Eigen::Index, double>>& weights) {
+            weights.clear();
+            for (Eigen::Index j = 0; j <= i; ++j) weights.emplace_back(j, 1.0 / (i + 1));
+        };
+
+        auto check = [&](const auto& M) {
+            auto M_array = experimental::create_array(M);
+            using EigenType = std::decay_t<decltype(M)>;
+
+            // Template and std::function overloads give the same result.
+            auto S1 = M_array->row_slice(5, index_fn);
+            auto S2 = M_array->row_slice(5, ArrayBase::IndexFunction(index_fn));
+            REQUIRE(S1->template get<EigenType>() == S2->template get<EigenType>());
+            REQUIRE(S1->template get<EigenType>() == M.colwise().reverse());
+
+            auto W1 = M_array->row_slice(5, weighted_fn);
+            auto W2 = M_array->row_slice(5, ArrayBase::WeightedIndexFunction(weighted_fn));
+            REQUIRE(W1->template get<EigenType>() == W2->template get<EigenType>());
+
+            // Precomputed mappings.
+            auto weights = make_row_mapping(5, weighted_fn);
+            REQUIRE(weights.get_num_rows() == 5);
+            REQUIRE(weights.get_rows(3).size() == 4);
+            REQUIRE(weights.get_weights(3)[0] == Approx(0.25));
+            REQUIRE(row_gather(M, weights) == W1->template get<EigenType>());
+            REQUIRE(row_gather(M, make_row_mapping(5, index_fn)) == M.colwise().reverse());
+
+            // Typed arrays expose the same overloads.
+            EigenArray<EigenType> typed_array(M);
+            auto T1 = typed_array.row_slice(std::vector<int>{4, 3, 2, 1, 0});
+            REQUIRE(T1->template get<EigenType>() == M.colwise().reverse());
+            auto T2 = typed_array.row_slice(5, weighted_fn);
+            REQUIRE(T2->template get<EigenType>() == W1->template get<EigenType>());
+        };
+        check(A);
+        check(B);
+
+        // Integral values are rounded.
+        auto W = row_gather(A, make_row_mapping(5, weighted_fn));
+        REQUIRE(W(1, 0) == 5);
+        REQUIRE(W(2, 1) == 11);
+    }
+
     SECTION("Set with incompatible storage order")
     {
         Eigen::Matrix<int, Eigen::Dynamic, Eigen::Dynamic> M1(2, 2);
@@ -0,0 +1,210 @@
+/*
+ * Copyright 2021 Adobe. All rights reserved.
+ * This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain a copy
+ * of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under
+ * the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ * OF ANY KIND, either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+ */
+#include <lagrange/testing/common.h>
+
+#include <lagrange/DisjointSets.h>
+#include <lagrange/Mesh.h>
+#include <lagrange/common.h>
+#include <lagrange/compute_edge_lengths.h>
+#include <lagrange/create_mesh.h>
+#include <lagrange/mesh_cleanup/MeshCleanupPipeline.h>
+#include <lagrange/mesh_cleanup/remove_duplicate_facets.h>
+#include <lagrange/mesh_cleanup/remove_isolated_vertices.h>
+#include <lagrange/mesh_cleanup/remove_null_area_triangles.h>
+#include <lagrange/mesh_cleanup/remove_short_edges.h>
+#include <lagrange/mesh_cleanup/remove_topologically_degenerate_triangles.h>
+
+#include <algorithm>
+#include <random>
+
+namespace {
+
+using MeshType = lagrange::TriangleMesh3D;
+using Index = MeshType::Index;
+
+// Multi-pass implementation of remove_short_edges(), creating one intermediate mesh per step.
+std::unique_ptr<MeshType> remove_short_edges_reference(const MeshType& in_mesh, double tol)
+{
+    using namespace lagrange;
+    auto mesh = remove_topologically_degenerate_triangles(in_mesh);
+    DisjointSets<Index> clusters(mesh->get_num_vertices());
+    compute_edge_lengths(*mesh);
+    const auto& edge_lengths = mesh->get_edge_attribute("length");
+    for (Index e = 0; e < mesh->get_num_edges(); ++e) {
+        if (edge_lengths(e) <= tol) {
+            const auto edge = mesh->get_edge_vertices(e);
+            clusters.merge(edge[0], edge[1]);
+        }
+    }
+    auto facets = mesh->get_facets();
+    for (Index f = 0; f < facets.rows(); ++f) {
+        for (Index lv = 0; lv < 3; ++lv) facets(f, lv) = clusters.find(facets(f, lv));
+    }
+    auto mesh2 = create_mesh(mesh->get_vertices(), std::move(facets));
+    map_attributes(*mesh, *mesh2);
+    mesh2 = remove_topologically_degenerate_triangles(*mesh2);
+    return remove_isolated_vertices(*mesh2);
+}
+
+// Grid with jittered vertices, a few duplicated and degenerate facets, isolated vertices, and
+// vertex, facet and corner attributes.
+std::unique_ptr<MeshType> create_dirty_grid(int n)
+{
+    using namespace lagrange;
+    std::mt19937 gen(7);
+    std::uniform_real_distribution<double> jitter(-0.45, 0.45);
+    std::uniform_int_distribution<int> pick(0, 2 * n * n - 1);
+
+    Vertices3D vertices((n + 1) * (n + 1) + 3, 3);
+    for (int i = 0; i <= n; ++i) {
+        for (int j = 0; j <= n; ++j) {
+            vertices.row(i * (n + 1) + j) << i + jitter(gen), j + jitter(gen), 0;
+        }
+    }
+    vertices.bottomRows(3).setConstant(-10);
+
+    std::vector<Eigen::RowVector3i> triangles;
+    for (int i = 0; i < n; ++i) {
+        for (int j = 0; j < n; ++j) {
+            const int v0 = i * (n + 1) + j;
+            triangles.emplace_back(v0, v0 + n + 1, v0 + n + 2);
+            triangles.emplace_back(v0, v0 + n + 2, v0 + 1);
+        }
+    }
+    for (int k = 0; k < n; ++k) {
+        const Eigen::RowVector3i t = triangles[pick(gen)];
+        triangles.emplace_back(t(2), t(1), t(0));
+        triangles.emplace_back(t(0), t(0), t(1));
+        triangles.emplace_back(t(0), t(1), t(1) + n + 1);
+    }
+    Triangles facets(triangles.size(), 3);
+    for (size_t f = 0; f < triangles.size(); ++f) facets.row(f) = triangles[f];
+
+    auto mesh = create_mesh(std::move(vertices), std::move(facets));
+    auto index = [](Index n) -> MeshType::AttributeArray {
+        return Eigen::VectorXd::LinSpaced(n, 0, n - 1);
+    };
+    mesh->add_vertex_attribute("index");
+    mesh->import_vertex_attribute("index", index(mesh->get_num_vertices()));
+    mesh->add_facet_attribute("index");
+    mesh->import_facet_attribute("index", index(mesh->get_num_facets()));
+    mesh->add_corner_attribute("index");
+    mesh->import_corner_attribute("index", index(3 * mesh->get_num_facets()));
+    return mesh;
+}
+
+void require_same_mesh(const MeshType& a, const MeshType& b)
+{
+    REQUIRE(a.get_vertices() == b.get_vertices());
+    REQUIRE(a.get_facets() == b.get_facets());
+    REQUIRE(a.get_vertex_attribute("index") == b.get_vertex_attribute("index"));
+    REQUIRE(a.get_facet_attribute("index") == b.get_facet_attribute("index"));
+    REQUIRE(a.get_corner_attribute("index") == b.get_corner_attribute("index"));
+}
+
+// Facets sorted by their sorted vertex indices, to compare meshes up to facet order.
+std::vector<std::array<Index, 3>> sorted_facets(const MeshType& mesh)
+{
+    std::vector<std::array<Index, 3>> result;
+    const auto& facets = mesh.get_facets();
+    for (Index f = 0; f < mesh.get_num_facets(); ++f) {
+        std::array<Index, 3> t = {{facets(f, 0), facets(f, 1), facets(f, 2)}};
+        std::sort(t.begin(), t.end());
+        result.push_back(t);
+    }
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+} // namespace
+
+TEST_CASE("MeshCleanupPipeline", "[mesh_cleanup][pipeline]")
+{
+    using namespace lagrange;
+    using Pipeline = MeshCleanupPipeline<MeshType>;
+    auto mesh = create_dirty_grid(40);
+
+    SECTION("no-op")
+    {
+        auto out = Pipeline(*mesh).finalize();
+        require_same_mesh(*out, *mesh);
+    }
+
+    SECTION("single steps")
+    {
+        require_same_mesh(
+            *Pipeline(*mesh).remove_topologically_degenerate_triangles().finalize(),
+            *remove_topologically_degenerate_triangles(*mesh));
+        require_same_mesh(
+            *Pipeline(*mesh).remove_isolated_vertices().finalize(),
+            *remove_isolated_vertices(*mesh));
+        require_same_mesh(
+            *Pipeline(*mesh).remove_null_area_triangles().finalize(),
+            *remove_null_area_triangles(*mesh));
+    }
+
+    SECTION("short edges")
+    {
+        for (double tol : {0.0, 0.1, 0.3, 0.6}) {
+            auto expected = remove_short_edges_reference(*mesh, tol);
+            auto out = Pipeline(*mesh).remove_short_edges(tol).finalize();
+            require_same_mesh(*out, *expected);
+            require_same_mesh(*remove_short_edges(*mesh, tol), *expected);
+        }
+    }
+
+    SECTION("duplicate facets")
+    {
+        Pipeline pipeline(*mesh);
+        pipeline.remove_topologically_degenerate_triangles().remove_duplicate_facets();
+        auto out = pipeline.finalize();
+        REQUIRE(out->get_num_facets() == pipeline.get_num_facets());
+
+        auto expected =
+            remove_duplicate_facets(*remove_topologically_degenerate_triangles(*mesh));
+        REQUIRE(sorted_facets(*out) == sorted_facets(*expected));
+
+        // First occurrences are kept in their original order and orientation.
+        const auto& facet_index = out->get_facet_attribute("index");
+        for (Index f = 0; f < out->get_num_facets(); ++f) {
+            const Index old_f = safe_cast<Index>(facet_index(f));
+            REQUIRE(out->get_facets().row(f) == mesh->get_facets().row(old_f));
+            if (f > 0) REQUIRE(facet_index(f - 1) < facet_index(f));
+        }
+    }
+
+    SECTION("chained")
+    {
+        auto out = Pipeline(*mesh)
+                       .remove_topologically_degenerate_triangles()
+                       .remove_short_edges(0.3)
+                       .remove_null_area_triangles()
+                       .remove_duplicate_facets()
+                       .remove_isolated_vertices()
+                       .finalize();
+
+        auto expected = remove_short_edges_reference(*mesh, 0.3);
+        expected = remove_null_area_triangles(*expected);
+        expected = remove_duplicate_facets(*expected);
+        expected = remove_isolated_vertices(*expected);
+        REQUIRE(out->get_num_vertices() == expected->get_num_vertices());
+        REQUIRE(sorted_facets(*out).size() == sorted_facets(*expected).size());
+
+        // Attributes follow the surviving elements.
+        const auto& vertex_index = out->get_vertex_attribute("index");
+        for (Index v = 0; v < out->get_num_vertices(); ++v) {
+            REQUIRE(
+                out->get_vertices().row(v) ==
+                mesh->get_vertices().row(safe_cast<Index>(vertex_index(v))));
+        }
+    }
+}
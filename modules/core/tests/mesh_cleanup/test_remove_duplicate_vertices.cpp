@@ -225,3 +225,98 @@ TEST_CASE("RemoveDuplicateVerticesTest", "[duplicate][duplicate_vertices][cleanu
         }
     }
 }
+
+TEST_CASE("RemoveDuplicateVerticesTolerance", "[duplicate][duplicate_vertices][cleanup]")
+{
+    using namespace lagrange;
+
+    SECTION("Same as exact")
+    {
+        // Grid of triangles with every facet owning its own vertices.
+        const int n = 20;
+        Vertices3D vertices(n * n * 6, 3);
+        Triangles facets(n * n * 2, 3);
+        for (int i = 0; i < n; ++i) {
+            for (int j = 0; j < n; ++j) {
+                const int f = (i * n + j) * 2;
+                const int v = f * 3;
+                vertices.row(v + 0) << i, j, 0;
+                vertices.row(v + 1) << i + 1, j, 0;
+                vertices.row(v + 2) << i + 1, j + 1, 0;
+                vertices.row(v + 3) << i, j, 0;
+                vertices.row(v + 4) << i + 1, j + 1, 0;
+                vertices.row(v + 5) << i, j + 1, 0;
+                facets.row(f) << v, v + 1, v + 2;
+                facets.row(f + 1) << v + 3, v + 4, v + 5;
+            }
+        }
+        auto mesh = create_mesh(vertices, facets);
+        mesh->initialize_uv(vertices.leftCols(2).eval(), facets);
+
+        auto expected = remove_duplicate_vertices(*mesh);
+        REQUIRE(expected->get_num_vertices() == (n + 1) * (n + 1));
+
+        for (double tol : {0.0, 1e-3}) {
+            auto mesh2 = remove_duplicate_vertices(*mesh, tol, {}, {"uv"});
+            REQUIRE(mesh2->get_num_vertices() == expected->get_num_vertices());
+            REQUIRE(mesh2->get_num_facets() == expected->get_num_facets());
+            REQUIRE(mesh2->is_uv_initialized());
+            for (auto f : range(mesh2->get_num_facets())) {
+                for (auto k : range(3)) {
+                    REQUIRE(
+                        mesh2->get_vertices().row(mesh2->get_facets()(f, k)) ==
+                        vertices.row(facets(f, k)));
+                }
+            }
+        }
+    }
+
+    SECTION("Near duplicates")
+    {
+        Vertices3D vertices(6, 3);
+        vertices << 0, 0, 0, 1, 0, 0, 0, 1, 0, //
+            1e-6, -1e-6, 0, 1, 1, 0, 1 + 1e-6, 1e-6, 0;
+        Triangles facets(2, 3);
+        facets << 0, 1, 2, 3, 5, 4;
+        auto mesh = create_mesh(vertices, facets);
+
+        auto exact = remove_duplicate_vertices(*mesh, 0.0);
+        REQUIRE(exact->get_num_vertices() == 6);
+
+        auto welded = remove_duplicate_vertices(*mesh, 1e-5);
+        REQUIRE(welded->get_num_vertices() == 4);
+        REQUIRE(welded->get_num_facets() == 2);
+    }
+
+    SECTION("Transitive chain")
+    {
+        // Consecutive points are within tolerance, end points are not.
+        Vertices3D vertices(5, 3);
+        vertices << 0, 0, 0, 0.6, 0, 0, 1.2, 0, 0, 1.8, 0, 0, 0, 5, 0;
+        Triangles facets(1, 3);
+        facets << 0, 3, 4;
+        auto mesh = create_mesh(vertices, facets);
+
+        auto welded = remove_duplicate_vertices(*mesh, 1.0);
+        REQUIRE(welded->get_num_vertices() == 2);
+        // The only facet is now topologically degenerate.
+        REQUIRE(welded->get_num_facets() == 0);
+    }
+
+    SECTION("With keys")
+    {
+        Vertices3D vertices(4, 3);
+        vertices << 0.0, 0.0, 0.0, 1.0, 0.0, 0.0, 0.0, 1.0, 0.0, 0.0, 0.0, 0.0;
+        Triangles facets(2, 3);
+        facets << 0, 1, 2, 2, 1, 3;
+        auto mesh = create_mesh(vertices, facets);
+
+        TriangleMesh3D::AttributeArray keys(4, 1);
+        keys << 0, 1, 2, 3;
+        mesh->add_vertex_attribute("keys");
+        mesh->set_vertex_attribute("keys", keys);
+
+        REQUIRE(remove_duplicate_vertices(*mesh, 0.1, {"keys"})->get_num_vertices() == 4);
+        REQUIRE(remove_duplicate_vertices(*mesh, 0.1)->get_num_vertices() == 3);
+    }
+}
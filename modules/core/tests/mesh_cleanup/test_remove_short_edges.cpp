@@ -13,6 +13,7 @@
 
 #include <lagrange/Mesh.h>
 #include <lagrange/common.h>
+#include <lagrange/compute_edge_lengths.h>
 #include <lagrange/create_mesh.h>
 #include <lagrange/mesh_cleanup/remove_short_edges.h>
 #include <lagrange/mesh_cleanup/split_long_edges.h>
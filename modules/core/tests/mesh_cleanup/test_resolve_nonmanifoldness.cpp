@@ -10,7 +10,11 @@
  * governing permissions and limitations under the License.
  */
 #include <lagrange/testing/common.h>
+#include <algorithm>
 #include <iostream>
+#include <numeric>
+#include <utility>
+#include <vector>
 
 #include <lagrange/common.h>
 #include <lagrange/create_mesh.h>
@@ -142,11 +146,17 @@ TEST_CASE("resolve_manifoldness", "[nonmanifold][Mesh][cleanup]")
         in_mesh->initialize_uv(uv, uv_indices);
         REQUIRE(in_mesh->is_uv_initialized());
 
-        auto out_mesh = lagrange::resolve_nonmanifoldness(*in_mesh);
+        lagrange::ResolveNonManifoldnessStats stats;
+        auto out_mesh = lagrange::resolve_nonmanifoldness(*in_mesh, &stats);
         out_mesh->initialize_topology();
         REQUIRE(out_mesh->get_num_vertices() == 7);
         REQUIRE(out_mesh->is_vertex_manifold());
 
+        REQUIRE(stats.num_nonmanifold_edges == 1);
+        REQUIRE(stats.num_detached_facets == 0);
+        REQUIRE(stats.num_split_vertices == 2);
+        REQUIRE(stats.num_added_vertices == 2);
+
         REQUIRE(out_mesh->is_uv_initialized());
         REQUIRE(out_mesh->get_uv_indices().rows() == out_mesh->get_num_facets());
     }
@@ -237,6 +247,127 @@ TEST_CASE("resolve_manifoldness", "[nonmanifold][Mesh][cleanup]")
     }
 }
 
+namespace {
+
+///
+/// Resolve the non-manifoldness of the given mesh, and return the output facets sorted by source
+/// facet with vertices numbered by first use, along with the source vertex of each output vertex.
+///
+std::pair<std::vector<int>, std::vector<int>> resolve_and_number(
+    const lagrange::TriangleMesh3D::VertexArray& vertices,
+    const lagrange::TriangleMesh3D::FacetArray& facets,
+    lagrange::ResolveNonManifoldnessStats* stats = nullptr)
+{
+    using namespace lagrange;
+    using AttributeArray = TriangleMesh3D::AttributeArray;
+
+    auto in_mesh = create_mesh(vertices, facets);
+    AttributeArray source_vertex(vertices.rows(), 1);
+    std::iota(source_vertex.data(), source_vertex.data() + source_vertex.size(), 0);
+    in_mesh->add_vertex_attribute("source_vertex");
+    in_mesh->import_vertex_attribute("source_vertex", source_vertex);
+    AttributeArray source_facet(facets.rows(), 1);
+    std::iota(source_facet.data(), source_facet.data() + source_facet.size(), 0);
+    in_mesh->add_facet_attribute("source_facet");
+    in_mesh->import_facet_attribute("source_facet", source_facet);
+
+    auto out_mesh = resolve_nonmanifoldness(*in_mesh, stats);
+    out_mesh->initialize_topology();
+    REQUIRE(out_mesh->is_vertex_manifold());
+    REQUIRE(out_mesh->is_edge_manifold());
+
+    const auto& out_facets = out_mesh->get_facets();
+    const auto& out_source_facet = out_mesh->get_facet_attribute("source_facet");
+    const auto& out_source_vertex = out_mesh->get_vertex_attribute("source_vertex");
+    std::vector<int> order(out_facets.rows());
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&](int a, int b) {
+        return out_source_facet(a, 0) < out_source_facet(b, 0);
+    });
+
+    std::vector<int> new_index(out_mesh->get_num_vertices(), -1);
+    std::pair<std::vector<int>, std::vector<int>> result;
+    for (int f : order) {
+        for (int j = 0; j < 3; ++j) {
+            const int v = out_facets(f, j);
+            if (new_index[v] < 0) {
+                new_index[v] = static_cast<int>(result.second.size());
+                result.second.push_back(static_cast<int>(out_source_vertex(v, 0)));
+            }
+            result.first.push_back(new_index[v]);
+        }
+    }
+    return result;
+}
+
+} // namespace
+
+TEST_CASE("resolve_manifoldness_output", "[nonmanifold][Mesh][cleanup]")
+{
+    using namespace lagrange;
+    using VertexArray = TriangleMesh3D::VertexArray;
+    using FacetArray = TriangleMesh3D::FacetArray;
+
+    SECTION("tet with a fin")
+    {
+        // Edge (0, 3) is shared by the tet and the fin, which gets its own copy of the edge
+        VertexArray vertices(5, 3);
+        vertices << 0, 0, 0, 1, 0, 0, 0, 1, 0, 0, 0, 1, -1, 0, 0;
+        FacetArray facets(5, 3);
+        facets << 0, 2, 1, 0, 3, 2, 0, 1, 3, 1, 2, 3, 0, 4, 3;
+
+        const auto result = resolve_and_number(vertices, facets);
+        REQUIRE(result.first == std::vector<int>{0, 1, 2, 0, 3, 1, 0, 2, 3, 2, 1, 3, 4, 5, 6});
+        REQUIRE(result.second == std::vector<int>{0, 2, 1, 3, 0, 4, 3});
+    }
+
+    SECTION("folded strip")
+    {
+        // Facets 0, 1 and 2 around edge (1, 4) are connected through manifold edges, so they
+        // have the same color and are detached from the edge
+        VertexArray vertices(5, 3);
+        vertices << 0, 0, 0, 1, 0, 0, 0, 1, 0, 0, 0, 1, 1, 1, 1;
+        FacetArray facets(5, 3);
+        facets << 4, 1, 0, 4, 3, 1, 4, 2, 1, 2, 4, 0, 0, 1, 3;
+
+        ResolveNonManifoldnessStats stats;
+        const auto result = resolve_and_number(vertices, facets, &stats);
+        REQUIRE(stats.num_nonmanifold_edges == 1);
+        REQUIRE(stats.num_detached_facets == 3);
+        REQUIRE(result.first == std::vector<int>{0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14});
+        REQUIRE(result.second == std::vector<int>{4, 1, 0, 4, 3, 1, 4, 2, 1, 2, 4, 0, 0, 1, 3});
+    }
+
+    SECTION("inconsistent orientation")
+    {
+        // Edge (0, 1) has three facets, and edge (1, 2) joins facets 0 and 3 with inconsistent
+        // orientations. Facets 2 and 3 stay connected through edge (1, 4).
+        VertexArray vertices(6, 3);
+        vertices << 0, 0, 0, 1, 0, 0, 0, 1, 0, 0, 0, 1, 0, -1, 0, 0, 0, -1;
+        FacetArray facets(4, 3);
+        facets << 0, 1, 2, 1, 0, 3, 0, 1, 4, 1, 2, 4;
+
+        ResolveNonManifoldnessStats stats;
+        const auto result = resolve_and_number(vertices, facets, &stats);
+        REQUIRE(stats.num_nonmanifold_edges == 2);
+        REQUIRE(stats.num_detached_facets == 0);
+        REQUIRE(result.first == std::vector<int>{0, 1, 2, 3, 4, 5, 6, 7, 8, 7, 9, 8});
+        REQUIRE(result.second == std::vector<int>{0, 1, 2, 1, 0, 3, 0, 1, 4, 2});
+    }
+
+    SECTION("bowtie")
+    {
+        VertexArray vertices(5, 3);
+        vertices << 0, 0, 0, 1, 0, 0, 1, 1, 0, -1, 0, 0, -1, -1, 0;
+        FacetArray facets(2, 3);
+        facets << 0, 1, 2, 0, 3, 4;
+
+        const auto result = resolve_and_number(vertices, facets);
+        REQUIRE(result.first == std::vector<int>{0, 1, 2, 3, 4, 5});
+        REQUIRE(result.second == std::vector<int>{0, 1, 2, 0, 3, 4});
+    }
+}
+
 TEST_CASE("resolve_manifoldness_slow", "[nonmanifold][Mesh]" LA_SLOW_FLAG LA_CORP_FLAG)
 {
     using namespace lagrange;
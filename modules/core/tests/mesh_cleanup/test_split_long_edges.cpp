@@ -17,6 +17,9 @@
 #include <lagrange/create_mesh.h>
 #include <lagrange/mesh_cleanup/split_long_edges.h>
 
+#include <algorithm>
+#include <cmath>
+
 TEST_CASE("SplitLongEdgesTest", "[split_long_edges][triangle_mesh][cleanup]")
 {
     using namespace lagrange;
@@ -123,3 +126,137 @@ TEST_CASE("SplitLongEdgesTest", "[split_long_edges][triangle_mesh][cleanup]")
         }
     }
 }
+
+TEST_CASE("SplitLongEdgesSphere", "[split_long_edges][triangle_mesh][cleanup]")
+{
+    using namespace lagrange;
+    using MeshType = TriangleMesh3D;
+    using Index = MeshType::Index;
+
+    auto mesh = create_sphere(2);
+    const Index num_vertices = mesh->get_num_vertices();
+    const Index num_facets = mesh->get_num_facets();
+    compute_facet_area(*mesh);
+    const double total_area = mesh->get_facet_attribute("area").sum();
+
+    auto max_sq_edge_length = [](const MeshType& m, const MeshType::AttributeArray* active) {
+        double max_sq_length = 0;
+        for (Index f = 0; f < m.get_num_facets(); ++f) {
+            if (active && (*active)(f, 0) == 0) continue;
+            for (Index lv = 0; lv < 3; ++lv) {
+                max_sq_length = std::max(
+                    max_sq_length,
+                    (m.get_vertices().row(m.get_facets()(f, lv)) -
+                     m.get_vertices().row(m.get_facets()(f, (lv + 1) % 3)))
+                        .squaredNorm());
+            }
+        }
+        return max_sq_length;
+    };
+    const double sq_tol = max_sq_edge_length(*mesh, nullptr) / 10;
+
+    SECTION("recursive")
+    {
+        auto out = split_long_edges(*mesh, sq_tol, true);
+        REQUIRE(max_sq_edge_length(*out, nullptr) <= sq_tol);
+        REQUIRE(out->get_vertices().topRows(num_vertices) == mesh->get_vertices());
+        compute_facet_area(*out);
+        REQUIRE(out->get_facet_attribute("area").sum() == Approx(total_area));
+
+        // Splitting is deterministic.
+        auto other = create_sphere(2);
+        auto out2 = split_long_edges(*other, sq_tol, true);
+        REQUIRE(out2->get_vertices() == out->get_vertices());
+        REQUIRE(out2->get_facets() == out->get_facets());
+    }
+
+    SECTION("active region")
+    {
+        // Only the first half of the facets is active. The other half is copied unchanged.
+        MeshType::AttributeArray active(num_facets, 1);
+        active.setZero();
+        active.topRows(num_facets / 2).setOnes();
+        mesh->add_facet_attribute("__is_active");
+        mesh->import_facet_attribute("__is_active", active);
+        MeshType::AttributeArray index(num_facets, 1);
+        for (Index f = 0; f < num_facets; ++f) index(f, 0) = f;
+        mesh->add_facet_attribute("index");
+        mesh->import_facet_attribute("index", index);
+
+        auto out = split_long_edges(*mesh, sq_tol, true);
+        const auto& out_index = out->get_facet_attribute("index");
+        const auto& out_active = out->get_facet_attribute("__is_active");
+        MeshType::AttributeArray from_active_region(out->get_num_facets(), 1);
+        Index num_copied = 0;
+        for (Index f = 0; f < out->get_num_facets(); ++f) {
+            const Index source = safe_cast<Index>(out_index(f, 0));
+            from_active_region(f, 0) = (source < num_facets / 2);
+            if (source >= num_facets / 2) {
+                REQUIRE(out->get_facets().row(f) == mesh->get_facets().row(source));
+                REQUIRE(out_active(f, 0) == 0);
+                ++num_copied;
+            }
+        }
+        REQUIRE(num_copied == num_facets - num_facets / 2);
+        REQUIRE(out->get_num_facets() > num_facets);
+        REQUIRE(max_sq_edge_length(*out, &from_active_region) <= sq_tol);
+        REQUIRE(max_sq_edge_length(*out, nullptr) > sq_tol);
+    }
+
+    SECTION("uv")
+    {
+        // Perturbed sphere with one UV chart per facet, so that every edge is a UV seam. Within a
+        // facet, UVs are an affine function of the position, which splitting must preserve.
+        auto vertices = mesh->get_vertices().eval();
+        for (Index v = 0; v < num_vertices; ++v) {
+            const auto p = vertices.row(v).eval();
+            vertices.row(v) *= 1 + 0.1 * std::sin(3 * p(0) + 2 * p(1) + p(2));
+        }
+        mesh->import_vertices(vertices);
+
+        auto facet_uv = [](const auto& p, Index f) {
+            return Eigen::RowVector2d(p(0) + 0.5 * p(1) + 4 * (f % 8), p(1) - p(2) + f / 8);
+        };
+        MeshType::UVArray uv(3 * num_facets, 2);
+        MeshType::UVIndices uv_indices(num_facets, 3);
+        MeshType::AttributeArray index(num_facets, 1);
+        for (Index f = 0; f < num_facets; ++f) {
+            for (Index lv = 0; lv < 3; ++lv) {
+                uv.row(3 * f + lv) =
+                    facet_uv(mesh->get_vertices().row(mesh->get_facets()(f, lv)), f);
+                uv_indices(f, lv) = 3 * f + lv;
+            }
+            index(f, 0) = f;
+        }
+        mesh->initialize_uv(uv, uv_indices);
+        mesh->add_facet_attribute("index");
+        mesh->import_facet_attribute("index", index);
+
+        auto out = split_long_edges(*mesh, sq_tol, true);
+        REQUIRE(max_sq_edge_length(*out, nullptr) <= sq_tol);
+        REQUIRE(out->is_uv_initialized());
+        REQUIRE(out->get_uv_indices().rows() == out->get_num_facets());
+
+        const auto& out_uv = out->get_uv();
+        const auto& out_uv_indices = out->get_uv_indices();
+        const auto& out_index = out->get_facet_attribute("index");
+        double max_error = 0;
+        for (Index f = 0; f < out->get_num_facets(); ++f) {
+            const Index source = safe_cast<Index>(out_index(f, 0));
+            for (Index lv = 0; lv < 3; ++lv) {
+                const auto p = out->get_vertices().row(out->get_facets()(f, lv));
+                const Eigen::RowVector2d expected = facet_uv(p, source);
+                max_error = std::max(
+                    max_error,
+                    (out_uv.row(out_uv_indices(f, lv)) - expected).norm());
+            }
+        }
+        REQUIRE(max_error < 1e-6);
+
+        // Sub-facets cover their source facet in UV space. Signed areas cancel out over the
+        // closed sphere, so compare absolute areas.
+        const auto in_areas = compute_uv_area_raw(uv, uv_indices);
+        const auto out_areas = compute_uv_area_raw(out_uv, out_uv_indices);
+        REQUIRE(out_areas.cwiseAbs().sum() == Approx(in_areas.cwiseAbs().sum()));
+    }
+}
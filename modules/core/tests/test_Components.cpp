@@ -9,6 +9,8 @@
  * OF ANY KIND, either express or implied. See the License for the specific language
  * governing permissions and limitations under the License.
  */
+#include <algorithm>
+
 #include <Eigen/Core>
 #include <lagrange/testing/common.h>
 
@@ -77,3 +79,72 @@ TEST_CASE("MultiComps", "[components][simple]")
     const auto& comp_ids = mesh->get_per_facet_component_ids();
     REQUIRE(comp_ids.size() == 2);
 }
+
+TEST_CASE("ComponentsUnionFind", "[components][union_find]")
+{
+    using namespace lagrange;
+
+    SECTION("Vertex touch")
+    {
+        Vertices3D vertices(5, 3);
+        vertices << 0.0, 0.0, 0.0, 1.0, 0.0, 0.0, 0.0, 1.0, 0.0, 1.0, 1.0, 0.0, 0.0, 0.0, 1.0;
+        Triangles facets(2, 3);
+        facets << 0, 1, 2, 0, 3, 4;
+
+        auto mesh = create_mesh(vertices, facets);
+        mesh->initialize_components(ConnectivityType::Vertex);
+        REQUIRE(mesh->get_num_components() == 1);
+        REQUIRE(!mesh->is_facet_facet_adjacency_initialized());
+
+        mesh->initialize_components(ConnectivityType::Edge);
+        REQUIRE(mesh->get_num_components() == 2);
+    }
+
+    SECTION("Same as BFS")
+    {
+        // Interleaved strips of triangles, so that components are not contiguous in facet order.
+        const int num_strips = 7;
+        const int strip_length = 50;
+        Vertices3D vertices(num_strips * (strip_length + 1) * 2, 3);
+        Triangles facets(num_strips * strip_length * 2, 3);
+        for (int s = 0; s < num_strips; ++s) {
+            for (int i = 0; i <= strip_length; ++i) {
+                const int v = (s * (strip_length + 1) + i) * 2;
+                vertices.row(v) << double(i), double(s), 0.0;
+                vertices.row(v + 1) << double(i), double(s) + 0.5, 0.0;
+            }
+            for (int i = 0; i < strip_length; ++i) {
+                const int v = (s * (strip_length + 1) + i) * 2;
+                const int f = (i * num_strips + s) * 2;
+                facets.row(f) << v, v + 2, v + 3;
+                facets.row(f + 1) << v, v + 3, v + 1;
+            }
+        }
+
+        auto mesh = create_mesh(vertices, facets);
+        mesh->initialize_components();
+        const auto expected_ids = mesh->get_per_facet_component_ids();
+        auto expected_components = mesh->get_components();
+        REQUIRE(expected_components.size() == num_strips);
+        // BFS lists facets in traversal order, union-find in increasing order.
+        for (auto& comp : expected_components) {
+            std::sort(comp.begin(), comp.end());
+        }
+
+        for (auto type : {ConnectivityType::Vertex, ConnectivityType::Edge}) {
+            auto mesh2 = create_mesh(vertices, facets);
+            mesh2->initialize_components(type);
+            REQUIRE(mesh2->get_per_facet_component_ids() == expected_ids);
+            REQUIRE(mesh2->get_components() == expected_components);
+        }
+    }
+
+    SECTION("Empty mesh")
+    {
+        Vertices3D vertices(0, 3);
+        Triangles facets(0, 3);
+        auto mesh = create_mesh(vertices, facets);
+        mesh->initialize_components(ConnectivityType::Vertex);
+        REQUIRE(mesh->get_num_components() == 0);
+    }
+}
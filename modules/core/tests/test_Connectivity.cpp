@@ -18,6 +18,8 @@
 #include <lagrange/common.h>
 #include <lagrange/create_mesh.h>
 
+#include <tbb/parallel_for.h>
+
 TEST_CASE("ConnectivitySimpleTriangleMesh", "[connectivity][triangle_mesh][simple]")
 {
     using namespace lagrange;
@@ -183,3 +185,127 @@ TEST_CASE("ConnectivityQuadMesh", "[connectivity][quad_mesh][simple]")
         }
     }
 }
+
+TEST_CASE("ConnectivityCSR", "[connectivity][triangle_mesh]")
+{
+    using namespace lagrange;
+
+    // Triangulated n x n grid, with a degenerate facet and a duplicate facet appended.
+    const int n = 16;
+    Vertices3D vertices((n + 1) * (n + 1), 3);
+    for (int i = 0; i <= n; i++) {
+        for (int j = 0; j <= n; j++) {
+            vertices.row(i * (n + 1) + j) << double(i), double(j), 0.0;
+        }
+    }
+    Triangles facets(2 * n * n + 2, 3);
+    for (int i = 0; i < n; i++) {
+        for (int j = 0; j < n; j++) {
+            const int v0 = i * (n + 1) + j;
+            facets.row(2 * (i * n + j)) << v0, v0 + n + 1, v0 + 1;
+            facets.row(2 * (i * n + j) + 1) << v0 + 1, v0 + n + 1, v0 + n + 2;
+        }
+    }
+    facets.row(2 * n * n) << 0, 0, 1;
+    facets.row(2 * n * n + 1) = facets.row(0);
+
+    auto mesh = create_mesh(vertices, facets);
+    mesh->initialize_connectivity();
+
+    using Index = decltype(mesh)::element_type::Index;
+    const Index num_vertices = mesh->get_num_vertices();
+    const Index num_facets = mesh->get_num_facets();
+
+    // Brute-force reference adjacency.
+    std::vector<std::vector<Index>> v2v(num_vertices), v2f(num_vertices), f2f(num_facets);
+    for (Index f = 0; f < num_facets; f++) {
+        for (Index j = 0; j < 3; j++) {
+            v2v[facets(f, j)].push_back(facets(f, (j + 1) % 3));
+            v2v[facets(f, j)].push_back(facets(f, (j + 2) % 3));
+            v2f[facets(f, j)].push_back(f);
+        }
+    }
+    for (auto* adj : {&v2v, &v2f}) {
+        for (auto& arr : *adj) {
+            std::sort(arr.begin(), arr.end());
+            arr.erase(std::unique(arr.begin(), arr.end()), arr.end());
+        }
+    }
+    for (Index fi = 0; fi < num_facets; fi++) {
+        for (Index fj = 0; fj < num_facets; fj++) {
+            if (fi == fj) continue;
+            int num_shared = 0;
+            for (auto v : {facets(fi, 0), facets(fi, 1), facets(fi, 2)}) {
+                const auto& arr = v2f[v];
+                num_shared += std::binary_search(arr.begin(), arr.end(), fj);
+            }
+            if (num_shared > 1) f2f[fi].push_back(fj);
+        }
+    }
+
+    REQUIRE(mesh->get_vertex_vertex_adjacency().get_num_entries() == num_vertices);
+    REQUIRE(mesh->get_vertex_facet_adjacency().get_num_entries() == num_vertices);
+    REQUIRE(mesh->get_facet_facet_adjacency().get_num_entries() == num_facets);
+    for (Index v = 0; v < num_vertices; v++) {
+        REQUIRE(mesh->get_vertices_adjacent_to_vertex(v).to_vector() == v2v[v]);
+        REQUIRE(mesh->get_facets_adjacent_to_vertex(v).to_vector() == v2f[v]);
+    }
+    for (Index f = 0; f < num_facets; f++) {
+        REQUIRE(mesh->get_facets_adjacent_to_facet(f).to_vector() == f2f[f]);
+    }
+}
+
+TEST_CASE("ConnectivityLazy", "[connectivity][triangle_mesh]")
+{
+    using namespace lagrange;
+
+    Vertices3D vertices(4, 3);
+    vertices << 0.0, 0.0, 0.0, 1.0, 0.0, 0.0, 0.0, 1.0, 0.0, 0.0, 0.0, 1.0;
+    Triangles facets(4, 3);
+    facets << 0, 2, 1, 0, 1, 3, 1, 2, 3, 2, 0, 3;
+
+    auto mesh = create_mesh(vertices, facets);
+    using Index = decltype(mesh)::element_type::Index;
+
+    SECTION("Per-relation initialization")
+    {
+        mesh->initialize_vertex_vertex_adjacency();
+        REQUIRE(mesh->is_vertex_vertex_adjacency_initialized());
+        REQUIRE(!mesh->is_vertex_facet_adjacency_initialized());
+        REQUIRE(!mesh->is_facet_facet_adjacency_initialized());
+        REQUIRE(!mesh->is_connectivity_initialized());
+
+        mesh->initialize_facet_facet_adjacency();
+        REQUIRE(mesh->is_vertex_facet_adjacency_initialized());
+        REQUIRE(mesh->is_facet_facet_adjacency_initialized());
+        REQUIRE(mesh->is_connectivity_initialized());
+
+        mesh->clear_connectivity();
+        REQUIRE(!mesh->is_vertex_vertex_adjacency_initialized());
+        REQUIRE(!mesh->is_vertex_facet_adjacency_initialized());
+        REQUIRE(!mesh->is_facet_facet_adjacency_initialized());
+    }
+
+    SECTION("Initialization on first access")
+    {
+        REQUIRE(mesh->get_facets_adjacent_to_facet(0).size() == 3);
+        REQUIRE(mesh->is_facet_facet_adjacency_initialized());
+        REQUIRE(!mesh->is_vertex_vertex_adjacency_initialized());
+
+        REQUIRE(mesh->get_vertices_adjacent_to_vertex(0).size() == 3);
+        REQUIRE(mesh->is_connectivity_initialized());
+    }
+
+    SECTION("Concurrent initialization")
+    {
+        std::vector<Index> num_neighbors(64, 0);
+        tbb::parallel_for(Index(0), Index(num_neighbors.size()), [&](Index i) {
+            num_neighbors[i] = safe_cast<Index>(
+                mesh->get_vertices_adjacent_to_vertex(i % 4).size() +
+                mesh->get_facets_adjacent_to_facet(i % 4).size());
+        });
+        for (auto n : num_neighbors) {
+            REQUIRE(n == 6);
+        }
+    }
+}
@@ -13,6 +13,8 @@
 
 #include <lagrange/DisjointSets.h>
 
+#include <tbb/parallel_for.h>
+
 TEST_CASE("DisjointSets", "[disjoint_sets]")
 {
     using namespace lagrange;
@@ -87,3 +89,44 @@ TEST_CASE("DisjointSets", "[disjoint_sets]")
         REQUIRE(data.find(0) == data.find(2));
     }
 }
+
+TEST_CASE("ConcurrentDisjointSets", "[disjoint_sets][concurrent]")
+{
+    using namespace lagrange;
+
+    SECTION("Init")
+    {
+        ConcurrentDisjointSets<int> data(10);
+        std::vector<int> index_map;
+        REQUIRE(data.extract_disjoint_set_indices(index_map) == 10);
+        for (int i = 0; i < 10; ++i) {
+            REQUIRE(index_map[i] == i);
+        }
+    }
+
+    SECTION("Deterministic roots")
+    {
+        ConcurrentDisjointSets<int> data(4);
+        data.merge(3, 2);
+        data.merge(2, 1);
+        REQUIRE(data.find(3) == 1);
+        REQUIRE(data.find(1) == 1);
+        REQUIRE(data.find(0) == 0);
+    }
+
+    SECTION("Parallel merge")
+    {
+        // Merge every element with its successor modulo the number of sets.
+        const int num_elements = 100000;
+        const int num_sets = 17;
+        ConcurrentDisjointSets<int> data(num_elements);
+        tbb::parallel_for(0, num_elements - num_sets, [&](int i) { data.merge(i + num_sets, i); });
+
+        std::vector<int> index_map;
+        REQUIRE(data.extract_disjoint_set_indices(index_map) == num_sets);
+        for (int i = 0; i < num_elements; ++i) {
+            REQUIRE(data.find(i) == i % num_sets);
+            REQUIRE(index_map[i] == i % num_sets);
+        }
+    }
+}
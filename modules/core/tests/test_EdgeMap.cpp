@@ -12,10 +12,15 @@
 #include <lagrange/testing/common.h>
 
 #include <limits>
+#include <random>
+#include <unordered_map>
+#include <unordered_set>
 
 #include <lagrange/Edge.h>
 #include <lagrange/common.h>
 
+#include <tbb/parallel_for.h>
+
 TEST_CASE("HashSymmetry", "[EdgeMap][Hash][Symmetry]")
 {
     using namespace lagrange;
@@ -31,3 +36,125 @@ TEST_CASE("HashSymmetry", "[EdgeMap][Hash][Symmetry]")
     REQUIRE(hash({{min, min}}) == hash({{min, min}}));
     REQUIRE(hash({{min, min}}) != hash({{max, min}}));
 }
+
+TEST_CASE("FlatEdgeMap", "[EdgeMap][FlatEdgeMap]")
+{
+    using namespace lagrange;
+
+    auto check_against_std = [](auto index_tag) {
+        using Index = decltype(index_tag);
+        using Edge = EdgeType<Index>;
+        std::mt19937 gen(0);
+        std::uniform_int_distribution<int> vertex(0, 200);
+        std::uniform_int_distribution<int> op(0, 3);
+
+        EdgeMap<Index, int> map;
+        std::unordered_map<Edge, int> expected;
+        for (int i = 0; i < 20000; ++i) {
+            const Edge e(Index(vertex(gen)), Index(vertex(gen)));
+            switch (op(gen)) {
+            case 0: {
+                const auto res = map.insert({e, i});
+                const auto expected_res = expected.insert({e, i});
+                REQUIRE(res.second == expected_res.second);
+                REQUIRE(res.first->second == expected_res.first->second);
+                break;
+            }
+            case 1: map[e] += i; expected[e] += i; break;
+            case 2: REQUIRE(map.erase(e) == expected.erase(e)); break;
+            default: {
+                const Edge flipped(e.v2(), e.v1());
+                REQUIRE(map.count(flipped) == expected.count(e));
+                if (map.count(flipped)) REQUIRE(map.at(flipped) == expected.at(e));
+                break;
+            }
+            }
+            REQUIRE(map.size() == expected.size());
+        }
+
+        size_t num_visited = 0;
+        for (const auto& item : map) {
+            REQUIRE(expected.at(item.first) == item.second);
+            ++num_visited;
+        }
+        REQUIRE(num_visited == expected.size());
+
+        map.clear();
+        REQUIRE(map.empty());
+        REQUIRE(map.begin() == map.end());
+    };
+
+    SECTION("32-bit indices") { check_against_std(int()); }
+    SECTION("64-bit indices") { check_against_std(size_t()); }
+
+    SECTION("orientation")
+    {
+        EdgeMap<int, int> map;
+        map.reserve(100);
+        const size_t num_buckets = map.bucket_count();
+        map.emplace(EdgeType<int>(3, 1), 7);
+        REQUIRE(map.find({{1, 3}})->first.v1() == 3);
+        REQUIRE(!map.emplace(EdgeType<int>(1, 3), 8).second);
+        REQUIRE(map.at({{1, 3}}) == 7);
+        REQUIRE(map.bucket_count() == num_buckets);
+        REQUIRE_THROWS(map.at({{1, 2}}));
+    }
+
+    SECTION("set")
+    {
+        EdgeSet<int> set;
+        REQUIRE(set.insert({{0, 1}}).second);
+        REQUIRE(!set.insert({{1, 0}}).second);
+        REQUIRE(set.insert({{1, 2}}).second);
+        REQUIRE(set.size() == 2);
+        REQUIRE(set.find({{2, 1}}) != set.end());
+        REQUIRE(set.erase({{0, 1}}) == 1);
+        REQUIRE(set.find({{0, 1}}) == set.end());
+        REQUIRE(set.size() == 1);
+    }
+}
+
+TEST_CASE("ConcurrentFlatEdgeSet", "[EdgeMap][FlatEdgeMap]")
+{
+    using namespace lagrange;
+    const int n = 300;
+
+    // Edges of a grid, each inserted twice (once per orientation).
+    std::vector<EdgeType<int>> edges;
+    for (int i = 0; i < n; ++i) {
+        for (int j = 0; j + 1 < n; ++j) {
+            edges.emplace_back(i * n + j, i * n + j + 1);
+            edges.emplace_back(j * n + i, (j + 1) * n + i);
+        }
+    }
+    const size_t num_edges = edges.size();
+    for (size_t i = 0; i < num_edges; ++i) {
+        edges.emplace_back(edges[i].v2(), edges[i].v1());
+    }
+
+    ConcurrentFlatEdgeSet<int> set(num_edges);
+    std::vector<size_t> slots(edges.size());
+    std::vector<char> inserted(edges.size());
+    tbb::parallel_for(size_t(0), edges.size(), [&](size_t i) {
+        const auto res = set.insert(edges[i]);
+        slots[i] = res.first;
+        inserted[i] = res.second;
+    });
+
+    REQUIRE(set.size() == num_edges);
+    REQUIRE(size_t(std::count(inserted.begin(), inserted.end(), 1)) == num_edges);
+    std::unordered_set<size_t> distinct_slots;
+    for (size_t i = 0; i < num_edges; ++i) {
+        REQUIRE(slots[i] == slots[i + num_edges]);
+        REQUIRE(inserted[i] != inserted[i + num_edges]);
+        REQUIRE(set.find(edges[i].v2(), edges[i].v1()) == slots[i]);
+        REQUIRE(set.get_edge(slots[i]) == edges[i]);
+        distinct_slots.insert(slots[i]);
+    }
+    REQUIRE(distinct_slots.size() == num_edges);
+
+    size_t num_occupied = 0;
+    for (size_t s = 0; s < set.get_num_slots(); ++s) num_occupied += set.is_occupied(s);
+    REQUIRE(num_occupied == num_edges);
+    REQUIRE(!set.contains(0, n * n - 1));
+}
@@ -0,0 +1,319 @@
+/*
+ * Copyright 2021 Adobe. All rights reserved.
+ * This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain a copy
+ * of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under
+ * the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ * OF ANY KIND, either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+ */
+#include <lagrange/testing/common.h>
+
+#include <lagrange/Mesh.h>
+#include <lagrange/TriangleBVH.h>
+#include <lagrange/common.h>
+#include <lagrange/compute_lift_operator.h>
+#include <lagrange/create_mesh.h>
+
+#include <tbb/global_control.h>
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <thread>
+
+namespace {
+
+// Random triangle soup, dense enough to exercise parallel subtree construction.
+template <typename Scalar>
+void create_soup(
+    int num_facets,
+    Eigen::Matrix<Scalar, Eigen::Dynamic, 3, Eigen::RowMajor>& vertices,
+    Eigen::Matrix<int, Eigen::Dynamic, 3, Eigen::RowMajor>& facets)
+{
+    std::mt19937 gen(42);
+    std::uniform_real_distribution<Scalar> center(-1, 1);
+    std::uniform_real_distribution<Scalar> offset(-0.05f, 0.05f);
+    vertices.resize(3 * num_facets, 3);
+    facets.resize(num_facets, 3);
+    for (int f = 0; f < num_facets; ++f) {
+        const Eigen::Matrix<Scalar, 1, 3> c(center(gen), center(gen), center(gen));
+        for (int lv = 0; lv < 3; ++lv) {
+            vertices.row(3 * f + lv) =
+                c + Eigen::Matrix<Scalar, 1, 3>(offset(gen), offset(gen), offset(gen));
+            facets(f, lv) = 3 * f + lv;
+        }
+    }
+}
+
+// Depth of the deepest leaf.
+template <typename BVH>
+int get_max_depth(const BVH& bvh)
+{
+    const auto& nodes = bvh.get_nodes();
+    std::vector<int> depth(nodes.size(), 0);
+    int max_depth = 0;
+    for (size_t n = 0; n < nodes.size(); ++n) {
+        max_depth = std::max(max_depth, depth[n]);
+        if (!nodes[n].is_leaf()) {
+            depth[n + 1] = depth[n] + 1;
+            depth[nodes[n].offset] = depth[n] + 1;
+        }
+    }
+    return max_depth;
+}
+
+} // namespace
+
+TEST_CASE("TriangleBVH", "[bvh][triangle]")
+{
+    using namespace lagrange;
+    using BVH = TriangleBVH<double, int>;
+    using Point = BVH::Point;
+
+    auto mesh = create_sphere(3);
+    const auto& vertices = mesh->get_vertices();
+    const auto& facets = mesh->get_facets();
+    const int num_facets = static_cast<int>(facets.rows());
+
+    BVH bvh(vertices, facets);
+    REQUIRE(bvh.get_num_triangles() == num_facets);
+    REQUIRE(bvh.get_num_nodes() <= 2 * num_facets - 1);
+
+    SECTION("layout")
+    {
+        // Every facet appears in exactly one leaf, and every box contains its children.
+        std::vector<int> seen(num_facets, 0);
+        const auto& nodes = bvh.get_nodes();
+        for (size_t n = 0; n < nodes.size(); ++n) {
+            if (nodes[n].is_leaf()) {
+                REQUIRE(nodes[n].count <= BVH::MaxLeafSize);
+                for (int i = nodes[n].offset; i < nodes[n].offset + nodes[n].count; ++i) {
+                    seen[bvh.get_facet_indices()[i]]++;
+                }
+            } else {
+                REQUIRE(nodes[n].offset > int(n) + 1);
+                REQUIRE(nodes[n].box.contains(nodes[n + 1].box));
+                REQUIRE(nodes[n].box.contains(nodes[nodes[n].offset].box));
+            }
+        }
+        REQUIRE(std::all_of(seen.begin(), seen.end(), [](int c) { return c == 1; }));
+    }
+
+    SECTION("closest point")
+    {
+        Eigen::Matrix<double, Eigen::Dynamic, 3, Eigen::RowMajor> queries(200, 3);
+        queries.setRandom();
+        queries *= 2;
+        const auto result = bvh.batch_query(queries);
+        REQUIRE(result.size() == 200);
+
+        for (Eigen::Index q = 0; q < queries.rows(); ++q) {
+            const Point p = queries.row(q);
+            const Eigen::Vector3d pt = p.transpose();
+            double best = std::numeric_limits<double>::infinity();
+            for (int f = 0; f < num_facets; ++f) {
+                Eigen::Vector3d closest;
+                double l0, l1, l2;
+                const Eigen::Vector3d v0 = vertices.row(facets(f, 0)).transpose();
+                const Eigen::Vector3d v1 = vertices.row(facets(f, 1)).transpose();
+                const Eigen::Vector3d v2 = vertices.row(facets(f, 2)).transpose();
+                best = std::min(
+                    best,
+                    point_triangle_squared_distance(pt, v0, v1, v2, closest, l0, l1, l2));
+            }
+            REQUIRE(result[q].squared_distance == Approx(best));
+            REQUIRE((result[q].closest_point - p).squaredNorm() == Approx(best));
+            const auto facet = facets.row(result[q].embedding_element_idx);
+            const Point interpolated =
+                result[q].barycentric_coordinates(0) * vertices.row(facet(0)) +
+                result[q].barycentric_coordinates(1) * vertices.row(facet(1)) +
+                result[q].barycentric_coordinates(2) * vertices.row(facet(2));
+            REQUIRE((interpolated - result[q].closest_point).norm() < 1e-8);
+        }
+
+        // Projections can be lifted back to the mesh vertices.
+        const auto lift = compute_lift_operator_from_projections(*mesh, result);
+        REQUIRE(lift.rows() == 200);
+        REQUIRE(lift.cols() == vertices.rows());
+
+        // A search radius that is too small finds nothing.
+        const auto none = bvh.query_closest_point(Point(0, 0, 0), 1e-6);
+        REQUIRE(none.embedding_element_idx == INVALID<int>());
+    }
+
+    SECTION("ray")
+    {
+        // Rays cast from the center of the sphere hit exactly one facet.
+        Eigen::Matrix<double, Eigen::Dynamic, 3, Eigen::RowMajor> directions(100, 3);
+        directions.setRandom();
+        Eigen::Matrix<double, Eigen::Dynamic, 3, Eigen::RowMajor> origins(100, 3);
+        origins.setZero();
+        const auto hits = bvh.batch_intersect_rays(origins, directions);
+
+        for (Eigen::Index r = 0; r < directions.rows(); ++r) {
+            REQUIRE(hits[r].is_hit());
+            const auto facet = facets.row(hits[r].embedding_element_idx);
+            const Point on_ray = hits[r].ray_parameter * directions.row(r);
+            const Point on_facet = hits[r].barycentric_coordinates(0) * vertices.row(facet(0)) +
+                                   hits[r].barycentric_coordinates(1) * vertices.row(facet(1)) +
+                                   hits[r].barycentric_coordinates(2) * vertices.row(facet(2));
+            REQUIRE((on_ray - on_facet).norm() < 1e-8);
+        }
+
+        // Rays pointing away from the mesh miss it.
+        const auto miss = bvh.intersect_ray(Point(0, 0, 5), Point(0, 0, 1));
+        REQUIRE(!miss.is_hit());
+
+        // A ray limited to a short segment does not reach the sphere.
+        const auto short_hit = bvh.intersect_ray(Point(0, 0, 0), Point(1, 0, 0), 0, 0.1);
+        REQUIRE(!short_hit.is_hit());
+    }
+
+    SECTION("box")
+    {
+        std::vector<BVH::Box> boxes;
+        boxes.emplace_back(Eigen::Vector3d(-0.2, -0.2, 0.5), Eigen::Vector3d(0.2, 0.2, 2.0));
+        boxes.emplace_back(Eigen::Vector3d(-0.1, -0.1, -0.1), Eigen::Vector3d(0.1, 0.1, 0.1));
+        boxes.emplace_back(Eigen::Vector3d(-2, -2, -2), Eigen::Vector3d(2, 2, 2));
+        const auto overlaps = bvh.batch_query_boxes(boxes);
+        REQUIRE(overlaps.get_num_entries() == 3);
+
+        for (size_t b = 0; b < boxes.size(); ++b) {
+            std::vector<int> expected;
+            for (int f = 0; f < num_facets; ++f) {
+                BVH::Box tri_box;
+                for (int lv = 0; lv < 3; ++lv) {
+                    tri_box.extend(vertices.row(facets(f, lv)).transpose());
+                }
+                if (tri_box.intersects(boxes[b])) expected.push_back(f);
+            }
+            const auto neighbors = overlaps.get_neighbors(int(b));
+            REQUIRE(std::vector<int>(neighbors.begin(), neighbors.end()) == expected);
+        }
+        REQUIRE(overlaps.get_neighbors(1).size() == 0);
+        REQUIRE(int(overlaps.get_neighbors(2).size()) == num_facets);
+    }
+
+    SECTION("refit")
+    {
+        Eigen::Matrix<double, Eigen::Dynamic, 3, Eigen::RowMajor> moved = 2 * vertices;
+        bvh.refit(moved, facets);
+        REQUIRE(bvh.get_bounding_box().max().maxCoeff() == Approx(2.0));
+        const auto hit = bvh.intersect_ray(Point(0, 0, 0), Point(1, 0, 0));
+        REQUIRE(hit.is_hit());
+        REQUIRE(hit.ray_parameter == Approx(2.0).epsilon(0.05));
+    }
+}
+
+TEST_CASE("TriangleBVH soup", "[bvh][triangle]")
+{
+    using namespace lagrange;
+    using BVH = TriangleBVH<float, int>;
+
+    Eigen::Matrix<float, Eigen::Dynamic, 3, Eigen::RowMajor> vertices;
+    Eigen::Matrix<int, Eigen::Dynamic, 3, Eigen::RowMajor> facets;
+    create_soup(20000, vertices, facets);
+
+    BVH bvh(vertices, facets);
+    REQUIRE(bvh.get_num_triangles() == 20000);
+
+    SECTION("deterministic")
+    {
+        // The tree must not depend on how subtrees are scheduled.
+        auto build_with_threads = [&](size_t num_threads) {
+            tbb::global_control control(
+                tbb::global_control::max_allowed_parallelism,
+                num_threads);
+            return BVH(vertices, facets);
+        };
+        const size_t max_threads = std::max(2u, std::thread::hardware_concurrency());
+        const BVH serial = build_with_threads(1);
+        for (const size_t num_threads : {size_t(2), max_threads}) {
+            const BVH other = build_with_threads(num_threads);
+            REQUIRE(other.get_num_nodes() == serial.get_num_nodes());
+            REQUIRE(other.get_facet_indices() == serial.get_facet_indices());
+            REQUIRE(other.get_triangles() == serial.get_triangles());
+            const bool same_nodes = std::equal(
+                serial.get_nodes().begin(),
+                serial.get_nodes().end(),
+                other.get_nodes().begin(),
+                [](const BVH::Node& a, const BVH::Node& b) {
+                    return a.offset == b.offset && a.count == b.count &&
+                           a.box.min() == b.box.min() && a.box.max() == b.box.max();
+                });
+            REQUIRE(same_nodes);
+        }
+    }
+
+    SECTION("closest point")
+    {
+        Eigen::Matrix<float, Eigen::Dynamic, 3, Eigen::RowMajor> queries(50, 3);
+        queries.setRandom();
+        const auto result = bvh.batch_query(queries);
+        for (Eigen::Index q = 0; q < queries.rows(); ++q) {
+            const Eigen::Vector3f p = queries.row(q).transpose();
+            float best = std::numeric_limits<float>::infinity();
+            for (Eigen::Index f = 0; f < facets.rows(); ++f) {
+                Eigen::Vector3f closest;
+                float l0, l1, l2;
+                const Eigen::Vector3f v0 = vertices.row(facets(f, 0)).transpose();
+                const Eigen::Vector3f v1 = vertices.row(facets(f, 1)).transpose();
+                const Eigen::Vector3f v2 = vertices.row(facets(f, 2)).transpose();
+                best = std::min(
+                    best,
+                    point_triangle_squared_distance(p, v0, v1, v2, closest, l0, l1, l2));
+            }
+            REQUIRE(result[q].squared_distance == Approx(best));
+        }
+    }
+
+    SECTION("degenerate")
+    {
+        // Identical triangles have coincident centroids and must still be split into leaves.
+        Eigen::Matrix<float, Eigen::Dynamic, 3, Eigen::RowMajor> same = vertices.topRows(3);
+        Eigen::Matrix<int, Eigen::Dynamic, 3, Eigen::RowMajor> repeated(100, 3);
+        repeated.rowwise() = Eigen::RowVector3i(0, 1, 2);
+        BVH degenerate(same, repeated);
+        REQUIRE(degenerate.get_num_nodes() == 2 * 32 - 1);
+        REQUIRE(degenerate.query_box(degenerate.get_bounding_box()).size() == 100);
+    }
+
+    SECTION("depth")
+    {
+        // Nested triangles of exponentially growing size make the SAH peel off small groups of
+        // the largest ones, which yields a tree much deeper than log2(#F).
+        const int num_nested = 4096;
+        Eigen::Matrix<double, Eigen::Dynamic, 3, Eigen::RowMajor> nested(3 * num_nested, 3);
+        Eigen::Matrix<int, Eigen::Dynamic, 3, Eigen::RowMajor> nested_facets(num_nested, 3);
+        for (int f = 0; f < num_nested; ++f) {
+            const double size = std::pow(1.05, f);
+            nested.row(3 * f + 0) << f, 0, 0;
+            nested.row(3 * f + 1) << f, size, 0;
+            nested.row(3 * f + 2) << f, 0, size;
+            nested_facets.row(f) << 3 * f, 3 * f + 1, 3 * f + 2;
+        }
+        using DoubleBVH = TriangleBVH<double, int>;
+        DoubleBVH deep(nested, nested_facets);
+        REQUIRE(deep.get_num_triangles() == num_nested);
+        REQUIRE(
+            get_max_depth(deep) <=
+            DoubleBVH::MaxSahDepth + int(std::ceil(std::log2(double(num_nested)))));
+        REQUIRE(deep.query_box(deep.get_bounding_box()).size() == size_t(num_nested));
+
+        // The first triangle containing (y, z) = (1, 1) is the first one with size >= 2.
+        const auto hit = deep.intersect_ray(DoubleBVH::Point(-1, 1, 1), DoubleBVH::Point(1, 0, 0));
+        REQUIRE(hit.embedding_element_idx == 15);
+    }
+
+    SECTION("empty")
+    {
+        BVH empty(vertices, Eigen::Matrix<int, Eigen::Dynamic, 3, Eigen::RowMajor>());
+        REQUIRE(empty.empty());
+        REQUIRE(!empty.intersect_ray(BVH::Point(0, 0, 0), BVH::Point(1, 0, 0)).is_hit());
+        REQUIRE(empty.query_closest_point(BVH::Point(0, 0, 0)).embedding_element_idx ==
+                INVALID<int>());
+    }
+}
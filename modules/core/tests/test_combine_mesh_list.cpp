@@ -184,4 +184,109 @@ TEST_CASE("combine_mesh_list", "[mesh][combine]")
             REQUIRE(out_indices.maxCoeff() == Approx(11));
         }
     }
+
+    SECTION("Many meshes")
+    {
+        using MeshType = TriangleMesh3D;
+        using Index = MeshType::Index;
+        using AttributeArray = MeshType::AttributeArray;
+        using IndexArray = MeshType::IndexArray;
+
+        auto ids = [](Index n, Index first) -> AttributeArray {
+            return Eigen::VectorXd::LinSpaced(n, first, first + n - 1);
+        };
+
+        // Grids of increasing size, with attributes holding global element ids.
+        std::vector<std::unique_ptr<MeshType>> meshes;
+        Index num_vertices = 0, num_facets = 0;
+        for (int n = 1; n <= 20; ++n) {
+            Vertices3D vertices((n + 1) * (n + 1), 3);
+            for (int i = 0; i <= n; ++i) {
+                for (int j = 0; j <= n; ++j) vertices.row(i * (n + 1) + j) << i, j, n;
+            }
+            Triangles facets(2 * n * n, 3);
+            for (int i = 0; i < n; ++i) {
+                for (int j = 0; j < n; ++j) {
+                    const int v0 = i * (n + 1) + j;
+                    facets.row(2 * (i * n + j)) << v0, v0 + n + 1, v0 + n + 2;
+                    facets.row(2 * (i * n + j) + 1) << v0, v0 + n + 2, v0 + 1;
+                }
+            }
+            auto mesh = create_mesh(std::move(vertices), std::move(facets));
+            const Index nv = mesh->get_num_vertices();
+            const Index nf = mesh->get_num_facets();
+
+            mesh->add_vertex_attribute("id");
+            mesh->import_vertex_attribute("id", ids(nv, num_vertices));
+            mesh->add_facet_attribute("id");
+            mesh->import_facet_attribute("id", ids(nf, num_facets));
+            mesh->add_corner_attribute("id");
+            mesh->import_corner_attribute("id", ids(3 * nf, 3 * num_facets));
+
+            // Edge midpoints, which only depend on the edge endpoints.
+            mesh->initialize_edge_data();
+            AttributeArray midpoints(mesh->get_num_edges(), 3);
+            for (Index e = 0; e < mesh->get_num_edges(); ++e) {
+                const auto v = mesh->get_edge_vertices(e);
+                midpoints.row(e) =
+                    (mesh->get_vertices().row(v[0]) + mesh->get_vertices().row(v[1])) / 2;
+            }
+            mesh->add_edge_attribute("midpoint");
+            mesh->import_edge_attribute("midpoint", midpoints);
+
+            // Per-facet indexed attribute.
+            AttributeArray values(nf, 1);
+            IndexArray indices(nf, 3);
+            for (Index f = 0; f < nf; ++f) {
+                values(f) = num_facets + f;
+                indices.row(f).setConstant(f);
+            }
+            mesh->add_indexed_attribute("id");
+            mesh->set_indexed_attribute("id", values, indices);
+
+            num_vertices += nv;
+            num_facets += nf;
+            meshes.push_back(std::move(mesh));
+        }
+
+        const auto out_mesh = combine_mesh_list(meshes, true);
+        REQUIRE(out_mesh->get_num_vertices() == num_vertices);
+        REQUIRE(out_mesh->get_num_facets() == num_facets);
+
+        const auto& vertex_ids = out_mesh->get_vertex_attribute("id");
+        for (Index v = 0; v < num_vertices; ++v) REQUIRE(vertex_ids(v) == v);
+        const auto& facet_ids = out_mesh->get_facet_attribute("id");
+        for (Index f = 0; f < num_facets; ++f) REQUIRE(facet_ids(f) == f);
+        const auto& corner_ids = out_mesh->get_corner_attribute("id");
+        for (Index c = 0; c < 3 * num_facets; ++c) REQUIRE(corner_ids(c) == c);
+
+        Index offset = 0;
+        for (const auto& mesh : meshes) {
+            const auto n = mesh->get_num_facets();
+            REQUIRE(
+                out_mesh->get_facets().middleRows(offset, n) ==
+                (mesh->get_facets().array() +
+                 safe_cast<Index>(mesh->get_vertex_attribute("id")(0)))
+                    .matrix());
+            offset += n;
+        }
+
+        REQUIRE(out_mesh->has_edge_attribute("midpoint"));
+        const auto& midpoints = out_mesh->get_edge_attribute("midpoint");
+        REQUIRE(midpoints.rows() == out_mesh->get_num_edges());
+        for (Index e = 0; e < out_mesh->get_num_edges(); ++e) {
+            const auto v = out_mesh->get_edge_vertices(e);
+            const Eigen::RowVector3d expected =
+                (out_mesh->get_vertices().row(v[0]) + out_mesh->get_vertices().row(v[1])) / 2;
+            REQUIRE(midpoints.row(e) == expected);
+        }
+
+        const auto attr = out_mesh->get_indexed_attribute("id");
+        const auto& values = std::get<0>(attr);
+        const auto& indices = std::get<1>(attr);
+        REQUIRE(indices.rows() == num_facets);
+        for (Index f = 0; f < num_facets; ++f) {
+            for (Index lv = 0; lv < 3; ++lv) REQUIRE(values(indices(f, lv)) == f);
+        }
+    }
 }
@@ -42,4 +42,40 @@ TEST_CASE("compute_corner_normal", "[mesh][triangle][attribute][corner_normal]")
         REQUIRE(corner_normals.rows() == 36);
         REQUIRE(corner_normals.rowwise().template lpNorm<Eigen::Infinity>().maxCoeff() < 1.0);
     }
+
+    SECTION("Sharpness callback")
+    {
+        using Index = TriangleMesh3D::Index;
+        auto mesh2 = create_mesh(mesh->get_vertices(), mesh->get_facets());
+        compute_corner_normal(*mesh, M_PI * 0.25);
+        compute_corner_normal(
+            *mesh2,
+            [](Index, Index) { return true; },
+            [](Index) { return false; });
+
+        REQUIRE(mesh2->has_corner_attribute("normal"));
+        const auto& corner_normals = mesh->get_corner_attribute("normal");
+        const auto& corner_normals_2 = mesh2->get_corner_attribute("normal");
+        REQUIRE((corner_normals - corner_normals_2).cwiseAbs().maxCoeff() == Approx(0.0));
+    }
+
+    SECTION("Cone vertex")
+    {
+        using Index = TriangleMesh3D::Index;
+        compute_corner_normal(*mesh, M_PI, std::vector<Index>{0});
+
+        const auto& facets = mesh->get_facets();
+        const auto& facet_normals = mesh->get_facet_attribute("normal");
+        const auto& corner_normals = mesh->get_corner_attribute("normal");
+        for (Index f = 0; f < mesh->get_num_facets(); ++f) {
+            for (Index lv = 0; lv < 3; ++lv) {
+                const Index c = f * 3 + lv;
+                if (facets(f, lv) == 0) {
+                    REQUIRE(corner_normals.row(c) == facet_normals.row(f));
+                } else {
+                    REQUIRE(corner_normals.row(c).template lpNorm<Eigen::Infinity>() < 1.0);
+                }
+            }
+        }
+    }
 }
@@ -11,11 +11,14 @@
  */
 #include <lagrange/testing/common.h>
 
+#include <lagrange/DijkstraDistanceEngine.h>
 #include <lagrange/Mesh.h>
 #include <lagrange/common.h>
 #include <lagrange/compute_dijkstra_distance.h>
 #include <lagrange/create_mesh.h>
 
+#include <algorithm>
+
 TEST_CASE("DijkstraDistance", "[dijstra][triangle]")
 {
     using namespace lagrange;
@@ -42,3 +45,77 @@ TEST_CASE("DijkstraDistance", "[dijstra][triangle]")
         REQUIRE(dist.maxCoeff() == Approx(M_PI).epsilon(0.1));
     }
 }
+
+TEST_CASE("DijkstraDistanceEngine", "[dijstra][triangle]")
+{
+    using namespace lagrange;
+    using MeshType = TriangleMesh3D;
+    using Engine = DijkstraDistanceEngine<MeshType>;
+    using Index = MeshType::Index;
+
+    auto sphere = create_sphere(4);
+    Engine engine(*sphere);
+    const std::vector<Engine::Seed> seeds = {
+        {0, {1.0, 0.0, 0.0}},
+        {100, {0.2, 0.3, 0.5}},
+        {sphere->get_num_facets() - 1, {1.0 / 3, 1.0 / 3, 1.0 / 3}}};
+
+    // Single seed fields.
+    std::vector<MeshType::AttributeArray> fields;
+    for (const auto& seed : seeds) {
+        compute_dijkstra_distance(*sphere, seed.facet, seed.bc);
+        fields.push_back(sphere->get_vertex_attribute("dijkstra_distance"));
+    }
+
+    SECTION("multiple seeds")
+    {
+        MeshType::AttributeArray dist;
+        engine.compute(seeds, 0, dist);
+        REQUIRE(dist.rows() == sphere->get_num_vertices());
+        for (Index v = 0; v < sphere->get_num_vertices(); ++v) {
+            const double expected =
+                std::min({fields[0](v, 0), fields[1](v, 0), fields[2](v, 0)});
+            REQUIRE(dist(v, 0) == Approx(expected));
+        }
+
+        engine.compute_vertex_attribute(seeds, 0, "distance");
+        REQUIRE(sphere->get_vertex_attribute("distance") == dist);
+    }
+
+    SECTION("radius")
+    {
+        const double radius = 0.5;
+        double last = 0;
+        Index num_reached = 0;
+        engine.compute({seeds[1]}, radius, [&](Index v, double d) {
+            REQUIRE(d >= last);
+            REQUIRE(d == fields[1](v, 0));
+            last = d;
+            ++num_reached;
+        });
+        REQUIRE(num_reached > 3);
+        REQUIRE(num_reached < sphere->get_num_vertices());
+        for (Index v = 0; v < sphere->get_num_vertices(); ++v) {
+            if (fields[1](v, 0) < radius) --num_reached;
+        }
+        REQUIRE(num_reached <= 3);
+    }
+
+    SECTION("batch")
+    {
+        std::vector<std::vector<Engine::Seed>> queries;
+        for (Index f = 0; f < sphere->get_num_facets(); f += 7) {
+            queries.push_back({{f, {0.3, 0.3, 0.4}}});
+        }
+        std::vector<std::vector<Engine::Reached>> results(queries.size());
+        engine.compute_batch(
+            queries,
+            0.3,
+            [&](size_t q, const std::vector<Engine::Reached>& reached) { results[q] = reached; });
+        for (size_t q = 0; q < queries.size(); ++q) {
+            std::vector<Engine::Reached> expected;
+            engine.compute(queries[q], 0.3, [&](Index v, double d) { expected.emplace_back(v, d); });
+            REQUIRE(results[q] == expected);
+        }
+    }
+}
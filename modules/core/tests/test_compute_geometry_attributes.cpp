@@ -0,0 +1,215 @@
+/*
+ * Copyright 2021 Adobe. All rights reserved.
+ * This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain a copy
+ * of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under
+ * the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ * OF ANY KIND, either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+ */
+#include <lagrange/testing/common.h>
+
+#include <lagrange/Mesh.h>
+#include <lagrange/common.h>
+#include <lagrange/compute_dihedral_angles.h>
+#include <lagrange/compute_edge_lengths.h>
+#include <lagrange/compute_facet_area.h>
+#include <lagrange/compute_geometry_attributes.h>
+#include <lagrange/create_mesh.h>
+#include <lagrange/utils/geometry3d.h>
+
+TEST_CASE("compute_geometry_attributes", "[mesh][geometry][area][normal]")
+{
+    using namespace lagrange;
+    using Index = TriangleMesh3D::Index;
+    using RowVector3d = Eigen::RowVector3d;
+
+    // Open sphere whose number of facets is not a multiple of the block size.
+    auto sphere = create_sphere(3);
+    auto mesh = create_mesh(
+        sphere->get_vertices(),
+        sphere->get_facets().topRows(sphere->get_num_facets() - 5).eval());
+    const auto& vertices = mesh->get_vertices();
+    const auto& facets = mesh->get_facets();
+    REQUIRE(mesh->get_num_facets() % internal::GeometryBlockSize != 0);
+
+    GeometryAttributeOptions options;
+    options.facet_normal = true;
+    options.edge_length = true;
+    options.dihedral_angle = true;
+    compute_geometry_attributes(*mesh, options);
+
+    REQUIRE(mesh->has_facet_attribute("area"));
+    REQUIRE(mesh->has_facet_attribute("normal"));
+    REQUIRE(mesh->has_edge_attribute("length"));
+    REQUIRE(mesh->has_edge_attribute("dihedral_angle"));
+
+    const auto& areas = mesh->get_facet_attribute("area");
+    const auto& normals = mesh->get_facet_attribute("normal");
+    for (Index f = 0; f < mesh->get_num_facets(); ++f) {
+        const RowVector3d p0 = vertices.row(facets(f, 0));
+        const RowVector3d p1 = vertices.row(facets(f, 1));
+        const RowVector3d p2 = vertices.row(facets(f, 2));
+        const RowVector3d n = (p1 - p0).cross(p2 - p0);
+        REQUIRE(areas(f, 0) == Approx(0.5 * n.norm()));
+        REQUIRE((normals.row(f) - n.normalized()).norm() < 1e-12);
+    }
+
+    const auto& lengths = mesh->get_edge_attribute("length");
+    const auto& angles = mesh->get_edge_attribute("dihedral_angle");
+    for (Index e = 0; e < mesh->get_num_edges(); ++e) {
+        const auto v = mesh->get_edge_vertices(e);
+        REQUIRE(lengths(e, 0) == Approx((vertices.row(v[0]) - vertices.row(v[1])).norm()));
+
+        std::vector<Index> adj;
+        mesh->foreach_facets_around_edge(e, [&](Index f) { adj.push_back(f); });
+        if (adj.size() == 2) {
+            const RowVector3d n0 = normals.row(adj[0]);
+            const RowVector3d n1 = normals.row(adj[1]);
+            REQUIRE(angles(e, 0) == Approx(angle_between(n0, n1)));
+        } else {
+            REQUIRE(angles(e, 0) == 0);
+        }
+    }
+}
+
+TEST_CASE("compute_geometry_attributes: individual functions", "[mesh][geometry][area]")
+{
+    using namespace lagrange;
+    using Index = TriangleMesh3D::Index;
+
+    // Unit cube with outward facing triangles
+    Vertices3D vertices(8, 3);
+    vertices << 0, 0, 0, 1, 0, 0, 1, 1, 0, 0, 1, 0, 0, 0, 1, 1, 0, 1, 1, 1, 1, 0, 1, 1;
+    Triangles facets(12, 3);
+    facets << 0, 2, 1, 0, 3, 2, 4, 5, 6, 4, 6, 7, 0, 1, 5, 0, 5, 4, 3, 7, 6, 3, 6, 2, 0, 4, 7, 0,
+        7, 3, 1, 2, 6, 1, 6, 5;
+    auto mesh = create_mesh(vertices, facets);
+
+    compute_facet_area(*mesh);
+    compute_edge_lengths(*mesh);
+    compute_dihedral_angles(*mesh);
+
+    const auto& areas = mesh->get_facet_attribute("area");
+    for (Index f = 0; f < 12; ++f) {
+        REQUIRE(areas(f, 0) == Approx(0.5));
+    }
+
+    // 12 sides of length 1 with a right dihedral angle, and 6 flat facet diagonals
+    REQUIRE(mesh->get_num_edges() == 18);
+    const auto& lengths = mesh->get_edge_attribute("length");
+    const auto& angles = mesh->get_edge_attribute("dihedral_angle");
+    int num_sides = 0;
+    int num_diagonals = 0;
+    for (Index e = 0; e < 18; ++e) {
+        const auto v = mesh->get_edge_vertices(e);
+        const auto d = vertices.row(v[0]) - vertices.row(v[1]);
+        const bool is_side = (d.array() != 0).count() == 1;
+        if (is_side) {
+            REQUIRE(lengths(e, 0) == Approx(1.0));
+            REQUIRE(angles(e, 0) == Approx(M_PI / 2));
+            ++num_sides;
+        } else {
+            REQUIRE(lengths(e, 0) == Approx(std::sqrt(2.0)));
+            REQUIRE(angles(e, 0) == Approx(0.0).margin(1e-12));
+            ++num_diagonals;
+        }
+    }
+    REQUIRE(num_sides == 12);
+    REQUIRE(num_diagonals == 6);
+}
+
+TEST_CASE("compute_geometry_attributes: quads and 2D", "[mesh][geometry][area]")
+{
+    using namespace lagrange;
+    using Index = TriangleMesh3D::Index;
+
+    SECTION("3D quad")
+    {
+        Vertices3D vertices(6, 3);
+        vertices << 0, 0, 0, 1, 0, 0, 2, 0, 0, 0, 1, 0, 1, 1, 1, 2, 1, 0;
+        Quads facets(2, 4);
+        facets << 0, 1, 4, 3, 1, 2, 5, 4;
+        auto mesh = create_mesh(vertices, facets);
+
+        GeometryAttributeOptions options;
+        options.edge_length = true;
+        compute_geometry_attributes(*mesh, options);
+        const auto& areas = mesh->get_facet_attribute("area");
+        for (Index f = 0; f < 2; ++f) {
+            const Eigen::RowVector3d v0 = vertices.row(facets(f, 0));
+            const Eigen::RowVector3d v1 = vertices.row(facets(f, 1));
+            const Eigen::RowVector3d v2 = vertices.row(facets(f, 2));
+            const Eigen::RowVector3d v3 = vertices.row(facets(f, 3));
+            const double expected =
+                0.5 * (v1 - v0).cross(v3 - v0).norm() + 0.5 * (v1 - v2).cross(v3 - v2).norm();
+            REQUIRE(areas(f, 0) == Approx(expected));
+        }
+        REQUIRE(mesh->get_num_edges() == 7);
+        REQUIRE(mesh->get_edge_attribute("length").maxCoeff() == Approx(std::sqrt(2.0)));
+
+        options.facet_normal = true;
+        REQUIRE_THROWS(compute_geometry_attributes(*mesh, options));
+    }
+
+    SECTION("2D triangles")
+    {
+        Vertices2D vertices(4, 2);
+        vertices << 0.0, 0.0, 2.0, 0.0, 0.0, 1.0, 2.0, 1.0;
+        Triangles facets(2, 3);
+        facets << 0, 1, 2, 2, 1, 3;
+        auto mesh = create_mesh(vertices, facets);
+
+        GeometryAttributeOptions options;
+        options.edge_length = true;
+        compute_geometry_attributes(*mesh, options);
+        const auto& areas = mesh->get_facet_attribute("area");
+        REQUIRE(areas(0, 0) == Approx(1.0));
+        REQUIRE(areas(1, 0) == Approx(1.0));
+        REQUIRE(mesh->get_edge_attribute("length").maxCoeff() == Approx(std::sqrt(5.0)));
+    }
+
+    SECTION("4D edge lengths")
+    {
+        Eigen::Matrix<double, Eigen::Dynamic, 4, Eigen::RowMajor> vertices(3, 4);
+        vertices << 0, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 2;
+        Triangles facets(1, 3);
+        facets << 0, 1, 2;
+        auto mesh = create_mesh(vertices, facets);
+
+        compute_edge_lengths(*mesh);
+        const auto& lengths = mesh->get_edge_attribute("length");
+        // Indexed by the sum of the edge vertices: (0, 1), (0, 2) and (1, 2)
+        const double expected[] = {0.0, 1.0, 2.0, std::sqrt(5.0)};
+        for (Index e = 0; e < 3; ++e) {
+            const auto v = mesh->get_edge_vertices(e);
+            REQUIRE(lengths(e, 0) == Approx(expected[v[0] + v[1]]));
+        }
+    }
+
+    SECTION("non-manifold dihedral angles")
+    {
+        Vertices3D vertices(5, 3);
+        vertices << 0, 0, 0, 1, 0, 0, 0, 1, 0, 0, -1, 0, 0, 0, 1;
+        Triangles facets(3, 3);
+        facets << 0, 1, 2, 1, 0, 3, 0, 1, 4;
+        auto mesh = create_mesh(vertices, facets);
+
+        GeometryAttributeOptions options;
+        options.facet_area = false;
+        options.dihedral_angle = true;
+        compute_geometry_attributes(*mesh, options);
+        REQUIRE(!mesh->has_facet_attribute("area"));
+        REQUIRE(!mesh->has_facet_attribute("normal"));
+        const auto& angles = mesh->get_edge_attribute("dihedral_angle");
+        for (Index e = 0; e < mesh->get_num_edges(); ++e) {
+            if (mesh->get_num_facets_around_edge(e) == 3) {
+                REQUIRE(angles(e, 0) == Approx(2 * M_PI));
+            } else {
+                REQUIRE(angles(e, 0) == 0);
+            }
+        }
+    }
+}
@@ -9,7 +9,10 @@
  * OF ANY KIND, either express or implied. See the License for the specific language
  * governing permissions and limitations under the License.
  */
+#include <lagrange/chain_corners_around_edges.h>
+#include <lagrange/chain_corners_around_vertices.h>
 #include <lagrange/corner_to_edge_mapping.h>
+#include <lagrange/create_mesh.h>
 #include <lagrange/io/load_mesh.h>
 #include <lagrange/Mesh.h>
 
@@ -23,6 +26,8 @@
 
 #include <lagrange/testing/common.h>
 
+#include <map>
+
 TEST_CASE("corner_to_edge_mapping: replicability", "[core]")
 {
     auto mesh = lagrange::testing::load_mesh<lagrange::TriangleMesh3D>("open/core/hemisphere.obj");
@@ -54,3 +59,78 @@ TEST_CASE("corner_to_edge_mapping: regression", "[core]")
     REQUIRE(c2e.size() == c2e_ref.size());
     REQUIRE(c2e == c2e_ref);
 }
+
+TEST_CASE("corner_to_edge_mapping: serial reference", "[core]")
+{
+    using namespace lagrange;
+    using Index = TriangleMesh3D::Index;
+
+    // Sphere with a dangling non-manifold facet and an isolated vertex, large enough to span
+    // several numbering blocks.
+    auto sphere = create_sphere(6);
+    TriangleMesh3D::VertexArray vertices(sphere->get_num_vertices() + 2, 3);
+    vertices.topRows(sphere->get_num_vertices()) = sphere->get_vertices();
+    vertices.bottomRows(2).setOnes();
+    TriangleMesh3D::FacetArray facets(sphere->get_num_facets() + 1, 3);
+    facets.topRows(sphere->get_num_facets()) = sphere->get_facets();
+    const auto f0 = sphere->get_facets().row(0);
+    facets.row(sphere->get_num_facets()) << f0(0), f0(1), Index(vertices.rows() - 2);
+    auto mesh = create_mesh(vertices, facets);
+    const Index num_vertices = mesh->get_num_vertices();
+    const Index num_corners = Index(facets.size());
+
+    // Serial reference: edges numbered in lexicographic order of their endpoints.
+    std::map<std::pair<Index, Index>, Index> edge_ids;
+    for (Index c = 0; c < num_corners; ++c) {
+        Index v1 = facets(c / 3, c % 3);
+        Index v2 = facets(c / 3, (c + 1) % 3);
+        edge_ids.emplace(std::minmax(v1, v2), 0);
+    }
+    Index num_ref_edges = 0;
+    for (auto& kv : edge_ids) kv.second = num_ref_edges++;
+
+    Eigen::VectorXi c2e;
+    const auto num_edges = corner_to_edge_mapping(facets, c2e);
+    REQUIRE(num_edges == num_ref_edges);
+    for (Index c = 0; c < num_corners; ++c) {
+        Index v1 = facets(c / 3, c % 3);
+        Index v2 = facets(c / 3, (c + 1) % 3);
+        REQUIRE(c2e(c) == edge_ids[std::minmax(v1, v2)]);
+    }
+
+    // Serial reference: corners pushed at the front of their chain in increasing order.
+    Eigen::VectorXi e2c_ref = Eigen::VectorXi::Constant(num_edges, INVALID<Index>());
+    Eigen::VectorXi next_e_ref = Eigen::VectorXi::Constant(num_corners, INVALID<Index>());
+    Eigen::VectorXi v2c_ref = Eigen::VectorXi::Constant(num_vertices, INVALID<Index>());
+    Eigen::VectorXi next_v_ref = Eigen::VectorXi::Constant(num_corners, INVALID<Index>());
+    for (Index c = 0; c < num_corners; ++c) {
+        next_e_ref(c) = e2c_ref(c2e(c));
+        e2c_ref(c2e(c)) = c;
+        const Index v = facets(c / 3, c % 3);
+        next_v_ref(c) = v2c_ref(v);
+        v2c_ref(v) = c;
+    }
+
+    Eigen::VectorXi e2c, next_e, v2c, next_v;
+    chain_corners_around_edges(facets, c2e, e2c, next_e);
+    chain_corners_around_vertices(num_vertices, facets, v2c, next_v);
+    REQUIRE(e2c == e2c_ref);
+    REQUIRE(next_e == next_e_ref);
+    REQUIRE(v2c == v2c_ref);
+    REQUIRE(next_v == next_v_ref);
+
+    // Boundary vertices are the endpoints of edges with a single incident corner.
+    mesh->initialize_edge_data();
+    std::vector<bool> is_boundary(num_vertices, false);
+    for (Index e = 0; e < Index(num_edges); ++e) {
+        if (next_e_ref(e2c_ref(e)) == INVALID<Index>()) {
+            const auto v = mesh->get_edge_vertices(e);
+            is_boundary[v[0]] = is_boundary[v[1]] = true;
+        }
+    }
+    for (Index v = 0; v < num_vertices; ++v) {
+        REQUIRE(mesh->is_boundary_vertex(v) == is_boundary[v]);
+    }
+    REQUIRE(mesh->is_boundary_vertex(num_vertices - 2));
+    REQUIRE(!mesh->is_boundary_vertex(num_vertices - 1));
+}
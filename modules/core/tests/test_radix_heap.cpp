@@ -0,0 +1,63 @@
+/*
+ * Copyright 2021 Adobe. All rights reserved.
+ * This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain a copy
+ * of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under
+ * the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ * OF ANY KIND, either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+ */
+#include <lagrange/testing/common.h>
+
+#include <lagrange/utils/RadixHeap.h>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+TEST_CASE("RadixHeap", "[utils]")
+{
+    std::mt19937 gen(0);
+    std::uniform_real_distribution<double> step(0, 2);
+    lagrange::RadixHeap<double, int> heap;
+    REQUIRE(heap.empty());
+
+    // Dijkstra-like sequence of operations: keys pushed are never below the last popped key.
+    for (int round = 0; round < 2; ++round) {
+        std::vector<double> pushed, popped;
+        double last = 0;
+        for (int i = 0; i < 10; ++i) {
+            pushed.push_back(step(gen));
+            heap.push(pushed.back(), i);
+        }
+        heap.push(0, -1);
+        pushed.push_back(0);
+        while (!heap.empty()) {
+            const auto entry = heap.pop();
+            REQUIRE(entry.first >= last);
+            last = entry.first;
+            popped.push_back(entry.first);
+            if (pushed.size() < 1000) {
+                for (int k = 0; k < 2; ++k) {
+                    pushed.push_back(last + step(gen) * (k == 0 ? 1e-8 : 1));
+                    heap.push(pushed.back(), int(pushed.size()));
+                }
+                pushed.push_back(last);
+                heap.push(last, int(pushed.size()));
+            }
+        }
+        std::sort(pushed.begin(), pushed.end());
+        REQUIRE(popped == pushed);
+
+        // The heap can be reused after being cleared.
+        heap.push(3, 0);
+        heap.clear();
+        REQUIRE(heap.empty());
+    }
+
+    lagrange::RadixHeap<float, int> float_heap;
+    for (int i = 10; i >= 0; --i) float_heap.push(float(i) / 4, i);
+    for (int i = 0; i <= 10; ++i) REQUIRE(float_heap.pop() == std::make_pair(float(i) / 4, i));
+}
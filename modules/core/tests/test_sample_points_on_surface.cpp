@@ -17,6 +17,8 @@
 #include <lagrange/io/save_mesh.h>
 #include <lagrange/sample_points_on_surface.h>
 
+#include <tbb/task_arena.h>
+
 TEST_CASE("SamplePointsOnSurface", "[sample_points_on_surface][triangle_mesh]" LA_SLOW_DEBUG_FLAG)
 {
     // Set this to true, only if the results need to be visualized.
@@ -314,5 +316,33 @@ TEST_CASE("SamplePointsOnSurface", "[sample_points_on_surface][triangle_mesh]" L
         }
     }
 
+    // Samples must not depend on the number of threads.
+    SECTION("deterministic")
+    {
+        auto mesh = create_sphere(4);
+        IndexList active_facets;
+        for (Index f = 0; f < mesh->get_num_facets(); f += 3) {
+            active_facets.push_back(f);
+        }
+        for (const auto& active : {IndexList(), active_facets}) {
+            auto out = sample_points_on_surface(*mesh, 20000, active);
+            SamplePointsOnSurfaceOutput<Mesh3D> single_threaded_out;
+            tbb::task_arena arena(1);
+            arena.execute(
+                [&] { single_threaded_out = sample_points_on_surface(*mesh, 20000, active); });
+            REQUIRE(out.num_samples == single_threaded_out.num_samples);
+            REQUIRE(out.facet_ids == single_threaded_out.facet_ids);
+            REQUIRE(out.positions == single_threaded_out.positions);
+            REQUIRE(out.barycentrics == single_threaded_out.barycentrics);
+            verify_samples(
+                mesh->get_vertices(),
+                mesh->get_facets(),
+                out.positions,
+                out.facet_ids,
+                out.barycentrics,
+                false);
+        }
+    }
+
     // Final todo: check agains SampleViaGrid
 }
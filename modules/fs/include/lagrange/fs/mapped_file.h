@@ -0,0 +1,88 @@
+/*
+ * Copyright 2021 Adobe. All rights reserved.
+ * This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain a copy
+ * of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under
+ * the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ * OF ANY KIND, either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+ */
+#pragma once
+
+#include <lagrange/fs/filesystem.h>
+
+#include <cstddef>
+
+namespace lagrange {
+namespace fs {
+
+///
+/// Read-only memory mapping of a whole file. The mapping is released when the object is destroyed.
+///
+class MappedFile
+{
+public:
+    MappedFile() = default;
+
+    ///
+    /// Maps a file in memory. Use is_open() to check whether the mapping succeeded.
+    ///
+    /// @param[in]  filename  File to map.
+    ///
+    explicit MappedFile(const path& filename) { open(filename); }
+
+    ~MappedFile() { close(); }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    MappedFile(MappedFile&& other) noexcept { swap(other); }
+    MappedFile& operator=(MappedFile&& other) noexcept
+    {
+        if (this != &other) {
+            close();
+            swap(other);
+        }
+        return *this;
+    }
+
+    ///
+    /// Maps a file in memory, releasing any previous mapping. Empty files are valid and result in
+    /// an open mapping of size 0.
+    ///
+    /// @param[in]  filename  File to map.
+    ///
+    /// @return     True if the file was successfully mapped.
+    ///
+    bool open(const path& filename);
+
+    /// Releases the mapping.
+    void close();
+
+    bool is_open() const { return m_is_open; }
+
+    const char* data() const { return m_data; }
+
+    size_t size() const { return m_size; }
+
+    const char* begin() const { return m_data; }
+
+    const char* end() const { return m_data + m_size; }
+
+private:
+    void swap(MappedFile& other) noexcept;
+
+private:
+    const char* m_data = nullptr;
+    size_t m_size = 0;
+    bool m_is_open = false;
+#ifdef _WIN32
+    void* m_file_handle = nullptr;
+    void* m_mapping_handle = nullptr;
+#endif
+};
+
+} // namespace fs
+} // namespace lagrange
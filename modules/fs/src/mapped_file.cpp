@@ -0,0 +1,120 @@
+/*
+ * Copyright 2021 Adobe. All rights reserved.
+ * This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain a copy
+ * of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under
+ * the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ * OF ANY KIND, either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+ */
+#include <lagrange/fs/mapped_file.h>
+
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <utility>
+
+namespace lagrange {
+namespace fs {
+
+bool MappedFile::open(const path& filename)
+{
+    close();
+
+#ifdef _WIN32
+    HANDLE file = CreateFileW(
+        filename.wstring().c_str(),
+        GENERIC_READ,
+        FILE_SHARE_READ,
+        NULL,
+        OPEN_EXISTING,
+        FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN,
+        NULL);
+    if (file == INVALID_HANDLE_VALUE) return false;
+
+    LARGE_INTEGER file_size;
+    if (!GetFileSizeEx(file, &file_size)) {
+        CloseHandle(file);
+        return false;
+    }
+    m_file_handle = file;
+    m_size = static_cast<size_t>(file_size.QuadPart);
+    m_is_open = true;
+    if (m_size == 0) return true;
+
+    HANDLE mapping = CreateFileMappingW(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (mapping == NULL) {
+        close();
+        return false;
+    }
+    m_mapping_handle = mapping;
+    m_data = static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+    if (m_data == nullptr) {
+        close();
+        return false;
+    }
+#else
+    const int fd = ::open(filename.string().c_str(), O_RDONLY);
+    if (fd < 0) return false;
+
+    struct stat info;
+    if (fstat(fd, &info) != 0) {
+        ::close(fd);
+        return false;
+    }
+    m_size = static_cast<size_t>(info.st_size);
+    m_is_open = true;
+    if (m_size > 0) {
+        void* ptr = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (ptr == MAP_FAILED) {
+            ::close(fd);
+            m_size = 0;
+            m_is_open = false;
+            return false;
+        }
+        m_data = static_cast<const char*>(ptr);
+    }
+    // The mapping stays valid after the descriptor is closed.
+    ::close(fd);
+#endif
+
+    return true;
+}
+
+void MappedFile::close()
+{
+#ifdef _WIN32
+    if (m_data) UnmapViewOfFile(m_data);
+    if (m_mapping_handle) CloseHandle(m_mapping_handle);
+    if (m_file_handle) CloseHandle(m_file_handle);
+    m_mapping_handle = nullptr;
+    m_file_handle = nullptr;
+#else
+    if (m_data) munmap(const_cast<char*>(m_data), m_size);
+#endif
+    m_data = nullptr;
+    m_size = 0;
+    m_is_open = false;
+}
+
+void MappedFile::swap(MappedFile& other) noexcept
+{
+    std::swap(m_data, other.m_data);
+    std::swap(m_size, other.m_size);
+    std::swap(m_is_open, other.m_is_open);
+#ifdef _WIN32
+    std::swap(m_file_handle, other.m_file_handle);
+    std::swap(m_mapping_handle, other.m_mapping_handle);
+#endif
+}
+
+} // namespace fs
+} // namespace lagrange
@@ -12,6 +12,9 @@
 #include <lagrange/testing/common.h>
 
 #include <lagrange/fs/file_utils.h>
+#include <lagrange/fs/mapped_file.h>
+
+#include <string>
 
 TEST_CASE("file_utils", "[io]")
 {
@@ -45,3 +48,34 @@ TEST_CASE("file_utils", "[io]")
     REQUIRE(data.size() == 12);
     REQUIRE(data == "Hello World!");
 }
+
+TEST_CASE("mapped_file", "[io]")
+{
+    using namespace lagrange;
+
+    const fs::path filename = "mapped_file_test.txt";
+    {
+        fs::ofstream f(filename, std::ios::binary);
+        f << "Hello World!";
+    }
+
+    fs::MappedFile file(filename);
+    REQUIRE(file.is_open());
+    REQUIRE(file.size() == 12);
+    REQUIRE(std::string(file.begin(), file.end()) == "Hello World!");
+
+    fs::MappedFile moved(std::move(file));
+    REQUIRE(!file.is_open());
+    REQUIRE(moved.is_open());
+    REQUIRE(std::string(moved.begin(), moved.end()) == "Hello World!");
+    moved.close();
+    REQUIRE(!moved.is_open());
+
+    { fs::ofstream f(filename, std::ios::binary | std::ios::trunc); }
+    REQUIRE(moved.open(filename));
+    REQUIRE(moved.size() == 0);
+    moved.close();
+    fs::remove(filename);
+
+    REQUIRE(!fs::MappedFile("does_not_exist.txt").is_open());
+}
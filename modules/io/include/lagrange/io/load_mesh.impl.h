@@ -3,6 +3,7 @@
 #include <lagrange/io/load_mesh.h>
 
 #include <lagrange/io/load_mesh_ext.h>
+#include <lagrange/io/load_mesh_obj.h>
 #include <lagrange/io/load_mesh_ply.h>
 #include <lagrange/fs/file_utils.h>
 #include <lagrange/MeshTrait.h>
@@ -36,11 +37,7 @@ std::vector<std::unique_ptr<MeshType>> load_obj_meshes(const fs::path& filename)
 {
     static_assert(MeshTrait<MeshType>::is_mesh(), "Input type is not Mesh");
 
-    if (!std::is_same<tinyobj::real_t, double>::value) {
-        logger().warn("Tinyobjloader compiled to use float, loss of precision may occur.");
-    }
-
-    return load_mesh_ext<MeshType>(filename).meshes;
+    return load_mesh_obj<MeshType>(filename).meshes;
 }
 extern template std::vector<std::unique_ptr<TriangleMesh3D>> load_obj_meshes(const fs::path&);
 extern template std::vector<std::unique_ptr<TriangleMesh3Df>> load_obj_meshes(const fs::path&);
@@ -0,0 +1,719 @@
+/*
+ * Copyright 2021 Adobe. All rights reserved.
+ * This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain a copy
+ * of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under
+ * the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ * OF ANY KIND, either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+ */
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <lagrange/MeshTrait.h>
+#include <lagrange/attributes/attribute_utils.h>
+#include <lagrange/common.h>
+#include <lagrange/create_mesh.h>
+#include <lagrange/io/load_mesh_ext.h>
+#include <lagrange/normalize_meshes.h>
+#include <lagrange/utils/range.h>
+#include <lagrange/utils/safe_cast.h>
+
+#include <lagrange/fs/filesystem.h>
+#include <lagrange/fs/mapped_file.h>
+
+#include <tbb/parallel_for.h>
+#include <tbb/task_arena.h>
+#include <tiny_obj_loader.h>
+
+namespace lagrange {
+namespace io {
+
+namespace internal {
+namespace obj {
+
+inline bool is_space(char c)
+{
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+inline const char* skip_space(const char* p, const char* end)
+{
+    while (p < end && is_space(*p)) ++p;
+    return p;
+}
+
+inline const char* skip_token(const char* p, const char* end)
+{
+    while (p < end && !is_space(*p)) ++p;
+    return p;
+}
+
+///
+/// Parses a floating point number. Decimal numbers with at most 17 significant digits and a small
+/// exponent are computed exactly, which covers virtually all OBJ files. Other inputs (long
+/// mantissas, large exponents, nan, inf) fall back to strtod.
+///
+/// @param[in]  p      Start of the number.
+/// @param[in]  end    End of the line.
+/// @param[out] value  Parsed value.
+///
+/// @return     Pointer past the parsed number, or nullptr if no number could be parsed.
+///
+inline const char* parse_double(const char* p, const char* end, double& value)
+{
+    static const double powers_of_ten[] = {1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,
+                                           1e8,  1e9,  1e10, 1e11, 1e12, 1e13, 1e14, 1e15,
+                                           1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+    constexpr uint64_t max_mantissa = 100000000000000000ULL; // 1e17
+    const char* start = p;
+
+    bool negative = false;
+    if (p < end && (*p == '-' || *p == '+')) {
+        negative = (*p == '-');
+        ++p;
+    }
+
+    uint64_t mantissa = 0;
+    int exponent = 0;
+    bool has_digits = false;
+    bool truncated = false;
+    for (; p < end && static_cast<unsigned>(*p - '0') < 10; ++p) {
+        has_digits = true;
+        if (mantissa < max_mantissa) {
+            mantissa = mantissa * 10 + static_cast<unsigned>(*p - '0');
+        } else {
+            ++exponent;
+            truncated = true;
+        }
+    }
+    if (p < end && *p == '.') {
+        for (++p; p < end && static_cast<unsigned>(*p - '0') < 10; ++p) {
+            has_digits = true;
+            if (mantissa < max_mantissa) {
+                mantissa = mantissa * 10 + static_cast<unsigned>(*p - '0');
+                --exponent;
+            } else {
+                truncated = true;
+            }
+        }
+    }
+    if (has_digits && p < end && (*p == 'e' || *p == 'E')) {
+        const char* q = p + 1;
+        bool negative_exponent = false;
+        if (q < end && (*q == '-' || *q == '+')) {
+            negative_exponent = (*q == '-');
+            ++q;
+        }
+        if (q < end && static_cast<unsigned>(*q - '0') < 10) {
+            int e = 0;
+            for (; q < end && static_cast<unsigned>(*q - '0') < 10; ++q) {
+                if (e < 100000) e = e * 10 + (*q - '0');
+            }
+            exponent += (negative_exponent ? -e : e);
+            p = q;
+        }
+    }
+
+    if (has_digits && !truncated && mantissa < (uint64_t(1) << 53) && exponent >= -22 &&
+        exponent <= 22) {
+        const double m = static_cast<double>(mantissa);
+        value = (exponent < 0 ? m / powers_of_ten[-exponent] : m * powers_of_ten[exponent]);
+        if (negative) value = -value;
+        return p;
+    }
+
+    // Slow path.
+    const std::string token(start, skip_token(start, end));
+    char* token_end = nullptr;
+    value = std::strtod(token.c_str(), &token_end);
+    if (token_end == token.c_str()) return nullptr;
+    return start + (token_end - token.c_str());
+}
+
+///
+/// Parses a (possibly negative) integer.
+///
+/// @param[in]  p      Start of the number.
+/// @param[in]  end    End of the line.
+/// @param[out] value  Parsed value, or 0 if there are no digits.
+///
+/// @return     Pointer past the parsed number.
+///
+inline const char* parse_int(const char* p, const char* end, int64_t& value)
+{
+    bool negative = false;
+    if (p < end && (*p == '-' || *p == '+')) {
+        negative = (*p == '-');
+        ++p;
+    }
+    value = 0;
+    for (; p < end && static_cast<unsigned>(*p - '0') < 10; ++p) {
+        value = value * 10 + (*p - '0');
+    }
+    if (negative) value = -value;
+    return p;
+}
+
+enum class LineType { Other, Vertex, Normal, TexCoord, Face, Object, UseMtl, MtlLib };
+
+///
+/// Identifies the type of a line and skips its keyword.
+///
+/// @param[in,out] p    Start of the line. Points past the keyword on return.
+/// @param[in]     eol  End of the line.
+///
+/// @return        The type of the line.
+///
+inline LineType get_line_type(const char*& p, const char* eol)
+{
+    p = skip_space(p, eol);
+    const size_t n = static_cast<size_t>(eol - p);
+    auto starts_with = [&](const char* keyword, size_t length) {
+        return n > length && std::strncmp(p, keyword, length) == 0 && is_space(p[length]);
+    };
+    LineType type = LineType::Other;
+    size_t length = 0;
+    if (n < 2) {
+        return type;
+    } else if (p[0] == 'v') {
+        if (is_space(p[1])) {
+            type = LineType::Vertex;
+            length = 1;
+        } else if (starts_with("vn", 2)) {
+            type = LineType::Normal;
+            length = 2;
+        } else if (starts_with("vt", 2)) {
+            type = LineType::TexCoord;
+            length = 2;
+        }
+    } else if (p[0] == 'f' && is_space(p[1])) {
+        type = LineType::Face;
+        length = 1;
+    } else if (p[0] == 'o' && is_space(p[1])) {
+        type = LineType::Object;
+        length = 1;
+    } else if (starts_with("usemtl", 6)) {
+        type = LineType::UseMtl;
+        length = 6;
+    } else if (starts_with("mtllib", 6)) {
+        type = LineType::MtlLib;
+        length = 6;
+    }
+    p += length;
+    return type;
+}
+
+///
+/// Calls a function on each line of a buffer, without the trailing newline.
+///
+template <typename Func>
+void for_each_line(const char* begin, const char* end, Func func)
+{
+    while (begin < end) {
+        const char* eol =
+            static_cast<const char*>(std::memchr(begin, '\n', static_cast<size_t>(end - begin)));
+        if (eol == nullptr) eol = end;
+        func(begin, eol);
+        begin = eol + 1;
+    }
+}
+
+/// Rest of the line, without surrounding whitespace.
+inline std::string get_line_string(const char* p, const char* eol)
+{
+    p = skip_space(p, eol);
+    while (eol > p && is_space(eol[-1])) --eol;
+    return std::string(p, eol);
+}
+
+/// Statements affecting global state, processed in file order after the first pass.
+struct Event
+{
+    LineType type;
+    std::string name;
+};
+
+/// Element counts of a part of a chunk that belongs to a single object.
+struct Segment
+{
+    size_t num_vertices = 0;
+    size_t num_normals = 0;
+    size_t num_uvs = 0;
+    size_t num_faces = 0;
+    size_t num_triangles = 0; // Number of triangles after fan triangulation.
+    int min_face_size = std::numeric_limits<int>::max();
+    int max_face_size = 0;
+
+    // Filled when resolving objects.
+    size_t object = 0;
+    size_t vertex_offset = 0;
+    size_t normal_offset = 0;
+    size_t uv_offset = 0;
+    size_t face_offset = 0; // Polygon offset, then output facet offset.
+    size_t triangle_offset = 0;
+};
+
+struct Chunk
+{
+    const char* begin = nullptr;
+    const char* end = nullptr;
+    std::vector<Event> events;
+    std::vector<Segment> segments;
+
+    // Filled when resolving objects and materials.
+    size_t first_material_event = 0;
+    int start_material_id = 0;
+};
+
+struct Object
+{
+    std::string name;
+    Segment counts;
+    size_t vertex_base = 0; // Global index of the first vertex of the object.
+    size_t normal_base = 0;
+    size_t uv_base = 0;
+    size_t num_cols = 0;
+    bool triangulate = false;
+};
+
+///
+/// First pass over a chunk: count elements per object segment and record global statements.
+///
+inline void scan_chunk(Chunk& chunk)
+{
+    chunk.segments.emplace_back();
+    for_each_line(chunk.begin, chunk.end, [&](const char* p, const char* eol) {
+        Segment& seg = chunk.segments.back();
+        const LineType type = get_line_type(p, eol);
+        switch (type) {
+        case LineType::Vertex: ++seg.num_vertices; break;
+        case LineType::Normal: ++seg.num_normals; break;
+        case LineType::TexCoord: ++seg.num_uvs; break;
+        case LineType::Face: {
+            int face_size = 0;
+            for (p = skip_space(p, eol); p < eol; p = skip_space(skip_token(p, eol), eol)) {
+                ++face_size;
+            }
+            if (face_size == 0) break;
+            ++seg.num_faces;
+            seg.num_triangles += static_cast<size_t>(std::max(face_size - 2, 0));
+            seg.min_face_size = std::min(seg.min_face_size, face_size);
+            seg.max_face_size = std::max(seg.max_face_size, face_size);
+            break;
+        }
+        case LineType::Object:
+            chunk.events.push_back({LineType::Object, get_line_string(p, eol)});
+            chunk.segments.emplace_back();
+            break;
+        case LineType::UseMtl:
+        case LineType::MtlLib:
+            chunk.events.push_back({type, get_line_string(p, eol)});
+            break;
+        default: break;
+        }
+    });
+}
+
+///
+/// Splits a buffer into line-aligned chunks.
+///
+inline std::vector<Chunk> split_chunks(const char* begin, const char* end)
+{
+    const size_t size = static_cast<size_t>(end - begin);
+    const size_t num_threads = static_cast<size_t>(tbb::this_task_arena::max_concurrency());
+    const size_t chunk_size = std::max<size_t>(size_t(1) << 20, size / (8 * num_threads) + 1);
+
+    std::vector<Chunk> chunks;
+    const char* p = begin;
+    while (p < end) {
+        Chunk chunk;
+        chunk.begin = p;
+        const char* q = p + std::min(chunk_size, static_cast<size_t>(end - p));
+        if (q < end) {
+            q = static_cast<const char*>(std::memchr(q, '\n', static_cast<size_t>(end - q)));
+            q = (q == nullptr ? end : q + 1);
+        }
+        chunk.end = q;
+        chunks.push_back(std::move(chunk));
+        p = q;
+    }
+    return chunks;
+}
+
+} // namespace obj
+} // namespace internal
+
+///
+/// Loads a .obj file with a multithreaded parser. The file is memory-mapped and split into
+/// line-aligned chunks that are parsed in parallel, writing directly into the output mesh arrays.
+///
+/// Results follow the same conventions as load_mesh_ext(): one mesh per object (`o` statement)
+/// unless `as_one_mesh` is set, UVs stored as an indexed attribute and mapped to a corner attribute,
+/// normals stored as a corner attribute, and material ids stored as a facet attribute when
+/// materials are loaded.
+///
+/// @param[in]  filename         Path to the .obj file.
+/// @param[in]  params           Optional parameters for the loader.
+/// @param[in]  material_reader  Optional pointer to the material reader class. Defaults to reading
+///                              material files from the directory of the .obj file.
+///
+/// @tparam     MeshType         Mesh type.
+///
+/// @return     Result of the load.
+///
+template <typename MeshType>
+MeshLoaderResult<MeshType> load_mesh_obj(
+    const fs::path& filename,
+    const MeshLoaderParams& params = {},
+    tinyobj::MaterialReader* material_reader = nullptr)
+{
+    static_assert(MeshTrait<MeshType>::is_mesh(), "Input type is not Mesh");
+    using namespace internal::obj;
+    using Scalar = typename MeshType::Scalar;
+    using Index = typename MeshType::Index;
+    using VertexArray = typename MeshType::VertexArray;
+    using FacetArray = typename MeshType::FacetArray;
+    using UVArray = typename MeshType::UVArray;
+    using UVIndices = typename MeshType::UVIndices;
+    using AttributeArray = typename MeshType::AttributeArray;
+
+    MeshLoaderResult<MeshType> result;
+
+    fs::MappedFile file(filename);
+    if (!file.is_open()) {
+        logger().error("Cannot open file: \"{}\"", filename);
+        result.success = false;
+        return result;
+    }
+    tinyobj::MaterialFileReader default_reader(filename.parent_path().string());
+    if (params.load_materials && !material_reader) {
+        material_reader = &default_reader;
+    }
+
+    // 1. Count elements of each chunk in parallel.
+    std::vector<Chunk> chunks = split_chunks(file.begin(), file.end());
+    tbb::parallel_for(size_t(0), chunks.size(), [&](size_t c) { scan_chunk(chunks[c]); });
+
+    // 2. Resolve objects, element offsets and materials, in file order.
+    std::vector<Object> objects(1);
+    std::vector<int> material_event_ids;
+    std::map<std::string, int> material_map;
+    int current_material_id = 0;
+    size_t num_vertices = 0, num_normals = 0, num_uvs = 0;
+
+    auto add_segment = [&](Segment& seg) {
+        Object& obj = objects.back();
+        seg.object = objects.size() - 1;
+        seg.vertex_offset = obj.counts.num_vertices;
+        seg.normal_offset = obj.counts.num_normals;
+        seg.uv_offset = obj.counts.num_uvs;
+        seg.face_offset = obj.counts.num_faces;
+        seg.triangle_offset = obj.counts.num_triangles;
+        obj.counts.num_vertices += seg.num_vertices;
+        obj.counts.num_normals += seg.num_normals;
+        obj.counts.num_uvs += seg.num_uvs;
+        obj.counts.num_faces += seg.num_faces;
+        obj.counts.num_triangles += seg.num_triangles;
+        obj.counts.min_face_size = std::min(obj.counts.min_face_size, seg.min_face_size);
+        obj.counts.max_face_size = std::max(obj.counts.max_face_size, seg.max_face_size);
+        num_vertices += seg.num_vertices;
+        num_normals += seg.num_normals;
+        num_uvs += seg.num_uvs;
+    };
+
+    for (auto& chunk : chunks) {
+        chunk.first_material_event = material_event_ids.size();
+        chunk.start_material_id = current_material_id;
+        size_t seg_index = 0;
+        add_segment(chunk.segments[seg_index]);
+        for (const auto& event : chunk.events) {
+            if (event.type == LineType::Object) {
+                if (!params.as_one_mesh) {
+                    if (objects.back().counts.num_vertices > 0) {
+                        objects.emplace_back();
+                        objects.back().vertex_base = num_vertices;
+                        objects.back().normal_base = num_normals;
+                        objects.back().uv_base = num_uvs;
+                    }
+                    objects.back().name = event.name;
+                }
+                add_segment(chunk.segments[++seg_index]);
+            } else if (event.type == LineType::UseMtl) {
+                auto it = material_map.find(event.name);
+                current_material_id = (it == material_map.end() ? -1 : it->second);
+                material_event_ids.push_back(current_material_id);
+            } else if (event.type == LineType::MtlLib && params.load_materials && material_reader) {
+                // Same as tinyobj: use the first material library that can be read.
+                const char* p = event.name.data();
+                const char* end = p + event.name.size();
+                for (p = skip_space(p, end); p < end;) {
+                    const char* q = skip_token(p, end);
+                    std::vector<tinyobj::material_t> materials;
+                    std::string warning_message, error_message;
+                    if ((*material_reader)(
+                            std::string(p, q),
+                            &materials,
+                            &material_map,
+                            &warning_message,
+                            &error_message)) {
+                        result.materials.insert(
+                            result.materials.end(),
+                            materials.begin(),
+                            materials.end());
+                        break;
+                    }
+                    p = skip_space(q, end);
+                }
+            }
+        }
+    }
+
+    const size_t num_coords =
+        (VertexArray::ColsAtCompileTime == Eigen::Dynamic ? 3 : VertexArray::ColsAtCompileTime);
+    constexpr size_t UV_DIM = 2;
+
+    struct ObjectData
+    {
+        VertexArray vertices;
+        FacetArray facets;
+        UVArray uvs;
+        UVIndices uv_indices;
+        AttributeArray normals;
+        std::vector<Index> corner_normal_ids;
+        std::vector<int> material_ids;
+    };
+    std::vector<ObjectData> data(objects.size());
+    for (auto i : range(objects.size())) {
+        auto& obj = objects[i];
+        auto& counts = obj.counts;
+        if (counts.num_faces == 0) counts.min_face_size = counts.max_face_size = 0;
+        if (FacetArray::ColsAtCompileTime == Eigen::Dynamic) {
+            obj.num_cols = static_cast<size_t>(counts.max_face_size);
+            if (counts.min_face_size != counts.max_face_size && params.triangulate) {
+                obj.num_cols = 3;
+            }
+        } else {
+            obj.num_cols = static_cast<size_t>(FacetArray::ColsAtCompileTime);
+        }
+        obj.triangulate = (obj.num_cols < static_cast<size_t>(counts.max_face_size));
+        const size_t num_out_faces = (obj.triangulate ? counts.num_triangles : counts.num_faces);
+
+        auto& d = data[i];
+        d.vertices.resize(counts.num_vertices, num_coords);
+        d.facets.resize(num_out_faces, obj.num_cols);
+        if (params.load_uvs && counts.num_uvs > 0) {
+            d.uvs.resize(counts.num_uvs, UV_DIM);
+            d.uv_indices.resize(num_out_faces, obj.num_cols);
+        }
+        if (params.load_normals && counts.num_normals > 0) {
+            d.normals.resize(counts.num_normals, num_coords);
+            d.corner_normal_ids.assign(num_out_faces * obj.num_cols, INVALID<Index>());
+        }
+        if (params.load_materials) {
+            d.material_ids.resize(num_out_faces);
+        }
+    }
+    for (auto& chunk : chunks) {
+        for (auto& seg : chunk.segments) {
+            if (objects[seg.object].triangulate) seg.face_offset = seg.triangle_offset;
+        }
+    }
+
+    // 3. Parse each chunk in parallel, writing directly into the output arrays.
+    tbb::parallel_for(size_t(0), chunks.size(), [&](size_t c) {
+        const Chunk& chunk = chunks[c];
+        size_t seg_index = 0;
+        const Segment* seg = &chunk.segments[0];
+        size_t v = 0, n = 0, t = 0, f = 0; // Element counts within the current segment.
+        size_t material_event = chunk.first_material_event;
+        int material_id = chunk.start_material_id;
+
+        struct Corner
+        {
+            int64_t v, t, n;
+        };
+        std::vector<Corner> corners;
+        double values[3];
+
+        // OBJ indices are 1-based, or negative for indices relative to the current element count.
+        auto resolve = [](int64_t index, size_t base, size_t count) -> Index {
+            int64_t i = -1;
+            if (index > 0) {
+                i = index - 1 - static_cast<int64_t>(base);
+            } else if (index < 0) {
+                i = static_cast<int64_t>(count) + index - static_cast<int64_t>(base);
+            }
+            return (i < 0 ? INVALID<Index>() : static_cast<Index>(i));
+        };
+
+        auto parse_values = [&](const char* p, const char* eol, int max_values) {
+            int k = 0;
+            for (p = skip_space(p, eol); p < eol && k < max_values; p = skip_space(p, eol)) {
+                const char* q = parse_double(p, eol, values[k]);
+                if (q == nullptr) break;
+                p = q;
+                ++k;
+            }
+            for (; k < max_values; ++k) values[k] = 0;
+        };
+
+        for_each_line(chunk.begin, chunk.end, [&](const char* p, const char* eol) {
+            const Object& obj = objects[seg->object];
+            ObjectData& d = data[seg->object];
+            switch (get_line_type(p, eol)) {
+            case LineType::Vertex: {
+                parse_values(p, eol, 3);
+                const size_t row = seg->vertex_offset + v++;
+                for (size_t k = 0; k < num_coords; ++k) {
+                    d.vertices(row, k) = static_cast<Scalar>(values[k]);
+                }
+                break;
+            }
+            case LineType::Normal: {
+                const size_t row = seg->normal_offset + n++;
+                if (d.normals.rows() == 0) break;
+                parse_values(p, eol, 3);
+                for (size_t k = 0; k < num_coords; ++k) {
+                    d.normals(row, k) = static_cast<Scalar>(values[k]);
+                }
+                break;
+            }
+            case LineType::TexCoord: {
+                const size_t row = seg->uv_offset + t++;
+                if (d.uvs.rows() == 0) break;
+                parse_values(p, eol, 2);
+                d.uvs(row, 0) = static_cast<Scalar>(values[0]);
+                d.uvs(row, 1) = static_cast<Scalar>(values[1]);
+                break;
+            }
+            case LineType::Face: {
+                const size_t v_count = obj.vertex_base + seg->vertex_offset + v;
+                const size_t n_count = obj.normal_base + seg->normal_offset + n;
+                const size_t t_count = obj.uv_base + seg->uv_offset + t;
+                corners.clear();
+                for (p = skip_space(p, eol); p < eol; p = skip_space(p, eol)) {
+                    Corner corner = {0, 0, 0};
+                    p = parse_int(p, eol, corner.v);
+                    if (p < eol && *p == '/') {
+                        p = parse_int(p + 1, eol, corner.t);
+                        if (p < eol && *p == '/') p = parse_int(p + 1, eol, corner.n);
+                    }
+                    p = skip_token(p, eol);
+                    corners.push_back(corner);
+                }
+                if (corners.empty()) break;
+
+                auto write_corner = [&](size_t row, size_t col, const Corner& corner) {
+                    d.facets(row, col) = resolve(corner.v, obj.vertex_base, v_count);
+                    if (d.uv_indices.rows() > 0) {
+                        d.uv_indices(row, col) = resolve(corner.t, obj.uv_base, t_count);
+                    }
+                    if (!d.corner_normal_ids.empty()) {
+                        d.corner_normal_ids[row * obj.num_cols + col] =
+                            resolve(corner.n, obj.normal_base, n_count);
+                    }
+                };
+
+                const size_t face_size = corners.size();
+                if (obj.triangulate) {
+                    // Triangle fan, always using the first vertex of the polygon.
+                    for (size_t i = 0; i + 2 < face_size; ++i) {
+                        const size_t row = seg->face_offset + f++;
+                        write_corner(row, 0, corners[0]);
+                        write_corner(row, 1, corners[i + 1]);
+                        write_corner(row, 2, corners[i + 2]);
+                        if (params.load_materials) d.material_ids[row] = material_id;
+                    }
+                } else {
+                    const size_t row = seg->face_offset + f++;
+                    for (size_t i = 0; i < face_size; ++i) {
+                        write_corner(row, i, corners[i]);
+                    }
+                    // Padding with INVALID<Index> for mixed triangle/quad or arbitrary polygon
+                    // meshes.
+                    for (size_t pad = face_size; pad < obj.num_cols; ++pad) {
+                        d.facets(row, pad) = INVALID<Index>();
+                        if (d.uv_indices.rows() > 0) d.uv_indices(row, pad) = INVALID<Index>();
+                    }
+                    if (params.load_materials) d.material_ids[row] = material_id;
+                }
+                break;
+            }
+            case LineType::Object:
+                seg = &chunk.segments[++seg_index];
+                v = n = t = f = 0;
+                break;
+            case LineType::UseMtl: material_id = material_event_ids[material_event++]; break;
+            default: break;
+            }
+        });
+    });
+
+    // 4. Assemble meshes.
+    for (auto i : range(objects.size())) {
+        const auto& obj = objects[i];
+        auto& d = data[i];
+        // Same as load_mesh_ext: objects without vertices are skipped.
+        if (obj.counts.num_vertices == 0) continue;
+
+        const Index num_out_faces = safe_cast<Index>(d.facets.rows());
+        AttributeArray corner_normals;
+        if (!d.corner_normal_ids.empty()) {
+            const Index num_corners = safe_cast<Index>(d.corner_normal_ids.size());
+            corner_normals.resize(num_corners, num_coords);
+            tbb::parallel_for(Index(0), num_corners, [&](Index c) {
+                const Index ni = d.corner_normal_ids[c];
+                if (ni == INVALID<Index>() || ni >= d.normals.rows()) {
+                    corner_normals.row(c).setZero();
+                } else {
+                    corner_normals.row(c) = d.normals.row(ni);
+                }
+            });
+        }
+
+        auto mesh = create_mesh(std::move(d.vertices), std::move(d.facets));
+
+        if (d.uvs.rows() > 0) {
+            mesh->initialize_uv(d.uvs, d.uv_indices);
+
+            // TODO: The loader should not do this mapping index -> corner
+            map_indexed_attribute_to_corner_attribute(*mesh, "uv");
+        }
+
+        if (corner_normals.rows() > 0) {
+            mesh->add_corner_attribute("normal");
+            mesh->import_corner_attribute("normal", corner_normals);
+        }
+
+        if (result.materials.size() > 0 &&
+            safe_cast<Index>(d.material_ids.size()) == num_out_faces) {
+            // Because AttributeArray is not integral type, this converts to float type
+            Eigen::Map<Eigen::VectorXi> map(d.material_ids.data(), d.material_ids.size());
+            mesh->add_facet_attribute("material_id");
+            mesh->set_facet_attribute("material_id", map.cast<Scalar>());
+        }
+
+        result.meshes.emplace_back(std::move(mesh));
+        result.mesh_names.push_back(obj.name);
+    }
+
+    if (params.normalize) {
+        normalize_meshes(result.meshes);
+    }
+
+    return result;
+}
+
+} // namespace io
+} // namespace lagrange
@@ -12,15 +12,13 @@
 #pragma once
 
 #include <lagrange/fs/filesystem.h>
+#include <lagrange/io/ply_utils.h>
 
+#include <lagrange/Logger.h>
 #include <lagrange/MeshTrait.h>
 #include <lagrange/create_mesh.h>
-
-// clang-format off
-#include <lagrange/utils/warnoff.h>
-#include <igl/readPLY.h>
-#include <lagrange/utils/warnon.h>
-// clang-format on
+#include <lagrange/utils/la_assert.h>
+#include <lagrange/utils/safe_cast.h>
 
 #include <string>
 #include <vector>
@@ -28,87 +26,188 @@
 namespace lagrange {
 namespace io {
 
-/// Load .ply with color information (if available)
+struct PlyLoaderParams
+{
+    /// Load the nx, ny, nz vertex properties as the "normal" vertex attribute.
+    bool load_normals = true;
+
+    /// Load the red, green, blue (and alpha) vertex properties as the "color" vertex attribute.
+    bool load_colors = true;
+
+    /// Additional scalar vertex properties to load. Each property is stored as a single-column
+    /// vertex attribute of the same name.
+    std::vector<std::string> vertex_properties;
+};
+
+///
+/// Loads a .ply mesh with normal and color information (if available). Ascii, binary little endian
+/// and binary big endian files are supported.
+///
+/// Element data is streamed from the file in bounded-size chunks and decoded directly into the
+/// mesh buffers, without staging whole property columns in memory. Properties that are not
+/// requested are skipped.
+///
+/// @param[in]  filename  Input file name.
+/// @param[in]  params    Loading parameters.
+///
+/// @tparam     MeshType  Mesh type.
+///
+/// @return     The loaded mesh, or nullptr if the file could not be opened.
+///
 template <typename MeshType>
-std::unique_ptr<MeshType> load_mesh_ply(const fs::path& filename)
+std::unique_ptr<MeshType> load_mesh_ply(
+    const fs::path& filename,
+    const PlyLoaderParams& params = {})
 {
     static_assert(MeshTrait<MeshType>::is_mesh(), "Input type is not Mesh");
     using VertexArray = typename MeshType::VertexArray;
     using FacetArray = typename MeshType::FacetArray;
     using AttributeArray = typename MeshType::AttributeArray;
+    using Scalar = typename MeshType::Scalar;
     using Index = typename MeshType::Index;
+    namespace ply = internal::ply;
+
+    fs::ifstream in(filename, std::ios::binary);
+    if (!in.is_open()) {
+        logger().error("Cannot open file: \"{}\"", filename.string());
+        return nullptr;
+    }
+    const ply::Header header = ply::read_header(in);
+
+    // Resolve the properties to load.
+    const ply::Element empty_element;
+    const ply::Element* vertex_element = &empty_element;
+    const ply::Element* face_element = &empty_element;
+    for (const auto& element : header.elements) {
+        if (element.name == "vertex") vertex_element = &element;
+        if (element.name == "face") face_element = &element;
+    }
+
+    auto find_properties = [&](std::initializer_list<const char*> names) {
+        std::vector<int> indices;
+        for (const char* name : names) {
+            const int k = vertex_element->find_property(name);
+            if (k < 0) break;
+            indices.push_back(k);
+        }
+        return indices;
+    };
+
+    std::vector<int> position_props = find_properties({"x", "y", "z"});
+    LA_ASSERT(position_props.size() >= 2, "PLY file is missing vertex positions");
+    constexpr int Dim = VertexArray::ColsAtCompileTime;
+    const Eigen::Index dim = (Dim == Eigen::Dynamic)
+                                 ? safe_cast<Eigen::Index>(position_props.size())
+                                 : Eigen::Index(Dim);
+    if (safe_cast<Eigen::Index>(position_props.size()) > dim) position_props.resize(dim);
+
+    std::vector<int> normal_props;
+    if (params.load_normals) {
+        normal_props = find_properties({"nx", "ny", "nz"});
+        if (normal_props.size() != 3) normal_props.clear();
+    }
+
+    std::vector<int> color_props;
+    if (params.load_colors) {
+        color_props = find_properties({"red", "green", "blue", "alpha"});
+        if (color_props.size() < 3) color_props.clear();
+    }
+
+    std::vector<int> extra_props;
+    std::vector<std::string> extra_names;
+    for (const auto& name : params.vertex_properties) {
+        const int k = vertex_element->find_property(name);
+        if (k < 0 || vertex_element->properties[k].is_list) {
+            logger().warn("Vertex property not found in PLY file: {}", name);
+            continue;
+        }
+        extra_props.push_back(k);
+        extra_names.push_back(name);
+    }
 
-    VertexArray V;
-    FacetArray F;
-    Eigen::Matrix<Index, Eigen::Dynamic, Eigen::Dynamic> E;
-    AttributeArray N;
-    AttributeArray UV;
-
-    AttributeArray VD;
-    std::vector<std::string> VDheader;
-
-    AttributeArray FD;
-    std::vector<std::string> FDheader;
-
-    AttributeArray ED;
-    std::vector<std::string> EDheader;
-    std::vector<std::string> comments;
-
-    // TODO: libigl's wrapper around tinyply doesn't allow to load attributes of different tyeps
-    // (e.g. char for colors + float for normals).
-    igl::readPLY(
-        filename.string(),
-        V,
-        F,
-        E,
-        N,
-        UV,
-        VD,
-        VDheader,
-        FD,
-        FDheader,
-        ED,
-        EDheader,
-        comments);
+    int face_prop = face_element->find_property("vertex_indices");
+    if (face_prop < 0) face_prop = face_element->find_property("vertex_index");
+
+    // Allocate the output buffers.
+    const Eigen::Index num_vertices = safe_cast<Eigen::Index>(vertex_element->count);
+    const Eigen::Index num_facets =
+        (face_prop < 0 ? 0 : safe_cast<Eigen::Index>(face_element->count));
+    VertexArray V(num_vertices, dim);
+    V.setZero();
+    FacetArray F(
+        num_facets,
+        FacetArray::ColsAtCompileTime == Eigen::Dynamic ? 3 : FacetArray::ColsAtCompileTime);
+    AttributeArray N(normal_props.empty() ? 0 : num_vertices, 3);
+    AttributeArray C(num_vertices, safe_cast<Eigen::Index>(color_props.size()));
+    AttributeArray X(num_vertices, safe_cast<Eigen::Index>(extra_props.size()));
+
+    // Stream the elements in file order.
+    ply::ChunkedReader reader(in);
+    auto ignore_row = [](size_t, const double*) {};
+    auto ignore_list = [](size_t, size_t, size_t, const double*) {};
+    for (const auto& element : header.elements) {
+        if (&element == vertex_element) {
+            ply::read_element(
+                in,
+                reader,
+                header.format,
+                element,
+                [&](size_t i, const double* values) {
+                    const auto row = safe_cast<Eigen::Index>(i);
+                    for (size_t j = 0; j < position_props.size(); ++j) {
+                        V(row, j) = static_cast<Scalar>(values[position_props[j]]);
+                    }
+                    for (size_t j = 0; j < normal_props.size(); ++j) {
+                        N(row, j) = static_cast<Scalar>(values[normal_props[j]]);
+                    }
+                    for (size_t j = 0; j < color_props.size(); ++j) {
+                        C(row, j) = static_cast<Scalar>(values[color_props[j]]);
+                    }
+                    for (size_t j = 0; j < extra_props.size(); ++j) {
+                        X(row, j) = static_cast<Scalar>(values[extra_props[j]]);
+                    }
+                },
+                ignore_list);
+        } else if (&element == face_element && face_prop >= 0) {
+            ply::read_element(
+                in,
+                reader,
+                header.format,
+                element,
+                ignore_row,
+                [&](size_t i, size_t k, size_t count, const double* values) {
+                    if (k != safe_cast<size_t>(face_prop)) return;
+                    const auto row = safe_cast<Eigen::Index>(i);
+                    if (row == 0 && FacetArray::ColsAtCompileTime == Eigen::Dynamic) {
+                        F.resize(num_facets, safe_cast<Eigen::Index>(count));
+                    }
+                    LA_ASSERT(
+                        safe_cast<Eigen::Index>(count) == F.cols(),
+                        "PLY facet size does not match the mesh facet size");
+                    for (size_t j = 0; j < count; ++j) {
+                        F(row, j) = static_cast<Index>(values[j]);
+                    }
+                });
+        } else {
+            ply::read_element(in, reader, header.format, element, ignore_row, ignore_list);
+        }
+    }
 
     auto mesh = create_mesh(std::move(V), std::move(F));
-    if (N.rows() == mesh->get_num_vertices()) {
+    if (!normal_props.empty()) {
         logger().debug("Setting vertex normal");
         mesh->add_vertex_attribute("normal");
         mesh->import_vertex_attribute("normal", N);
     }
-
-    auto has_attribute = [&](const std::string& name) {
-        return std::find(VDheader.begin(), VDheader.end(), name) != VDheader.end();
-    };
-
-    if (VD.rows() == mesh->get_num_vertices()) {
-        if (has_attribute("red") && has_attribute("green") && has_attribute("blue")) {
-            bool has_alpha = has_attribute("alpha");
-            int n = (has_alpha ? 4 : 3);
-            AttributeArray color(mesh->get_num_vertices(), n);
-            color.setZero();
-            for (size_t i = 0; i < VDheader.size(); ++i) {
-                if (VDheader[i] == "red") {
-                    LA_ASSERT(n >= 1);
-                    color.col(0) = VD.col(i);
-                } else if (VDheader[i] == "green") {
-                    LA_ASSERT(n >= 2);
-                    color.col(1) = VD.col(i);
-                } else if (VDheader[i] == "blue") {
-                    LA_ASSERT(n >= 3);
-                    color.col(2) = VD.col(i);
-                } else if (VDheader[i] == "alpha") {
-                    LA_ASSERT(n >= 4);
-                    color.col(3) = VD.col(i);
-                } else {
-                    logger().warn("Unknown vertex attribute: {}", VDheader[i]);
-                }
-            }
-            logger().debug("Setting vertex color");
-            mesh->add_vertex_attribute("color");
-            mesh->import_vertex_attribute("color", color);
-        }
+    if (!color_props.empty()) {
+        logger().debug("Setting vertex color");
+        mesh->add_vertex_attribute("color");
+        mesh->import_vertex_attribute("color", C);
+    }
+    for (size_t j = 0; j < extra_props.size(); ++j) {
+        AttributeArray attr = X.col(j);
+        mesh->add_vertex_attribute(extra_names[j]);
+        mesh->import_vertex_attribute(extra_names[j], attr);
     }
 
     return mesh;
@@ -0,0 +1,722 @@
+/*
+ * Copyright 2021 Adobe. All rights reserved.
+ * This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain a copy
+ * of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under
+ * the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ * OF ANY KIND, either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+ */
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include <lagrange/Mesh.h>
+#include <lagrange/MeshTrait.h>
+#include <lagrange/common.h>
+#include <lagrange/create_mesh.h>
+#include <lagrange/experimental/Array.h>
+#include <lagrange/experimental/Scalar.h>
+#include <lagrange/utils/la_assert.h>
+#include <lagrange/utils/safe_cast.h>
+
+#include <lagrange/fs/filesystem.h>
+#include <lagrange/fs/mapped_file.h>
+
+namespace lagrange {
+namespace io {
+
+///
+/// Binary mesh archive.
+///
+/// The archive stores the mesh buffers exactly as they are laid out in memory, so that loading
+/// amounts to one memcpy per buffer (load_mesh_archive), or no copy at all when the file is
+/// memory-mapped (map_mesh_archive). The layout is:
+///
+/// - A fixed-size file header (magic, endianness tag, format version, section count and the
+///   offset of the section table).
+/// - The payload of each section, aligned to ArchiveAlignment bytes. Matrices are always stored
+///   in row-major order.
+/// - The section names, followed by the section table.
+///
+/// Sections describe the vertices, the facets, and every vertex/facet/corner/edge/indexed
+/// attribute of the mesh. Attributes keep their own scalar type.
+///
+namespace archive {
+
+constexpr char Magic[8] = {'L', 'G', 'R', 'M', 'E', 'S', 'H', '\0'};
+constexpr uint32_t EndianTag = 0x01020304;
+constexpr uint16_t VersionMajor = 1;
+constexpr uint16_t VersionMinor = 0;
+constexpr uint64_t ArchiveAlignment = 64;
+
+enum class SectionKind : uint32_t {
+    Vertices = 0,
+    Facets = 1,
+    VertexAttribute = 2,
+    FacetAttribute = 3,
+    CornerAttribute = 4,
+    EdgeAttribute = 5,
+    IndexedValues = 6,
+    IndexedIndices = 7,
+};
+
+struct FileHeader
+{
+    char magic[8];
+    uint32_t endian_tag;
+    uint16_t version_major;
+    uint16_t version_minor;
+    uint64_t num_sections;
+    uint64_t section_table_offset;
+};
+
+struct SectionEntry
+{
+    uint32_t kind;
+    uint8_t scalar_type;
+    uint8_t reserved[3];
+    uint64_t rows;
+    uint64_t cols;
+    uint64_t name_offset;
+    uint64_t name_size;
+    uint64_t data_offset;
+    uint64_t data_size;
+};
+
+static_assert(sizeof(FileHeader) == 32, "Unexpected archive header size");
+static_assert(sizeof(SectionEntry) == 56, "Unexpected archive section size");
+
+} // namespace archive
+
+namespace internal {
+
+inline size_t scalar_size(experimental::ScalarEnum type)
+{
+    using experimental::ScalarEnum;
+    switch (type) {
+    case ScalarEnum::INT8:
+    case ScalarEnum::UINT8: return 1;
+    case ScalarEnum::INT16:
+    case ScalarEnum::UINT16: return 2;
+    case ScalarEnum::INT32:
+    case ScalarEnum::UINT32:
+    case ScalarEnum::FLOAT: return 4;
+    case ScalarEnum::INT64:
+    case ScalarEnum::UINT64:
+    case ScalarEnum::DOUBLE: return 8;
+    default: throw std::runtime_error("Unsupported scalar type in mesh archive");
+    }
+}
+
+///
+/// Returns the byte size of a rows x cols section, or throws if it does not fit in 64 bits.
+///
+inline uint64_t section_byte_size(uint64_t rows, uint64_t cols, experimental::ScalarEnum type)
+{
+    constexpr uint64_t max_size = std::numeric_limits<uint64_t>::max();
+    const uint64_t element_size = scalar_size(type);
+    LA_ASSERT(cols == 0 || rows <= max_size / cols, "Mesh archive section size overflows");
+    const uint64_t num_elements = rows * cols;
+    LA_ASSERT(num_elements <= max_size / element_size, "Mesh archive section size overflows");
+    return num_elements * element_size;
+}
+
+///
+/// Calls func(T()) where T is the C++ type corresponding to a runtime scalar type.
+///
+template <typename Func>
+void dispatch_scalar(experimental::ScalarEnum type, Func&& func)
+{
+    using namespace experimental;
+    switch (type) {
+    case ScalarEnum::INT8: func(EnumToScalar_t<ScalarEnum::INT8>()); break;
+    case ScalarEnum::INT16: func(EnumToScalar_t<ScalarEnum::INT16>()); break;
+    case ScalarEnum::INT32: func(EnumToScalar_t<ScalarEnum::INT32>()); break;
+    case ScalarEnum::INT64: func(EnumToScalar_t<ScalarEnum::INT64>()); break;
+    case ScalarEnum::UINT8: func(EnumToScalar_t<ScalarEnum::UINT8>()); break;
+    case ScalarEnum::UINT16: func(EnumToScalar_t<ScalarEnum::UINT16>()); break;
+    case ScalarEnum::UINT32: func(EnumToScalar_t<ScalarEnum::UINT32>()); break;
+    case ScalarEnum::UINT64: func(EnumToScalar_t<ScalarEnum::UINT64>()); break;
+    case ScalarEnum::FLOAT: func(EnumToScalar_t<ScalarEnum::FLOAT>()); break;
+    case ScalarEnum::DOUBLE: func(EnumToScalar_t<ScalarEnum::DOUBLE>()); break;
+    default: throw std::runtime_error("Unsupported scalar type in mesh archive");
+    }
+}
+
+class ArchiveWriter
+{
+public:
+    explicit ArchiveWriter(const fs::path& filename)
+        : m_out(filename, std::ios::binary)
+    {
+        LA_ASSERT(m_out.good(), "Cannot open file for writing: " + filename.string());
+        archive::FileHeader header;
+        std::memset(&header, 0, sizeof(header));
+        m_out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        m_offset = sizeof(header);
+    }
+
+    void add_section(
+        archive::SectionKind kind,
+        const std::string& name,
+        experimental::ScalarEnum scalar_type,
+        uint64_t rows,
+        uint64_t cols,
+        const void* data)
+    {
+        pad_to_alignment();
+
+        archive::SectionEntry entry;
+        std::memset(&entry, 0, sizeof(entry));
+        entry.kind = static_cast<uint32_t>(kind);
+        entry.scalar_type = static_cast<uint8_t>(scalar_type);
+        entry.rows = rows;
+        entry.cols = cols;
+        entry.name_offset = m_names.size();
+        entry.name_size = name.size();
+        entry.data_offset = m_offset;
+        entry.data_size = rows * cols * scalar_size(scalar_type);
+        m_names += name;
+
+        if (entry.data_size > 0) {
+            m_out.write(
+                static_cast<const char*>(data),
+                safe_cast<std::streamsize>(entry.data_size));
+            m_offset += entry.data_size;
+        }
+        m_sections.push_back(entry);
+    }
+
+    ///
+    /// Adds a section holding a dense Eigen matrix. Column-major matrices are transposed into a
+    /// temporary row-major copy first.
+    ///
+    template <typename Derived>
+    void add_matrix(
+        archive::SectionKind kind,
+        const std::string& name,
+        const Eigen::MatrixBase<Derived>& matrix)
+    {
+        using Scalar = typename Derived::Scalar;
+        using RowMajorMatrix =
+            Eigen::Matrix<Scalar, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>;
+        RowMajorMatrix tmp;
+        const Scalar* data = matrix.derived().data();
+        if (!Derived::IsRowMajor && matrix.cols() > 1) {
+            tmp = matrix;
+            data = tmp.data();
+        }
+        add_section(
+            kind,
+            name,
+            experimental::ScalarToEnum_v<Scalar>,
+            safe_cast<uint64_t>(matrix.rows()),
+            safe_cast<uint64_t>(matrix.cols()),
+            data);
+    }
+
+    void add_array(
+        archive::SectionKind kind,
+        const std::string& name,
+        const experimental::ArrayBase& array)
+    {
+        if (array.is_row_major() || array.cols() == 1) {
+            add_section(
+                kind,
+                name,
+                array.get_scalar_type(),
+                safe_cast<uint64_t>(array.rows()),
+                safe_cast<uint64_t>(array.cols()),
+                array.data());
+        } else {
+            dispatch_scalar(array.get_scalar_type(), [&](auto dummy) {
+                using T = decltype(dummy);
+                using ColMajorMatrix = Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic>;
+                add_matrix(kind, name, array.view<ColMajorMatrix>());
+            });
+        }
+    }
+
+    void finalize()
+    {
+        const uint64_t names_offset = m_offset;
+        m_out.write(m_names.data(), safe_cast<std::streamsize>(m_names.size()));
+        m_offset += m_names.size();
+        pad_to_alignment();
+        for (auto& entry : m_sections) {
+            entry.name_offset += names_offset;
+        }
+
+        archive::FileHeader header;
+        std::memset(&header, 0, sizeof(header));
+        std::memcpy(header.magic, archive::Magic, sizeof(header.magic));
+        header.endian_tag = archive::EndianTag;
+        header.version_major = archive::VersionMajor;
+        header.version_minor = archive::VersionMinor;
+        header.num_sections = m_sections.size();
+        header.section_table_offset = m_offset;
+
+        m_out.write(
+            reinterpret_cast<const char*>(m_sections.data()),
+            safe_cast<std::streamsize>(m_sections.size() * sizeof(archive::SectionEntry)));
+        m_out.seekp(0);
+        m_out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        m_out.close();
+        LA_ASSERT(!m_out.fail(), "Failed to write mesh archive");
+    }
+
+private:
+    void pad_to_alignment()
+    {
+        static const char zeros[archive::ArchiveAlignment] = {};
+        const uint64_t padding =
+            (archive::ArchiveAlignment - m_offset % archive::ArchiveAlignment) %
+            archive::ArchiveAlignment;
+        m_out.write(zeros, safe_cast<std::streamsize>(padding));
+        m_offset += padding;
+    }
+
+private:
+    fs::ofstream m_out;
+    uint64_t m_offset = 0;
+    std::vector<archive::SectionEntry> m_sections;
+    std::string m_names;
+};
+
+///
+/// Read-only view over the sections of an archive held in memory. Validates the header and the
+/// section table on construction.
+///
+class ArchiveReader
+{
+public:
+    struct Section
+    {
+        archive::SectionKind kind;
+        experimental::ScalarEnum scalar_type;
+        std::string name;
+        Eigen::Index rows;
+        Eigen::Index cols;
+        const void* data;
+    };
+
+public:
+    ArchiveReader(const char* data, size_t size)
+    {
+        LA_ASSERT(size >= sizeof(archive::FileHeader), "Mesh archive is truncated");
+        archive::FileHeader header;
+        std::memcpy(&header, data, sizeof(header));
+        LA_ASSERT(
+            std::memcmp(header.magic, archive::Magic, sizeof(header.magic)) == 0,
+            "Not a mesh archive");
+        LA_ASSERT(
+            header.endian_tag == archive::EndianTag,
+            "Mesh archive was written with a different endianness");
+        LA_ASSERT(
+            header.version_major == archive::VersionMajor,
+            "Unsupported mesh archive version");
+        LA_ASSERT(
+            header.section_table_offset <= size &&
+                header.num_sections <=
+                    (size - header.section_table_offset) / sizeof(archive::SectionEntry),
+            "Mesh archive section table is truncated");
+
+        m_sections.reserve(safe_cast<size_t>(header.num_sections));
+        for (uint64_t i = 0; i < header.num_sections; ++i) {
+            archive::SectionEntry entry;
+            std::memcpy(
+                &entry,
+                data + header.section_table_offset + i * sizeof(archive::SectionEntry),
+                sizeof(entry));
+            const auto scalar_type = static_cast<experimental::ScalarEnum>(entry.scalar_type);
+            LA_ASSERT(
+                entry.kind <= static_cast<uint32_t>(archive::SectionKind::IndexedIndices),
+                "Unknown mesh archive section kind");
+            LA_ASSERT(
+                entry.name_offset <= size && entry.name_size <= size - entry.name_offset,
+                "Mesh archive section name is out of bounds");
+            LA_ASSERT(
+                entry.data_size == section_byte_size(entry.rows, entry.cols, scalar_type),
+                "Mesh archive section has an inconsistent size");
+            LA_ASSERT(
+                entry.data_offset <= size && entry.data_size <= size - entry.data_offset &&
+                    entry.data_offset % archive::ArchiveAlignment == 0,
+                "Mesh archive section data is out of bounds");
+
+            Section section;
+            section.kind = static_cast<archive::SectionKind>(entry.kind);
+            section.scalar_type = scalar_type;
+            section.name.assign(data + entry.name_offset, safe_cast<size_t>(entry.name_size));
+            section.rows = safe_cast<Eigen::Index>(entry.rows);
+            section.cols = safe_cast<Eigen::Index>(entry.cols);
+            section.data = data + entry.data_offset;
+            m_sections.push_back(std::move(section));
+        }
+    }
+
+    const std::vector<Section>& get_sections() const { return m_sections; }
+
+    const Section& get_section(archive::SectionKind kind) const
+    {
+        for (const auto& section : m_sections) {
+            if (section.kind == kind) return section;
+        }
+        throw std::runtime_error("Mesh archive is missing a required section");
+    }
+
+    const Section& get_section(archive::SectionKind kind, const std::string& name) const
+    {
+        for (const auto& section : m_sections) {
+            if (section.kind == kind && section.name == name) return section;
+        }
+        throw std::runtime_error("Mesh archive is missing section: " + name);
+    }
+
+private:
+    std::vector<Section> m_sections;
+};
+
+///
+/// Checks that a section holds integer indices in [0, num_values). Throws otherwise.
+///
+/// Padding values are accepted: INVALID<T>() (e.g. for mixed triangle/quad or polygon facets
+/// loaded from OBJ files), and -1 for signed types.
+///
+inline void validate_index_section(const ArchiveReader::Section& section, uint64_t num_values)
+{
+    dispatch_scalar(section.scalar_type, [&](auto dummy) {
+        using T = decltype(dummy);
+        if constexpr (!std::is_integral<T>::value) {
+            throw std::runtime_error("Mesh archive index section must have an integer type");
+        } else {
+            const T* indices = static_cast<const T*>(section.data);
+            const Eigen::Index num_indices = section.rows * section.cols;
+            for (Eigen::Index i = 0; i < num_indices; ++i) {
+                const T index = indices[i];
+                if (index == INVALID<T>()) continue;
+                if (std::is_signed<T>::value && index == T(-1)) continue;
+                LA_ASSERT(
+                    !(index < T(0)) && static_cast<uint64_t>(index) < num_values,
+                    "Mesh archive index is out of range");
+            }
+        }
+    });
+}
+
+///
+/// Checks that the facets reference existing vertices, and indexed attributes existing values.
+///
+inline void validate_archive_indices(const ArchiveReader& reader)
+{
+    using archive::SectionKind;
+    const auto& vertices = reader.get_section(SectionKind::Vertices);
+    validate_index_section(
+        reader.get_section(SectionKind::Facets),
+        safe_cast<uint64_t>(vertices.rows));
+    for (const auto& section : reader.get_sections()) {
+        if (section.kind != SectionKind::IndexedValues) continue;
+        validate_index_section(
+            reader.get_section(SectionKind::IndexedIndices, section.name),
+            safe_cast<uint64_t>(section.rows));
+    }
+}
+
+///
+/// Copies a section into a plain Eigen matrix, converting the scalar type if needed.
+///
+template <typename MatrixType>
+void copy_section(const ArchiveReader::Section& section, MatrixType& matrix)
+{
+    constexpr int Cols = MatrixType::ColsAtCompileTime;
+    LA_ASSERT(
+        Cols == Eigen::Dynamic || Cols == section.cols,
+        "Archive column count does not match the requested array type");
+    dispatch_scalar(section.scalar_type, [&](auto dummy) {
+        using T = decltype(dummy);
+        using RowMajorMatrix = Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>;
+        Eigen::Map<const RowMajorMatrix> map(
+            static_cast<const T*>(section.data),
+            section.rows,
+            section.cols);
+        matrix = map.template cast<typename MatrixType::Scalar>();
+    });
+}
+
+///
+/// Wraps a section into an array. If copy is false, the returned array references the section
+/// data directly and must not outlive it.
+///
+inline std::shared_ptr<experimental::ArrayBase> wrap_section(
+    const ArchiveReader::Section& section,
+    bool copy)
+{
+    std::shared_ptr<experimental::ArrayBase> result;
+    dispatch_scalar(section.scalar_type, [&](auto dummy) {
+        using T = decltype(dummy);
+        using RawArray = experimental::
+            RawArray<const T, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>;
+        auto raw = std::make_shared<RawArray>(
+            static_cast<const T*>(section.data),
+            section.rows,
+            section.cols);
+        if (copy) {
+            result = raw->clone();
+        } else {
+            result = std::move(raw);
+        }
+    });
+    return result;
+}
+
+///
+/// Attaches all the attribute sections of an archive to a mesh.
+///
+template <typename MeshType>
+void set_archive_attributes(MeshType& mesh, const ArchiveReader& reader, bool copy)
+{
+    using archive::SectionKind;
+    for (const auto& section : reader.get_sections()) {
+        switch (section.kind) {
+        case SectionKind::VertexAttribute:
+            mesh.add_vertex_attribute(section.name);
+            mesh.set_vertex_attribute_array(section.name, wrap_section(section, copy));
+            break;
+        case SectionKind::FacetAttribute:
+            mesh.add_facet_attribute(section.name);
+            mesh.set_facet_attribute_array(section.name, wrap_section(section, copy));
+            break;
+        case SectionKind::CornerAttribute:
+            mesh.add_corner_attribute(section.name);
+            mesh.set_corner_attribute_array(section.name, wrap_section(section, copy));
+            break;
+        case SectionKind::EdgeAttribute:
+            mesh.initialize_edge_data();
+            mesh.add_edge_attribute(section.name);
+            mesh.set_edge_attribute_array(section.name, wrap_section(section, copy));
+            break;
+        case SectionKind::IndexedValues: {
+            const auto& indices = reader.get_section(SectionKind::IndexedIndices, section.name);
+            mesh.add_indexed_attribute(section.name);
+            mesh.set_indexed_attribute_array(
+                section.name,
+                wrap_section(section, copy),
+                wrap_section(indices, copy));
+            break;
+        }
+        default: break;
+        }
+    }
+}
+
+} // namespace internal
+
+///
+/// Saves a mesh and all its attributes into a binary mesh archive.
+///
+/// @param[in]  filename  Output file name.
+/// @param[in]  mesh      Mesh to save.
+///
+template <typename MeshType>
+void save_mesh_archive(const fs::path& filename, const MeshType& mesh)
+{
+    static_assert(MeshTrait<MeshType>::is_mesh(), "Input type is not Mesh");
+    using archive::SectionKind;
+
+    internal::ArchiveWriter writer(filename);
+    writer.add_matrix(SectionKind::Vertices, "", mesh.get_vertices());
+    writer.add_matrix(SectionKind::Facets, "", mesh.get_facets());
+
+    auto add_attributes = [&](SectionKind kind, const std::vector<std::string>& names, auto get) {
+        for (const auto& name : names) {
+            const auto array = get(name);
+            if (array == nullptr) continue;
+            writer.add_array(kind, name, *array);
+        }
+    };
+    add_attributes(
+        SectionKind::VertexAttribute,
+        mesh.get_vertex_attribute_names(),
+        [&](const std::string& name) { return mesh.get_vertex_attribute_array(name); });
+    add_attributes(
+        SectionKind::FacetAttribute,
+        mesh.get_facet_attribute_names(),
+        [&](const std::string& name) { return mesh.get_facet_attribute_array(name); });
+    add_attributes(
+        SectionKind::CornerAttribute,
+        mesh.get_corner_attribute_names(),
+        [&](const std::string& name) { return mesh.get_corner_attribute_array(name); });
+    if (mesh.is_edge_data_initialized()) {
+        add_attributes(
+            SectionKind::EdgeAttribute,
+            mesh.get_edge_attribute_names(),
+            [&](const std::string& name) { return mesh.get_edge_attribute_array(name); });
+    }
+    for (const auto& name : mesh.get_indexed_attribute_names()) {
+        const auto attr = mesh.get_indexed_attribute_array(name);
+        const auto& values = std::get<0>(attr);
+        const auto& indices = std::get<1>(attr);
+        if (values == nullptr || indices == nullptr) continue;
+        writer.add_array(SectionKind::IndexedValues, name, *values);
+        writer.add_array(SectionKind::IndexedIndices, name, *indices);
+    }
+
+    writer.finalize();
+}
+
+///
+/// Loads a mesh from a binary mesh archive. The file is memory-mapped and each buffer is copied
+/// once into the returned mesh; no parsing is involved. Vertex and facet buffers are converted to
+/// the scalar and index types of MeshType if needed, while attributes keep the scalar type they
+/// were saved with.
+///
+/// @param[in]  filename  Input file name.
+///
+/// @tparam     MeshType  Mesh type.
+///
+/// @return     The loaded mesh, or nullptr if the file could not be opened.
+///
+template <typename MeshType>
+std::unique_ptr<MeshType> load_mesh_archive(const fs::path& filename)
+{
+    static_assert(MeshTrait<MeshType>::is_mesh(), "Input type is not Mesh");
+    using VertexArray = typename MeshType::VertexArray;
+    using FacetArray = typename MeshType::FacetArray;
+    using archive::SectionKind;
+
+    fs::MappedFile file;
+    if (!file.open(filename)) {
+        logger().error("Cannot open file: \"{}\"", filename.string());
+        return nullptr;
+    }
+    internal::ArchiveReader reader(file.data(), file.size());
+    internal::validate_archive_indices(reader);
+
+    VertexArray vertices;
+    FacetArray facets;
+    internal::copy_section(reader.get_section(SectionKind::Vertices), vertices);
+    internal::copy_section(reader.get_section(SectionKind::Facets), facets);
+    auto mesh = create_mesh(std::move(vertices), std::move(facets));
+    internal::set_archive_attributes(*mesh, reader, true);
+    return mesh;
+}
+
+///
+/// Mesh backed by a memory-mapped archive. Vertices, facets and attributes all point directly
+/// into the mapped file, so opening an archive costs no copy regardless of its size.
+///
+/// The mesh is read-only: vertices and facets are exposed as const Eigen::Map, and attributes are
+/// stored as experimental::RawArray views. Attributes must therefore be accessed through the
+/// `get_*_attribute_array` methods (e.g. `mesh.get_vertex_attribute_array(name)->view<T>()`)
+/// rather than `get_*_attribute`, which expects an owned array. The mapping stays valid for the
+/// lifetime of this object, which cannot be copied or moved.
+///
+/// @tparam     VertexArray  Row-major vertex array type matching the archive content.
+/// @tparam     FacetArray   Row-major facet array type matching the archive content.
+///
+template <typename VertexArray, typename FacetArray>
+class MappedMeshArchive
+{
+public:
+    using VertexMap = Eigen::Map<const VertexArray, Eigen::Aligned16>;
+    using FacetMap = Eigen::Map<const FacetArray, Eigen::Aligned16>;
+    using MeshType = Mesh<VertexMap, FacetMap>;
+
+    static_assert(
+        VertexArray::IsRowMajor || VertexArray::ColsAtCompileTime == 1,
+        "Mapped archives require a row-major vertex array");
+    static_assert(
+        FacetArray::IsRowMajor || FacetArray::ColsAtCompileTime == 1,
+        "Mapped archives require a row-major facet array");
+
+public:
+    ///
+    /// Maps an archive.
+    ///
+    /// @param[in]  file  Opened file holding the archive. Ownership is transferred to this object.
+    ///
+    explicit MappedMeshArchive(fs::MappedFile file)
+        : m_file(std::move(file))
+        , m_reader(validated_reader(m_file))
+        , m_vertices(map_section<VertexMap>(archive::SectionKind::Vertices))
+        , m_facets(map_section<FacetMap>(archive::SectionKind::Facets))
+    {
+        m_mesh = wrap_with_mesh(m_vertices, m_facets);
+        internal::set_archive_attributes(*m_mesh, m_reader, false);
+    }
+
+    MappedMeshArchive(const MappedMeshArchive&) = delete;
+    MappedMeshArchive(MappedMeshArchive&&) = delete;
+    MappedMeshArchive& operator=(const MappedMeshArchive&) = delete;
+    MappedMeshArchive& operator=(MappedMeshArchive&&) = delete;
+
+    /// Mesh wrapping the mapped buffers.
+    MeshType& get_mesh() { return *m_mesh; }
+    const MeshType& get_mesh() const { return *m_mesh; }
+
+    /// Underlying mapped file.
+    const fs::MappedFile& get_file() const { return m_file; }
+
+private:
+    static internal::ArchiveReader validated_reader(const fs::MappedFile& file)
+    {
+        internal::ArchiveReader reader(file.data(), file.size());
+        internal::validate_archive_indices(reader);
+        return reader;
+    }
+
+    template <typename MapType>
+    MapType map_section(archive::SectionKind kind) const
+    {
+        using Scalar = typename MapType::Scalar;
+        constexpr int Cols = MapType::ColsAtCompileTime;
+        const auto& section = m_reader.get_section(kind);
+        LA_ASSERT(
+            section.scalar_type == experimental::ScalarToEnum_v<Scalar>,
+            "Archive scalar type does not match the requested array type");
+        LA_ASSERT(
+            Cols == Eigen::Dynamic || Cols == section.cols,
+            "Archive column count does not match the requested array type");
+        return MapType(static_cast<const Scalar*>(section.data), section.rows, section.cols);
+    }
+
+private:
+    fs::MappedFile m_file;
+    internal::ArchiveReader m_reader;
+    VertexMap m_vertices;
+    FacetMap m_facets;
+    std::unique_ptr<MeshType> m_mesh;
+};
+
+///
+/// Memory-maps a binary mesh archive without copying its content.
+///
+/// @param[in]  filename     Input file name.
+///
+/// @tparam     VertexArray  Row-major vertex array type matching the archive content.
+/// @tparam     FacetArray   Row-major facet array type matching the archive content.
+///
+/// @return     The mapped archive, or nullptr if the file could not be opened.
+///
+template <typename VertexArray = Vertices3D, typename FacetArray = Triangles>
+std::unique_ptr<MappedMeshArchive<VertexArray, FacetArray>> map_mesh_archive(
+    const fs::path& filename)
+{
+    fs::MappedFile file;
+    if (!file.open(filename)) {
+        logger().error("Cannot open file: \"{}\"", filename.string());
+        return nullptr;
+    }
+    return std::make_unique<MappedMeshArchive<VertexArray, FacetArray>>(std::move(file));
+}
+
+} // namespace io
+} // namespace lagrange
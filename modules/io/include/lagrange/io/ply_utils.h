@@ -0,0 +1,481 @@
+/*
+ * Copyright 2021 Adobe. All rights reserved.
+ * This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain a copy
+ * of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under
+ * the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ * OF ANY KIND, either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+ */
+#pragma once
+
+#include <lagrange/Logger.h>
+#include <lagrange/utils/la_assert.h>
+#include <lagrange/utils/safe_cast.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <istream>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace lagrange {
+namespace io {
+namespace internal {
+namespace ply {
+
+/// Size of the staging buffer used to stream binary element data, in bytes.
+constexpr size_t ChunkSize = size_t(1) << 22;
+
+enum class Format { Ascii, BinaryLittleEndian, BinaryBigEndian };
+
+enum class Type { Int8, UInt8, Int16, UInt16, Int32, UInt32, Float32, Float64 };
+
+struct Property
+{
+    std::string name;
+    Type type = Type::Float32;
+    bool is_list = false;
+    Type count_type = Type::UInt8;
+};
+
+struct Element
+{
+    std::string name;
+    size_t count = 0;
+    std::vector<Property> properties;
+
+    bool has_list() const
+    {
+        return std::any_of(properties.begin(), properties.end(), [](const Property& p) {
+            return p.is_list;
+        });
+    }
+
+    int find_property(const std::string& property_name) const
+    {
+        for (size_t i = 0; i < properties.size(); ++i) {
+            if (properties[i].name == property_name) return static_cast<int>(i);
+        }
+        return -1;
+    }
+};
+
+struct Header
+{
+    Format format = Format::Ascii;
+    std::vector<Element> elements;
+};
+
+inline bool is_little_endian_host()
+{
+    const uint16_t value = 1;
+    uint8_t first_byte;
+    std::memcpy(&first_byte, &value, 1);
+    return first_byte == 1;
+}
+
+inline size_t type_size(Type type)
+{
+    switch (type) {
+    case Type::Int8:
+    case Type::UInt8: return 1;
+    case Type::Int16:
+    case Type::UInt16: return 2;
+    case Type::Int32:
+    case Type::UInt32:
+    case Type::Float32: return 4;
+    case Type::Float64: return 8;
+    default: return 0;
+    }
+}
+
+inline Type parse_type(const std::string& name)
+{
+    if (name == "char" || name == "int8") return Type::Int8;
+    if (name == "uchar" || name == "uint8") return Type::UInt8;
+    if (name == "short" || name == "int16") return Type::Int16;
+    if (name == "ushort" || name == "uint16") return Type::UInt16;
+    if (name == "int" || name == "int32") return Type::Int32;
+    if (name == "uint" || name == "uint32") return Type::UInt32;
+    if (name == "float" || name == "float32") return Type::Float32;
+    if (name == "double" || name == "float64") return Type::Float64;
+    throw std::runtime_error("Unknown PLY property type: " + name);
+}
+
+inline const char* type_name(Type type)
+{
+    switch (type) {
+    case Type::Int8: return "char";
+    case Type::UInt8: return "uchar";
+    case Type::Int16: return "short";
+    case Type::UInt16: return "ushort";
+    case Type::Int32: return "int";
+    case Type::UInt32: return "uint";
+    case Type::Float32: return "float";
+    case Type::Float64: return "double";
+    default: return "unknown";
+    }
+}
+
+template <typename T>
+struct TypeOf;
+template <>
+struct TypeOf<int8_t>
+{
+    static constexpr Type value = Type::Int8;
+};
+template <>
+struct TypeOf<uint8_t>
+{
+    static constexpr Type value = Type::UInt8;
+};
+template <>
+struct TypeOf<int16_t>
+{
+    static constexpr Type value = Type::Int16;
+};
+template <>
+struct TypeOf<uint16_t>
+{
+    static constexpr Type value = Type::UInt16;
+};
+template <>
+struct TypeOf<int32_t>
+{
+    static constexpr Type value = Type::Int32;
+};
+template <>
+struct TypeOf<uint32_t>
+{
+    static constexpr Type value = Type::UInt32;
+};
+template <>
+struct TypeOf<float>
+{
+    static constexpr Type value = Type::Float32;
+};
+template <>
+struct TypeOf<double>
+{
+    static constexpr Type value = Type::Float64;
+};
+
+///
+/// Decodes a single binary value.
+///
+/// @param[in]  p     Pointer to the encoded value.
+/// @param[in]  type  Encoded type.
+/// @param[in]  swap  Whether the value is stored with the opposite endianness of the host.
+///
+/// @return     The decoded value.
+///
+inline double decode(const char* p, Type type, bool swap)
+{
+    char bytes[8];
+    const size_t n = type_size(type);
+    std::memcpy(bytes, p, n);
+    if (swap) std::reverse(bytes, bytes + n);
+
+    switch (type) {
+    case Type::Int8: {
+        int8_t v;
+        std::memcpy(&v, bytes, 1);
+        return v;
+    }
+    case Type::UInt8: {
+        uint8_t v;
+        std::memcpy(&v, bytes, 1);
+        return v;
+    }
+    case Type::Int16: {
+        int16_t v;
+        std::memcpy(&v, bytes, 2);
+        return v;
+    }
+    case Type::UInt16: {
+        uint16_t v;
+        std::memcpy(&v, bytes, 2);
+        return v;
+    }
+    case Type::Int32: {
+        int32_t v;
+        std::memcpy(&v, bytes, 4);
+        return v;
+    }
+    case Type::UInt32: {
+        uint32_t v;
+        std::memcpy(&v, bytes, 4);
+        return v;
+    }
+    case Type::Float32: {
+        float v;
+        std::memcpy(&v, bytes, 4);
+        return v;
+    }
+    case Type::Float64: {
+        double v;
+        std::memcpy(&v, bytes, 8);
+        return v;
+    }
+    default: return 0;
+    }
+}
+
+///
+/// Reads a PLY header. On return, the stream is positioned at the start of the element data.
+///
+/// @param[in]  in    Input stream.
+///
+/// @return     The parsed header.
+///
+inline Header read_header(std::istream& in)
+{
+    Header header;
+    std::string line;
+
+    auto next_line = [&]() {
+        LA_ASSERT(std::getline(in, line), "Unexpected end of PLY header");
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+    };
+
+    next_line();
+    LA_ASSERT(line == "ply", "Invalid PLY file: missing magic number");
+
+    bool has_format = false;
+    while (true) {
+        next_line();
+        std::istringstream tokens(line);
+        std::string keyword;
+        tokens >> keyword;
+        if (keyword.empty() || keyword == "comment" || keyword == "obj_info") {
+            continue;
+        } else if (keyword == "format") {
+            std::string format, version;
+            tokens >> format >> version;
+            if (format == "ascii") {
+                header.format = Format::Ascii;
+            } else if (format == "binary_little_endian") {
+                header.format = Format::BinaryLittleEndian;
+            } else if (format == "binary_big_endian") {
+                header.format = Format::BinaryBigEndian;
+            } else {
+                throw std::runtime_error("Unknown PLY format: " + format);
+            }
+            has_format = true;
+        } else if (keyword == "element") {
+            Element element;
+            tokens >> element.name >> element.count;
+            LA_ASSERT(!tokens.fail(), "Invalid PLY element declaration: " + line);
+            header.elements.push_back(std::move(element));
+        } else if (keyword == "property") {
+            LA_ASSERT(!header.elements.empty(), "PLY property declared before any element");
+            Property property;
+            std::string type;
+            tokens >> type;
+            if (type == "list") {
+                std::string count_type, value_type;
+                tokens >> count_type >> value_type;
+                property.is_list = true;
+                property.count_type = parse_type(count_type);
+                property.type = parse_type(value_type);
+            } else {
+                property.type = parse_type(type);
+            }
+            tokens >> property.name;
+            LA_ASSERT(!tokens.fail(), "Invalid PLY property declaration: " + line);
+            header.elements.back().properties.push_back(std::move(property));
+        } else if (keyword == "end_header") {
+            break;
+        } else {
+            throw std::runtime_error("Unknown PLY header keyword: " + keyword);
+        }
+    }
+    LA_ASSERT(has_format, "Invalid PLY file: missing format");
+    return header;
+}
+
+///
+/// Buffered reader over a binary stream. Hands out contiguous blocks of at most ChunkSize bytes
+/// (or larger on demand), so element data never needs to be staged in full.
+///
+class ChunkedReader
+{
+public:
+    explicit ChunkedReader(std::istream& in)
+        : m_in(in)
+        , m_buffer(ChunkSize)
+    {}
+
+    ///
+    /// Ensures that n contiguous bytes are available, and consumes them.
+    ///
+    /// @param[in]  n     Number of bytes.
+    ///
+    /// @return     Pointer to the first byte. Valid until the next call.
+    ///
+    const char* take(size_t n)
+    {
+        if (m_end - m_begin < n) refill(n);
+        const char* p = m_buffer.data() + m_begin;
+        m_begin += n;
+        return p;
+    }
+
+private:
+    void refill(size_t n)
+    {
+        const size_t remaining = m_end - m_begin;
+        std::memmove(m_buffer.data(), m_buffer.data() + m_begin, remaining);
+        m_begin = 0;
+        m_end = remaining;
+        if (m_buffer.size() < n) m_buffer.resize(n);
+        m_in.read(m_buffer.data() + m_end, safe_cast<std::streamsize>(m_buffer.size() - m_end));
+        m_end += safe_cast<size_t>(m_in.gcount());
+        LA_ASSERT(m_end >= n, "Unexpected end of PLY file");
+    }
+
+private:
+    std::istream& m_in;
+    std::vector<char> m_buffer;
+    size_t m_begin = 0;
+    size_t m_end = 0;
+};
+
+///
+/// Streams the rows of an element.
+///
+/// @param[in]  in       Input stream, positioned at the start of the element data.
+/// @param[in]  reader   Buffered reader over the same stream (binary formats only).
+/// @param[in]  format   File format.
+/// @param[in]  element  Element to read.
+/// @param[in]  on_row   Callback on_row(row, values), where values[k] holds the value of the k-th
+///                      scalar property (entries of list properties are unspecified).
+/// @param[in]  on_list  Callback on_list(row, k, count, values) invoked for each list property k.
+///
+template <typename RowFunc, typename ListFunc>
+void read_element(
+    std::istream& in,
+    ChunkedReader& reader,
+    Format format,
+    const Element& element,
+    RowFunc&& on_row,
+    ListFunc&& on_list)
+{
+    const size_t num_properties = element.properties.size();
+    std::vector<double> values(num_properties, 0.0);
+    std::vector<double> list_values;
+
+    if (format == Format::Ascii) {
+        for (size_t row = 0; row < element.count; ++row) {
+            for (size_t k = 0; k < num_properties; ++k) {
+                const auto& property = element.properties[k];
+                if (property.is_list) {
+                    double count = 0;
+                    in >> count;
+                    list_values.resize(safe_cast<size_t>(count));
+                    for (auto& v : list_values) in >> v;
+                    LA_ASSERT(!in.fail(), "Invalid PLY ascii data");
+                    on_list(row, k, list_values.size(), list_values.data());
+                } else {
+                    in >> values[k];
+                }
+            }
+            LA_ASSERT(!in.fail(), "Invalid PLY ascii data");
+            on_row(row, values.data());
+        }
+        return;
+    }
+
+    const bool swap = (format == Format::BinaryLittleEndian) != is_little_endian_host();
+    if (!element.has_list()) {
+        // Fixed stride: decode rows by blocks.
+        std::vector<size_t> offsets(num_properties);
+        size_t stride = 0;
+        for (size_t k = 0; k < num_properties; ++k) {
+            offsets[k] = stride;
+            stride += type_size(element.properties[k].type);
+        }
+        if (stride == 0) return;
+        const size_t rows_per_block = std::max<size_t>(1, ChunkSize / stride);
+        for (size_t first = 0; first < element.count; first += rows_per_block) {
+            const size_t num_rows = std::min(rows_per_block, element.count - first);
+            const char* block = reader.take(num_rows * stride);
+            for (size_t r = 0; r < num_rows; ++r) {
+                const char* p = block + r * stride;
+                for (size_t k = 0; k < num_properties; ++k) {
+                    values[k] = decode(p + offsets[k], element.properties[k].type, swap);
+                }
+                on_row(first + r, values.data());
+            }
+        }
+        return;
+    }
+
+    for (size_t row = 0; row < element.count; ++row) {
+        for (size_t k = 0; k < num_properties; ++k) {
+            const auto& property = element.properties[k];
+            if (property.is_list) {
+                const size_t count = safe_cast<size_t>(
+                    decode(reader.take(type_size(property.count_type)), property.count_type, swap));
+                const size_t value_size = type_size(property.type);
+                const char* p = reader.take(count * value_size);
+                list_values.resize(count);
+                for (size_t i = 0; i < count; ++i) {
+                    list_values[i] = decode(p + i * value_size, property.type, swap);
+                }
+                on_list(row, k, count, list_values.data());
+            } else {
+                values[k] = decode(reader.take(type_size(property.type)), property.type, swap);
+            }
+        }
+        on_row(row, values.data());
+    }
+}
+
+///
+/// Buffered binary writer. Values are always written in little endian order.
+///
+class ChunkedWriter
+{
+public:
+    explicit ChunkedWriter(std::ostream& out)
+        : m_out(out)
+        , m_swap(!is_little_endian_host())
+    {
+        m_buffer.reserve(ChunkSize);
+    }
+
+    ~ChunkedWriter() { flush(); }
+
+    template <typename T>
+    void write(T value)
+    {
+        char bytes[sizeof(T)];
+        std::memcpy(bytes, &value, sizeof(T));
+        if (m_swap) std::reverse(bytes, bytes + sizeof(T));
+        if (m_buffer.size() + sizeof(T) > ChunkSize) flush();
+        m_buffer.insert(m_buffer.end(), bytes, bytes + sizeof(T));
+    }
+
+    void flush()
+    {
+        m_out.write(m_buffer.data(), safe_cast<std::streamsize>(m_buffer.size()));
+        m_buffer.clear();
+    }
+
+private:
+    std::ostream& m_out;
+    bool m_swap;
+    std::vector<char> m_buffer;
+};
+
+} // namespace ply
+} // namespace internal
+} // namespace io
+} // namespace lagrange
@@ -11,15 +11,12 @@
  */
 #pragma once
 
+#include <algorithm>
+#include <cstdio>
 #include <fstream>
 #include <numeric>
 #include <string>
-
-// clang-format off
-#include <lagrange/utils/warnoff.h>
-#include <igl/writeOBJ.h>
-#include <lagrange/utils/warnon.h>
-// clang-format on
+#include <vector>
 
 #include <lagrange/Mesh.h>
 #include <lagrange/MeshTrait.h>
@@ -33,40 +30,163 @@
 
 #include <lagrange/fs/filesystem.h>
 
+#include <tbb/parallel_for.h>
+#include <tbb/task_arena.h>
+
 namespace lagrange {
 namespace io {
 
 namespace internal {
+
+///
+/// Appends a floating point value to a buffer, formatted with a printf-style format string. Values
+/// are formatted exactly as printf/ostream would, which keeps the output byte-compatible with the
+/// stream-based writers.
+///
+inline void append_double(std::string& buffer, const char* format, double value)
+{
+    char tmp[64];
+    const int n = std::snprintf(tmp, sizeof(tmp), format, value);
+    buffer.append(tmp, safe_cast<size_t>(std::max(n, 0)));
+}
+
+template <typename T>
+void append_integer(std::string& buffer, T value)
+{
+    char tmp[24];
+    char* end = tmp + sizeof(tmp);
+    char* p = end;
+    const long long signed_value = static_cast<long long>(value);
+    const bool negative = signed_value < 0;
+    auto v = static_cast<unsigned long long>(negative ? -signed_value : signed_value);
+    do {
+        *(--p) = static_cast<char>('0' + v % 10);
+        v /= 10;
+    } while (v != 0);
+    if (negative) *(--p) = '-';
+    buffer.append(p, end);
+}
+
+///
+/// Format string matching Eigen's IOFormat(FullPrecision) for a given scalar type.
+///
+template <typename Scalar>
+std::string full_precision_format()
+{
+    char format[16];
+    std::snprintf(
+        format,
+        sizeof(format),
+        "%%.%dg",
+        int(Eigen::internal::significant_decimals_impl<Scalar>::run()));
+    return format;
+}
+
+///
+/// Formats rows in parallel and writes them to a stream in order. Rows are grouped into blocks
+/// that are formatted into separate buffers, and a bounded number of blocks is processed at a time
+/// so that memory usage does not grow with the size of the output.
+///
+/// @param[in]  out         Output stream.
+/// @param[in]  num_rows    Number of rows.
+/// @param[in]  format_row  Callback format_row(buffer, row) appending the text of a row.
+///
+template <typename Index, typename RowFunc>
+void write_rows(std::ostream& out, Index num_rows, RowFunc&& format_row)
+{
+    constexpr Index block_size = 4096;
+    const Index num_blocks = (num_rows + block_size - 1) / block_size;
+    const Index blocks_per_batch =
+        std::max<Index>(1, safe_cast<Index>(4 * tbb::this_task_arena::max_concurrency()));
+    std::vector<std::string> buffers(safe_cast<size_t>(std::min(num_blocks, blocks_per_batch)));
+
+    for (Index first_block = 0; first_block < num_blocks; first_block += blocks_per_batch) {
+        const Index last_block = std::min(num_blocks, first_block + blocks_per_batch);
+        tbb::parallel_for(first_block, last_block, [&](Index b) {
+            auto& buffer = buffers[safe_cast<size_t>(b - first_block)];
+            buffer.clear();
+            const Index end = std::min(num_rows, (b + 1) * block_size);
+            for (Index i = b * block_size; i < end; ++i) {
+                format_row(buffer, i);
+            }
+        });
+        for (Index b = first_block; b < last_block; ++b) {
+            const auto& buffer = buffers[safe_cast<size_t>(b - first_block)];
+            out.write(buffer.data(), safe_cast<std::streamsize>(buffer.size()));
+        }
+    }
+}
+
 template <typename MeshType>
 void save_mesh_2D(const fs::path& filename, const MeshType& mesh)
 {
+    using Index = typename MeshType::Index;
+
+    // Same output as streaming with the default precision.
     fs::ofstream fout(filename);
     const auto& vertices = mesh.get_vertices();
-    for (auto i : range(mesh.get_num_vertices())) {
-        fout << "v " << vertices(i, 0) << " " << vertices(i, 1) << std::endl;
-    }
+    write_rows(fout, mesh.get_num_vertices(), [&](std::string& buffer, Index i) {
+        buffer += "v ";
+        append_double(buffer, "%.6g", double(vertices(i, 0)));
+        buffer += ' ';
+        append_double(buffer, "%.6g", double(vertices(i, 1)));
+        buffer += '\n';
+    });
 
     const auto& facets = mesh.get_facets();
     const auto vertex_per_facet = mesh.get_vertex_per_facet();
-    for (auto i : range(mesh.get_num_facets())) {
-        fout << "f";
+    write_rows(fout, mesh.get_num_facets(), [&](std::string& buffer, Index i) {
+        buffer += 'f';
         for (auto j : range(vertex_per_facet)) {
-            fout << " " << facets(i, j) + 1;
+            buffer += ' ';
+            append_integer(buffer, facets(i, j) + 1);
         }
-        fout << std::endl;
-    }
+        buffer += '\n';
+    });
     fout.close();
 }
 
 template <typename MeshType>
 void save_mesh_basic(const fs::path& filename, const MeshType& mesh)
 {
+    using Scalar = typename MeshType::Scalar;
+    using Index = typename MeshType::Index;
+
     if (mesh.get_dim() == 2) {
         save_mesh_2D(filename, mesh);
     } else {
+        // Same output as Eigen's full precision matrix printing, one "v" or "f" row per line.
+        fs::ofstream fout(filename);
+        LA_ASSERT(fout.is_open(), "Cannot open file for writing: " + filename.string());
         const auto& vertices = mesh.get_vertices();
         const auto& facets = mesh.get_facets();
-        igl::writeOBJ(filename.string(), vertices, facets);
+        const std::string format = full_precision_format<Scalar>();
+
+        if (vertices.size() == 0) {
+            fout << "\n";
+        } else {
+            write_rows(fout, mesh.get_num_vertices(), [&](std::string& buffer, Index i) {
+                buffer += 'v';
+                for (Eigen::Index j = 0; j < vertices.cols(); ++j) {
+                    buffer += ' ';
+                    append_double(buffer, format.c_str(), double(vertices(i, j)));
+                }
+                buffer += '\n';
+            });
+        }
+
+        if (facets.size() == 0) {
+            fout << "\n";
+        } else {
+            write_rows(fout, mesh.get_num_facets(), [&](std::string& buffer, Index i) {
+                buffer += 'f';
+                for (Eigen::Index j = 0; j < facets.cols(); ++j) {
+                    buffer += ' ';
+                    append_integer(buffer, facets(i, j) + 1);
+                }
+                buffer += '\n';
+            });
+        }
     }
 }
 
@@ -115,7 +235,59 @@ void save_mesh_obj(const fs::path& filename, const MeshType& mesh)
     extract_attribute(mesh, "uv", TC, FTC);
     extract_attribute(mesh, "normal", CN, FN);
 
-    igl::writeOBJ(filename.string(), vertices, facets, CN, FN, TC, FTC);
+    const bool write_normals = CN.rows() > 0;
+    const bool write_uvs = TC.rows() > 0;
+    LA_ASSERT(!write_normals || CN.cols() >= 3, "Normals must have 3 components");
+
+    // Same output as igl::writeOBJ.
+    fs::ofstream fout(filename);
+    LA_ASSERT(fout.is_open(), "Cannot open file for writing: " + filename.string());
+
+    write_rows(fout, vertices.rows(), [&](std::string& buffer, Eigen::Index i) {
+        buffer += 'v';
+        for (Eigen::Index j = 0; j < vertices.cols(); ++j) {
+            append_double(buffer, " %0.17g", double(vertices(i, j)));
+        }
+        buffer += '\n';
+    });
+
+    if (write_normals) {
+        write_rows(fout, CN.rows(), [&](std::string& buffer, Eigen::Index i) {
+            buffer += "vn";
+            for (Eigen::Index j = 0; j < 3; ++j) {
+                append_double(buffer, " %0.15g", double(CN(i, j)));
+            }
+            buffer += '\n';
+        });
+        fout << "\n";
+    }
+
+    if (write_uvs) {
+        write_rows(fout, TC.rows(), [&](std::string& buffer, Eigen::Index i) {
+            buffer += "vt";
+            append_double(buffer, " %0.15g", double(TC(i, 0)));
+            append_double(buffer, " %0.15g", double(TC(i, 1)));
+            buffer += '\n';
+        });
+        fout << "\n";
+    }
+
+    write_rows(fout, facets.rows(), [&](std::string& buffer, Eigen::Index i) {
+        buffer += 'f';
+        for (Eigen::Index j = 0; j < facets.cols(); ++j) {
+            buffer += ' ';
+            append_integer(buffer, static_cast<unsigned>(facets(i, j) + 1));
+            if (write_uvs) {
+                buffer += '/';
+                append_integer(buffer, static_cast<unsigned>(FTC(i, j) + 1));
+            }
+            if (write_normals) {
+                buffer += (write_uvs ? "/" : "//");
+                append_integer(buffer, static_cast<unsigned>(FN(i, j) + 1));
+            }
+        }
+        buffer += '\n';
+    });
 }
 
 template <typename MeshType>
@@ -126,6 +298,10 @@ void save_mesh_vtk(
     const std::vector<std::string>& vertex_attrib_names)
 {
     using AttributeArray = typename MeshType::AttributeArray;
+    using Index = typename MeshType::Index;
+
+    // Scientific notation with a precision of 12.
+    const char* scalar_format = "%.12e";
 
     auto write_connectivity = [&](std::ostream& fl) {
         LA_ASSERT(fl);
@@ -145,17 +321,23 @@ void save_mesh_vtk(
         fl << "\n";
 
         // write the vertices
+        const auto& vertices = mesh.get_vertices();
+        if (vertices.rows() > 0 && vertices.cols() != 2 && vertices.cols() != 3) {
+            throw std::runtime_error("This dimension is not supported");
+        }
         fl << "POINTS " << mesh.get_num_vertices() << " float\n";
-        for (auto vnidx : range(mesh.get_num_vertices())) {
-            auto xyz = mesh.get_vertices().row(vnidx).eval();
-            if (xyz.cols() == 3) {
-                fl << xyz(0) << " " << xyz(1) << " " << xyz(2) << "\n";
-            } else if (xyz.cols() == 2) {
-                fl << xyz(0) << " " << xyz(1) << " " << 0 << "\n";
+        write_rows(fl, mesh.get_num_vertices(), [&](std::string& buffer, Index vnidx) {
+            append_double(buffer, scalar_format, double(vertices(vnidx, 0)));
+            buffer += ' ';
+            append_double(buffer, scalar_format, double(vertices(vnidx, 1)));
+            if (vertices.cols() == 3) {
+                buffer += ' ';
+                append_double(buffer, scalar_format, double(vertices(vnidx, 2)));
+                buffer += '\n';
             } else {
-                throw std::runtime_error("This dimension is not supported");
+                buffer += " 0\n";
             }
-        }
+        });
         fl << "\n";
 
         //
@@ -163,24 +345,27 @@ void save_mesh_vtk(
         //
 
         // count their total number of vertices.
+        const auto& facets = mesh.get_facets();
+        const Index vertex_per_facet = mesh.get_vertex_per_facet();
         fl << "CELLS " << mesh.get_num_facets() << " "
-           << mesh.get_num_facets() * (mesh.get_vertex_per_facet() + 1) << "\n";
-        for (auto fn : range(mesh.get_num_facets())) {
-            fl << mesh.get_vertex_per_facet() << " ";
-            for (auto voffset : range(mesh.get_vertex_per_facet())) { //
-                fl << mesh.get_facets()(fn, voffset) << " ";
+           << mesh.get_num_facets() * (vertex_per_facet + 1) << "\n";
+        write_rows(fl, mesh.get_num_facets(), [&](std::string& buffer, Index fn) {
+            append_integer(buffer, vertex_per_facet);
+            buffer += ' ';
+            for (auto voffset : range(vertex_per_facet)) {
+                append_integer(buffer, facets(fn, voffset));
+                buffer += ' ';
             }
-            fl << "\n";
-        }
+            buffer += '\n';
+        });
         fl << "\n";
 
         // write the face types
         fl << "CELL_TYPES " << mesh.get_num_facets() << "\n";
-        for (auto f : range(mesh.get_num_facets())) {
-            (void)f;
-            // fl << "7 \n"; // VTK POLYGON
-            fl << "5 \n"; // VTK TRIANGLE
-        }
+        write_rows(fl, mesh.get_num_facets(), [&](std::string& buffer, Index) {
+            // buffer += "7 \n"; // VTK POLYGON
+            buffer += "5 \n"; // VTK TRIANGLE
+        });
         fl << "\n";
     }; // end of write connectivity
 
@@ -193,22 +378,21 @@ void save_mesh_vtk(
     }; // end of write_cell_header
 
     auto write_data =
-        [](std::ostream& fl, const std::string attrib_name, const AttributeArray& attrib) {
+        [&](std::ostream& fl, const std::string attrib_name, const AttributeArray& attrib) {
             fl << "SCALARS " << attrib_name << " float " << attrib.cols() << "\n";
             fl << "LOOKUP_TABLE default \n";
-            for (auto row : range(attrib.rows())) {
+            write_rows(fl, attrib.rows(), [&](std::string& buffer, Eigen::Index row) {
                 for (auto col : range(attrib.cols())) {
-                    fl << attrib(row, col) << " ";
+                    append_double(buffer, scalar_format, double(attrib(row, col)));
+                    buffer += ' ';
                 } // end of col
-                fl << "\n";
-            } // end of row
+                buffer += '\n';
+            }); // end of row
             fl << "\n";
         }; // end of write_data()
 
     // Open the file
     fs::ofstream fl(filename, fs::fstream::out);
-    fl.precision(12);
-    fl.flags(fs::fstream::scientific);
     LA_ASSERT(fl.is_open());
 
     // write the connectivity
@@ -12,82 +12,122 @@
 #pragma once
 
 #include <lagrange/fs/filesystem.h>
+#include <lagrange/io/ply_utils.h>
 #include <lagrange/io/types.h>
 
+#include <lagrange/Logger.h>
 #include <lagrange/MeshTrait.h>
 #include <lagrange/create_mesh.h>
+#include <lagrange/utils/la_assert.h>
 #include <lagrange/utils/safe_cast.h>
 
-// clang-format off
-#include <lagrange/utils/warnoff.h>
-#include <igl/writePLY.h>
-#include <lagrange/utils/warnon.h>
-// clang-format on
-
+#include <limits>
 #include <string>
 #include <vector>
 
 namespace lagrange {
 namespace io {
 
-/// Save .ply with color information (if available)
+///
+/// Saves a .ply mesh with normal and color information (if available). Binary files are written in
+/// little endian order. Rows are encoded into a bounded-size buffer and flushed as they are
+/// produced, so no full copy of the mesh is made.
+///
+/// @param[in]  filename  Output file name.
+/// @param[in]  mesh      Mesh to save.
+/// @param[in]  encoding  Binary or ascii encoding.
+///
 template <typename MeshType>
-void save_mesh_ply(const fs::path &filename, const MeshType &mesh, FileEncoding encoding = FileEncoding::Binary)
+void save_mesh_ply(
+    const fs::path& filename,
+    const MeshType& mesh,
+    FileEncoding encoding = FileEncoding::Binary)
 {
     static_assert(MeshTrait<MeshType>::is_mesh(), "Input type is not Mesh");
-    using VertexArray = typename MeshType::VertexArray;
     using AttributeArray = typename MeshType::AttributeArray;
-    using Index = unsigned int;
-
-    const VertexArray &V = mesh.get_vertices();
-    const auto F = mesh.get_facets().template cast<Index>();
-    Eigen::Matrix<Index, Eigen::Dynamic, Eigen::Dynamic> E;
-    AttributeArray N;
-    AttributeArray UV;
-
-    Eigen::Matrix<unsigned char, Eigen::Dynamic, Eigen::Dynamic> VD;
-    std::vector<std::string> VDheader;
+    using Scalar = typename MeshType::Scalar;
+    namespace ply = internal::ply;
 
-    AttributeArray FD;
-    std::vector<std::string> FDheader;
-
-    AttributeArray ED;
-    std::vector<std::string> EDheader;
-    std::vector<std::string> comments;
+    const auto& V = mesh.get_vertices();
+    const auto& F = mesh.get_facets();
+    const Eigen::Index num_vertices = V.rows();
+    const Eigen::Index num_facets = F.rows();
+    LA_ASSERT(V.cols() >= 2 && V.cols() <= 3, "Only 2D and 3D meshes can be saved as PLY");
+    LA_ASSERT(F.cols() <= 255, "Facet size is too large for PLY");
 
+    AttributeArray N;
     if (mesh.has_vertex_attribute("normal")) {
         N = mesh.get_vertex_attribute("normal");
+        LA_ASSERT(N.cols() <= 3);
     }
 
+    Eigen::Matrix<unsigned char, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> C;
     if (mesh.has_vertex_attribute("color")) {
-        VDheader = {"red", "green", "blue"};
-        auto C = mesh.get_vertex_attribute("color");
-        if (C.maxCoeff() <= 1.0 && C.maxCoeff() > 0.0) {
+        const auto& color = mesh.get_vertex_attribute("color");
+        if (color.maxCoeff() <= 1.0 && color.maxCoeff() > 0.0) {
             logger().warn("Max color value is > 0.0 but <= 1.0, but colors are saved as char. "
                           "Please convert your colors to the range [0, 255].");
         }
-        VD = C.template cast<unsigned char>();
-        if (VD.cols() > 3) {
-            VDheader.push_back("alpha");
+        C = color.template cast<unsigned char>();
+        LA_ASSERT(C.cols() >= 3 && C.cols() <= 4);
+    }
+
+    fs::ofstream out(filename, std::ios::binary);
+    LA_ASSERT(out.is_open(), "Cannot open file for writing: " + filename.string());
+
+    // Header.
+    const char* scalar_name = ply::type_name(ply::TypeOf<Scalar>::value);
+    const char* position_names[] = {"x", "y", "z"};
+    const char* normal_names[] = {"nx", "ny", "nz"};
+    const char* color_names[] = {"red", "green", "blue", "alpha"};
+    out << "ply\n";
+    out << "format " << (encoding == FileEncoding::Binary ? "binary_little_endian" : "ascii")
+        << " 1.0\n";
+    out << "element vertex " << num_vertices << "\n";
+    for (Eigen::Index j = 0; j < V.cols(); ++j) {
+        out << "property " << scalar_name << " " << position_names[j] << "\n";
+    }
+    for (Eigen::Index j = 0; j < N.cols(); ++j) {
+        out << "property " << scalar_name << " " << normal_names[j] << "\n";
+    }
+    for (Eigen::Index j = 0; j < C.cols(); ++j) {
+        out << "property uchar " << color_names[j] << "\n";
+    }
+    out << "element face " << num_facets << "\n";
+    out << "property list uchar int vertex_indices\n";
+    out << "end_header\n";
+
+    // Element data.
+    if (encoding == FileEncoding::Binary) {
+        ply::ChunkedWriter writer(out);
+        for (Eigen::Index i = 0; i < num_vertices; ++i) {
+            for (Eigen::Index j = 0; j < V.cols(); ++j) writer.write<Scalar>(V(i, j));
+            for (Eigen::Index j = 0; j < N.cols(); ++j) writer.write<Scalar>(N(i, j));
+            for (Eigen::Index j = 0; j < C.cols(); ++j) writer.write<uint8_t>(C(i, j));
+        }
+        for (Eigen::Index i = 0; i < num_facets; ++i) {
+            writer.write<uint8_t>(safe_cast<uint8_t>(F.cols()));
+            for (Eigen::Index j = 0; j < F.cols(); ++j) {
+                writer.write<int32_t>(safe_cast<int32_t>(F(i, j)));
+            }
+        }
+    } else {
+        out.precision(std::numeric_limits<Scalar>::max_digits10);
+        for (Eigen::Index i = 0; i < num_vertices; ++i) {
+            const char* sep = "";
+            for (Eigen::Index j = 0; j < V.cols(); ++j, sep = " ") out << sep << V(i, j);
+            for (Eigen::Index j = 0; j < N.cols(); ++j) out << " " << N(i, j);
+            for (Eigen::Index j = 0; j < C.cols(); ++j) out << " " << int(C(i, j));
+            out << "\n";
+        }
+        for (Eigen::Index i = 0; i < num_facets; ++i) {
+            out << F.cols();
+            for (Eigen::Index j = 0; j < F.cols(); ++j) out << " " << F(i, j);
+            out << "\n";
         }
-        LA_ASSERT(safe_cast<size_t>(VD.cols()) == VDheader.size());
     }
 
-    igl::writePLY(
-        filename.string(),
-        V,
-        F,
-        E,
-        N,
-        UV,
-        VD,
-        VDheader,
-        FD,
-        FDheader,
-        ED,
-        EDheader,
-        comments,
-        encoding == FileEncoding::Binary ? igl::FileEncoding::Binary : igl::FileEncoding::Ascii);
+    LA_ASSERT(!out.fail(), "Failed to write PLY file: " + filename.string());
 }
 
 } // namespace io
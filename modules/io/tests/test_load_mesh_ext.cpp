@@ -16,6 +16,7 @@
 #include <lagrange/Logger.h>
 #include <lagrange/io/load_mesh.h>
 #include <lagrange/io/load_mesh_ext.h>
+#include <lagrange/io/load_mesh_obj.h>
 
 #include "test_load_mesh_data.h"
 
@@ -322,3 +323,207 @@ TEST_CASE("MeshLoad", "[Mesh][Load]")
         }
     }
 }
+
+TEST_CASE("MeshLoadObj", "[Mesh][Load]")
+{
+    using namespace lagrange;
+    using namespace lagrange::io;
+
+    const std::string tmp_filename = "tmp_obj.obj";
+
+    SECTION("TwoObjects")
+    {
+        {
+            std::ofstream f(tmp_filename);
+            f << obj_quad_multiple;
+        }
+
+        auto tri_result = load_mesh_obj<Mesh<Vertices3D, Triangles>>(tmp_filename);
+        REQUIRE(tri_result.success);
+        REQUIRE(tri_result.meshes.size() == 2);
+        REQUIRE(tri_result.mesh_names == std::vector<std::string>{"Cube", "Plane"});
+
+        auto quad_result = load_mesh_obj<Mesh<Vertices3Df, Quads>>(tmp_filename);
+        REQUIRE(quad_result.meshes.size() == 2);
+
+        const std::vector<int> num_vertices = {8, 4};
+        const std::vector<int> num_quads = {6, 1};
+        for (auto i : range(2)) {
+            auto& tri_mesh = *tri_result.meshes[i];
+            auto& quad_mesh = *quad_result.meshes[i];
+            REQUIRE(tri_mesh.get_num_vertices() == num_vertices[i]);
+            REQUIRE(tri_mesh.get_num_facets() == 2 * num_quads[i]);
+            REQUIRE(quad_mesh.get_num_vertices() == num_vertices[i]);
+            REQUIRE(quad_mesh.get_num_facets() == num_quads[i]);
+            REQUIRE(faces_in_range(tri_mesh));
+            REQUIRE(faces_in_range(quad_mesh));
+            REQUIRE(tri_mesh.is_uv_initialized());
+            REQUIRE(tri_mesh.get_uv_indices().rows() == tri_mesh.get_num_facets());
+            REQUIRE(tri_mesh.has_corner_attribute("normal"));
+            REQUIRE(tri_mesh.has_corner_attribute("uv"));
+
+            // Triangle fans use the first polygon vertex.
+            const auto& T = tri_mesh.get_facets();
+            const auto& Q = quad_mesh.get_facets();
+            for (auto f : range(quad_mesh.get_num_facets())) {
+                REQUIRE(T(2 * f, 0) == Q(f, 0));
+                REQUIRE(T(2 * f, 1) == Q(f, 1));
+                REQUIRE(T(2 * f, 2) == Q(f, 2));
+                REQUIRE(T(2 * f + 1, 0) == Q(f, 0));
+                REQUIRE(T(2 * f + 1, 1) == Q(f, 2));
+                REQUIRE(T(2 * f + 1, 2) == Q(f, 3));
+            }
+        }
+    }
+
+    SECTION("TwoObjectAsOne")
+    {
+        {
+            std::ofstream f(tmp_filename);
+            f << obj_quad_multiple;
+        }
+
+        MeshLoaderParams params;
+        params.as_one_mesh = true;
+        auto result = load_mesh_obj<Mesh<Vertices3Df, Triangles>>(tmp_filename, params);
+        REQUIRE(result.meshes.size() == 1);
+        auto& mesh = *result.meshes[0];
+        REQUIRE(mesh.get_num_vertices() == 8 + 4);
+        REQUIRE(mesh.get_num_facets() == 12 + 2);
+        REQUIRE(faces_in_range(mesh));
+        REQUIRE(mesh.is_uv_initialized());
+        REQUIRE(mesh.get_uv_indices().rows() == mesh.get_num_facets());
+    }
+
+    SECTION("Mixed")
+    {
+        {
+            std::ofstream f(tmp_filename);
+            f << obj_mixed_plane;
+        }
+
+        auto quads = load_mesh_obj<Mesh<Vertices3D, Quads>>(tmp_filename);
+        REQUIRE(quads.meshes.size() == 1);
+        REQUIRE(quads.meshes[0]->get_num_facets() == 3);
+        REQUIRE(quads.meshes[0]->get_facets()(1, 3) == INVALID<typename Quads::Scalar>());
+        REQUIRE(quads.meshes[0]->get_facets()(2, 3) == INVALID<typename Quads::Scalar>());
+
+        auto triangles = load_mesh_obj<Mesh<Vertices3D, Triangles>>(tmp_filename);
+        REQUIRE(triangles.meshes.size() == 1);
+        REQUIRE(triangles.meshes[0]->get_num_facets() == 4);
+        REQUIRE(faces_in_range(*triangles.meshes[0]));
+
+        using PolyMesh = Mesh<Vertices3D, Eigen::Matrix<int, Eigen::Dynamic, Eigen::Dynamic>>;
+        MeshLoaderParams params;
+        REQUIRE(load_mesh_obj<PolyMesh>(tmp_filename, params).meshes[0]->get_num_facets() == 3);
+        params.triangulate = true;
+        REQUIRE(load_mesh_obj<PolyMesh>(tmp_filename, params).meshes[0]->get_num_facets() == 4);
+    }
+
+    SECTION("Params")
+    {
+        {
+            std::ofstream f(tmp_filename);
+            f << obj_quad_multiple;
+        }
+        {
+            std::ofstream f("material.mtl");
+            f << mtl_material;
+        }
+
+        for (bool load_normals : {true, false}) {
+            for (bool load_materials : {true, false}) {
+                for (bool load_uvs : {true, false}) {
+                    MeshLoaderParams params;
+                    params.load_materials = load_materials;
+                    params.load_normals = load_normals;
+                    params.load_uvs = load_uvs;
+                    auto result = load_mesh_obj<TriangleMesh3D>(tmp_filename, params);
+                    REQUIRE(result.success);
+                    REQUIRE(result.meshes.size() == 2);
+                    REQUIRE(load_materials != result.materials.empty());
+                    const auto& mesh = *result.meshes.front();
+                    REQUIRE(load_materials == mesh.has_facet_attribute("material_id"));
+                    REQUIRE(load_uvs == mesh.is_uv_initialized());
+                    REQUIRE(load_normals == mesh.has_corner_attribute("normal"));
+                }
+            }
+        }
+
+        // "usemtl Material" resolves to the first material, "usemtl None" is not in the library.
+        auto result = load_mesh_obj<TriangleMesh3D>(tmp_filename);
+        REQUIRE(result.materials.size() == 1);
+        REQUIRE(result.materials[0].name == "Material");
+        REQUIRE((result.meshes[0]->get_facet_attribute("material_id").array() == 0).all());
+        REQUIRE((result.meshes[1]->get_facet_attribute("material_id").array() == -1).all());
+    }
+
+    SECTION("Relative indices")
+    {
+        {
+            std::ofstream f(tmp_filename);
+            f << "v 0 0 0\nv 1 0 0\nv 0 1 0\nf -3 -2 -1\n"
+              << "o B\nv 0 0 1\nv 1 0 1\nv 0 1 1\nf -3 -2 -1\nf 4 5 6\n";
+        }
+        auto result = load_mesh_obj<TriangleMesh3D>(tmp_filename);
+        REQUIRE(result.meshes.size() == 2);
+        REQUIRE(result.meshes[0]->get_facets().row(0) == Eigen::RowVector3i(0, 1, 2));
+        REQUIRE(result.meshes[1]->get_facets().row(0) == Eigen::RowVector3i(0, 1, 2));
+        REQUIRE(result.meshes[1]->get_facets().row(1) == Eigen::RowVector3i(0, 1, 2));
+    }
+
+    SECTION("Large file")
+    {
+        // Enough data to be split in multiple chunks, with objects spanning chunk boundaries.
+        const int num_objects = 5;
+        const int n = 100;
+        {
+            std::ofstream f(tmp_filename);
+            f.precision(17);
+            for (int o = 0; o < num_objects; ++o) {
+                f << "o part" << o << "\n";
+                for (int i = 0; i <= n; ++i) {
+                    for (int j = 0; j <= n; ++j) {
+                        f << "v " << i / 3.0 << " " << j * 1e-7 << " " << -o * 1.25e3 << "\n";
+                        f << "vt " << i / double(n) << " " << j / double(n) << "\n";
+                    }
+                }
+                for (int i = 0; i < n; ++i) {
+                    for (int j = 0; j < n; ++j) {
+                        const int v = o * (n + 1) * (n + 1) + i * (n + 1) + j + 1;
+                        f << "f " << v << "/" << v << " " << v + n + 1 << "/" << v + n + 1 << " "
+                          << v + n + 2 << "/" << v + n + 2 << " " << v + 1 << "/" << v + 1
+                          << "\n";
+                    }
+                }
+            }
+        }
+
+        auto result = load_mesh_obj<TriangleMesh3D>(tmp_filename);
+        REQUIRE(result.meshes.size() == num_objects);
+        for (int o = 0; o < num_objects; ++o) {
+            auto& mesh = *result.meshes[o];
+            REQUIRE(result.mesh_names[o] == "part" + std::to_string(o));
+            REQUIRE(mesh.get_num_vertices() == (n + 1) * (n + 1));
+            REQUIRE(mesh.get_num_facets() == 2 * n * n);
+            REQUIRE(faces_in_range(mesh));
+            REQUIRE(mesh.get_uv_indices() == mesh.get_facets());
+            for (int i = 0; i <= n; ++i) {
+                for (int j = 0; j <= n; ++j) {
+                    const auto row = mesh.get_vertices().row(i * (n + 1) + j);
+                    REQUIRE(row(0) == i / 3.0);
+                    REQUIRE(row(1) == j * 1e-7);
+                    REQUIRE(row(2) == -o * 1.25e3);
+                }
+            }
+        }
+    }
+
+    SECTION("Missing file")
+    {
+        auto result = load_mesh_obj<TriangleMesh3D>("does_not_exist.obj");
+        REQUIRE(!result.success);
+    }
+
+    fs::remove(tmp_filename);
+}
@@ -0,0 +1,291 @@
+/*
+ * Copyright 2021 Adobe. All rights reserved.
+ * This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain a copy
+ * of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under
+ * the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ * OF ANY KIND, either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+ */
+#include <lagrange/Mesh.h>
+#include <lagrange/common.h>
+#include <lagrange/create_mesh.h>
+#include <lagrange/testing/common.h>
+
+#include <lagrange/io/mesh_archive.h>
+
+#include <cstring>
+#include <iterator>
+#include <string>
+
+TEST_CASE("MeshArchive", "[mesh][io][archive]")
+{
+    using namespace lagrange;
+    using AttributeArray = TriangleMesh3D::AttributeArray;
+
+    auto mesh = create_cube();
+    const auto num_vertices = mesh->get_num_vertices();
+    const auto num_facets = mesh->get_num_facets();
+
+    AttributeArray vertex_attr(num_vertices, 3);
+    vertex_attr.setRandom();
+    mesh->add_vertex_attribute("normal");
+    mesh->set_vertex_attribute("normal", vertex_attr);
+
+    AttributeArray facet_attr(num_facets, 1);
+    facet_attr.setRandom();
+    mesh->add_facet_attribute("area");
+    mesh->set_facet_attribute("area", facet_attr);
+
+    AttributeArray corner_attr(num_facets * 3, 2);
+    corner_attr.setRandom();
+    mesh->add_corner_attribute("corner");
+    mesh->set_corner_attribute("corner", corner_attr);
+
+    mesh->initialize_edge_data();
+    AttributeArray edge_attr(mesh->get_num_edges(), 1);
+    edge_attr.setRandom();
+    mesh->add_edge_attribute("edge");
+    mesh->set_edge_attribute("edge", edge_attr);
+
+    // Column-major float attribute, stored transposed in the archive.
+    Eigen::MatrixXf float_attr(num_vertices, 2);
+    float_attr.setRandom();
+    mesh->add_vertex_attribute("float");
+    mesh->set_vertex_attribute_array("float", float_attr);
+
+    TriangleMesh3D::UVArray uv(num_vertices, 2);
+    uv.setRandom();
+    mesh->initialize_uv(uv, mesh->get_facets());
+
+    const std::string filename = "io_test_cube.lgrmesh";
+    io::save_mesh_archive(filename, *mesh);
+
+    auto check_attributes = [&](const auto& other) {
+        using RowMajorMatrix =
+            Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>;
+        using FloatMatrix = Eigen::Matrix<float, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>;
+        using IndexMatrix = Eigen::Matrix<int, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>;
+        const auto& const_other = other;
+        REQUIRE(const_other.get_vertex_attribute_array("normal")->template view<RowMajorMatrix>() ==
+                vertex_attr);
+        REQUIRE(const_other.get_facet_attribute_array("area")->template view<RowMajorMatrix>() ==
+                facet_attr);
+        REQUIRE(const_other.get_corner_attribute_array("corner")->template view<RowMajorMatrix>() ==
+                corner_attr);
+        REQUIRE(const_other.is_edge_data_initialized());
+        REQUIRE(const_other.get_edge_attribute_array("edge")->template view<RowMajorMatrix>() ==
+                edge_attr);
+        REQUIRE(const_other.get_vertex_attribute_array("float")->template view<FloatMatrix>() ==
+                float_attr);
+        REQUIRE(const_other.has_indexed_attribute("uv"));
+        const auto uv_attr = const_other.get_indexed_attribute_array("uv");
+        REQUIRE(std::get<0>(uv_attr)->template view<RowMajorMatrix>() == uv);
+        REQUIRE(std::get<1>(uv_attr)->template view<IndexMatrix>() == mesh->get_facets());
+    };
+
+    SECTION("load")
+    {
+        auto mesh2 = io::load_mesh_archive<TriangleMesh3D>(filename);
+        REQUIRE(mesh2 != nullptr);
+        REQUIRE(mesh2->get_vertices() == mesh->get_vertices());
+        REQUIRE(mesh2->get_facets() == mesh->get_facets());
+        check_attributes(*mesh2);
+
+        // Owned attributes of matching type are accessible directly.
+        REQUIRE(mesh2->get_vertex_attribute("normal") == vertex_attr);
+        REQUIRE(mesh2->get_uv() == uv);
+    }
+
+    SECTION("load with conversion")
+    {
+        using FloatMesh = Mesh<Eigen::Matrix<float, Eigen::Dynamic, 3>, Eigen::MatrixXi>;
+        auto mesh2 = io::load_mesh_archive<FloatMesh>(filename);
+        REQUIRE(mesh2 != nullptr);
+        REQUIRE(mesh2->get_vertices() == mesh->get_vertices().cast<float>());
+        REQUIRE(mesh2->get_facets() == mesh->get_facets());
+    }
+
+    SECTION("map")
+    {
+        auto mapped = io::map_mesh_archive<Vertices3D, Triangles>(filename);
+        REQUIRE(mapped != nullptr);
+        auto& mesh2 = mapped->get_mesh();
+        REQUIRE(mesh2.get_vertices() == mesh->get_vertices());
+        REQUIRE(mesh2.get_facets() == mesh->get_facets());
+        check_attributes(mesh2);
+
+        // Data must point directly into the mapped file.
+        const char* begin = mapped->get_file().begin();
+        const char* end = mapped->get_file().end();
+        auto in_file = [&](const void* ptr) {
+            const char* p = static_cast<const char*>(ptr);
+            return p >= begin && p < end;
+        };
+        const auto& const_mesh2 = mesh2;
+        REQUIRE(in_file(mesh2.get_vertices().data()));
+        REQUIRE(in_file(mesh2.get_facets().data()));
+        REQUIRE(in_file(const_mesh2.get_vertex_attribute_array("normal")->data()));
+        REQUIRE(in_file(std::get<0>(const_mesh2.get_indexed_attribute_array("uv"))->data()));
+
+        mesh2.initialize_connectivity();
+        REQUIRE(mesh2.get_vertices_adjacent_to_vertex(0).size() > 0);
+    }
+
+    SECTION("type mismatch")
+    {
+        using FloatVertices = Eigen::Matrix<float, Eigen::Dynamic, 3, Eigen::RowMajor>;
+        REQUIRE_THROWS((io::map_mesh_archive<FloatVertices, Triangles>(filename)));
+    }
+
+    fs::remove(filename);
+}
+
+TEST_CASE("MeshArchive invalid", "[mesh][io][archive]")
+{
+    using namespace lagrange;
+    const std::string filename = "io_test_invalid.lgrmesh";
+    {
+        fs::ofstream out(filename, std::ios::binary);
+        out << "This is not a mesh archive, but it is long enough to hold a header.";
+    }
+    REQUIRE_THROWS(io::load_mesh_archive<TriangleMesh3D>(filename));
+    fs::remove(filename);
+
+    REQUIRE(io::load_mesh_archive<TriangleMesh3D>("io_test_missing.lgrmesh") == nullptr);
+}
+
+TEST_CASE("MeshArchive corrupted", "[mesh][io][archive]")
+{
+    using namespace lagrange;
+    const std::string filename = "io_test_corrupted.lgrmesh";
+    io::save_mesh_archive(filename, *create_cube());
+
+    std::string bytes;
+    {
+        fs::ifstream in(filename, std::ios::binary);
+        bytes.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+
+    io::archive::FileHeader header;
+    std::memcpy(&header, bytes.data(), sizeof(header));
+    auto entry_offset = [&](io::archive::SectionKind kind) {
+        for (uint64_t i = 0; i < header.num_sections; ++i) {
+            const size_t offset =
+                size_t(header.section_table_offset + i * sizeof(io::archive::SectionEntry));
+            io::archive::SectionEntry entry;
+            std::memcpy(&entry, bytes.data() + offset, sizeof(entry));
+            if (entry.kind == static_cast<uint32_t>(kind)) return offset;
+        }
+        FAIL("Section not found");
+        return size_t(0);
+    };
+    auto load_modified = [&](io::archive::SectionKind kind, auto modify) {
+        std::string modified = bytes;
+        const size_t offset = entry_offset(kind);
+        io::archive::SectionEntry entry;
+        std::memcpy(&entry, modified.data() + offset, sizeof(entry));
+        modify(entry, modified);
+        std::memcpy(&modified[offset], &entry, sizeof(entry));
+        {
+            fs::ofstream out(filename, std::ios::binary);
+            out.write(modified.data(), std::streamsize(modified.size()));
+        }
+        return io::load_mesh_archive<TriangleMesh3D>(filename);
+    };
+
+    SECTION("unmodified")
+    {
+        REQUIRE(load_modified(io::archive::SectionKind::Facets, [](auto&, auto&) {}) != nullptr);
+    }
+
+    SECTION("size overflow")
+    {
+        // rows * cols * 8 wraps around to the 0 bytes stored in data_size.
+        auto modify = [](io::archive::SectionEntry& entry, std::string&) {
+            entry.rows = uint64_t(1) << 62;
+            entry.cols = 4;
+            entry.data_size = 0;
+        };
+        REQUIRE_THROWS(load_modified(io::archive::SectionKind::Vertices, modify));
+        REQUIRE_THROWS(io::map_mesh_archive<Vertices3D, Triangles>(filename));
+    }
+
+    SECTION("facet index out of range")
+    {
+        auto modify = [](io::archive::SectionEntry& entry, std::string& data) {
+            const int index = 8;
+            std::memcpy(&data[size_t(entry.data_offset)], &index, sizeof(index));
+        };
+        REQUIRE_THROWS(load_modified(io::archive::SectionKind::Facets, modify));
+        REQUIRE_THROWS(io::map_mesh_archive<Vertices3D, Triangles>(filename));
+    }
+
+    SECTION("facet index equal to the vertex count")
+    {
+        auto modify = [](io::archive::SectionEntry& entry, std::string& data) {
+            // The cube has 8 vertices, index 8 is the first one out of range.
+            const int index = 8;
+            const size_t last = size_t(entry.data_offset + entry.data_size) - sizeof(index);
+            std::memcpy(&data[last], &index, sizeof(index));
+        };
+        REQUIRE_THROWS(load_modified(io::archive::SectionKind::Facets, modify));
+        REQUIRE_THROWS(io::map_mesh_archive<Vertices3D, Triangles>(filename));
+    }
+
+    SECTION("facet section with the wrong width")
+    {
+        // 12 triangles read as 9 quads: the data size still matches.
+        auto modify = [](io::archive::SectionEntry& entry, std::string&) {
+            entry.rows = 9;
+            entry.cols = 4;
+        };
+        REQUIRE_THROWS(load_modified(io::archive::SectionKind::Facets, modify));
+        REQUIRE_THROWS(io::map_mesh_archive<Vertices3D, Triangles>(filename));
+    }
+
+    fs::remove(filename);
+}
+
+TEST_CASE("MeshArchive padded polygons", "[mesh][io][archive]")
+{
+    using namespace lagrange;
+
+    // One quad and one triangle, padded with INVALID as load_mesh_obj does for mixed meshes.
+    Vertices3D vertices(5, 3);
+    vertices << 0, 0, 0, //
+        1, 0, 0, //
+        1, 1, 0, //
+        0, 1, 0, //
+        2, 0, 0;
+    Quads facets(2, 4);
+    facets << 0, 1, 2, 3, //
+        1, 4, 2, INVALID<int>();
+    auto mesh = create_mesh(vertices, facets);
+
+    QuadMesh3D::UVArray uv = vertices.leftCols(2);
+    mesh->initialize_uv(uv, facets);
+
+    const std::string filename = "io_test_padded.lgrmesh";
+    io::save_mesh_archive(filename, *mesh);
+
+    {
+        auto mesh2 = io::load_mesh_archive<QuadMesh3D>(filename);
+        REQUIRE(mesh2 != nullptr);
+        REQUIRE(mesh2->get_vertices() == vertices);
+        REQUIRE(mesh2->get_facets() == facets);
+        using IndexMatrix = Eigen::Matrix<int, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>;
+        const auto& const_mesh2 = *mesh2;
+        const auto uv_attr = const_mesh2.get_indexed_attribute_array("uv");
+        REQUIRE(std::get<1>(uv_attr)->template view<IndexMatrix>() == facets);
+    }
+    {
+        auto mapped = io::map_mesh_archive<Vertices3D, Quads>(filename);
+        REQUIRE(mapped != nullptr);
+        REQUIRE(mapped->get_mesh().get_facets() == facets);
+    }
+
+    fs::remove(filename);
+}
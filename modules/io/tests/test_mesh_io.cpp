@@ -16,6 +16,9 @@
 #include <lagrange/io/load_mesh.h>
 #include <lagrange/io/save_mesh.h>
 
+#include <cmath>
+#include <sstream>
+
 
 TEST_CASE("drop", "[mesh][io]")
 {
@@ -32,3 +35,137 @@ TEST_CASE("drop", "[mesh][io]")
     REQUIRE((mesh->get_uv() - mesh2->get_uv()).norm() == Approx(0.0).margin(1e-14));
     REQUIRE((mesh->get_uv_indices() - mesh2->get_uv_indices()).norm() == Approx(0.0));
 }
+
+namespace {
+
+std::string read_file(const lagrange::fs::path& filename)
+{
+    lagrange::fs::ifstream in(filename);
+    std::stringstream buffer;
+    buffer << in.rdbuf();
+    return buffer.str();
+}
+
+} // namespace
+
+TEST_CASE("save_mesh byte compatibility", "[mesh][io]")
+{
+    using namespace lagrange;
+
+    // Large enough to span several formatting blocks.
+    const int n = 100;
+    Vertices3D vertices((n + 1) * (n + 1), 3);
+    Triangles facets(2 * n * n, 3);
+    for (int i = 0; i <= n; ++i) {
+        for (int j = 0; j <= n; ++j) {
+            vertices.row(i * (n + 1) + j) << i / 3.0, std::sqrt(double(j)), -1e-7 * i * j;
+        }
+    }
+    for (int i = 0; i < n; ++i) {
+        for (int j = 0; j < n; ++j) {
+            const int v = i * (n + 1) + j;
+            facets.row(2 * (i * n + j)) << v, v + 1, v + n + 2;
+            facets.row(2 * (i * n + j) + 1) << v, v + n + 2, v + n + 1;
+        }
+    }
+    auto mesh = create_mesh(vertices, facets);
+
+    SECTION("obj")
+    {
+        // Reference: printf-style full precision, as igl::writeOBJ.
+        std::stringstream expected;
+        expected.precision(17);
+        for (Eigen::Index i = 0; i < vertices.rows(); ++i) {
+            expected << "v " << vertices(i, 0) << " " << vertices(i, 1) << " " << vertices(i, 2)
+                     << "\n";
+        }
+        for (Eigen::Index i = 0; i < facets.rows(); ++i) {
+            expected << "f " << facets(i, 0) + 1 << " " << facets(i, 1) + 1 << " "
+                     << facets(i, 2) + 1 << "\n";
+        }
+        io::save_mesh("io_test_compat.obj", *mesh);
+        REQUIRE(read_file("io_test_compat.obj") == expected.str());
+        fs::remove("io_test_compat.obj");
+    }
+
+    SECTION("basic")
+    {
+        // Reference: Eigen full precision matrix printing.
+        std::stringstream expected;
+        using Eigen::DontAlignCols;
+        using Eigen::FullPrecision;
+        using Eigen::IOFormat;
+        const IOFormat vertex_format(FullPrecision, DontAlignCols, " ", "\n", "v ", "", "", "\n");
+        const IOFormat facet_format(FullPrecision, DontAlignCols, " ", "\n", "f ", "", "", "\n");
+        expected << vertices.format(vertex_format) << (facets.array() + 1).format(facet_format);
+        io::internal::save_mesh_basic("io_test_compat.obj", *mesh);
+        REQUIRE(read_file("io_test_compat.obj") == expected.str());
+        fs::remove("io_test_compat.obj");
+    }
+
+    SECTION("obj with normals")
+    {
+        mesh->add_vertex_attribute("normal");
+        mesh->set_vertex_attribute("normal", vertices);
+        io::save_mesh("io_test_compat.obj", *mesh);
+        const std::string output = read_file("io_test_compat.obj");
+        REQUIRE(output.find("v 0 1 -0\n") != std::string::npos);
+        REQUIRE(output.find("\nv 0.33333333333333331 0 -0\n") != std::string::npos);
+        REQUIRE(output.find("\nvn 0.333333333333333 0 -0\n") != std::string::npos);
+        REQUIRE(output.find("\nf 1//1 2//2 103//103\n") != std::string::npos);
+        fs::remove("io_test_compat.obj");
+    }
+
+    SECTION("vtk")
+    {
+        TriangleMesh3D::AttributeArray attr = vertices;
+        mesh->add_vertex_attribute("position");
+        mesh->set_vertex_attribute("position", attr);
+
+        // Reference: stream formatting, as the vtk writer used to do.
+        std::stringstream expected;
+        expected.precision(12);
+        expected.flags(std::ios::scientific);
+        expected << "# vtk DataFile Version 2.0\nLagrange output mesh\nASCII\n"
+                 << "DATASET UNSTRUCTURED_GRID\n\n";
+        expected << "POINTS " << vertices.rows() << " float\n";
+        for (Eigen::Index i = 0; i < vertices.rows(); ++i) {
+            expected << vertices(i, 0) << " " << vertices(i, 1) << " " << vertices(i, 2) << "\n";
+        }
+        expected << "\nCELLS " << facets.rows() << " " << facets.rows() * 4 << "\n";
+        for (Eigen::Index i = 0; i < facets.rows(); ++i) {
+            expected << 3 << " " << facets(i, 0) << " " << facets(i, 1) << " " << facets(i, 2)
+                     << " \n";
+        }
+        expected << "\nCELL_TYPES " << facets.rows() << "\n";
+        for (Eigen::Index i = 0; i < facets.rows(); ++i) expected << "5 \n";
+        expected << "\nPOINT_DATA " << vertices.rows() << " \n";
+        expected << "SCALARS position float 3\nLOOKUP_TABLE default \n";
+        for (Eigen::Index i = 0; i < vertices.rows(); ++i) {
+            expected << vertices(i, 0) << " " << vertices(i, 1) << " " << vertices(i, 2) << " \n";
+        }
+        expected << "\n";
+
+        io::save_mesh("io_test_compat.vtk", *mesh);
+        REQUIRE(read_file("io_test_compat.vtk") == expected.str());
+        fs::remove("io_test_compat.vtk");
+    }
+
+    SECTION("2D")
+    {
+        Vertices2D vertices_2d = vertices.leftCols(2);
+        auto mesh_2d = create_mesh(vertices_2d, facets);
+
+        std::stringstream expected;
+        for (Eigen::Index i = 0; i < vertices_2d.rows(); ++i) {
+            expected << "v " << vertices_2d(i, 0) << " " << vertices_2d(i, 1) << std::endl;
+        }
+        for (Eigen::Index i = 0; i < facets.rows(); ++i) {
+            expected << "f " << facets(i, 0) + 1 << " " << facets(i, 1) + 1 << " "
+                     << facets(i, 2) + 1 << std::endl;
+        }
+        io::internal::save_mesh_basic("io_test_compat_2d.obj", *mesh_2d);
+        REQUIRE(read_file("io_test_compat_2d.obj") == expected.str());
+        fs::remove("io_test_compat_2d.obj");
+    }
+}
@@ -0,0 +1,174 @@
+/*
+ * Copyright 2021 Adobe. All rights reserved.
+ * This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain a copy
+ * of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under
+ * the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ * OF ANY KIND, either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+ */
+#include <lagrange/Mesh.h>
+#include <lagrange/common.h>
+#include <lagrange/create_mesh.h>
+#include <lagrange/testing/common.h>
+
+#include <lagrange/io/load_mesh_ply.h>
+#include <lagrange/io/save_mesh_ply.h>
+
+#include <algorithm>
+#include <cstring>
+
+TEST_CASE("MeshPly", "[mesh][io][ply]")
+{
+    using namespace lagrange;
+    using AttributeArray = TriangleMesh3D::AttributeArray;
+
+    auto mesh = create_cube();
+    const auto num_vertices = mesh->get_num_vertices();
+
+    AttributeArray normals(num_vertices, 3);
+    normals.setRandom();
+    mesh->add_vertex_attribute("normal");
+    mesh->set_vertex_attribute("normal", normals);
+
+    AttributeArray colors(num_vertices, 4);
+    for (Eigen::Index i = 0; i < colors.size(); ++i) {
+        colors.data()[i] = double(i % 256);
+    }
+    mesh->add_vertex_attribute("color");
+    mesh->set_vertex_attribute("color", colors);
+
+    const std::string filename = "io_test_cube.ply";
+    auto encoding = GENERATE(io::FileEncoding::Binary, io::FileEncoding::Ascii);
+    io::save_mesh_ply(filename, *mesh, encoding);
+
+    SECTION("roundtrip")
+    {
+        auto mesh2 = io::load_mesh_ply<TriangleMesh3D>(filename);
+        REQUIRE(mesh2 != nullptr);
+        REQUIRE(mesh2->get_vertices() == mesh->get_vertices());
+        REQUIRE(mesh2->get_facets() == mesh->get_facets());
+        REQUIRE(mesh2->has_vertex_attribute("normal"));
+        REQUIRE(mesh2->get_vertex_attribute("normal") == normals);
+        REQUIRE(mesh2->has_vertex_attribute("color"));
+        REQUIRE(mesh2->get_vertex_attribute("color") == colors);
+    }
+
+    SECTION("selected properties")
+    {
+        io::PlyLoaderParams params;
+        params.load_normals = false;
+        params.load_colors = false;
+        params.vertex_properties = {"alpha", "missing"};
+        auto mesh2 = io::load_mesh_ply<TriangleMesh3D>(filename, params);
+        REQUIRE(mesh2 != nullptr);
+        REQUIRE(mesh2->get_vertices() == mesh->get_vertices());
+        REQUIRE(mesh2->get_facets() == mesh->get_facets());
+        REQUIRE(!mesh2->has_vertex_attribute("normal"));
+        REQUIRE(!mesh2->has_vertex_attribute("color"));
+        REQUIRE(mesh2->has_vertex_attribute("alpha"));
+        REQUIRE(!mesh2->has_vertex_attribute("missing"));
+        REQUIRE(mesh2->get_vertex_attribute("alpha") == colors.col(3));
+    }
+
+    SECTION("dynamic facet size")
+    {
+        using DynamicMesh = Mesh<Eigen::MatrixXf, Eigen::MatrixXi>;
+        auto mesh2 = io::load_mesh_ply<DynamicMesh>(filename);
+        REQUIRE(mesh2 != nullptr);
+        REQUIRE(mesh2->get_dim() == 3);
+        REQUIRE(mesh2->get_vertex_per_facet() == 3);
+        REQUIRE(mesh2->get_vertices() == mesh->get_vertices().cast<float>());
+        REQUIRE(mesh2->get_facets() == mesh->get_facets());
+    }
+
+    fs::remove(filename);
+}
+
+TEST_CASE("MeshPly big endian", "[mesh][io][ply]")
+{
+    using namespace lagrange;
+
+    // A single quad with float positions, a face-level property and an extra element.
+    std::string data =
+        "ply\n"
+        "format binary_big_endian 1.0\n"
+        "comment big endian quad\n"
+        "element vertex 4\n"
+        "property float x\n"
+        "property float y\n"
+        "property float z\n"
+        "property uchar red\n"
+        "property uchar green\n"
+        "property uchar blue\n"
+        "element face 1\n"
+        "property uchar flags\n"
+        "property list uchar uint vertex_indices\n"
+        "element extra 2\n"
+        "property list uchar short values\n"
+        "end_header\n";
+
+    auto push = [&](auto value) {
+        char bytes[sizeof(value)];
+        std::memcpy(bytes, &value, sizeof(value));
+        if (io::internal::ply::is_little_endian_host()) {
+            std::reverse(bytes, bytes + sizeof(value));
+        }
+        data.append(bytes, sizeof(value));
+    };
+
+    const float positions[4][3] = {{0, 0, 0}, {1, 0, 0}, {1, 1, 0}, {0, 1, 0.5f}};
+    for (int i = 0; i < 4; ++i) {
+        for (int j = 0; j < 3; ++j) push(positions[i][j]);
+        for (int j = 0; j < 3; ++j) push(uint8_t(10 * i + j));
+    }
+    push(uint8_t(7));
+    push(uint8_t(4));
+    for (uint32_t i = 0; i < 4; ++i) push(i);
+    push(uint8_t(1));
+    push(int16_t(-1));
+    push(uint8_t(0));
+
+    const std::string filename = "io_test_big_endian.ply";
+    {
+        fs::ofstream out(filename, std::ios::binary);
+        out.write(data.data(), data.size());
+    }
+
+    using QuadMesh = Mesh<Eigen::Matrix<double, Eigen::Dynamic, 3>, Eigen::MatrixXi>;
+    auto mesh = io::load_mesh_ply<QuadMesh>(filename);
+    fs::remove(filename);
+
+    REQUIRE(mesh != nullptr);
+    REQUIRE(mesh->get_num_vertices() == 4);
+    REQUIRE(mesh->get_num_facets() == 1);
+    REQUIRE(mesh->get_vertex_per_facet() == 4);
+    for (int i = 0; i < 4; ++i) {
+        for (int j = 0; j < 3; ++j) {
+            REQUIRE(mesh->get_vertices()(i, j) == positions[i][j]);
+        }
+        REQUIRE(mesh->get_facets()(0, i) == i);
+    }
+    REQUIRE(mesh->has_vertex_attribute("color"));
+    const auto& colors = mesh->get_vertex_attribute("color");
+    REQUIRE(colors.cols() == 3);
+    REQUIRE(colors(3, 2) == 32);
+}
+
+TEST_CASE("MeshPly invalid", "[mesh][io][ply]")
+{
+    using namespace lagrange;
+    REQUIRE(io::load_mesh_ply<TriangleMesh3D>("io_test_missing.ply") == nullptr);
+
+    const std::string filename = "io_test_truncated.ply";
+    {
+        fs::ofstream out(filename, std::ios::binary);
+        out << "ply\nformat binary_little_endian 1.0\nelement vertex 10\n"
+               "property float x\nproperty float y\nproperty float z\nend_header\n";
+        out << "short";
+    }
+    REQUIRE_THROWS(io::load_mesh_ply<TriangleMesh3D>(filename));
+    fs::remove(filename);
+}
@@ -18,7 +18,12 @@ using StringID = entt::id_type;
 /*
     Globally used enums
 */
+/// Mesh element an attribute is defined on. INDEXED attributes have their own index buffer
+/// (Mesh indexed attributes).
 enum class IndexingMode { VERTEX, EDGE, FACE, CORNER, INDEXED };
+/// Layout of the GLMesh buffers of a corner indexed render: FLATTENED has one row per corner,
+/// INDEXED has one row per render vertex and an index buffer (see RenderVertexMap).
+enum class BufferLayout { FLATTENED, INDEXED };
 enum class PrimitiveType { POINTS, LINES, TRIANGLES };
 enum class SelectionBehavior { SET, ADD, ERASE };
 
@@ -18,15 +18,76 @@
 #include <lagrange/utils/warnon.h>
 // clang-format on
 
+#include <atomic>
+#include <memory>
+#include <vector>
+
 namespace lagrange {
 namespace ui {
 
-
+/// Ray intersection acceleration structure of a mesh entity, see enable_accelerated_picking().
+/// Trees are built or refitted on a background task and swapped in when complete. The previous
+/// tree keeps serving intersect_ray() during a refit, but not during a rebuild since the facets
+/// may have changed.
 struct AcceleratedPicking
 {
-    igl::AABB<RowMajorMatrixXf, 3> root;
-    RowMajorMatrixXf V;
-    RowMajorMatrixXi F;
+    /// Tree over a copy of the mesh geometry. Not modified once published, until it is retired
+    /// and no longer referenced.
+    struct Tree
+    {
+        using Node = igl::AABB<RowMajorMatrixXf, 3>;
+
+        Node root;
+        RowMajorMatrixXf V;
+
+        /// Shared by the trees refitted from the same build
+        std::shared_ptr<const RowMajorMatrixXi> F;
+
+        /// Nodes in depth-first order, children come after their parent. Points into `root`,
+        /// must be listed again when the tree is copied.
+        std::vector<Node*> nodes;
+
+        /// Parent of each node, -1 for the root
+        std::vector<int> parents;
+
+        /// Leaf node of each facet
+        std::vector<int> facet_leaves;
+
+        /// Facets around vertex `v` are vertex_facets[vertex_facet_offsets[v]] up to
+        /// vertex_facets[vertex_facet_offsets[v + 1] - 1]
+        std::vector<int> vertex_facet_offsets;
+        std::vector<int> vertex_facets;
+
+        /// Vertices moved and nodes refitted since the tree this one was refitted from
+        std::vector<int> refitted_vertices;
+        std::vector<int> refitted_nodes;
+    };
+
+    /// State shared with the background task
+    struct PendingTree
+    {
+        std::shared_ptr<const Tree> tree;
+        std::atomic<bool> ready{false};
+
+        /// Value of `generation` when the task was started
+        int generation = 0;
+    };
+
+    /// Tree serving queries. Null until a build completes, and during a rebuild.
+    std::shared_ptr<const Tree> current;
+
+    /// Tree `current` was refitted from, reused by the next refit once no query holds it
+    std::shared_ptr<const Tree> retired;
+
+    /// Incremented by each rebuild. Tasks started before are discarded when they complete.
+    int generation = 0;
+
+    /// Build or refit in progress, at most one at a time
+    std::shared_ptr<PendingTree> pending;
+
+    /// Changes made since the last task was started, applied when the pending one completes
+    bool needs_rebuild = false;
+    std::vector<int> moved_vertices;
 };
 
 } // namespace ui
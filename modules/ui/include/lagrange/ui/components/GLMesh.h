@@ -11,6 +11,7 @@
  */
 #pragma once
 #include <lagrange/ui/Entity.h>
+#include <lagrange/ui/types/RenderVertexMap.h>
 #include <lagrange/ui/types/VertexBuffer.h>
 #include <memory>
 
@@ -36,6 +37,8 @@ struct DefaultShaderIndicesNames
     constexpr static const entt::id_type VertexIndices = entt::hashed_string{"_vertex_indices"};
     constexpr static const entt::id_type EdgeIndices = entt::hashed_string{"_edge_indices"};
     constexpr static const entt::id_type TriangleIndices = entt::hashed_string{"_triangle_indices"};
+    constexpr static const entt::id_type RenderTriangleIndices =
+        entt::hashed_string{"_render_triangle_indices"};
 };
 
 struct GLMesh
@@ -68,6 +71,38 @@ struct GLMesh
     std::unordered_map<entt::id_type, std::shared_ptr<GPUBuffer>> index_buffers;
 
     std::unordered_map<entt::id_type, std::shared_ptr<GPUBuffer>> submesh_indices;
+
+    //
+    // Indexed layout: attributes are stored once per render vertex (see RenderVertexMap) and
+    // triangles index into them. The buffers above use the flattened layout (one row per corner)
+    // and are only uploaded for entities that need it.
+    //
+
+    std::shared_ptr<GPUBuffer> get_indexed_attribute_buffer(entt::id_type id) const
+    {
+        auto it = indexed_attribute_buffers.find(id);
+        if (it == indexed_attribute_buffers.end()) return nullptr;
+        return it->second;
+    }
+
+    std::shared_ptr<GPUBuffer> get_indexed_submesh_buffer(entt::id_type id) const
+    {
+        auto it = indexed_submesh_indices.find(id);
+        if (it == indexed_submesh_indices.end()) return nullptr;
+        return it->second;
+    }
+
+    /// Cached mapping from corners to render vertices. Null if not computed yet.
+    std::shared_ptr<const RenderVertexMap> render_vertex_map;
+
+    /// Corners around each vertex, cached for partial updates of the flattened layout when
+    /// render_vertex_map is not computed. Null if not computed yet.
+    std::shared_ptr<const RenderVertexMap> vertex_corner_map;
+
+    // Use DefaultShaderAtrribNames or custom ids
+    std::unordered_map<entt::id_type, std::shared_ptr<GPUBuffer>> indexed_attribute_buffers;
+
+    std::unordered_map<entt::id_type, std::shared_ptr<GPUBuffer>> indexed_submesh_indices;
 };
 
 } // namespace ui
@@ -17,10 +17,15 @@
 namespace lagrange {
 namespace ui {
 
+struct MeshDataOps;
+
 struct MeshData
 {
     std::shared_ptr<lagrange::MeshBase> mesh;
     entt::type_info type;
+
+    /// Operations of `type`, cached by register_mesh(). Looked up from `type` if null.
+    const MeshDataOps* ops = nullptr;
 };
 
 struct MeshDataDirty
@@ -28,6 +33,14 @@ struct MeshDataDirty
     bool vertices = false;
     bool normals = false;
     bool all = false;
+
+    /// Vertices whose positions changed, when only some of them did. Lets systems update
+    /// buffers, bounds and picking in proportion to the edit. Ignored if `vertices` or `all`
+    /// is set. May contain duplicates.
+    std::vector<int> vertex_indices;
+
+    /// True if only the positions of `vertex_indices` changed
+    bool has_partial_vertices() const { return !all && !vertices && !vertex_indices.empty(); }
 };
 
 } // namespace ui
@@ -190,6 +190,12 @@ Entity load_mesh(
  * Mesh update
  */
 void set_mesh_vertices_dirty(Registry& r, Entity mesh_entity);
+/// Marks only the positions of the given vertices as modified. Accumulates until the dirty
+/// state is cleared at the end of the frame.
+void set_mesh_vertices_dirty(
+    Registry& r,
+    Entity mesh_entity,
+    const std::vector<int>& vertex_indices);
 void set_mesh_normals_dirty(Registry& r, Entity mesh_entity);
 void set_mesh_dirty(Registry& r, Entity mesh_entity);
 
@@ -0,0 +1,168 @@
+/*
+ * Copyright 2020 Adobe. All rights reserved.
+ * This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain a copy
+ * of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under
+ * the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ * OF ANY KIND, either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+ */
+#pragma once
+
+#include <lagrange/Mesh.h>
+#include <lagrange/ui/Entity.h>
+#include <lagrange/ui/utils/math.h>
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace lagrange {
+namespace ui {
+
+class AABB;
+class Camera;
+class Frustum;
+struct GPUBuffer;
+struct RayFacetHit;
+struct RenderVertexMap;
+
+/// Functions of a registered mesh type, called by the MeshData functions of
+/// <lagrange/ui/utils/mesh.h>. Filled by register_mesh_type<MeshType>() and cached on MeshData,
+/// so that each call is an indirect call instead of a reflection lookup.
+struct MeshDataOps
+{
+    using GPUBufferMap = std::unordered_map<entt::id_type, std::shared_ptr<GPUBuffer>>;
+
+    // Getters
+    size_t (*get_num_vertices)(const MeshBase*) = nullptr;
+    size_t (*get_num_facets)(const MeshBase*) = nullptr;
+    size_t (*get_num_edges)(const MeshBase*) = nullptr;
+    RowMajorMatrixXf (*get_mesh_vertices)(const MeshBase*) = nullptr;
+    RowMajorMatrixXf (*get_mesh_vertices_subset)(const MeshBase*, const std::vector<int>*) =
+        nullptr;
+    RowMajorMatrixXi (*get_mesh_facets)(const MeshBase*) = nullptr;
+    RowMajorMatrixXf (*get_mesh_vertex_attribute)(const MeshBase*, const std::string&) = nullptr;
+    RowMajorMatrixXf (*get_mesh_corner_attribute)(const MeshBase*, const std::string&) = nullptr;
+    RowMajorMatrixXf (*get_mesh_facet_attribute)(const MeshBase*, const std::string&) = nullptr;
+    RowMajorMatrixXf (*get_mesh_edge_attribute)(const MeshBase*, const std::string&) = nullptr;
+    RowMajorMatrixXf (*get_mesh_attribute)(const MeshBase*, IndexingMode, const std::string&) =
+        nullptr;
+    std::pair<Eigen::VectorXf, Eigen::VectorXf> (
+        *get_mesh_attribute_range)(const MeshBase*, IndexingMode, const std::string&) = nullptr;
+    AABB (*get_mesh_bounds)(const MeshBase*) = nullptr;
+
+    // Ensure attribs
+    void (*ensure_uv)(MeshBase*) = nullptr;
+    void (*ensure_normal)(MeshBase*) = nullptr;
+    void (*ensure_tangent_bitangent)(MeshBase*) = nullptr;
+    void (*ensure_is_selected_attribute)(MeshBase*) = nullptr;
+    void (*map_indexed_attribute_to_corner_attribute)(MeshBase*, const std::string&) = nullptr;
+    void (*map_corner_attribute_to_vertex_attribute)(MeshBase*, const std::string&) = nullptr;
+
+    // Has attribute
+    bool (*has_mesh_vertex_attribute)(const MeshBase*, const std::string&) = nullptr;
+    bool (*has_mesh_corner_attribute)(const MeshBase*, const std::string&) = nullptr;
+    bool (*has_mesh_facet_attribute)(const MeshBase*, const std::string&) = nullptr;
+    bool (*has_mesh_edge_attribute)(const MeshBase*, const std::string&) = nullptr;
+    bool (*has_mesh_indexed_attribute)(const MeshBase*, const std::string&) = nullptr;
+
+    // Mesh to GPU
+    void (*upload_mesh_vertices)(const MeshBase*, GPUBuffer*) = nullptr;
+    void (*update_mesh_vertices)(
+        const MeshBase*,
+        const std::vector<int>*,
+        const RenderVertexMap*,
+        GPUBuffer*) = nullptr;
+    void (*upload_mesh_triangles)(const MeshBase*, GPUBuffer*) = nullptr;
+    void (*upload_mesh_vertex_attribute)(const MeshBase*, const RowMajorMatrixXf*, GPUBuffer*) =
+        nullptr;
+    void (*upload_mesh_corner_attribute)(const MeshBase*, const RowMajorMatrixXf*, GPUBuffer*) =
+        nullptr;
+    void (*upload_mesh_facet_attribute)(const MeshBase*, const RowMajorMatrixXf*, GPUBuffer*) =
+        nullptr;
+    void (*upload_mesh_edge_attribute)(const MeshBase*, const RowMajorMatrixXf*, GPUBuffer*) =
+        nullptr;
+    GPUBufferMap (*upload_submesh_indices)(const MeshBase*, const std::string&) = nullptr;
+
+    // Mesh to GPU (indexed layout)
+    std::shared_ptr<RenderVertexMap> (*compute_vertex_corner_map)(const MeshBase*) = nullptr;
+    std::shared_ptr<RenderVertexMap> (
+        *compute_render_vertex_map)(const MeshBase*, const std::vector<std::string>*) = nullptr;
+    void (*upload_mesh_vertices_indexed)(const MeshBase*, const RenderVertexMap*, GPUBuffer*) =
+        nullptr;
+    void (*update_mesh_vertices_indexed)(
+        const MeshBase*,
+        const std::vector<int>*,
+        const RenderVertexMap*,
+        GPUBuffer*) = nullptr;
+    void (*upload_mesh_vertex_attribute_indexed)(
+        const MeshBase*,
+        const RowMajorMatrixXf*,
+        const RenderVertexMap*,
+        GPUBuffer*) = nullptr;
+    void (*upload_mesh_corner_attribute_indexed)(
+        const MeshBase*,
+        const RowMajorMatrixXf*,
+        const RenderVertexMap*,
+        GPUBuffer*) = nullptr;
+    GPUBufferMap (*upload_submesh_indices_indexed)(
+        const MeshBase*,
+        const std::string&,
+        const RenderVertexMap*) = nullptr;
+
+    // Picking
+    bool (*intersect_ray)(
+        const MeshBase*,
+        const Eigen::Vector3f&,
+        const Eigen::Vector3f&,
+        RayFacetHit*) = nullptr;
+
+    // Selection
+    bool (*select_facets_in_frustum)(MeshBase*, SelectionBehavior, const Frustum*) = nullptr;
+    void (*select_vertices_in_frustum)(MeshBase*, SelectionBehavior, const Frustum*) = nullptr;
+    void (*select_edges_in_frustum)(MeshBase*, SelectionBehavior, const Frustum*) = nullptr;
+    void (*propagate_corner_selection)(MeshBase*, const std::string&) = nullptr;
+    void (*propagate_vertex_selection)(MeshBase*, const std::string&) = nullptr;
+    void (*propagate_facet_selection)(MeshBase*, const std::string&) = nullptr;
+    void (*combine_vertex_and_corner_selection)(MeshBase*, const std::string&) = nullptr;
+    void (*select_facets_by_color)(
+        MeshBase*,
+        const std::string&,
+        SelectionBehavior,
+        const unsigned char*,
+        size_t) = nullptr;
+    void (*select_edges_by_color)(
+        MeshBase*,
+        const std::string&,
+        SelectionBehavior,
+        const unsigned char*,
+        size_t) = nullptr;
+    void (*select_vertices_by_color)(
+        MeshBase*,
+        const std::string&,
+        SelectionBehavior,
+        const unsigned char*,
+        size_t) = nullptr;
+    void (*select_facets)(MeshBase*, SelectionBehavior, const std::vector<int>*) = nullptr;
+    void (*filter_closest_vertex)(
+        MeshBase*,
+        const std::string&,
+        SelectionBehavior,
+        const Camera&,
+        const Eigen::Vector2i&) = nullptr;
+};
+
+/// Makes the operations of a mesh type available to MeshData of that type.
+/// Called by register_mesh_type<MeshType>(), `ops` must outlive all such MeshData.
+void register_mesh_data_ops(const entt::type_info& type, const MeshDataOps* ops);
+
+/// Returns the operations of a type registered with register_mesh_type(), or nullptr.
+const MeshDataOps* get_mesh_data_ops(const entt::type_info& type);
+
+} // namespace ui
+} // namespace lagrange
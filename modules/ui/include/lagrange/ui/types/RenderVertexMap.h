@@ -0,0 +1,51 @@
+/*
+ * Copyright 2020 Adobe. All rights reserved.
+ * This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain a copy
+ * of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under
+ * the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ * OF ANY KIND, either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+ */
+#pragma once
+
+#include <lagrange/ui/utils/math.h>
+
+#include <string>
+#include <vector>
+
+namespace lagrange {
+namespace ui {
+
+/// Maps mesh corners to the shared vertices of the indexed GPU layout (render vertices).
+/// Corners around the same mesh vertex share a render vertex, unless the value of one of
+/// `attribute_names` differs between them (i.e. the vertex lies on a seam of that attribute).
+struct RenderVertexMap
+{
+    /// Corner attributes that were compared to split render vertices.
+    std::vector<std::string> attribute_names;
+
+    /// Mesh vertex of each render vertex.
+    std::vector<int> vertices;
+
+    /// Representative corner of each render vertex, used to gather corner attributes.
+    std::vector<int> corners;
+
+    /// Render vertex of each corner, #facets x 3.
+    RowMajorMatrixXi triangles;
+
+    /// Render vertices of mesh vertex `v` are [vertex_offsets[v], vertex_offsets[v + 1]).
+    std::vector<int> vertex_offsets;
+
+    /// Corners around mesh vertex `v` are vertex_corners[corner_offsets[v]] up to
+    /// vertex_corners[corner_offsets[v + 1] - 1].
+    std::vector<int> corner_offsets;
+    std::vector<int> vertex_corners;
+
+    size_t get_num_render_vertices() const { return vertices.size(); }
+};
+
+} // namespace ui
+} // namespace lagrange
@@ -95,8 +95,38 @@ struct VertexBuffer
     void
     upload(GLuint byte_size, const uint8_t* data, GLsizei count, bool integral, GLenum gl_type);
 
+    /// Overwrites `size_` bytes starting at byte `offset`, keeping the rest of the buffer.
+    /// The range must lie within the allocated storage.
+    void upload_range(GLuint offset, GLuint size_, const uint8_t* data);
+
     void download(GLuint size_, uint8_t* data) const;
 
+    /// Uploads `rows` x `cols` floats written by `fill(float* output)`, without an intermediate
+    /// copy. The buffer storage is mapped and filled in place. If the driver cannot map the
+    /// buffer, the data is written to a reusable staging buffer and uploaded with glBufferData.
+    template <typename FillFunc>
+    void upload_float_rows(size_t rows, size_t cols, const FillFunc& fill);
+
+    /// Allocates `size_` bytes of storage and maps it for writing. The previous content is
+    /// discarded. Returns nullptr if the buffer could not be mapped. After a failure, the
+    /// following uploads in the current GL context skip mapping for a while.
+    uint8_t* map(GLuint size_, GLsizei count, bool integral, GLenum gl_type);
+
+    /// Unmaps a buffer mapped by map(). Returns false if the content was lost while mapped, in
+    /// which case it must be uploaded again.
+    bool unmap();
+
+    /// Returns host memory of at least `byte_size` bytes, reused between uploads that cannot map
+    /// the buffer. Only valid on the thread owning the GL context, until the next call.
+    static uint8_t* get_staging_memory(size_t byte_size);
+
+    /// Called once per frame. Frees the staging memory if it has been much larger than the
+    /// uploads needed for a few seconds, or if it exceeds a size cap.
+    static void trim_staging_memory();
+
+    /// Frees the staging memory, e.g. before the GL context is destroyed.
+    static void release_staging_memory();
+
     void free();
 };
 
@@ -127,6 +157,25 @@ void VertexBuffer::upload(const std::vector<T>& arr, uint32_t component_count)
 }
 
 
+template <typename FillFunc>
+void VertexBuffer::upload_float_rows(size_t rows, size_t cols, const FillFunc& fill)
+{
+    const size_t byte_size = rows * cols * sizeof(float);
+    const GLsizei cnt = static_cast<GLsizei>(rows);
+
+    if (byte_size > 0) {
+        if (uint8_t* mapped = map(GLuint(byte_size), cnt, false, GL_FLOAT)) {
+            fill(reinterpret_cast<float*>(mapped));
+            if (unmap()) return;
+        }
+    }
+
+    uint8_t* staging = get_staging_memory(byte_size);
+    fill(reinterpret_cast<float*>(staging));
+    upload(GLuint(byte_size), staging, cnt, false, GL_FLOAT);
+}
+
+
 struct VAO
 {
     VAO()
@@ -0,0 +1,87 @@
+/*
+ * Copyright 2020 Adobe. All rights reserved.
+ * This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain a copy
+ * of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under
+ * the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ * OF ANY KIND, either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+ */
+#pragma once
+
+#include <Eigen/Core>
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace lagrange {
+namespace ui {
+
+/// Fills `output` with `num_rows` rows of `data` converted to float, in row-major order.
+/// Output row `i` is the input row `row_of(i)`. Rows are gathered in parallel.
+///
+/// This is the CPU side of the GPU buffer uploads: `output` is usually mapped GPU memory or
+/// a staging buffer, and must hold at least `num_rows * data.cols()` floats.
+///
+/// @param[in]  data      Source rows.
+/// @param[in]  num_rows  Number of rows to write.
+/// @param[in]  row_of    Callable returning the source row index of an output row.
+/// @param[out] output    Destination buffer.
+template <typename Derived, typename RowIndexFunc>
+void gather_rows_to_float(
+    const Eigen::MatrixBase<Derived>& data,
+    size_t num_rows,
+    const RowIndexFunc& row_of,
+    float* output)
+{
+    const Eigen::Index cols = data.cols();
+    tbb::parallel_for(
+        tbb::blocked_range<size_t>(0, num_rows),
+        [&](const tbb::blocked_range<size_t>& range) {
+            for (size_t i = range.begin(); i != range.end(); i++) {
+                const Eigen::Index row = static_cast<Eigen::Index>(row_of(i));
+                float* dst = output + i * cols;
+                for (Eigen::Index j = 0; j < cols; j++) {
+                    dst[j] = static_cast<float>(data(row, j));
+                }
+            }
+        });
+}
+
+/// Fills `output` with the rows of `data` converted to float, in row-major order.
+template <typename Derived>
+void gather_rows_to_float(const Eigen::MatrixBase<Derived>& data, float* output)
+{
+    gather_rows_to_float(
+        data,
+        static_cast<size_t>(data.rows()),
+        [](size_t i) { return i; },
+        output);
+}
+
+/// Sorts and removes duplicates from `rows`, and returns the ranges [begin, end) of consecutive
+/// rows. Used to send only the modified parts of a buffer to the GPU.
+inline std::vector<std::pair<int, int>> sort_into_row_ranges(std::vector<int>& rows)
+{
+    std::sort(rows.begin(), rows.end());
+    rows.erase(std::unique(rows.begin(), rows.end()), rows.end());
+
+    std::vector<std::pair<int, int>> ranges;
+    for (const int row : rows) {
+        if (!ranges.empty() && ranges.back().second == row) {
+            ranges.back().second++;
+        } else {
+            ranges.emplace_back(row, row + 1);
+        }
+    }
+    return ranges;
+}
+
+} // namespace ui
+} // namespace lagrange
@@ -17,6 +17,8 @@
 #include <lagrange/ui/types/Frustum.h>
 #include <lagrange/ui/types/RayFacetHit.h>
 #include <lagrange/ui/types/AABB.h>
+#include <lagrange/ui/types/MeshDataOps.h>
+#include <lagrange/ui/types/RenderVertexMap.h>
 #include <lagrange/ui/utils/math.h>
 #include <optional>
 
@@ -37,6 +39,7 @@ Entity register_mesh(Registry& r, std::shared_ptr<MeshType> mesh)
     MeshData d;
     d.mesh = mesh;
     d.type = entt::type_id<MeshType>();
+    d.ops = get_mesh_data_ops(d.type);
     r.emplace<MeshData>(e, std::move(d));
     return e;
 }
@@ -67,6 +70,8 @@ size_t get_num_vertices(const MeshData& d);
 size_t get_num_facets(const MeshData& d);
 size_t get_num_edges(const MeshData& d);
 RowMajorMatrixXf get_mesh_vertices(const MeshData& d);
+/// Returns the positions of the given vertices, one row per index.
+RowMajorMatrixXf get_mesh_vertices(const MeshData& d, const std::vector<int>& vertex_indices);
 RowMajorMatrixXi get_mesh_facets(const MeshData& d);
 RowMajorMatrixXf get_mesh_vertex_attribute(const MeshData& d, const std::string& name);
 RowMajorMatrixXf get_mesh_corner_attribute(const MeshData& d, const std::string& name);
@@ -105,6 +110,50 @@ std::unordered_map<entt::id_type, std::shared_ptr<GPUBuffer>> upload_submesh_ind
     const MeshData& d,
     const std::string& facet_attrib_name);
 
+//////////////////////////////////////////////////////////////////////////////////////
+// Mesh to GPU upload (indexed layout)
+//////////////////////////////////////////////////////////////////////////////////////
+
+/// Computes only the corners around each vertex (corner_offsets and vertex_corners), which is
+/// all the flattened layout needs to update a subset of vertices.
+std::shared_ptr<RenderVertexMap> compute_vertex_corner_map(const MeshData& d);
+
+/// Computes the render vertices of the indexed layout. Vertices are split only where one of
+/// the given corner attributes differs between corners (missing attributes are ignored).
+std::shared_ptr<RenderVertexMap> compute_render_vertex_map(
+    const MeshData& d,
+    const std::vector<std::string>& corner_attribute_names);
+
+void upload_mesh_vertices(const MeshData& d, const RenderVertexMap& map, GPUBuffer& gpu);
+void upload_render_triangles(const RenderVertexMap& map, GPUBuffer& gpu);
+
+/// Re-uploads the positions of the given vertices to a buffer filled by upload_mesh_vertices(),
+/// in the given layout. Only the rows of these vertices are sent to the GPU. `map` is used to
+/// find them; the flattened layout only needs its corners (see compute_vertex_corner_map()).
+void update_mesh_vertices(
+    const MeshData& d,
+    const std::vector<int>& vertex_indices,
+    const RenderVertexMap& map,
+    BufferLayout layout,
+    GPUBuffer& gpu);
+
+void upload_mesh_vertex_attribute(
+    const MeshData& d,
+    const RowMajorMatrixXf& data,
+    const RenderVertexMap& map,
+    GPUBuffer& gpu);
+/// Corner attributes not used to compute `map` are sampled at a single corner per render vertex.
+void upload_mesh_corner_attribute(
+    const MeshData& d,
+    const RowMajorMatrixXf& data,
+    const RenderVertexMap& map,
+    GPUBuffer& gpu);
+
+std::unordered_map<entt::id_type, std::shared_ptr<GPUBuffer>> upload_submesh_indices(
+    const MeshData& d,
+    const std::string& facet_attrib_name,
+    const RenderVertexMap& map);
+
 //////////////////////////////////////////////////////////////////////////////////////
 // Has attribute
 //////////////////////////////////////////////////////////////////////////////////////
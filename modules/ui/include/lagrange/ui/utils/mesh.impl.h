@@ -20,8 +20,11 @@
 #include <lagrange/ui/types/Camera.h>
 #include <lagrange/ui/types/Color.h>
 #include <lagrange/ui/types/Frustum.h>
+#include <lagrange/ui/types/MeshDataOps.h>
 #include <lagrange/ui/types/RayFacetHit.h>
+#include <lagrange/ui/types/RenderVertexMap.h>
 #include <lagrange/ui/types/VertexBuffer.h>
+#include <lagrange/ui/utils/buffer_staging.h>
 #include <lagrange/ui/utils/math.h>
 #include <lagrange/ui/utils/objectid_viewport.h>
 #include <lagrange/utils/tbb.h>
@@ -71,6 +74,22 @@ const typename MeshType::VertexArray& get_mesh_vertices(const MeshBase* mesh_bas
 }
 
 
+template <typename MeshType>
+RowMajorMatrixXf get_mesh_vertices_subset(
+    const MeshBase* mesh_base,
+    const std::vector<int>* vertex_indices)
+{
+    const auto& V = reinterpret_cast<const MeshType&>(*mesh_base).get_vertices();
+    const auto& indices = *vertex_indices;
+    RowMajorMatrixXf result(indices.size(), V.cols());
+    gather_rows_to_float(
+        V,
+        indices.size(),
+        [&](size_t i) { return indices[i]; },
+        result.data());
+    return result;
+}
+
 template <typename MeshType>
 RowMajorMatrixXi get_mesh_facets(const MeshBase* mesh_base)
 {
@@ -320,21 +339,73 @@ std::shared_ptr<GPUBuffer> create_gpubuffer_and_upload(const T& data)
     return gpubuf;
 }
 
+/// Uploads `num_rows` rows of `data` converted to float, output row `i` being `row_of(i)`.
+/// The rows are gathered in parallel directly into the GPU buffer storage.
+template <typename Derived, typename RowIndexFunc>
+void upload_gathered_rows(
+    GPUBuffer* gpu,
+    const Eigen::MatrixBase<Derived>& data,
+    size_t num_rows,
+    const RowIndexFunc& row_of)
+{
+    gpu->vbo().upload_float_rows(num_rows, size_t(data.cols()), [&](float* output) {
+        gather_rows_to_float(data, num_rows, row_of, output);
+    });
+}
+
+/// Re-uploads the rows `rows` of a buffer filled by upload_gathered_rows() with the same
+/// arguments. Only the modified ranges are sent to the GPU, unless they cover most of the buffer.
+template <typename Derived, typename RowIndexFunc>
+void update_gathered_rows(
+    GPUBuffer* gpu,
+    const Eigen::MatrixBase<Derived>& data,
+    size_t num_rows,
+    const RowIndexFunc& row_of,
+    std::vector<int> rows)
+{
+    auto& vbo = gpu->vbo();
+    const size_t cols = size_t(data.cols());
+    const size_t row_bytes = cols * sizeof(float);
+
+    // Buffer was never uploaded with this layout, or partial updates would not pay off
+    if (vbo.id == 0 || size_t(vbo.size) != num_rows * row_bytes || rows.size() * 2 > num_rows) {
+        upload_gathered_rows(gpu, data, num_rows, row_of);
+        return;
+    }
+
+    const auto ranges = sort_into_row_ranges(rows);
+    if (ranges.empty()) return;
+
+    // Gather the modified rows contiguously, then copy each range to its place in the buffer
+    auto staging =
+        reinterpret_cast<float*>(VertexBuffer::get_staging_memory(rows.size() * row_bytes));
+    gather_rows_to_float(
+        data,
+        rows.size(),
+        [&](size_t i) { return row_of(size_t(rows[i])); },
+        staging);
+
+    size_t offset = 0;
+    for (const auto& range : ranges) {
+        const size_t count = size_t(range.second - range.first);
+        vbo.upload_range(
+            GLuint(size_t(range.first) * row_bytes),
+            GLuint(count * row_bytes),
+            reinterpret_cast<const uint8_t*>(staging + offset * cols));
+        offset += count;
+    }
+}
+
 template <typename MeshType>
 void upload_mesh_vertex_attribute(const MeshBase* d, const RowMajorMatrixXf* data, GPUBuffer* gpu)
 {
     auto& m = reinterpret_cast<const MeshType&>(*d);
     LA_ASSERT(data->rows() == m.get_num_vertices());
-    RowMajorMatrixXf flattened = RowMajorMatrixXf(m.get_num_facets() * 3, data->cols());
 
     const auto& F = m.get_facets();
-    for (auto fi = 0; fi < m.get_num_facets(); fi++) {
-        flattened.row(3 * fi + 0) = data->row(F(fi, 0));
-        flattened.row(3 * fi + 1) = data->row(F(fi, 1));
-        flattened.row(3 * fi + 2) = data->row(F(fi, 2));
-    }
-
-    (*gpu).vbo().upload(std::move(flattened));
+    upload_gathered_rows(gpu, *data, size_t(m.get_num_facets()) * 3, [&](size_t c) {
+        return F(c / 3, c % 3);
+    });
 }
 
 template <typename MeshType>
@@ -351,15 +422,9 @@ void upload_mesh_facet_attribute(const MeshBase* d, const RowMajorMatrixXf* data
     auto& m = reinterpret_cast<const MeshType&>(*d);
     LA_ASSERT(data->rows() == m.get_num_facets());
 
-    RowMajorMatrixXf flattened = RowMajorMatrixXf(m.get_num_facets() * 3, data->cols());
-
-    for (auto i = 0; i < data->rows(); i++) {
-        flattened.row(3 * i + 0) = data->row(i);
-        flattened.row(3 * i + 1) = data->row(i);
-        flattened.row(3 * i + 2) = data->row(i);
-    }
-
-    (*gpu).vbo().upload(std::move(flattened));
+    upload_gathered_rows(gpu, *data, size_t(m.get_num_facets()) * 3, [](size_t c) {
+        return c / 3;
+    });
 }
 
 template <typename MeshType>
@@ -369,21 +434,13 @@ void upload_mesh_edge_attribute(const MeshBase* d, const RowMajorMatrixXf* data,
     LA_ASSERT(m.is_edge_data_initialized(), "Edge data (new) not initialized");
     LA_ASSERT(data->rows() == m.get_num_edges());
 
-    const auto& F = m.get_facets();
-    const auto per_facet = m.get_vertex_per_facet();
-
-    RowMajorMatrixXf flattened = RowMajorMatrixXf(m.get_num_facets() * per_facet, data->cols());
-
-    // For each flattened triangle
-    for (auto i = 0; i < F.rows(); i++) {
-        // For each of its edges
-        for (auto k = 0; k < per_facet; k++) {
-            const auto ei = m.get_edge(i, k);
-            flattened.row(per_facet * i + k) = data->row(ei);
-        }
-    }
+    using Index = typename MeshType::Index;
+    const auto per_facet = size_t(m.get_vertex_per_facet());
 
-    (*gpu).vbo().upload(std::move(flattened));
+    // Each corner of a flattened facet gets the value of its outgoing edge
+    upload_gathered_rows(gpu, *data, size_t(m.get_num_facets()) * per_facet, [&](size_t c) {
+        return m.get_edge(Index(c / per_facet), Index(c % per_facet));
+    });
 }
 
 template <typename MeshType>
@@ -391,27 +448,47 @@ void upload_mesh_vertices(const MeshBase* mesh_base, GPUBuffer* gpu)
 {
     // TODO template for 2D
     auto& m = reinterpret_cast<const MeshType&>(*mesh_base);
-    auto& data = m.get_vertices();
-
-    RowMajorMatrixXf flattened = RowMajorMatrixXf(m.get_num_facets() * 3, data.cols());
 
     const auto& F = m.get_facets();
-    for (auto fi = 0; fi < m.get_num_facets(); fi++) {
-        flattened.row(3 * fi + 0) = data.row(F(fi, 0)).template cast<float>();
-        flattened.row(3 * fi + 1) = data.row(F(fi, 1)).template cast<float>();
-        flattened.row(3 * fi + 2) = data.row(F(fi, 2)).template cast<float>();
-    }
-
-    (*gpu).vbo().upload(std::move(flattened));
+    upload_gathered_rows(gpu, m.get_vertices(), size_t(m.get_num_facets()) * 3, [&](size_t c) {
+        return F(c / 3, c % 3);
+    });
 }
 
 template <typename MeshType>
-std::unordered_map<entt::id_type, std::shared_ptr<GPUBuffer>> upload_submesh_indices(
+void update_mesh_vertices(
     const MeshBase* mesh_base,
-    const std::string& facet_attrib_name)
+    const std::vector<int>* vertex_indices,
+    const RenderVertexMap* map,
+    GPUBuffer* gpu)
 {
     auto& m = reinterpret_cast<const MeshType&>(*mesh_base);
+    LA_ASSERT(map->corner_offsets.size() == size_t(m.get_num_vertices()) + 1);
+
+    // Rows of the flattened layout are the corners around the modified vertices
+    std::vector<int> rows;
+    for (const int v : *vertex_indices) {
+        LA_ASSERT(v >= 0 && v < m.get_num_vertices(), "Invalid vertex index");
+        for (int i = map->corner_offsets[v]; i < map->corner_offsets[v + 1]; i++) {
+            rows.push_back(map->vertex_corners[i]);
+        }
+    }
+
+    const auto& F = m.get_facets();
+    update_gathered_rows(
+        gpu,
+        m.get_vertices(),
+        size_t(m.get_num_facets()) * 3,
+        [&](size_t c) { return F(c / 3, c % 3); },
+        std::move(rows));
+}
 
+template <typename MeshType, typename CornerIndexFunc>
+std::unordered_map<entt::id_type, std::shared_ptr<GPUBuffer>> upload_submesh_indices_impl(
+    const MeshType& m,
+    const std::string& facet_attrib_name,
+    const CornerIndexFunc& get_corner_index)
+{
     const auto& sub_ids = m.get_facet_attribute(facet_attrib_name);
 
     using FacetArray = typename MeshType::FacetArray;
@@ -440,9 +517,9 @@ std::unordered_map<entt::id_type, std::shared_ptr<GPUBuffer>> upload_submesh_ind
         auto id = entt::id_type(sub_ids(fi, 0));
         auto& counter = sub_counts.at(id);
         auto& triangles = submesh_triangles.at(id);
-        triangles(counter - 1, 0) = 3 * fi + 0;
-        triangles(counter - 1, 1) = 3 * fi + 1;
-        triangles(counter - 1, 2) = 3 * fi + 2;
+        triangles(counter - 1, 0) = get_corner_index(fi, 0);
+        triangles(counter - 1, 1) = get_corner_index(fi, 1);
+        triangles(counter - 1, 2) = get_corner_index(fi, 2);
         counter--;
     }
 #ifdef _DEBUG
@@ -461,6 +538,238 @@ std::unordered_map<entt::id_type, std::shared_ptr<GPUBuffer>> upload_submesh_ind
     return result;
 }
 
+template <typename MeshType>
+std::unordered_map<entt::id_type, std::shared_ptr<GPUBuffer>> upload_submesh_indices(
+    const MeshBase* mesh_base,
+    const std::string& facet_attrib_name)
+{
+    auto& m = reinterpret_cast<const MeshType&>(*mesh_base);
+    using Index = typename MeshType::Index;
+    return upload_submesh_indices_impl(m, facet_attrib_name, [](Index fi, Index k) {
+        return 3 * fi + k;
+    });
+}
+
+//////////////////////////////////////////////////////////////////////////////////////
+// Mesh to GPU upload (indexed layout)
+//////////////////////////////////////////////////////////////////////////////////////
+
+// Fills the corners around each vertex, ordered by corner index
+template <typename FacetArray>
+void compute_vertex_corners(const FacetArray& F, int num_vertices, RenderVertexMap& map)
+{
+    const int num_corners = int(F.rows() * 3);
+    auto& corner_offsets = map.corner_offsets;
+    auto& vertex_corners = map.vertex_corners;
+    corner_offsets.assign(num_vertices + 1, 0);
+    for (int c = 0; c < num_corners; c++) {
+        corner_offsets[F(c / 3, c % 3) + 1]++;
+    }
+    for (int v = 0; v < num_vertices; v++) {
+        corner_offsets[v + 1] += corner_offsets[v];
+    }
+    vertex_corners.resize(num_corners);
+    std::vector<int> counter(corner_offsets.begin(), corner_offsets.end() - 1);
+    for (int c = 0; c < num_corners; c++) {
+        vertex_corners[counter[F(c / 3, c % 3)]++] = c;
+    }
+}
+
+template <typename MeshType>
+std::shared_ptr<RenderVertexMap> compute_vertex_corner_map(const MeshBase* mesh_base)
+{
+    const auto& m = reinterpret_cast<const MeshType&>(*mesh_base);
+    LA_ASSERT(m.get_facets().cols() == 3, "Triangulate the mesh first");
+
+    auto result = std::make_shared<RenderVertexMap>();
+    compute_vertex_corners(m.get_facets(), int(m.get_num_vertices()), *result);
+    return result;
+}
+
+template <typename MeshType>
+std::shared_ptr<RenderVertexMap> compute_render_vertex_map(
+    const MeshBase* mesh_base,
+    const std::vector<std::string>* corner_attribute_names)
+{
+    const auto& m = reinterpret_cast<const MeshType&>(*mesh_base);
+    using AttributeArray = typename MeshType::AttributeArray;
+    LA_ASSERT(m.get_facets().cols() == 3, "Triangulate the mesh first");
+
+    const auto& F = m.get_facets();
+    const int num_vertices = int(m.get_num_vertices());
+    const int num_corners = int(m.get_num_facets() * 3);
+
+    auto result = std::make_shared<RenderVertexMap>();
+
+    // Only corner attributes can split a vertex
+    std::vector<const AttributeArray*> attributes;
+    for (const auto& name : *corner_attribute_names) {
+        if (!m.has_corner_attribute(name)) continue;
+        attributes.push_back(&m.get_corner_attribute(name));
+        result->attribute_names.push_back(name);
+    }
+    // Lexicographic order on attribute values, NaNs sort last and never match
+    auto corner_less = [&](int c0, int c1) {
+        for (const auto* attr : attributes) {
+            for (Eigen::Index k = 0; k < attr->cols(); k++) {
+                const auto a = (*attr)(c0, k);
+                const auto b = (*attr)(c1, k);
+                if (a == b || (std::isnan(a) && std::isnan(b))) continue;
+                if (std::isnan(a)) return false;
+                if (std::isnan(b)) return true;
+                return a < b;
+            }
+        }
+        return false;
+    };
+    auto is_same_render_vertex = [&](int c0, int c1) {
+        for (const auto* attr : attributes) {
+            if (attr->row(c0) != attr->row(c1)) return false;
+        }
+        return true;
+    };
+
+    compute_vertex_corners(F, num_vertices, *result);
+    const auto& corner_offsets = result->corner_offsets;
+    const auto& vertex_corners = result->vertex_corners;
+
+    // Group the corners around each vertex by value. Corners are stable sorted by value, so each
+    // run of identical values starts with its first corner, then groups are numbered in the order
+    // of their first corner.
+    std::vector<int> local_ids(num_corners);
+    auto& vertex_offsets = result->vertex_offsets;
+    vertex_offsets.assign(num_vertices + 1, 0);
+    tbb::parallel_for(
+        tbb::blocked_range<int>(0, num_vertices),
+        [&](const tbb::blocked_range<int>& tbb_range) {
+            std::vector<int> sorted_corners;
+            for (int v = tbb_range.begin(); v != tbb_range.end(); v++) {
+                const auto begin = vertex_corners.begin() + corner_offsets[v];
+                const auto end = vertex_corners.begin() + corner_offsets[v + 1];
+                sorted_corners.assign(begin, end);
+                std::stable_sort(sorted_corners.begin(), sorted_corners.end(), corner_less);
+
+                // Point each corner to the first corner of its run
+                for (size_t i = 0; i < sorted_corners.size(); i++) {
+                    const int c = sorted_corners[i];
+                    const bool starts_run =
+                        i == 0 || !is_same_render_vertex(sorted_corners[i - 1], c);
+                    local_ids[c] = starts_run ? c : local_ids[sorted_corners[i - 1]];
+                }
+
+                // First corners come before the rest of their group in corner order
+                int num_groups = 0;
+                for (auto it = begin; it != end; ++it) {
+                    const int c = *it;
+                    local_ids[c] = local_ids[c] == c ? num_groups++ : local_ids[local_ids[c]];
+                }
+                vertex_offsets[v + 1] = num_groups;
+            }
+        });
+    for (int v = 0; v < num_vertices; v++) {
+        vertex_offsets[v + 1] += vertex_offsets[v];
+    }
+
+    const int num_render_vertices = vertex_offsets.back();
+    result->vertices.resize(num_render_vertices);
+    result->corners.resize(num_render_vertices);
+    result->triangles.resize(m.get_num_facets(), 3);
+    tbb::parallel_for(0, num_vertices, [&](int v) {
+        int num_groups = 0;
+        for (int i = corner_offsets[v]; i < corner_offsets[v + 1]; i++) {
+            const int c = vertex_corners[i];
+            const int r = vertex_offsets[v] + local_ids[c];
+            result->triangles(c / 3, c % 3) = r;
+            // Groups are numbered by first corner, which is their representative
+            if (local_ids[c] == num_groups) {
+                result->vertices[r] = v;
+                result->corners[r] = c;
+                num_groups++;
+            }
+        }
+    });
+
+    return result;
+}
+
+template <typename MeshType>
+void upload_mesh_vertices_indexed(
+    const MeshBase* mesh_base,
+    const RenderVertexMap* map,
+    GPUBuffer* gpu)
+{
+    auto& m = reinterpret_cast<const MeshType&>(*mesh_base);
+    const auto& rows = map->vertices;
+    upload_gathered_rows(gpu, m.get_vertices(), rows.size(), [&](size_t i) { return rows[i]; });
+}
+
+template <typename MeshType>
+void update_mesh_vertices_indexed(
+    const MeshBase* mesh_base,
+    const std::vector<int>* vertex_indices,
+    const RenderVertexMap* map,
+    GPUBuffer* gpu)
+{
+    auto& m = reinterpret_cast<const MeshType&>(*mesh_base);
+    LA_ASSERT(map->vertex_offsets.size() == size_t(m.get_num_vertices()) + 1);
+
+    // Render vertices of a mesh vertex are consecutive
+    std::vector<int> rows;
+    for (const int v : *vertex_indices) {
+        LA_ASSERT(v >= 0 && v < m.get_num_vertices(), "Invalid vertex index");
+        for (int r = map->vertex_offsets[v]; r < map->vertex_offsets[v + 1]; r++) {
+            rows.push_back(r);
+        }
+    }
+
+    const auto& render_vertices = map->vertices;
+    update_gathered_rows(
+        gpu,
+        m.get_vertices(),
+        render_vertices.size(),
+        [&](size_t i) { return render_vertices[i]; },
+        std::move(rows));
+}
+
+template <typename MeshType>
+void upload_mesh_vertex_attribute_indexed(
+    const MeshBase* d,
+    const RowMajorMatrixXf* data,
+    const RenderVertexMap* map,
+    GPUBuffer* gpu)
+{
+    auto& m = reinterpret_cast<const MeshType&>(*d);
+    LA_ASSERT(data->rows() == m.get_num_vertices());
+    const auto& rows = map->vertices;
+    upload_gathered_rows(gpu, *data, rows.size(), [&](size_t i) { return rows[i]; });
+}
+
+template <typename MeshType>
+void upload_mesh_corner_attribute_indexed(
+    const MeshBase* d,
+    const RowMajorMatrixXf* data,
+    const RenderVertexMap* map,
+    GPUBuffer* gpu)
+{
+    auto& m = reinterpret_cast<const MeshType&>(*d);
+    LA_ASSERT(data->rows() == m.get_num_facets() * 3);
+    const auto& rows = map->corners;
+    upload_gathered_rows(gpu, *data, rows.size(), [&](size_t i) { return rows[i]; });
+}
+
+template <typename MeshType>
+std::unordered_map<entt::id_type, std::shared_ptr<GPUBuffer>> upload_submesh_indices_indexed(
+    const MeshBase* mesh_base,
+    const std::string& facet_attrib_name,
+    const RenderVertexMap* map)
+{
+    auto& m = reinterpret_cast<const MeshType&>(*mesh_base);
+    using Index = typename MeshType::Index;
+    return upload_submesh_indices_impl(m, facet_attrib_name, [map](Index fi, Index k) {
+        return map->triangles(fi, k);
+    });
+}
+
 
 //////////////////////////////////////////////////////////////////////////////////////
 // Has attribute
@@ -1007,6 +1316,84 @@ void filter_closest_vertex(
 }
 
 
+
+/// Typed dispatch table of MeshType, see MeshDataOps
+template <typename MeshType>
+MeshDataOps make_mesh_data_ops()
+{
+    MeshDataOps ops;
+
+    // Getters
+    ops.get_num_vertices = &get_num_vertices<MeshType>;
+    ops.get_num_facets = &get_num_facets<MeshType>;
+    ops.get_num_edges = &get_num_edges<MeshType>;
+    ops.get_mesh_vertices = [](const MeshBase* mesh_base) -> RowMajorMatrixXf {
+        return eigen_convert_to_float(get_mesh_vertices<MeshType>(mesh_base));
+    };
+    ops.get_mesh_vertices_subset = &get_mesh_vertices_subset<MeshType>;
+    ops.get_mesh_facets = &get_mesh_facets<MeshType>;
+    ops.get_mesh_vertex_attribute = &get_mesh_vertex_attribute<MeshType>;
+    ops.get_mesh_corner_attribute = &get_mesh_corner_attribute<MeshType>;
+    ops.get_mesh_facet_attribute = &get_mesh_facet_attribute<MeshType>;
+    ops.get_mesh_edge_attribute = &get_mesh_edge_attribute<MeshType>;
+    ops.get_mesh_attribute = &get_mesh_attribute<MeshType>;
+    ops.get_mesh_attribute_range = &get_mesh_attribute_range<MeshType>;
+    ops.get_mesh_bounds = &get_mesh_bounds<MeshType>;
+
+    // Ensure attribs
+    ops.ensure_uv = &ensure_uv<MeshType>;
+    ops.ensure_normal = &ensure_normal<MeshType>;
+    ops.ensure_tangent_bitangent = &ensure_tangent_bitangent<MeshType>;
+    ops.ensure_is_selected_attribute = &ensure_is_selected_attribute<MeshType>;
+    ops.map_indexed_attribute_to_corner_attribute = &map_indexed_attribute_to_corner_attribute<MeshType>;
+    ops.map_corner_attribute_to_vertex_attribute = &map_corner_attribute_to_vertex_attribute<MeshType>;
+
+    // Has attribute
+    ops.has_mesh_vertex_attribute = &has_mesh_vertex_attribute<MeshType>;
+    ops.has_mesh_corner_attribute = &has_mesh_corner_attribute<MeshType>;
+    ops.has_mesh_facet_attribute = &has_mesh_facet_attribute<MeshType>;
+    ops.has_mesh_edge_attribute = &has_mesh_edge_attribute<MeshType>;
+    ops.has_mesh_indexed_attribute = &has_mesh_indexed_attribute<MeshType>;
+
+    // Mesh to GPU
+    ops.upload_mesh_vertices = &upload_mesh_vertices<MeshType>;
+    ops.update_mesh_vertices = &update_mesh_vertices<MeshType>;
+    ops.upload_mesh_triangles = &upload_mesh_triangles<MeshType>;
+    ops.upload_mesh_vertex_attribute = &upload_mesh_vertex_attribute<MeshType>;
+    ops.upload_mesh_corner_attribute = &upload_mesh_corner_attribute<MeshType>;
+    ops.upload_mesh_facet_attribute = &upload_mesh_facet_attribute<MeshType>;
+    ops.upload_mesh_edge_attribute = &upload_mesh_edge_attribute<MeshType>;
+    ops.upload_submesh_indices = &upload_submesh_indices<MeshType>;
+
+    // Mesh to GPU (indexed layout)
+    ops.compute_vertex_corner_map = &compute_vertex_corner_map<MeshType>;
+    ops.compute_render_vertex_map = &compute_render_vertex_map<MeshType>;
+    ops.upload_mesh_vertices_indexed = &upload_mesh_vertices_indexed<MeshType>;
+    ops.update_mesh_vertices_indexed = &update_mesh_vertices_indexed<MeshType>;
+    ops.upload_mesh_vertex_attribute_indexed = &upload_mesh_vertex_attribute_indexed<MeshType>;
+    ops.upload_mesh_corner_attribute_indexed = &upload_mesh_corner_attribute_indexed<MeshType>;
+    ops.upload_submesh_indices_indexed = &upload_submesh_indices_indexed<MeshType>;
+
+    // Picking
+    ops.intersect_ray = &intersect_ray<MeshType>;
+
+    // Selection
+    ops.select_facets_in_frustum = &select_facets_in_frustum<MeshType>;
+    ops.select_vertices_in_frustum = &select_vertices_in_frustum<MeshType>;
+    ops.select_edges_in_frustum = &select_edges_in_frustum<MeshType>;
+    ops.propagate_corner_selection = &propagate_corner_selection<MeshType>;
+    ops.propagate_vertex_selection = &propagate_vertex_selection<MeshType>;
+    ops.propagate_facet_selection = &propagate_facet_selection<MeshType>;
+    ops.combine_vertex_and_corner_selection = &combine_vertex_and_corner_selection<MeshType>;
+    ops.select_facets_by_color = &select_facets_by_color<MeshType>;
+    ops.select_edges_by_color = &select_edges_by_color<MeshType>;
+    ops.select_vertices_by_color = &select_vertices_by_color<MeshType>;
+    ops.select_facets = &select_facets<MeshType>;
+    ops.filter_closest_vertex = &filter_closest_vertex<MeshType>;
+
+    return ops;
+}
+
 } // namespace detail
 
 
@@ -1032,6 +1419,8 @@ void register_mesh_type([[maybe_unused]] const std::string& display_name = entt:
 
     entt::meta<MeshType>().template func<&detail::get_mesh_vertices<MeshType>>(
         "get_mesh_vertices"_hs);
+    entt::meta<MeshType>().template func<&detail::get_mesh_vertices_subset<MeshType>>(
+        "get_mesh_vertices_subset"_hs);
 
     entt::meta<MeshType>().template func<&detail::get_mesh_facets<MeshType>>("get_mesh_facets"_hs);
     entt::meta<MeshType>().template func<&detail::get_mesh_vertex_attribute<MeshType>>(
@@ -1069,6 +1458,8 @@ void register_mesh_type([[maybe_unused]] const std::string& display_name = entt:
     // Mesh to GPU
     entt::meta<MeshType>().template func<&detail::upload_mesh_vertices<MeshType>>(
         "upload_mesh_vertices"_hs);
+    entt::meta<MeshType>().template func<&detail::update_mesh_vertices<MeshType>>(
+        "update_mesh_vertices"_hs);
     entt::meta<MeshType>().template func<&detail::upload_mesh_triangles<MeshType>>(
         "upload_mesh_triangles"_hs);
     entt::meta<MeshType>().template func<&detail::upload_mesh_vertex_attribute<MeshType>>(
@@ -1082,6 +1473,22 @@ void register_mesh_type([[maybe_unused]] const std::string& display_name = entt:
     entt::meta<MeshType>().template func<&detail::upload_submesh_indices<MeshType>>(
         "upload_submesh_indices"_hs);
 
+    // Mesh to GPU (indexed layout)
+    entt::meta<MeshType>().template func<&detail::compute_vertex_corner_map<MeshType>>(
+        "compute_vertex_corner_map"_hs);
+    entt::meta<MeshType>().template func<&detail::compute_render_vertex_map<MeshType>>(
+        "compute_render_vertex_map"_hs);
+    entt::meta<MeshType>().template func<&detail::upload_mesh_vertices_indexed<MeshType>>(
+        "upload_mesh_vertices_indexed"_hs);
+    entt::meta<MeshType>().template func<&detail::update_mesh_vertices_indexed<MeshType>>(
+        "update_mesh_vertices_indexed"_hs);
+    entt::meta<MeshType>().template func<&detail::upload_mesh_vertex_attribute_indexed<MeshType>>(
+        "upload_mesh_vertex_attribute_indexed"_hs);
+    entt::meta<MeshType>().template func<&detail::upload_mesh_corner_attribute_indexed<MeshType>>(
+        "upload_mesh_corner_attribute_indexed"_hs);
+    entt::meta<MeshType>().template func<&detail::upload_submesh_indices_indexed<MeshType>>(
+        "upload_submesh_indices_indexed"_hs);
+
 
     // Has attribute
     entt::meta<MeshType>().template func<&detail::has_mesh_vertex_attribute<MeshType>>(
@@ -1127,6 +1534,11 @@ void register_mesh_type([[maybe_unused]] const std::string& display_name = entt:
     entt::meta<MeshType>().template func<&detail::select_facets<MeshType>>("select_facets"_hs);
     entt::meta<MeshType>().template func<&detail::filter_closest_vertex<MeshType>>(
         "filter_closest_vertex"_hs);
+
+    // Typed dispatch table, used by the functions of <lagrange/ui/utils/mesh.h> instead of the
+    // reflection lookups above
+    static const MeshDataOps ops = detail::make_mesh_data_ops<MeshType>();
+    register_mesh_data_ops(entt::type_id<MeshType>(), &ops);
 }
 
 
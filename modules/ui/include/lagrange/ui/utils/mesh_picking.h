@@ -24,6 +24,7 @@ struct MeshSelectionRender;
 
 /// Mesh triangle X ray intersection
 /// Uses an accelerated data structure if enabled for entity e (use `enable_accelerated_picking`)
+/// and built, otherwise tests all triangles
 std::optional<RayFacetHit>
 intersect_ray(Registry& r, Entity e, const Eigen::Vector3f& origin, const Eigen::Vector3f& dir);
 
@@ -83,12 +84,26 @@ void mark_selection_dirty(Registry& r, MeshSelectionRender& sel_render);
 */
 
 /// Computes acceleration structure (igl::AABB) for faster ray-triangle intersection
+/// The structure is built on a background task, intersect_ray() tests all triangles until then
 /// Entity can be entity with MeshGeometry or MeshData
 /// Returns false if entity does not have a mesh
 bool enable_accelerated_picking(Registry& r, Entity e);
 
 bool has_accelerated_picking(Registry& r, Entity e);
 
+/// Updates the positions of the given vertices in the acceleration structure and refits its
+/// boxes on a background task, without rebuilding the tree. The facets must be unchanged.
+/// Returns false if the entity does not have accelerated picking enabled
+bool refit_accelerated_picking(Registry& r, Entity e, const std::vector<int>& vertex_indices);
+
+/// Publishes a completed acceleration structure and starts the next build or refit if changes
+/// were queued meanwhile. Entity must have a mesh and accelerated picking enabled.
+/// Called each frame by the update_accelerated_picking system
+void poll_accelerated_picking(Registry& r, Entity e);
+
+/// Blocks until the acceleration structure reflects all the changes made so far
+void wait_for_accelerated_picking(Registry& r, Entity e);
+
 
 
 
@@ -123,17 +123,29 @@ bool set_mesh_geometry_layout(
 
 int get_gl_attribute_dimension(GLenum attrib_type);
 
+/// @brief Returns the layout of the GLMesh buffers bound for a MeshRender entity
+///
+/// Corner indexed renders use the shared render vertices of the indexed layout, unless the
+/// entity needs one vertex per corner: per-entity attribute buffers (AttributeRender) and
+/// element picking (Selection layer) rely on the flattened layout.
+/// @param registry
+/// @param e entity with MeshRender component
+BufferLayout get_mesh_buffer_layout(Registry& registry, Entity e);
+
 /// @brief Assigns buffers from GLMesh to GLVertexData to Shader specified locations
 /// @param glmesh collection of gpu buffers
 /// @param shader
 /// @param glvd
 /// @param indexing
+/// @param submesh_index
+/// @param layout BufferLayout::INDEXED binds the indexed layout buffers of glmesh
 void update_vertex_data(
     const GLMesh& glmesh,
     const Shader& shader,
     VertexData& glvd,
     IndexingMode indexing,
-    entt::id_type submesh_index
+    entt::id_type submesh_index,
+    BufferLayout layout = BufferLayout::FLATTENED
 );
 
 } // namespace ui
@@ -35,6 +35,7 @@
 #include <lagrange/ui/systems/update_scene_bounds.h>
 #include <lagrange/ui/systems/update_transform_hierarchy.h>
 #include <lagrange/ui/types/GLContext.h>
+#include <lagrange/ui/types/VertexBuffer.h>
 #include <lagrange/ui/utils/bounds.h>
 #include <lagrange/ui/utils/events.h>
 #include <lagrange/ui/utils/file_dialog.h>
@@ -594,6 +595,7 @@ Viewer::~Viewer()
     ImGui_ImplOpenGL3_Shutdown();
     ImGui_ImplGlfw_Shutdown();
     ImGui::DestroyContext(m_imgui_context);
+    VertexBuffer::release_staging_memory();
     glfwDestroyWindow(m_window);
     glfwTerminate(); // TODO ref count windows
 }
@@ -135,7 +135,22 @@ void set_material(Registry& registry, Entity meshrender_entity, std::shared_ptr<
 
 void set_mesh_vertices_dirty(Registry& registry, Entity mesh_entity)
 {
-    registry.get_or_emplace<MeshDataDirty>(mesh_entity).vertices = true;
+    auto& mdd = registry.get_or_emplace<MeshDataDirty>(mesh_entity);
+    mdd.vertices = true;
+    mdd.vertex_indices.clear();
+}
+
+void set_mesh_vertices_dirty(
+    Registry& registry,
+    Entity mesh_entity,
+    const std::vector<int>& vertex_indices)
+{
+    auto& mdd = registry.get_or_emplace<MeshDataDirty>(mesh_entity);
+    if (mdd.vertices || mdd.all) return;
+    mdd.vertex_indices.insert(
+        mdd.vertex_indices.end(),
+        vertex_indices.begin(),
+        vertex_indices.end());
 }
 
 void set_mesh_normals_dirty(Registry& registry, Entity mesh_entity)
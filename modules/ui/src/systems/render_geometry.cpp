@@ -126,7 +126,7 @@ void setup_vertex_data(Registry& r)
 
     // Setup default mesh rendering attribute arrays
     r.view<VertexData, MeshRender, MeshGeometry>().each(
-        [&](Entity /*e*/, VertexData& glvd, MeshRender& render, const MeshGeometry& geom_entity) {
+        [&](Entity e, VertexData& glvd, MeshRender& render, const MeshGeometry& geom_entity) {
             if (!r.valid(geom_entity.entity)) return;
             if (!r.has<GLMesh>(geom_entity.entity)) return;
             if (!render.material) return;
@@ -137,7 +137,13 @@ void setup_vertex_data(Registry& r)
             auto& glmesh = r.get<GLMesh>(geom_entity.entity);
             auto& shader = *shader_handle;
 
-            update_vertex_data(glmesh, shader, glvd, render.indexing, geom_entity.submesh_index);
+            update_vertex_data(
+                glmesh,
+                shader,
+                glvd,
+                render.indexing,
+                geom_entity.submesh_index,
+                get_mesh_buffer_layout(r, e));
         });
 }
 
@@ -23,11 +23,20 @@ void update_accelerated_picking(Registry& r)
 
     for (auto e : dview) {
         const auto& mdd = dview.get<MeshDataDirty>(e);
-        if (mdd.all || mdd.vertices) {
+        if (mdd.has_partial_vertices()) {
+            // Facets are unchanged, keep the tree and only refit its boxes
+            refit_accelerated_picking(r, e, mdd.vertex_indices);
+        } else if (mdd.all || mdd.vertices) {
             // Recompute acceleration data structure
             enable_accelerated_picking(r, e);
         }
     }
+
+    // Swap in trees completed since the last frame
+    auto view = r.view<MeshData, AcceleratedPicking>();
+    for (auto e : view) {
+        poll_accelerated_picking(r, e);
+    }
 }
 
 } // namespace ui
@@ -24,11 +24,25 @@ namespace ui {
 void update_mesh_bounds_system(Registry& r)
 {
     {
-        // Dirty view, reset bounds
+        // Dirty view, reset bounds if vertices moved
         auto dview = r.view<MeshDataDirty, MeshData>();
         for (auto e : dview) {
             if (!r.has<Bounds>(e)) continue;
-            r.remove<Bounds>(e);
+
+            const auto& mdd = dview.get<MeshDataDirty>(e);
+            if (mdd.has_partial_vertices()) {
+                // Grow the bounds to include the moved vertices. They may become loose if
+                // vertices moved inwards, until the next full update.
+                auto& bounds = r.get<Bounds>(e);
+                const auto P = get_mesh_vertices(dview.get<MeshData>(e), mdd.vertex_indices);
+                for (Eigen::Index i = 0; i < P.rows(); i++) {
+                    bounds.local.extend(P.row(i).transpose().head<3>());
+                }
+                bounds.global = bounds.local;
+                bounds.bvh_node = bounds.local;
+            } else if (mdd.all || mdd.vertices) {
+                r.remove<Bounds>(e);
+            }
         }
     }
 
@@ -17,12 +17,200 @@
 #include <lagrange/ui/components/MeshRender.h>
 #include <lagrange/ui/systems/update_mesh_buffers.h>
 #include <lagrange/ui/utils/mesh.h>
+#include <lagrange/ui/utils/render.h>
 
+#include <algorithm>
 #include <unordered_map>
+#include <unordered_set>
 
 namespace lagrange {
 namespace ui {
 
+namespace {
+
+// Mapping between lagrange mesh and default shader attributes
+const std::vector<std::pair<const char*, entt::id_type>>& get_default_attribs()
+{
+    const static std::vector<std::pair<const char*, entt::id_type>> default_attribs = {
+        {"normal", DefaultShaderAtrribNames::Normal},
+        {"uv", DefaultShaderAtrribNames::UV},
+        {"tangent", DefaultShaderAtrribNames::Tangent},
+        {"bitangent", DefaultShaderAtrribNames::Bitangent},
+        {"bone_ids", DefaultShaderAtrribNames::BoneIDs},
+        {"bone_weights", DefaultShaderAtrribNames::BoneWeights},
+    };
+    return default_attribs;
+}
+
+// One row per corner
+void upload_flattened_buffers(const MeshData& meshdata, GLMesh& glmesh)
+{
+    if (!glmesh.get_attribute_buffer(DefaultShaderAtrribNames::Position)) {
+        glmesh.attribute_buffers[DefaultShaderAtrribNames::Position] =
+            std::make_shared<GPUBuffer>();
+        upload_mesh_vertices(meshdata, *glmesh.attribute_buffers[DefaultShaderAtrribNames::Position]);
+    }
+
+    if (!glmesh.get_index_buffer(DefaultShaderIndicesNames::TriangleIndices)) {
+        glmesh.index_buffers[DefaultShaderIndicesNames::TriangleIndices] =
+            std::make_shared<GPUBuffer>(GL_ELEMENT_ARRAY_BUFFER);
+        upload_mesh_triangles(
+            meshdata,
+            *glmesh.index_buffers[DefaultShaderIndicesNames::TriangleIndices]);
+    }
+
+    for (const auto& attr : get_default_attribs()) {
+        // Already uploaded
+        if (glmesh.get_attribute_buffer(attr.second)) continue;
+
+        // If has corner attribute, upload
+        if (has_mesh_corner_attribute(meshdata, attr.first)) {
+            glmesh.attribute_buffers[attr.second] = std::make_shared<GPUBuffer>();
+            upload_mesh_corner_attribute(
+                meshdata,
+                get_mesh_corner_attribute(meshdata, attr.first),
+                *glmesh.attribute_buffers[attr.second]);
+        }
+        // Otherwise try vertex attribute (and expand it to corner attribute for gpu upload)
+        else if (has_mesh_vertex_attribute(meshdata, attr.first)) {
+            glmesh.attribute_buffers[attr.second] = std::make_shared<GPUBuffer>();
+            upload_mesh_vertex_attribute(
+                meshdata,
+                get_mesh_vertex_attribute(meshdata, attr.first),
+                *glmesh.attribute_buffers[attr.second]);
+        }
+    }
+
+    // Material id
+    if (has_mesh_facet_attribute(meshdata, "material_id") && glmesh.submesh_indices.size() == 0) {
+        glmesh.submesh_indices = upload_submesh_indices(meshdata, "material_id");
+    }
+}
+
+void clear_indexed_buffers(GLMesh& glmesh)
+{
+    glmesh.render_vertex_map = nullptr;
+    glmesh.indexed_attribute_buffers.clear();
+    glmesh.indexed_submesh_indices.clear();
+    glmesh.index_buffers.erase(DefaultShaderIndicesNames::RenderTriangleIndices);
+}
+
+// Corner attributes that split render vertices
+std::vector<std::string> get_corner_attribute_names(const MeshData& meshdata)
+{
+    std::vector<std::string> corner_attribute_names;
+    for (const auto& attr : get_default_attribs()) {
+        if (has_mesh_corner_attribute(meshdata, attr.first)) {
+            corner_attribute_names.push_back(attr.first);
+        }
+    }
+    return corner_attribute_names;
+}
+
+// Re-uploads the positions of the moved vertices only, in each layout already on the GPU
+void update_position_buffers(
+    const MeshData& meshdata,
+    const std::vector<int>& vertex_indices,
+    GLMesh& glmesh)
+{
+    auto flattened = glmesh.get_attribute_buffer(DefaultShaderAtrribNames::Position);
+    auto indexed = glmesh.get_indexed_attribute_buffer(DefaultShaderAtrribNames::Position);
+    if (!flattened && !indexed) return;
+
+    // The render vertex map exists if the indexed layout was uploaded. The flattened layout only
+    // needs the corners around each vertex, which are cheaper to compute.
+    if (indexed) {
+        update_mesh_vertices(
+            meshdata,
+            vertex_indices,
+            *glmesh.render_vertex_map,
+            BufferLayout::INDEXED,
+            *indexed);
+    }
+    if (flattened) {
+        if (!glmesh.render_vertex_map && !glmesh.vertex_corner_map) {
+            glmesh.vertex_corner_map = compute_vertex_corner_map(meshdata);
+        }
+        const auto& map = glmesh.render_vertex_map ? *glmesh.render_vertex_map
+                                                   : *glmesh.vertex_corner_map;
+        update_mesh_vertices(meshdata, vertex_indices, map, BufferLayout::FLATTENED, *flattened);
+    }
+}
+
+// Normals changed. Render vertices are split again only if corner normals were used to split
+// them, and the other indexed buffers are kept if the split did not change.
+void update_normal_seams(const MeshData& meshdata, GLMesh& glmesh)
+{
+    if (!glmesh.render_vertex_map) return;
+    const auto& names = glmesh.render_vertex_map->attribute_names;
+    if (std::find(names.begin(), names.end(), "normal") == names.end()) return;
+
+    auto map = compute_render_vertex_map(meshdata, get_corner_attribute_names(meshdata));
+    if (map->attribute_names != names || map->triangles != glmesh.render_vertex_map->triangles) {
+        clear_indexed_buffers(glmesh);
+    }
+    glmesh.render_vertex_map = std::move(map);
+}
+
+// One row per render vertex, vertices are split only along seams of corner attributes
+void upload_indexed_buffers(const MeshData& meshdata, GLMesh& glmesh)
+{
+    const auto corner_attribute_names = get_corner_attribute_names(meshdata);
+
+    // Corner attributes were added since the last upload, render vertices have to be split again
+    if (glmesh.render_vertex_map &&
+        glmesh.render_vertex_map->attribute_names != corner_attribute_names) {
+        clear_indexed_buffers(glmesh);
+    }
+    if (!glmesh.render_vertex_map) {
+        glmesh.render_vertex_map = compute_render_vertex_map(meshdata, corner_attribute_names);
+    }
+    const auto& map = *glmesh.render_vertex_map;
+
+    if (!glmesh.get_indexed_attribute_buffer(DefaultShaderAtrribNames::Position)) {
+        auto buffer = std::make_shared<GPUBuffer>();
+        upload_mesh_vertices(meshdata, map, *buffer);
+        glmesh.indexed_attribute_buffers[DefaultShaderAtrribNames::Position] = std::move(buffer);
+    }
+
+    if (!glmesh.get_index_buffer(DefaultShaderIndicesNames::RenderTriangleIndices)) {
+        auto buffer = std::make_shared<GPUBuffer>(GL_ELEMENT_ARRAY_BUFFER);
+        upload_render_triangles(map, *buffer);
+        glmesh.index_buffers[DefaultShaderIndicesNames::RenderTriangleIndices] = std::move(buffer);
+    }
+
+    for (const auto& attr : get_default_attribs()) {
+        // Already uploaded
+        if (glmesh.get_indexed_attribute_buffer(attr.second)) continue;
+
+        if (has_mesh_corner_attribute(meshdata, attr.first)) {
+            auto buffer = std::make_shared<GPUBuffer>();
+            upload_mesh_corner_attribute(
+                meshdata,
+                get_mesh_corner_attribute(meshdata, attr.first),
+                map,
+                *buffer);
+            glmesh.indexed_attribute_buffers[attr.second] = std::move(buffer);
+        } else if (has_mesh_vertex_attribute(meshdata, attr.first)) {
+            auto buffer = std::make_shared<GPUBuffer>();
+            upload_mesh_vertex_attribute(
+                meshdata,
+                get_mesh_vertex_attribute(meshdata, attr.first),
+                map,
+                *buffer);
+            glmesh.indexed_attribute_buffers[attr.second] = std::move(buffer);
+        }
+    }
+
+    // Material id
+    if (has_mesh_facet_attribute(meshdata, "material_id") &&
+        glmesh.indexed_submesh_indices.size() == 0) {
+        glmesh.indexed_submesh_indices = upload_submesh_indices(meshdata, "material_id", map);
+    }
+}
+
+} // namespace
+
 
 void update_mesh_buffers_system(Registry& r)
 {
@@ -37,18 +225,34 @@ void update_mesh_buffers_system(Registry& r)
                 continue;
             }
 
-            if (mdd.vertices) {
-                upload_mesh_vertices(
-                    view.get<MeshData>(e),
-                    *view.get<GLMesh>(e).attribute_buffers[DefaultShaderAtrribNames::Position]);
+            auto& glmesh = view.get<GLMesh>(e);
+            if (mdd.normals) {
+                glmesh.attribute_buffers[DefaultShaderAtrribNames::Normal] = nullptr;
+                glmesh.indexed_attribute_buffers.erase(DefaultShaderAtrribNames::Normal);
+                update_normal_seams(view.get<MeshData>(e), glmesh);
             }
 
-            if (mdd.normals) {
-                view.get<GLMesh>(e).attribute_buffers[DefaultShaderAtrribNames::Normal] = nullptr;
+            if (mdd.vertices) {
+                if (auto buffer = glmesh.get_attribute_buffer(DefaultShaderAtrribNames::Position)) {
+                    upload_mesh_vertices(view.get<MeshData>(e), *buffer);
+                }
+                if (auto buffer =
+                        glmesh.get_indexed_attribute_buffer(DefaultShaderAtrribNames::Position)) {
+                    upload_mesh_vertices(
+                        view.get<MeshData>(e),
+                        *glmesh.render_vertex_map,
+                        *buffer);
+                }
+            } else if (mdd.has_partial_vertices()) {
+                update_position_buffers(view.get<MeshData>(e), mdd.vertex_indices, glmesh);
             }
         }
     }
 
+    // Mesh entities rendered with one row per corner, and with shared render vertices
+    std::unordered_set<Entity> flattened_meshes;
+    std::unordered_set<Entity> indexed_meshes;
+
     //Ensure attributes like normals/uvs/bitangents/tangents are present if shader needs them
     {
         auto view = r.view<MeshRender, MeshGeometry>();
@@ -59,6 +263,12 @@ void update_mesh_buffers_system(Registry& r)
 
             LA_ASSERT(r.valid(mesh_entity), "Invalid mesh entity " + ui::get_name(r, e));
 
+            if (get_mesh_buffer_layout(r, e) == BufferLayout::INDEXED) {
+                indexed_meshes.insert(mesh_entity);
+            } else {
+                flattened_meshes.insert(mesh_entity);
+            }
+
             auto& md = r.get<MeshData>(mesh_entity);
 
             // No material set
@@ -88,78 +298,41 @@ void update_mesh_buffers_system(Registry& r)
 
     // Iterate over all MeshData
     // If they do not have GLMesh yet, create one
-    // For each buffer, if it doesn't exist and the data is available, upload to GPU
+    // For each buffer of the layouts in use, if it doesn't exist and the data is available,
+    // upload to GPU
     {
         auto view = r.view<MeshData>();
         for (auto e : view) {
             auto& meshdata = view.get<MeshData>(e);
+            const bool flattened = flattened_meshes.count(e) > 0;
+            const bool indexed = indexed_meshes.count(e) > 0;
 
             if (!r.has<GLMesh>(e)) {
                 r.emplace<GLMesh>(e);
             } else {
-                // Skip non-dirty mesh entities that already have glmesh
-                if (!r.has<MeshDataDirty>(e)) {
+                // Skip non-dirty mesh entities that already have their buffers
+                const auto& glmesh = r.get<GLMesh>(e);
+                const bool has_flattened =
+                    glmesh.get_attribute_buffer(DefaultShaderAtrribNames::Position) != nullptr;
+                const bool has_indexed = glmesh.get_indexed_attribute_buffer(
+                                             DefaultShaderAtrribNames::Position) != nullptr;
+                if (!r.has<MeshDataDirty>(e) && (!flattened || has_flattened) &&
+                    (!indexed || has_indexed)) {
                     continue;
                 }
             }
             auto& glmesh = r.get<GLMesh>(e);
 
-
-            if (!glmesh.get_attribute_buffer(DefaultShaderAtrribNames::Position)) {
-                glmesh.attribute_buffers[DefaultShaderAtrribNames::Position] =
-                    std::make_shared<GPUBuffer>();
-                upload_mesh_vertices(
-                    meshdata,
-                    *glmesh.attribute_buffers[DefaultShaderAtrribNames::Position]);
+            if (flattened) {
+                upload_flattened_buffers(meshdata, glmesh);
             }
-
-            if (!glmesh.get_index_buffer(DefaultShaderIndicesNames::TriangleIndices)) {
-                glmesh.index_buffers[DefaultShaderIndicesNames::TriangleIndices] =
-                    std::make_shared<GPUBuffer>(GL_ELEMENT_ARRAY_BUFFER);
-                upload_mesh_triangles(
-                    meshdata,
-                    *glmesh.index_buffers[DefaultShaderIndicesNames::TriangleIndices]);
-            }
-
-            // Mapping between lagrange mesh and default shader attributes
-            const static std::vector<std::pair<const char*, entt::id_type>> default_attribs = {
-                {"normal", DefaultShaderAtrribNames::Normal},
-                {"uv", DefaultShaderAtrribNames::UV},
-                {"tangent", DefaultShaderAtrribNames::Tangent},
-                {"bitangent", DefaultShaderAtrribNames::Bitangent},
-                {"bone_ids", DefaultShaderAtrribNames::BoneIDs},
-                {"bone_weights", DefaultShaderAtrribNames::BoneWeights},
-            };
-
-            for (const auto& attr : default_attribs) {
-                // Already uploaded
-                if (glmesh.get_attribute_buffer(attr.second)) continue;
-
-                // If has corner attribute, upload
-                if (has_mesh_corner_attribute(meshdata, attr.first)) {
-                    glmesh.attribute_buffers[attr.second] = std::make_shared<GPUBuffer>();
-                    upload_mesh_corner_attribute(
-                        meshdata,
-                        get_mesh_corner_attribute(meshdata, attr.first),
-                        *glmesh.attribute_buffers[attr.second]);
-                }
-                // Otherwise try vertex attribute (and expand it to corner attribute for gpu upload)
-                else if (has_mesh_vertex_attribute(meshdata, attr.first)) {
-                    glmesh.attribute_buffers[attr.second] = std::make_shared<GPUBuffer>();
-                    upload_mesh_vertex_attribute(
-                        meshdata,
-                        get_mesh_vertex_attribute(meshdata, attr.first),
-                        *glmesh.attribute_buffers[attr.second]);
-                }
-            }
-
-            // Material id
-            if (has_mesh_facet_attribute(meshdata, "material_id") &&
-                glmesh.submesh_indices.size() == 0) {
-                glmesh.submesh_indices = upload_submesh_indices(meshdata, "material_id");
+            if (indexed) {
+                upload_indexed_buffers(meshdata, glmesh);
             }
         }
     }
+
+    VertexBuffer::trim_staging_memory();
 }
 
 
@@ -11,7 +11,10 @@
  */
 #include <lagrange/ui/types/VertexBuffer.h>
 
+#include <algorithm>
 #include <cassert>
+#include <memory>
+#include <unordered_map>
 
 namespace lagrange {
 namespace ui {
@@ -52,6 +55,13 @@ void VertexBuffer::upload(const void* data, size_t byte_size, DataDescription& d
         desc.gl_type);
 }
 
+void VertexBuffer::upload_range(GLuint offset, GLuint size_, const uint8_t* data)
+{
+    assert(id != 0 && offset + size_ <= size);
+    GL(glBindBuffer(target, id));
+    GL(glBufferSubData(target, offset, size_, data));
+}
+
 void VertexBuffer::initialize()
 {
     if (id != 0) assert(false);
@@ -64,6 +74,117 @@ void VertexBuffer::download(GLuint size_, uint8_t* data) const
     GL(glGetBufferSubData(target, 0, size_, data));
 }
 
+namespace {
+
+struct StagingMemory
+{
+    std::unique_ptr<uint8_t[]> data;
+    size_t capacity = 0;
+
+    /// Largest request since the last trim
+    size_t frame_peak = 0;
+
+    /// Consecutive trims for which the memory was much larger than needed
+    unsigned oversized_frames = 0;
+};
+
+// Staging memory larger than this is released at the end of the frame instead of being kept
+constexpr size_t s_staging_keep_limit = size_t(256) << 20;
+
+// The memory is released after this many consecutive frames using less than a quarter of it
+constexpr unsigned s_staging_trim_frames = 300;
+
+StagingMemory& get_staging()
+{
+    static StagingMemory staging;
+    return staging;
+}
+
+// After mapping fails, the next uploads in the same context go straight to the staging memory.
+// Mapping is tried again after this many uploads, in case the failure was transient.
+constexpr unsigned s_mapping_retry_interval = 64;
+
+// Uploads left before mapping is tried again, per GL context. Kept per thread, so that no locking
+// is needed; a context made current on another thread simply tries mapping again.
+unsigned& get_mapping_skips()
+{
+    thread_local std::unordered_map<GLFWwindow*, unsigned> skips;
+    return skips[glfwGetCurrentContext()];
+}
+
+} // namespace
+
+uint8_t* VertexBuffer::map(GLuint size_, GLsizei cnt, bool integral, GLenum gl_type)
+{
+    auto& skips = get_mapping_skips();
+    if (skips > 0) {
+        skips--;
+        return nullptr;
+    }
+
+    if (id == 0) {
+        initialize();
+    }
+    size = size_;
+    GL(glBindBuffer(target, id));
+    GL(glBufferData(target, size, nullptr, GL_DYNAMIC_DRAW));
+    this->is_integral = integral;
+    this->count = cnt;
+    this->glType = gl_type;
+
+    void* ptr =
+        glMapBufferRange(target, 0, size, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+    if (!ptr) {
+        // Clear the error flag so it is not reported by the next checked call
+        glGetError();
+        skips = s_mapping_retry_interval;
+    }
+    return reinterpret_cast<uint8_t*>(ptr);
+}
+
+bool VertexBuffer::unmap()
+{
+    GL(glBindBuffer(target, id));
+    return glUnmapBuffer(target) == GL_TRUE;
+}
+
+uint8_t* VertexBuffer::get_staging_memory(size_t byte_size)
+{
+    auto& staging = get_staging();
+    staging.frame_peak = std::max(staging.frame_peak, byte_size);
+    if (staging.capacity < byte_size || !staging.data) {
+        // Grow geometrically to avoid reallocating on every slightly larger mesh
+        const size_t capacity = std::max(byte_size, 2 * staging.capacity);
+        staging.data.reset(new uint8_t[std::max<size_t>(capacity, 1)]);
+        staging.capacity = capacity;
+    }
+    return staging.data.get();
+}
+
+void VertexBuffer::trim_staging_memory()
+{
+    auto& staging = get_staging();
+    const size_t peak = staging.frame_peak;
+    staging.frame_peak = 0;
+
+    if (staging.capacity > s_staging_keep_limit) {
+        release_staging_memory();
+    } else if (peak < staging.capacity / 4) {
+        if (++staging.oversized_frames >= s_staging_trim_frames) release_staging_memory();
+    } else {
+        staging.oversized_frames = 0;
+    }
+}
+
+void VertexBuffer::release_staging_memory()
+{
+    auto& staging = get_staging();
+    staging.data.reset();
+    staging.capacity = 0;
+    staging.frame_peak = 0;
+    staging.oversized_frames = 0;
+}
+
 void VertexBuffer::free()
 {
     if (id != 0) {
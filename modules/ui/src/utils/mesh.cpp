@@ -11,11 +11,43 @@
  */
 #include <lagrange/ui/utils/mesh.h>
 #include <lagrange/ui/types/Camera.h>
+#include <lagrange/ui/types/VertexBuffer.h>
 
 
 namespace lagrange {
 namespace ui {
 
+namespace {
+
+std::unordered_map<entt::id_type, const MeshDataOps*>& get_registered_ops()
+{
+    static std::unordered_map<entt::id_type, const MeshDataOps*> registered_ops;
+    return registered_ops;
+}
+
+const MeshDataOps& get_ops(const MeshData& d)
+{
+    if (d.ops) return *d.ops;
+    const auto* ops = get_mesh_data_ops(d.type);
+    LA_ASSERT(ops, "Mesh type is not registered, call register_mesh_type<MeshType>() first");
+    return *ops;
+}
+
+} // namespace
+
+void register_mesh_data_ops(const entt::type_info& type, const MeshDataOps* ops)
+{
+    get_registered_ops()[type.hash()] = ops;
+}
+
+const MeshDataOps* get_mesh_data_ops(const entt::type_info& type)
+{
+    const auto& registered_ops = get_registered_ops();
+    auto it = registered_ops.find(type.hash());
+    if (it == registered_ops.end()) return nullptr;
+    return it->second;
+}
+
 MeshData& get_mesh_data(Registry& r, Entity e)
 {
     if (r.has<MeshData>(e)) return r.get<MeshData>(e);
@@ -30,219 +62,148 @@ const MeshData& get_mesh_data(const Registry& r, Entity e)
 
 size_t get_num_vertices(const MeshData& d)
 {
-    return entt::resolve(d.type)
-        .func(entt::hashed_string{"get_num_vertices"})
-        .invoke({}, (const MeshBase*)(d.mesh.get()))
-        .cast<size_t>();
+    return get_ops(d).get_num_vertices(d.mesh.get());
 }
 
 size_t get_num_facets(const MeshData& d)
 {
-    return entt::resolve(d.type)
-        .func(entt::hashed_string{"get_num_facets"})
-        .invoke({}, (const MeshBase*)(d.mesh.get()))
-        .cast<size_t>();
+    return get_ops(d).get_num_facets(d.mesh.get());
 }
 
 size_t get_num_edges(const MeshData& d)
 {
-    return entt::resolve(d.type)
-        .func(entt::hashed_string{"get_num_edges"})
-        .invoke({}, (const MeshBase*)(d.mesh.get()))
-        .cast<size_t>();
+    return get_ops(d).get_num_edges(d.mesh.get());
 }
 
 RowMajorMatrixXf get_mesh_vertices(const MeshData& d)
 {
-    const MeshBase* base = d.mesh.get();
-    auto fn = entt::resolve(d.type).func(entt::hashed_string{"get_mesh_vertices"});
-    auto result = fn.invoke({}, base);
-    auto conversion_result = entt::resolve<RowMajorMatrixXf>().construct(result);
-    return conversion_result.cast<RowMajorMatrixXf>();
+    return get_ops(d).get_mesh_vertices(d.mesh.get());
+}
+
+RowMajorMatrixXf get_mesh_vertices(const MeshData& d, const std::vector<int>& vertex_indices)
+{
+    return get_ops(d).get_mesh_vertices_subset(d.mesh.get(), &vertex_indices);
 }
 
 RowMajorMatrixXi get_mesh_facets(const MeshData& d)
 {
-    return entt::resolve(d.type)
-        .func(entt::hashed_string{"get_mesh_facets"})
-        .invoke({}, (const MeshBase*)(d.mesh.get()))
-        .cast<RowMajorMatrixXi>();
+    return get_ops(d).get_mesh_facets(d.mesh.get());
 }
 
 RowMajorMatrixXf get_mesh_vertex_attribute(const MeshData& d, const std::string& name)
 {
-    return entt::resolve(d.type)
-        .func(entt::hashed_string{"get_mesh_vertex_attribute"})
-        .invoke({}, (const MeshBase*)(d.mesh.get()), name)
-        .cast<RowMajorMatrixXf>();
+    return get_ops(d).get_mesh_vertex_attribute(d.mesh.get(), name);
 }
 
 RowMajorMatrixXf get_mesh_corner_attribute(const MeshData& d, const std::string& name)
 {
-    return entt::resolve(d.type)
-        .func(entt::hashed_string{"get_mesh_corner_attribute"})
-        .invoke({}, (const MeshBase*)(d.mesh.get()), name)
-        .cast<RowMajorMatrixXf>();
+    return get_ops(d).get_mesh_corner_attribute(d.mesh.get(), name);
 }
 
 RowMajorMatrixXf get_mesh_facet_attribute(const MeshData& d, const std::string& name)
 {
-    return entt::resolve(d.type)
-        .func(entt::hashed_string{"get_mesh_facet_attribute"})
-        .invoke({}, (const MeshBase*)(d.mesh.get()), name)
-        .cast<RowMajorMatrixXf>();
+    return get_ops(d).get_mesh_facet_attribute(d.mesh.get(), name);
 }
 
 RowMajorMatrixXf get_mesh_edge_attribute(const MeshData& d, const std::string& name)
 {
-    return entt::resolve(d.type)
-        .func(entt::hashed_string{"get_mesh_edge_attribute"})
-        .invoke({}, (const MeshBase*)(d.mesh.get()), name)
-        .cast<RowMajorMatrixXf>();
+    return get_ops(d).get_mesh_edge_attribute(d.mesh.get(), name);
 }
 
 RowMajorMatrixXf get_mesh_attribute(const MeshData& d, IndexingMode mode, const std::string& name)
 {
-    return entt::resolve(d.type)
-        .func(entt::hashed_string{"get_mesh_attribute"})
-        .invoke({}, (const MeshBase*)(d.mesh.get()), mode, name)
-        .cast<RowMajorMatrixXf>();
+    return get_ops(d).get_mesh_attribute(d.mesh.get(), mode, name);
 }
 std::pair<Eigen::VectorXf, Eigen::VectorXf>
 get_mesh_attribute_range(const MeshData& d, IndexingMode mode, const std::string& name)
 {
-    return entt::resolve(d.type)
-        .func(entt::hashed_string{"get_mesh_attribute_range"})
-        .invoke({}, (const MeshBase*)(d.mesh.get()), mode, name)
-        .cast<std::pair<Eigen::VectorXf, Eigen::VectorXf>>();
+    return get_ops(d).get_mesh_attribute_range(d.mesh.get(), mode, name);
 }
 
 ui::AABB get_mesh_bounds(const MeshData& d) {
-    return entt::resolve(d.type)
-        .func(entt::hashed_string{"get_mesh_bounds"})
-        .invoke({}, (const MeshBase*)(d.mesh.get()))
-        .cast<ui::AABB>();
+    return get_ops(d).get_mesh_bounds(d.mesh.get());
 }
 
 void ensure_uv(MeshData& d)
 {
-    entt::resolve(d.type)
-        .func(entt::hashed_string{"ensure_uv"})
-        .invoke({}, (MeshBase*)(d.mesh.get()));
+    get_ops(d).ensure_uv(d.mesh.get());
 }
 
 void ensure_normal(MeshData& d)
 {
-    entt::resolve(d.type)
-        .func(entt::hashed_string{"ensure_normal"})
-        .invoke({}, (MeshBase*)(d.mesh.get()));
+    get_ops(d).ensure_normal(d.mesh.get());
 }
 
 void ensure_tangent_bitangent(MeshData& d)
 {
-    entt::resolve(d.type)
-        .func(entt::hashed_string{"ensure_tangent_bitangent"})
-        .invoke({}, (MeshBase*)(d.mesh.get()));
+    get_ops(d).ensure_tangent_bitangent(d.mesh.get());
 }
 
 void ensure_is_selected_attribute(MeshData& d) {
-    entt::resolve(d.type)
-        .func(entt::hashed_string{"ensure_is_selected_attribute"})
-        .invoke({}, (MeshBase*)(d.mesh.get()));
+    get_ops(d).ensure_is_selected_attribute(d.mesh.get());
 }
 
 void map_indexed_attribute_to_corner_attribute(MeshData& d, const std::string& name) {
-    entt::resolve(d.type)
-        .func(entt::hashed_string{"map_indexed_attribute_to_corner_attribute"})
-        .invoke({}, (MeshBase*)(d.mesh.get()), name);
+    get_ops(d).map_indexed_attribute_to_corner_attribute(d.mesh.get(), name);
 }
 
 void map_corner_attribute_to_vertex_attribute(MeshData& d, const std::string& name) {
-    entt::resolve(d.type)
-        .func(entt::hashed_string{"map_corner_attribute_to_vertex_attribute"})
-        .invoke({}, (MeshBase*)(d.mesh.get()), name);
+    get_ops(d).map_corner_attribute_to_vertex_attribute(d.mesh.get(), name);
 }
 
 bool has_mesh_vertex_attribute(const MeshData& d, const std::string& name)
 {
-    return entt::resolve(d.type)
-        .func(entt::hashed_string{"has_mesh_vertex_attribute"})
-        .invoke({}, (const MeshBase*)(d.mesh.get()), name)
-        .cast<bool>();
+    return get_ops(d).has_mesh_vertex_attribute(d.mesh.get(), name);
 }
 
 bool has_mesh_corner_attribute(const MeshData& d, const std::string& name)
 {
-    return entt::resolve(d.type)
-        .func(entt::hashed_string{"has_mesh_corner_attribute"})
-        .invoke({}, (const MeshBase*)(d.mesh.get()), name)
-        .cast<bool>();
+    return get_ops(d).has_mesh_corner_attribute(d.mesh.get(), name);
 }
 
 bool has_mesh_facet_attribute(const MeshData& d, const std::string& name)
 {
-    return entt::resolve(d.type)
-        .func(entt::hashed_string{"has_mesh_facet_attribute"})
-        .invoke({}, (const MeshBase*)(d.mesh.get()), name)
-        .cast<bool>();
+    return get_ops(d).has_mesh_facet_attribute(d.mesh.get(), name);
 }
 
 bool has_mesh_edge_attribute(const MeshData& d, const std::string& name)
 {
-    return entt::resolve(d.type)
-        .func(entt::hashed_string{"has_mesh_edge_attribute"})
-        .invoke({}, (const MeshBase*)(d.mesh.get()), name)
-        .cast<bool>();
+    return get_ops(d).has_mesh_edge_attribute(d.mesh.get(), name);
 }
 
 
 bool has_mesh_indexed_attribute(const MeshData& d, const std::string& name) {
-    return entt::resolve(d.type)
-        .func(entt::hashed_string{"has_mesh_indexed_attribute"})
-        .invoke({}, (const MeshBase*)(d.mesh.get()), name)
-        .cast<bool>();
+    return get_ops(d).has_mesh_indexed_attribute(d.mesh.get(), name);
 }
 
 void upload_mesh_vertices(const MeshData& d, GPUBuffer& gpu)
 {
-    entt::resolve(d.type)
-        .func(entt::hashed_string{"upload_mesh_vertices"})
-        .invoke({}, (const MeshBase*)(d.mesh.get()), &gpu);
+    get_ops(d).upload_mesh_vertices(d.mesh.get(), &gpu);
 }
 
 void upload_mesh_triangles(const MeshData& d, GPUBuffer& gpu)
 {
-    entt::resolve(d.type)
-        .func(entt::hashed_string{"upload_mesh_triangles"})
-        .invoke({}, (const MeshBase*)(d.mesh.get()), &gpu);
+    get_ops(d).upload_mesh_triangles(d.mesh.get(), &gpu);
 }
 
 void upload_mesh_vertex_attribute(const MeshData& d, const RowMajorMatrixXf& data, GPUBuffer& gpu)
 {
-    entt::resolve(d.type)
-        .func(entt::hashed_string{"upload_mesh_vertex_attribute"})
-        .invoke({}, (const MeshBase*)(d.mesh.get()), &data, &gpu);
+    get_ops(d).upload_mesh_vertex_attribute(d.mesh.get(), &data, &gpu);
 }
 
 void upload_mesh_corner_attribute(const MeshData& d, const RowMajorMatrixXf& data, GPUBuffer& gpu)
 {
-    entt::resolve(d.type)
-        .func(entt::hashed_string{"upload_mesh_corner_attribute"})
-        .invoke({}, (const MeshBase*)(d.mesh.get()), &data, &gpu);
+    get_ops(d).upload_mesh_corner_attribute(d.mesh.get(), &data, &gpu);
 }
 
 void upload_mesh_facet_attribute(const MeshData& d, const RowMajorMatrixXf& data, GPUBuffer& gpu)
 {
-    entt::resolve(d.type)
-        .func(entt::hashed_string{"upload_mesh_facet_attribute"})
-        .invoke({}, (const MeshBase*)(d.mesh.get()), &data, &gpu);
+    get_ops(d).upload_mesh_facet_attribute(d.mesh.get(), &data, &gpu);
 }
 
 void upload_mesh_edge_attribute(const MeshData& d, const RowMajorMatrixXf& data, GPUBuffer& gpu)
 {
-    entt::resolve(d.type)
-        .func(entt::hashed_string{"upload_mesh_edge_attribute"})
-        .invoke({}, (const MeshBase*)(d.mesh.get()), &data, &gpu);
+    get_ops(d).upload_mesh_edge_attribute(d.mesh.get(), &data, &gpu);
 }
 
 
@@ -250,11 +211,73 @@ std::unordered_map<entt::id_type, std::shared_ptr<lagrange::ui::GPUBuffer>> uplo
     const MeshData& d,
     const std::string& facet_attrib_name)
 {
-    auto res = entt::resolve(d.type)
-        .func(entt::hashed_string{"upload_submesh_indices"})
-        .invoke({}, (const MeshBase*)(d.mesh.get()), facet_attrib_name);
+    return get_ops(d).upload_submesh_indices(d.mesh.get(), facet_attrib_name);
+}
+
+std::shared_ptr<RenderVertexMap> compute_vertex_corner_map(const MeshData& d)
+{
+    return get_ops(d).compute_vertex_corner_map(d.mesh.get());
+}
 
-    return res.cast<std::unordered_map<entt::id_type, std::shared_ptr<GPUBuffer>>>();
+std::shared_ptr<RenderVertexMap> compute_render_vertex_map(
+    const MeshData& d,
+    const std::vector<std::string>& corner_attribute_names)
+{
+    return get_ops(d).compute_render_vertex_map(d.mesh.get(), &corner_attribute_names);
+}
+
+void upload_mesh_vertices(const MeshData& d, const RenderVertexMap& map, GPUBuffer& gpu)
+{
+    get_ops(d).upload_mesh_vertices_indexed(d.mesh.get(), &map, &gpu);
+}
+
+void update_mesh_vertices(
+    const MeshData& d,
+    const std::vector<int>& vertex_indices,
+    const RenderVertexMap& map,
+    BufferLayout layout,
+    GPUBuffer& gpu)
+{
+    const auto& ops = get_ops(d);
+    const auto fn = (layout == BufferLayout::INDEXED) ? ops.update_mesh_vertices_indexed
+                                                      : ops.update_mesh_vertices;
+    fn(d.mesh.get(), &vertex_indices, &map, &gpu);
+}
+
+void upload_render_triangles(const RenderVertexMap& map, GPUBuffer& gpu)
+{
+    gpu.vbo().upload(
+        GLuint(map.triangles.size() * sizeof(unsigned int)),
+        (const uint8_t*)map.triangles.data(),
+        GLsizei(map.triangles.rows()),
+        true,
+        GL_UNSIGNED_INT);
+}
+
+void upload_mesh_vertex_attribute(
+    const MeshData& d,
+    const RowMajorMatrixXf& data,
+    const RenderVertexMap& map,
+    GPUBuffer& gpu)
+{
+    get_ops(d).upload_mesh_vertex_attribute_indexed(d.mesh.get(), &data, &map, &gpu);
+}
+
+void upload_mesh_corner_attribute(
+    const MeshData& d,
+    const RowMajorMatrixXf& data,
+    const RenderVertexMap& map,
+    GPUBuffer& gpu)
+{
+    get_ops(d).upload_mesh_corner_attribute_indexed(d.mesh.get(), &data, &map, &gpu);
+}
+
+std::unordered_map<entt::id_type, std::shared_ptr<lagrange::ui::GPUBuffer>> upload_submesh_indices(
+    const MeshData& d,
+    const std::string& facet_attrib_name,
+    const RenderVertexMap& map)
+{
+    return get_ops(d).upload_submesh_indices_indexed(d.mesh.get(), facet_attrib_name, &map);
 }
 
 //////////////////////////////////////////////////////////////////////////////////////
@@ -266,10 +289,7 @@ intersect_ray(const MeshData& d, const Eigen::Vector3f& origin, const Eigen::Vec
 {
     RayFacetHit rfhit;
 
-    bool result = entt::resolve(d.type)
-                      .func(entt::hashed_string{"intersect_ray"})
-                      .invoke({}, (const MeshBase*)(d.mesh.get()), origin, dir, &rfhit)
-                      .cast<bool>();
+    bool result = get_ops(d).intersect_ray(d.mesh.get(), origin, dir, &rfhit);
 
     if (!result) return {};
     return rfhit;
@@ -277,69 +297,38 @@ intersect_ray(const MeshData& d, const Eigen::Vector3f& origin, const Eigen::Vec
 
 bool select_facets_in_frustum(MeshData& d, SelectionBehavior sel_behavior, const Frustum& frustum)
 {
-    auto result = entt::resolve(d.type)
-                      .func(entt::hashed_string{"select_facets_in_frustum"})
-                      .invoke({}, (MeshBase*)(d.mesh.get()), sel_behavior, & frustum);
-
-    if (!result) {
-        LA_ASSERT(false, "select_facets_in_frustum failed");
-    }
-    return result.cast<bool>();
+    return get_ops(d).select_facets_in_frustum(d.mesh.get(), sel_behavior, &frustum);
 }
 
 void select_vertices_in_frustum(MeshData& d, SelectionBehavior sel_behavior, const Frustum& frustum)
 {
-    if (!entt::resolve(d.type)
-             .func(entt::hashed_string{"select_vertices_in_frustum"})
-             .invoke({}, (MeshBase*)(d.mesh.get()), sel_behavior, & frustum)) {
-        LA_ASSERT(false, "select_vertices_in_frustum failed");
-    }
+    get_ops(d).select_vertices_in_frustum(d.mesh.get(), sel_behavior, &frustum);
 }
 
 void select_edges_in_frustum(MeshData& d, SelectionBehavior sel_behavior, const Frustum& frustum)
 {
-    if (!entt::resolve(d.type)
-             .func(entt::hashed_string{"select_edges_in_frustum"})
-             .invoke({}, (MeshBase*)(d.mesh.get()), sel_behavior, & frustum)) {
-        LA_ASSERT(false, "select_edges_in_frustum failed");
-    }
+    get_ops(d).select_edges_in_frustum(d.mesh.get(), sel_behavior, &frustum);
 }
 
 
 void propagate_corner_selection(MeshData& d, const std::string& attrib_name)
 {
-    if (!entt::resolve(d.type)
-             .func(entt::hashed_string{"propagate_corner_selection"})
-             .invoke({}, (MeshBase*)(d.mesh.get()), attrib_name)) {
-        LA_ASSERT(false, "propagate_corner_selection failed");
-    }
+    get_ops(d).propagate_corner_selection(d.mesh.get(), attrib_name);
 }
 
 void propagate_vertex_selection(MeshData& d, const std::string& attrib_name)
 {
-    if (!entt::resolve(d.type)
-             .func(entt::hashed_string{"propagate_vertex_selection"})
-             .invoke({}, (MeshBase*)(d.mesh.get()), attrib_name)) {
-        LA_ASSERT(false, "propagate_vertex_selection failed");
-    }
+    get_ops(d).propagate_vertex_selection(d.mesh.get(), attrib_name);
 }
 
 void propagate_facet_selection(MeshData& d, const std::string& attrib_name)
 {
-    if (!entt::resolve(d.type)
-             .func(entt::hashed_string{"propagate_facet_selection"})
-             .invoke({}, (MeshBase*)(d.mesh.get()), attrib_name)) {
-        LA_ASSERT(false, "propagate_facet_selection failed");
-    }
+    get_ops(d).propagate_facet_selection(d.mesh.get(), attrib_name);
 }
 
 void combine_vertex_and_corner_selection(MeshData& d, const std::string& attrib_name)
 {
-    if (!entt::resolve(d.type)
-             .func(entt::hashed_string{"combine_vertex_and_corner_selection"})
-             .invoke({}, (MeshBase*)(d.mesh.get()), attrib_name)) {
-        LA_ASSERT(false, "combine_vertex_and_corner_selection failed");
-    }
+    get_ops(d).combine_vertex_and_corner_selection(d.mesh.get(), attrib_name);
 }
 
 void select_facets_by_color(
@@ -349,17 +338,12 @@ void select_facets_by_color(
     const unsigned char* color_bytes,
     size_t colors_byte_size)
 {
-    if (!entt::resolve(d.type)
-             .func(entt::hashed_string{"select_facets_by_color"})
-             .invoke(
-                 {},
-                 (MeshBase*)(d.mesh.get()),
-                 attrib_name,
-                 sel_behavior,
-                 color_bytes,
-                 colors_byte_size)) {
-        LA_ASSERT(false, "select_facets_by_color failed");
-    }
+    get_ops(d).select_facets_by_color(
+        d.mesh.get(),
+        attrib_name,
+        sel_behavior,
+        color_bytes,
+        colors_byte_size);
 }
 
 void select_edges_by_color(
@@ -369,17 +353,12 @@ void select_edges_by_color(
     const unsigned char* color_bytes,
     size_t colors_byte_size)
 {
-    if (!entt::resolve(d.type)
-             .func(entt::hashed_string{"select_edges_by_color"})
-             .invoke(
-                 {},
-                 (MeshBase*)(d.mesh.get()),
-                 attrib_name,
-                 sel_behavior,
-                 color_bytes,
-                 colors_byte_size)) {
-        LA_ASSERT(false, "select_edges_by_color failed");
-    }
+    get_ops(d).select_edges_by_color(
+        d.mesh.get(),
+        attrib_name,
+        sel_behavior,
+        color_bytes,
+        colors_byte_size);
 }
 
 void select_vertices_by_color(
@@ -389,30 +368,17 @@ void select_vertices_by_color(
     const unsigned char* color_bytes,
     size_t colors_byte_size)
 {
-    if (!entt::resolve(d.type)
-             .func(entt::hashed_string{"select_vertices_by_color"})
-             .invoke(
-                 {},
-                 (MeshBase*)(d.mesh.get()),
-                 attrib_name,
-                 sel_behavior,
-                 color_bytes,
-                 colors_byte_size)) {
-        LA_ASSERT(false, "select_vertices_by_color failed");
-    }
+    get_ops(d).select_vertices_by_color(
+        d.mesh.get(),
+        attrib_name,
+        sel_behavior,
+        color_bytes,
+        colors_byte_size);
 }
 
 
 void select_facets(MeshData& d, SelectionBehavior sel_behavior, const std::vector<int> & facet_indices) {
-    if (!entt::resolve(d.type)
-             .func(entt::hashed_string{"select_facets"})
-             .invoke(
-                 {},
-                 (MeshBase*)(d.mesh.get()),
-                 sel_behavior,
-                 &facet_indices)) {
-        LA_ASSERT(false, "select_facets failed");
-    }
+    get_ops(d).select_facets(d.mesh.get(), sel_behavior, &facet_indices);
 }
 
 void filter_closest_vertex(
@@ -422,11 +388,7 @@ void filter_closest_vertex(
     const Camera& camera,
     const Eigen::Vector2i& viewport_pos)
 {
-    if (!entt::resolve(d.type)
-             .func(entt::hashed_string{"filter_closest_vertex"})
-             .invoke({}, (MeshBase*)(d.mesh.get()), attrib_name, sel_behavior, camera, viewport_pos)) {
-        LA_ASSERT(false, "filter_closest_vertex failed");
-    }
+    get_ops(d).filter_closest_vertex(d.mesh.get(), attrib_name, sel_behavior, camera, viewport_pos);
 }
 
 } // namespace ui
@@ -30,8 +30,157 @@
 
 #include <lagrange/ui/default_entities.h>
 
+#include <tbb/parallel_invoke.h>
+#include <tbb/task_arena.h>
+#include <tbb/task_group.h>
+
+#include <algorithm>
+#include <functional>
+#include <numeric>
+
 namespace {
 using namespace lagrange::ui;
+
+using PickingNode = AcceleratedPicking::Tree::Node;
+
+void fit_leaf(PickingNode& node, const RowMajorMatrixXf& V, const RowMajorMatrixXi& F)
+{
+    node.m_box.setEmpty();
+    // Root of an empty tree
+    if (node.m_primitive < 0) return;
+    for (Eigen::Index k = 0; k < F.cols(); k++) {
+        node.m_box.extend(V.row(F(node.m_primitive, k)).transpose());
+    }
+}
+
+// Recomputes the boxes of the tree bottom-up for the current vertex positions.
+// The top levels are refitted in parallel.
+void refit_aabb(
+    PickingNode& node,
+    const RowMajorMatrixXf& V,
+    const RowMajorMatrixXi& F,
+    int depth = 0)
+{
+    if (!node.m_left && !node.m_right) {
+        fit_leaf(node, V, F);
+        return;
+    }
+
+    auto refit_child = [&](PickingNode* child) {
+        if (child) refit_aabb(*child, V, F, depth + 1);
+    };
+    if (depth < 8 && node.m_left && node.m_right) {
+        tbb::parallel_invoke(
+            [&]() { refit_child(node.m_left); },
+            [&]() { refit_child(node.m_right); });
+    } else {
+        refit_child(node.m_left);
+        refit_child(node.m_right);
+    }
+
+    node.m_box.setEmpty();
+    if (node.m_left) node.m_box.extend(node.m_left->m_box);
+    if (node.m_right) node.m_box.extend(node.m_right->m_box);
+}
+
+void index_nodes(AcceleratedPicking::Tree& tree)
+{
+    tree.nodes.clear();
+    tree.parents.clear();
+    std::vector<std::pair<PickingNode*, int>> stack = {{&tree.root, -1}};
+    while (!stack.empty()) {
+        const auto [node, parent] = stack.back();
+        stack.pop_back();
+        const int index = int(tree.nodes.size());
+        tree.nodes.push_back(node);
+        tree.parents.push_back(parent);
+        if (node->m_right) stack.emplace_back(node->m_right, index);
+        if (node->m_left) stack.emplace_back(node->m_left, index);
+    }
+}
+
+// Lists the nodes of a new tree and the leaves around each vertex, for partial refits
+void index_tree(AcceleratedPicking::Tree& tree)
+{
+    index_nodes(tree);
+
+    const auto& F = *tree.F;
+    tree.facet_leaves.assign(F.rows(), -1);
+    for (int i = 0; i < int(tree.nodes.size()); i++) {
+        const auto* node = tree.nodes[i];
+        if (!node->m_left && !node->m_right && node->m_primitive >= 0) {
+            tree.facet_leaves[node->m_primitive] = i;
+        }
+    }
+
+    auto& offsets = tree.vertex_facet_offsets;
+    offsets.assign(tree.V.rows() + 1, 0);
+    for (Eigen::Index i = 0; i < F.size(); i++) {
+        offsets[F(i / F.cols(), i % F.cols()) + 1]++;
+    }
+    for (Eigen::Index v = 0; v < tree.V.rows(); v++) {
+        offsets[v + 1] += offsets[v];
+    }
+    tree.vertex_facets.resize(F.size());
+    std::vector<int> counter(offsets.begin(), offsets.end() - 1);
+    for (Eigen::Index i = 0; i < F.size(); i++) {
+        tree.vertex_facets[counter[F(i / F.cols(), i % F.cols())]++] = int(i / F.cols());
+    }
+}
+
+// Refits the leaves of the facets around the given vertices and their ancestors only.
+// Falls back to refitting the whole tree if most nodes are affected.
+void refit_aabb(AcceleratedPicking::Tree& tree, const std::vector<int>& vertex_indices)
+{
+    const auto& F = *tree.F;
+    std::vector<char> is_marked(tree.nodes.size(), 0);
+    auto& marked = tree.refitted_nodes;
+    marked.clear();
+    for (const int v : vertex_indices) {
+        for (int i = tree.vertex_facet_offsets[v]; i < tree.vertex_facet_offsets[v + 1]; i++) {
+            // Stop at the first ancestor already marked by another leaf
+            int n = tree.facet_leaves[tree.vertex_facets[i]];
+            for (; n >= 0 && !is_marked[n]; n = tree.parents[n]) {
+                is_marked[n] = 1;
+                marked.push_back(n);
+            }
+        }
+    }
+    tree.refitted_vertices = vertex_indices;
+
+    if (marked.size() > tree.nodes.size() / 2) {
+        refit_aabb(tree.root, tree.V, F);
+        marked.resize(tree.nodes.size());
+        std::iota(marked.begin(), marked.end(), 0);
+        return;
+    }
+
+    // Children come after their parent
+    std::sort(marked.begin(), marked.end(), std::greater<int>());
+    for (const int n : marked) {
+        auto& node = *tree.nodes[n];
+        if (!node.m_left && !node.m_right) {
+            fit_leaf(node, tree.V, F);
+        } else {
+            node.m_box.setEmpty();
+            if (node.m_left) node.m_box.extend(node.m_left->m_box);
+            if (node.m_right) node.m_box.extend(node.m_right->m_box);
+        }
+    }
+}
+
+// Brings `tree` up to date with `base`, which was refitted from it. Both come from the same
+// build, so their nodes are listed in the same order.
+void catch_up(AcceleratedPicking::Tree& tree, const AcceleratedPicking::Tree& base)
+{
+    for (const int v : base.refitted_vertices) {
+        tree.V.row(v) = base.V.row(v);
+    }
+    for (const int n : base.refitted_nodes) {
+        tree.nodes[n]->m_box = base.nodes[n]->m_box;
+    }
+}
+
 void update_meshselection_render(Registry& r, Entity selected_entity)
 {
     const auto& sr = r.get<MeshSelectionRender>(selected_entity);
@@ -380,19 +529,64 @@ void mark_selection_dirty(Registry& r, MeshSelectionRender& sel_render)
     r.get<AttributeRender>(sel_render.vertex_render).dirty = true;
 }
 
+namespace {
+
+using PickingTree = AcceleratedPicking::Tree;
+
+// Background tasks of the picking structures of all entities
+struct PickingTasks
+{
+    tbb::task_arena arena;
+    tbb::task_group group;
+
+    ~PickingTasks() { wait(); }
+
+    void wait()
+    {
+        arena.execute([&]() { group.wait(); });
+    }
+};
+
+PickingTasks& get_picking_tasks()
+{
+    static PickingTasks tasks;
+    return tasks;
+}
+
+// Runs `make_tree` on a background task and stores its result in `ap.pending`
+template <typename MakeTreeFunc>
+void start_picking_task(AcceleratedPicking& ap, MakeTreeFunc make_tree)
+{
+    auto pending = std::make_shared<AcceleratedPicking::PendingTree>();
+    pending->generation = ap.generation;
+    ap.pending = pending;
+
+    auto& tasks = get_picking_tasks();
+    tasks.arena.execute([&]() {
+        tasks.group.run([pending, make_tree]() {
+            pending->tree = make_tree();
+            pending->ready.store(true, std::memory_order_release);
+        });
+    });
+}
+
+} // namespace
+
 bool enable_accelerated_picking(Registry& r, Entity in_e)
 {
     auto e = get_mesh_entity(r, in_e);
     if (!r.valid(e)) return false;
 
-    const auto& md = r.get<MeshData>(e);
+    auto& ap = r.get_or_emplace<AcceleratedPicking>(e);
+    ap.needs_rebuild = true;
+    ap.moved_vertices.clear();
 
-    AcceleratedPicking ap;
-    ap.V = get_mesh_vertices(md);
-    ap.F = get_mesh_facets(md);
-    ap.root.init(ap.V, ap.F);
+    // The facets may have changed, previous trees can no longer answer queries
+    ap.current = nullptr;
+    ap.retired = nullptr;
+    ap.generation++;
 
-    r.emplace_or_replace<AcceleratedPicking>(e, std::move(ap));
+    poll_accelerated_picking(r, e);
     return true;
 }
 
@@ -401,22 +595,125 @@ bool has_accelerated_picking(Registry& r, Entity e)
     return r.has<AcceleratedPicking>(get_mesh_entity(r, e));
 }
 
+bool refit_accelerated_picking(Registry& r, Entity in_e, const std::vector<int>& vertex_indices)
+{
+    auto e = get_mesh_entity(r, in_e);
+    if (!r.valid(e) || !r.has<AcceleratedPicking>(e)) return false;
+
+    auto& ap = r.get<AcceleratedPicking>(e);
+    if (!ap.needs_rebuild) {
+        ap.moved_vertices.insert(
+            ap.moved_vertices.end(),
+            vertex_indices.begin(),
+            vertex_indices.end());
+    }
+
+    poll_accelerated_picking(r, e);
+    return true;
+}
+
+void poll_accelerated_picking(Registry& r, Entity e)
+{
+    auto& ap = r.get<AcceleratedPicking>(e);
+
+    // Swap in the completed tree, unless a rebuild was requested since it was started
+    if (ap.pending && ap.pending->ready.load(std::memory_order_acquire)) {
+        if (ap.pending->generation == ap.generation) {
+            ap.retired = std::move(ap.current);
+            ap.current = std::move(ap.pending->tree);
+        }
+        ap.pending = nullptr;
+    }
+    if (ap.pending) return;
+
+    const auto& md = r.get<MeshData>(e);
+
+    if (ap.needs_rebuild || (!ap.current && !ap.moved_vertices.empty())) {
+        // Copy the geometry now, the mesh may change while the tree is built
+        auto tree = std::make_shared<PickingTree>();
+        tree->V = get_mesh_vertices(md);
+        tree->F = std::make_shared<const RowMajorMatrixXi>(get_mesh_facets(md));
+        start_picking_task(ap, [tree]() {
+            // igl::AABB does not support empty meshes
+            if (tree->F->rows() > 0) tree->root.init(tree->V, *tree->F);
+            index_tree(*tree);
+            return std::shared_ptr<const PickingTree>(tree);
+        });
+        ap.needs_rebuild = false;
+        ap.moved_vertices.clear();
+    } else if (!ap.moved_vertices.empty()) {
+        // Facets are unchanged, keep the tree and only refit its boxes
+        auto indices = std::make_shared<std::vector<int>>(std::move(ap.moved_vertices));
+        ap.moved_vertices.clear();
+        std::sort(indices->begin(), indices->end());
+        indices->erase(std::unique(indices->begin(), indices->end()), indices->end());
+        auto positions = std::make_shared<RowMajorMatrixXf>(get_mesh_vertices(md, *indices));
+
+        // Reuse the tree the current one was refitted from, unless a query still holds it.
+        // Trees are created non-const, it can be modified once no longer shared.
+        std::shared_ptr<PickingTree> storage;
+        if (ap.retired && ap.retired.use_count() == 1 && ap.retired->F == ap.current->F) {
+            storage = std::const_pointer_cast<PickingTree>(std::move(ap.retired));
+        }
+        ap.retired = nullptr;
+
+        start_picking_task(ap, [base = ap.current, storage, indices, positions]() {
+            // The current tree may be in use by queries, write to another one
+            std::shared_ptr<PickingTree> tree = storage;
+            if (tree) {
+                catch_up(*tree, *base);
+            } else {
+                tree = std::make_shared<PickingTree>(*base);
+                index_nodes(*tree);
+            }
+            for (size_t i = 0; i < indices->size(); i++) {
+                tree->V.row((*indices)[i]) = positions->row(Eigen::Index(i));
+            }
+            refit_aabb(*tree, *indices);
+            return std::shared_ptr<const PickingTree>(tree);
+        });
+    }
+}
+
+void wait_for_accelerated_picking(Registry& r, Entity in_e)
+{
+    auto e = get_mesh_entity(r, in_e);
+    if (!r.valid(e) || !r.has<AcceleratedPicking>(e)) return;
+
+    // Each completed task may start the next one for the changes queued meanwhile
+    while (true) {
+        poll_accelerated_picking(r, e);
+        if (!r.get<AcceleratedPicking>(e).pending) break;
+        get_picking_tasks().wait();
+    }
+}
+
 std::optional<lagrange::ui::RayFacetHit>
 intersect_ray(Registry& r, Entity in_e, const Eigen::Vector3f& origin, const Eigen::Vector3f& dir)
 {
     auto e = get_mesh_entity(r, in_e);
     if (!r.valid(e)) return {};
 
-    if (!has_accelerated_picking(r, e)) {
+    std::shared_ptr<const AcceleratedPicking::Tree> tree;
+    if (has_accelerated_picking(r, e)) {
+        poll_accelerated_picking(r, e);
+        tree = r.get<AcceleratedPicking>(e).current;
+    }
+
+    // No tree, or the first one is still being built
+    if (!tree) {
         const auto& md = r.get<MeshData>(e);
         return intersect_ray(md, origin, dir);
     }
 
-    auto& ap = r.get<AcceleratedPicking>(e);
-
     igl::Hit hit;
-    bool res =
-        ap.root.intersect_ray(ap.V, ap.F, origin, dir, std::numeric_limits<float>::infinity(), hit);
+    bool res = tree->root.intersect_ray(
+        tree->V,
+        *tree->F,
+        origin,
+        dir,
+        std::numeric_limits<float>::infinity(),
+        hit);
 
     if (!res) return {};
 
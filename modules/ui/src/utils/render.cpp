@@ -15,9 +15,12 @@
 #include <lagrange/utils/strings.h>
 
 // new
+#include <lagrange/ui/components/AttributeRender.h>
 #include <lagrange/ui/components/Common.h>
+#include <lagrange/ui/components/MeshRender.h>
 #include <lagrange/ui/components/RenderContext.h>
 #include <lagrange/ui/components/Transform.h>
+#include <lagrange/ui/utils/layer.h>
 #include <lagrange/ui/types/ShaderLoader.h>
 
 namespace lagrange {
@@ -420,25 +423,45 @@ int get_gl_attribute_dimension(GLenum attrib_type)
     return 0;
 }
 
+BufferLayout get_mesh_buffer_layout(Registry& registry, Entity e)
+{
+    if (registry.get<MeshRender>(e).indexing != IndexingMode::CORNER) {
+        return BufferLayout::FLATTENED;
+    }
+    if (registry.has<AttributeRender>(e) || is_in_layer(registry, e, DefaultLayers::Selection)) {
+        return BufferLayout::FLATTENED;
+    }
+    return BufferLayout::INDEXED;
+}
+
 void update_vertex_data(
     const GLMesh& glmesh,
     const Shader& shader,
     VertexData& glvd,
     IndexingMode indexing,
-    entt::id_type submesh_index)
+    entt::id_type submesh_index,
+    BufferLayout layout)
 {
     // todo multi mat
     auto& vd = glvd;
+    const bool indexed = (layout == BufferLayout::INDEXED);
 
     // Go through shader inputs (attributes)
     auto& attribs = shader.attribs();
     for (const auto& it : attribs) {
         // If has a default name, assign automatically from GLMesh
-        const auto buffer = glmesh.get_attribute_buffer(it.first);
+        const auto buffer = indexed ? glmesh.get_indexed_attribute_buffer(it.first)
+                                    : glmesh.get_attribute_buffer(it.first);
         if (buffer) {
             vd.attribute_buffers[it.second.location] = buffer;
             vd.attribute_dimensions[it.second.location] =
                 get_gl_attribute_dimension(it.second.type);
+        } else {
+            // Do not mix buffers of the flattened and indexed layouts
+            auto& bound = vd.attribute_buffers[it.second.location];
+            if (indexed || bound == glmesh.get_indexed_attribute_buffer(it.first)) {
+                bound = nullptr;
+            }
         }
 
         // Otherwise the layout has to be adjusted in custom render pass later
@@ -446,7 +469,11 @@ void update_vertex_data(
     }
 
     // Add indexing buffer
-    if (submesh_index != entt::null) {
+    if (indexed && submesh_index != entt::null) {
+        vd.index_buffer = glmesh.get_indexed_submesh_buffer(submesh_index);
+    } else if (indexed) {
+        vd.index_buffer = glmesh.get_index_buffer(DefaultShaderIndicesNames::RenderTriangleIndices);
+    } else if (submesh_index != entt::null) {
         vd.index_buffer = glmesh.get_submesh_buffer(submesh_index);
     } else if (indexing == IndexingMode::VERTEX) {
         vd.index_buffer = glmesh.get_index_buffer(DefaultShaderIndicesNames::VertexIndices);
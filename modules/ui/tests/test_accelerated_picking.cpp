@@ -0,0 +1,155 @@
+/*
+ * Copyright 2020 Adobe. All rights reserved.
+ * This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain a copy
+ * of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under
+ * the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ * OF ANY KIND, either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+ */
+#include <lagrange/testing/common.h>
+
+#include <lagrange/Mesh.h>
+#include <lagrange/create_mesh.h>
+#include <lagrange/ui/Entity.h>
+#include <lagrange/ui/components/AcceleratedPicking.h>
+#include <lagrange/ui/components/MeshData.h>
+#include <lagrange/ui/utils/mesh.h>
+#include <lagrange/ui/utils/mesh.impl.h>
+#include <lagrange/ui/utils/mesh_picking.h>
+
+#include <memory>
+#include <vector>
+
+namespace ui = lagrange::ui;
+
+TEST_CASE("accelerated picking", "[ui][picking]")
+{
+    using MeshType = lagrange::TriangleMesh3D;
+    ui::register_mesh_type<MeshType>();
+
+    // n x n grid in the z = 0 plane, two triangles per cell
+    const int n = 10;
+    MeshType::VertexArray V((n + 1) * (n + 1), 3);
+    for (int i = 0; i <= n; i++) {
+        for (int j = 0; j <= n; j++) {
+            V.row(i * (n + 1) + j) << i, j, 0;
+        }
+    }
+    MeshType::FacetArray F(2 * n * n, 3);
+    for (int i = 0; i < n; i++) {
+        for (int j = 0; j < n; j++) {
+            const int v = i * (n + 1) + j;
+            F.row(2 * (i * n + j)) << v, v + n + 1, v + 1;
+            F.row(2 * (i * n + j) + 1) << v + 1, v + n + 1, v + n + 2;
+        }
+    }
+
+    std::shared_ptr<MeshType> mesh = lagrange::create_mesh(V, F);
+    ui::Registry r;
+    const auto e = ui::register_mesh(r, mesh);
+
+    // Rays go down the z axis
+    auto pick = [&](float x, float y) {
+        return ui::intersect_ray(r, e, Eigen::Vector3f(x, y, 1), Eigen::Vector3f(0, 0, -1));
+    };
+    // Same query testing all triangles
+    auto check_pick = [&](float x, float y) {
+        const auto hit = pick(x, y);
+        const auto expected = ui::intersect_ray(
+            ui::get_mesh_data(r, e),
+            Eigen::Vector3f(x, y, 1),
+            Eigen::Vector3f(0, 0, -1));
+        REQUIRE(hit.has_value() == expected.has_value());
+        if (hit) {
+            REQUIRE(hit->facet_id == expected->facet_id);
+            REQUIRE(hit->t == Approx(expected->t));
+        }
+        return hit;
+    };
+    auto move_vertex = [&](int v, float x, float y) {
+        MeshType::VertexArray vertices = mesh->get_vertices();
+        vertices.row(v) << x, y, 0;
+        mesh->import_vertices(vertices);
+    };
+
+    REQUIRE(ui::enable_accelerated_picking(r, e));
+    ui::wait_for_accelerated_picking(r, e);
+    REQUIRE(r.get<ui::AcceleratedPicking>(e).current);
+
+    auto hit = check_pick(2.25f, 3.5f);
+    REQUIRE(hit);
+    REQUIRE(hit->facet_id == 2 * (2 * n + 3));
+    REQUIRE(hit->t == Approx(1));
+    REQUIRE(!check_pick(n + 2.0f, n + 2.0f));
+
+    SECTION("refit")
+    {
+        // Pull the last corner of the grid out, its only facet now covers (n + 2, n + 2)
+        const int corner = n * (n + 1) + n;
+        const int corner_facet = 2 * n * n - 1;
+        move_vertex(corner, n + 5.0f, n + 5.0f);
+        REQUIRE(ui::refit_accelerated_picking(r, e, {corner}));
+
+        // The previous tree keeps answering queries during a refit
+        REQUIRE(r.get<ui::AcceleratedPicking>(e).current);
+
+        ui::wait_for_accelerated_picking(r, e);
+        hit = check_pick(n + 2.0f, n + 2.0f);
+        REQUIRE(hit);
+        REQUIRE(hit->facet_id == corner_facet);
+
+        // Move it back, the next refit writes to the tree retired by the previous one
+        move_vertex(corner, n, n);
+        REQUIRE(ui::refit_accelerated_picking(r, e, {corner}));
+        ui::wait_for_accelerated_picking(r, e);
+        REQUIRE(!check_pick(n + 2.0f, n + 2.0f));
+        hit = check_pick(n - 0.25f, n - 0.25f);
+        REQUIRE(hit);
+        REQUIRE(hit->facet_id == corner_facet);
+        check_pick(2.25f, 3.5f);
+    }
+
+    SECTION("topology change")
+    {
+        // Keep the cells of the first n / 2 rows only
+        MeshType::FacetArray half_facets = F.topRows(n * n);
+        mesh->import_facets(half_facets);
+        REQUIRE(ui::enable_accelerated_picking(r, e));
+
+        // The previous tree indexes removed facets, all triangles are tested until the new tree
+        // is built
+        REQUIRE(!r.get<ui::AcceleratedPicking>(e).current);
+        REQUIRE(!check_pick(8.25f, 3.5f));
+        check_pick(2.25f, 3.5f);
+
+        ui::wait_for_accelerated_picking(r, e);
+        const auto& current = r.get<ui::AcceleratedPicking>(e).current;
+        REQUIRE(current);
+        REQUIRE(current->F->rows() == n * n);
+        REQUIRE(!check_pick(8.25f, 3.5f));
+        hit = check_pick(2.25f, 3.5f);
+        REQUIRE(hit);
+        REQUIRE(hit->facet_id == 2 * (2 * n + 3));
+    }
+
+    SECTION("refit during rebuild")
+    {
+        MeshType::FacetArray half_facets = F.topRows(n * n);
+        mesh->import_facets(half_facets);
+        REQUIRE(ui::enable_accelerated_picking(r, e));
+
+        // Applied to the new tree once built. Vertex 0 is only used by facet 0.
+        move_vertex(0, -5, -5);
+        REQUIRE(ui::refit_accelerated_picking(r, e, {0}));
+        ui::wait_for_accelerated_picking(r, e);
+
+        REQUIRE(r.get<ui::AcceleratedPicking>(e).current->F->rows() == n * n);
+        hit = check_pick(-2, -2);
+        REQUIRE(hit);
+        REQUIRE(hit->facet_id == 0);
+        REQUIRE(!check_pick(8.25f, 3.5f));
+    }
+}
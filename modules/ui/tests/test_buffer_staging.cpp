@@ -0,0 +1,128 @@
+/*
+ * Copyright 2020 Adobe. All rights reserved.
+ * This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain a copy
+ * of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under
+ * the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ * OF ANY KIND, either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+ */
+#include <lagrange/testing/common.h>
+#include <lagrange/ui/utils/buffer_staging.h>
+
+#include <vector>
+
+namespace ui = lagrange::ui;
+
+TEST_CASE("gather_rows_to_float", "[ui][buffer_staging]")
+{
+    using RowMatrixXd = Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>;
+
+    RowMatrixXd data(4, 3);
+    data << 0.5, 1.0, 1.5, //
+        2.0, 2.5, 3.0, //
+        3.5, 4.0, 4.5, //
+        5.0, 5.5, 6.0;
+
+    SECTION("identity")
+    {
+        std::vector<float> output(data.size(), -1.f);
+        ui::gather_rows_to_float(data, output.data());
+        for (Eigen::Index i = 0; i < data.rows(); i++) {
+            for (Eigen::Index j = 0; j < data.cols(); j++) {
+                REQUIRE(output[i * data.cols() + j] == float(data(i, j)));
+            }
+        }
+    }
+
+    SECTION("flattened corners")
+    {
+        Eigen::Matrix<int, Eigen::Dynamic, 3, Eigen::RowMajor> facets(2, 3);
+        facets << 0, 1, 2, //
+            2, 1, 3;
+
+        const size_t num_corners = size_t(facets.size());
+        std::vector<float> output(num_corners * data.cols(), -1.f);
+        ui::gather_rows_to_float(
+            data,
+            num_corners,
+            [&](size_t c) { return facets(c / 3, c % 3); },
+            output.data());
+
+        for (size_t c = 0; c < num_corners; c++) {
+            const auto v = facets(c / 3, c % 3);
+            for (Eigen::Index j = 0; j < data.cols(); j++) {
+                REQUIRE(output[c * data.cols() + j] == float(data(v, j)));
+            }
+        }
+    }
+
+    SECTION("column major input")
+    {
+        const Eigen::MatrixXd col_major = data;
+        std::vector<float> output(data.size(), -1.f);
+        ui::gather_rows_to_float(col_major, output.data());
+
+        std::vector<float> expected(data.size());
+        Eigen::Map<Eigen::Matrix<float, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>>(
+            expected.data(),
+            data.rows(),
+            data.cols()) = data.cast<float>();
+        REQUIRE(output == expected);
+    }
+
+    SECTION("large")
+    {
+        // Enough rows to be split between several tasks
+        const size_t num_rows = 100000;
+        std::vector<float> output(num_rows * data.cols(), -1.f);
+        ui::gather_rows_to_float(
+            data,
+            num_rows,
+            [&](size_t i) { return (i * 7) % data.rows(); },
+            output.data());
+
+        std::vector<float> expected(output.size());
+        for (size_t i = 0; i < num_rows; i++) {
+            const auto r = Eigen::Index((i * 7) % data.rows());
+            for (Eigen::Index j = 0; j < data.cols(); j++) {
+                expected[i * data.cols() + j] = float(data(r, j));
+            }
+        }
+        REQUIRE(output == expected);
+    }
+
+    SECTION("empty")
+    {
+        std::vector<float> output;
+        ui::gather_rows_to_float(data, 0, [](size_t i) { return i; }, output.data());
+        REQUIRE(output.empty());
+    }
+}
+
+TEST_CASE("sort_into_row_ranges", "[ui][buffer_staging]")
+{
+    using Ranges = std::vector<std::pair<int, int>>;
+
+    SECTION("empty")
+    {
+        std::vector<int> rows;
+        REQUIRE(ui::sort_into_row_ranges(rows).empty());
+    }
+
+    SECTION("unsorted with duplicates")
+    {
+        std::vector<int> rows = {7, 2, 3, 9, 2, 8, 0, 3};
+        const auto ranges = ui::sort_into_row_ranges(rows);
+        REQUIRE(rows == std::vector<int>{0, 2, 3, 7, 8, 9});
+        REQUIRE(ranges == Ranges{{0, 1}, {2, 4}, {7, 10}});
+    }
+
+    SECTION("single range")
+    {
+        std::vector<int> rows = {4, 5, 6, 5};
+        REQUIRE(ui::sort_into_row_ranges(rows) == Ranges{{4, 7}});
+    }
+}
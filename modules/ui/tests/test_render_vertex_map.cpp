@@ -0,0 +1,269 @@
+/*
+ * Copyright 2020 Adobe. All rights reserved.
+ * This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain a copy
+ * of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under
+ * the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ * OF ANY KIND, either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+ */
+#include <lagrange/testing/common.h>
+
+#include <lagrange/Mesh.h>
+#include <lagrange/create_mesh.h>
+#include <lagrange/ui/Entity.h>
+#include <lagrange/ui/components/MeshData.h>
+#include <lagrange/ui/types/RenderVertexMap.h>
+#include <lagrange/ui/utils/mesh.h>
+#include <lagrange/ui/utils/mesh.impl.h>
+
+#include <algorithm>
+#include <memory>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace ui = lagrange::ui;
+
+namespace {
+
+using MeshType = lagrange::TriangleMesh3D;
+using AttributeArray = MeshType::AttributeArray;
+
+/// Checks that drawing the indexed layout gives the same triangles as the flattened layout: every
+/// corner reads the position of its vertex and, for the attributes that split render vertices, the
+/// values of the corner itself.
+void check_same_triangles(const ui::MeshData& md, const ui::RenderVertexMap& map)
+{
+    const auto& mesh = reinterpret_cast<const MeshType&>(*md.mesh);
+    const auto& F = mesh.get_facets();
+
+    REQUIRE(map.triangles.rows() == F.rows());
+    REQUIRE(map.triangles.cols() == 3);
+    REQUIRE(map.vertices.size() == map.get_num_render_vertices());
+    REQUIRE(map.corners.size() == map.get_num_render_vertices());
+
+    for (Eigen::Index f = 0; f < F.rows(); f++) {
+        for (Eigen::Index k = 0; k < 3; k++) {
+            const int c = int(f * 3 + k);
+            const int r = map.triangles(f, k);
+            REQUIRE(r >= 0);
+            REQUIRE(r < int(map.get_num_render_vertices()));
+            REQUIRE(map.vertices[r] == F(f, k));
+            for (const auto& name : map.attribute_names) {
+                const auto& attr = mesh.get_corner_attribute(name);
+                REQUIRE(attr.row(map.corners[r]) == attr.row(c));
+            }
+        }
+    }
+
+    // Render vertices of each mesh vertex are contiguous
+    REQUIRE(map.vertex_offsets.size() == size_t(mesh.get_num_vertices() + 1));
+    REQUIRE(map.vertex_offsets.back() == int(map.get_num_render_vertices()));
+    for (int v = 0; v < int(mesh.get_num_vertices()); v++) {
+        for (int r = map.vertex_offsets[v]; r < map.vertex_offsets[v + 1]; r++) {
+            REQUIRE(map.vertices[r] == v);
+        }
+    }
+}
+
+} // namespace
+
+TEST_CASE("compute_render_vertex_map", "[ui][mesh]")
+{
+    ui::register_mesh_type<MeshType>();
+
+    // Two triangles sharing the edge (1, 2)
+    MeshType::VertexArray V(4, 3);
+    V << 0, 0, 0, //
+        1, 0, 0, //
+        0, 1, 0, //
+        1, 1, 0;
+    MeshType::FacetArray F(2, 3);
+    F << 0, 1, 2, //
+        2, 1, 3;
+
+    std::shared_ptr<MeshType> mesh = lagrange::create_mesh(V, F);
+    ui::Registry r;
+    const auto e = ui::register_mesh(r, mesh);
+    const auto& md = ui::get_mesh_data(r, e);
+
+    auto set_corner_attribute = [&](const std::string& name, const AttributeArray& values) {
+        if (!mesh->has_corner_attribute(name)) mesh->add_corner_attribute(name);
+        mesh->set_corner_attribute(name, values);
+    };
+
+    SECTION("no attributes")
+    {
+        auto map = ui::compute_render_vertex_map(md, {});
+        REQUIRE(map->get_num_render_vertices() == 4);
+        REQUIRE(map->triangles == F);
+        check_same_triangles(md, *map);
+    }
+
+    SECTION("identical corners merge")
+    {
+        AttributeArray uv(6, 2);
+        uv << 0, 0, 1, 0, 0, 1, //
+            0, 1, 1, 0, 1, 1;
+        set_corner_attribute("uv", uv);
+
+        auto map = ui::compute_render_vertex_map(md, {"uv"});
+        REQUIRE(map->attribute_names == std::vector<std::string>{"uv"});
+        REQUIRE(map->get_num_render_vertices() == 4);
+        REQUIRE(map->triangles == F);
+        check_same_triangles(md, *map);
+    }
+
+    SECTION("uv seam splits vertices")
+    {
+        // The second triangle has its own chart
+        AttributeArray uv(6, 2);
+        uv << 0, 0, 1, 0, 0, 1, //
+            2, 1, 3, 0, 3, 1;
+        set_corner_attribute("uv", uv);
+
+        auto map = ui::compute_render_vertex_map(md, {"uv"});
+        REQUIRE(map->get_num_render_vertices() == 6);
+        REQUIRE(map->vertex_offsets == std::vector<int>{0, 1, 3, 5, 6});
+        check_same_triangles(md, *map);
+    }
+
+    SECTION("normal seam splits vertices")
+    {
+        // Hard edge along (1, 2): each triangle has its own normal
+        AttributeArray normal(6, 3);
+        normal << 0, 0, 1, 0, 0, 1, 0, 0, 1, //
+            0, 1, 0, 0, 1, 0, 0, 1, 0;
+        set_corner_attribute("normal", normal);
+
+        AttributeArray uv(6, 2);
+        uv << 0, 0, 1, 0, 0, 1, //
+            0, 1, 1, 0, 1, 1;
+        set_corner_attribute("uv", uv);
+
+        auto map = ui::compute_render_vertex_map(md, {"uv", "normal"});
+        REQUIRE(map->attribute_names == std::vector<std::string>{"uv", "normal"});
+        REQUIRE(map->get_num_render_vertices() == 6);
+        check_same_triangles(md, *map);
+
+        // Without the normals, the uv alone does not split anything
+        map = ui::compute_render_vertex_map(md, {"uv"});
+        REQUIRE(map->get_num_render_vertices() == 4);
+    }
+
+    SECTION("missing attributes are ignored")
+    {
+        auto map = ui::compute_render_vertex_map(md, {"missing"});
+        REQUIRE(map->attribute_names.empty());
+        REQUIRE(map->get_num_render_vertices() == 4);
+    }
+}
+
+TEST_CASE("compute_render_vertex_map random seams", "[ui][mesh]")
+{
+    ui::register_mesh_type<MeshType>();
+
+    // Grid where each corner picks one of two values per vertex, so that seams go through
+    // arbitrary vertices and corners on the same side merge.
+    const int n = 20;
+    MeshType::VertexArray V((n + 1) * (n + 1), 3);
+    for (int i = 0; i <= n; i++) {
+        for (int j = 0; j <= n; j++) {
+            V.row(i * (n + 1) + j) << i, j, 0;
+        }
+    }
+    MeshType::FacetArray F(2 * n * n, 3);
+    for (int i = 0; i < n; i++) {
+        for (int j = 0; j < n; j++) {
+            const int v = i * (n + 1) + j;
+            F.row(2 * (i * n + j)) << v, v + n + 1, v + 1;
+            F.row(2 * (i * n + j) + 1) << v + 1, v + n + 1, v + n + 2;
+        }
+    }
+
+    std::mt19937 gen(0);
+    std::uniform_int_distribution<int> coin(0, 1);
+    AttributeArray uv(F.size(), 2);
+    AttributeArray normal(F.size(), 3);
+    for (Eigen::Index c = 0; c < F.size(); c++) {
+        const int v = F(c / 3, c % 3);
+        uv.row(c) << V(v, 0) + coin(gen), V(v, 1);
+        normal.row(c) << 0, coin(gen), 1;
+    }
+
+    std::shared_ptr<MeshType> mesh = lagrange::create_mesh(V, F);
+    mesh->add_corner_attribute("uv");
+    mesh->set_corner_attribute("uv", uv);
+    mesh->add_corner_attribute("normal");
+    mesh->set_corner_attribute("normal", normal);
+
+    ui::Registry r;
+    const auto e = ui::register_mesh(r, mesh);
+    const auto& md = ui::get_mesh_data(r, e);
+
+    auto map = ui::compute_render_vertex_map(md, {"uv", "normal"});
+    check_same_triangles(md, *map);
+
+    // Each vertex is split into as many render vertices as distinct (uv, normal) values
+    for (int v = 0; v < int(V.rows()); v++) {
+        std::vector<std::pair<float, float>> values;
+        for (int i = map->corner_offsets[v]; i < map->corner_offsets[v + 1]; i++) {
+            const int c = map->vertex_corners[i];
+            values.emplace_back(float(uv(c, 0)), float(normal(c, 1)));
+        }
+        std::sort(values.begin(), values.end());
+        values.erase(std::unique(values.begin(), values.end()), values.end());
+        REQUIRE(map->vertex_offsets[v + 1] - map->vertex_offsets[v] == int(values.size()));
+    }
+    REQUIRE(map->get_num_render_vertices() < size_t(F.size()));
+
+    // Render vertices are numbered by first corner, which is their representative
+    for (int v = 0; v < int(V.rows()); v++) {
+        int next = map->vertex_offsets[v];
+        for (int i = map->corner_offsets[v]; i < map->corner_offsets[v + 1]; i++) {
+            const int c = map->vertex_corners[i];
+            const int rv = map->triangles(c / 3, c % 3);
+            REQUIRE(rv <= next);
+            if (rv == next) {
+                REQUIRE(map->corners[rv] == c);
+                next++;
+            }
+        }
+    }
+}
+
+TEST_CASE("compute_vertex_corner_map", "[ui][mesh]")
+{
+    ui::register_mesh_type<MeshType>();
+
+    MeshType::VertexArray V(5, 3);
+    V << 0, 0, 0, //
+        1, 0, 0, //
+        0, 1, 0, //
+        1, 1, 0, //
+        2, 2, 0;
+    MeshType::FacetArray F(3, 3);
+    F << 0, 1, 2, //
+        2, 1, 3, //
+        3, 1, 0;
+
+    std::shared_ptr<MeshType> mesh = lagrange::create_mesh(V, F);
+    ui::Registry r;
+    const auto e = ui::register_mesh(r, mesh);
+    const auto& md = ui::get_mesh_data(r, e);
+
+    // Only the corners around each vertex are computed, as in the full map
+    auto map = ui::compute_vertex_corner_map(md);
+    auto full_map = ui::compute_render_vertex_map(md, {});
+    REQUIRE(map->corner_offsets == full_map->corner_offsets);
+    REQUIRE(map->vertex_corners == full_map->vertex_corners);
+    REQUIRE(map->get_num_render_vertices() == 0);
+
+    // Unreferenced vertex 4 has no corners
+    REQUIRE(map->corner_offsets == std::vector<int>{0, 2, 5, 7, 9, 9});
+    REQUIRE(map->vertex_corners == std::vector<int>{0, 8, 1, 4, 7, 2, 3, 5, 6});
+}